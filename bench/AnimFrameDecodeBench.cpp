@@ -0,0 +1,81 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkString.h"
+#include "include/utils/SkAnimFrameDecoder.h"
+#include "src/utils/SkOSPath.h"
+#include "tools/Resources.h"
+
+/**
+ *  Decodes every frame of an animated image in order with SkAnimFrameDecoder, as a transcoder
+ *  would. With threads > 1, independent runs of frames are decoded concurrently.
+ */
+class AnimFrameDecodeBench : public Benchmark {
+public:
+    AnimFrameDecodeBench(const char* path, int threads, int cacheFrames)
+            : fPath(path)
+            , fThreads(threads)
+            , fCacheFrames(cacheFrames) {
+        fName.printf("anim_frame_decode_%s_%dthreads_%dframes",
+                     SkOSPath::Basename(path).c_str(), threads, cacheFrames);
+    }
+
+    bool isSuitableFor(Backend backend) override { return kNonRendering_Backend == backend; }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fData = GetResourceAsData(fPath);
+        if (auto decoder = SkAnimFrameDecoder::Make(fData, nullptr, 0)) {
+            fCacheBytes = fCacheFrames * SkImageInfo::MakeN32Premul(decoder->dimensions())
+                                                 .computeMinByteSize();
+        } else {
+            fData = nullptr;
+        }
+        if (fThreads > 1) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fData) {
+            return;
+        }
+        for (int i = 0; i < loops; i++) {
+            auto decoder = SkAnimFrameDecoder::Make(fData, fExecutor.get(), fCacheBytes);
+            for (int frame = 0; frame < decoder->frameCount(); frame++) {
+                decoder->getFrame(frame);
+            }
+        }
+    }
+
+private:
+    const char* const           fPath;
+    const int                   fThreads;
+    const int                   fCacheFrames;
+    SkString                    fName;
+    sk_sp<SkData>               fData;
+    size_t                      fCacheBytes = 0;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+    using INHERITED = Benchmark;
+};
+
+#define ANIM_FRAME_DECODE_BENCHES(path)                                \
+    DEF_BENCH(return new AnimFrameDecodeBench(path,  1, 16);)          \
+    DEF_BENCH(return new AnimFrameDecodeBench(path,  4, 16);)          \
+    DEF_BENCH(return new AnimFrameDecodeBench(path, 16, 64);)
+
+ANIM_FRAME_DECODE_BENCHES("images/alphabetAnim.gif")
+ANIM_FRAME_DECODE_BENCHES("images/flightAnim.gif")
+ANIM_FRAME_DECODE_BENCHES("images/test640x479.gif")
+ANIM_FRAME_DECODE_BENCHES("images/stoplight.webp")
@@ -13,12 +13,15 @@
 #include "src/core/SkOSFile.h"
 
 BitmapRegionDecoderBench::BitmapRegionDecoderBench(const char* baseName, SkData* encoded,
-        SkColorType colorType, uint32_t sampleSize, const SkIRect& subset)
+        SkColorType colorType, uint32_t sampleSize, const SkIRect& subset, int tileSize,
+        size_t cacheBytes)
     : fBRD(nullptr)
     , fData(SkRef(encoded))
     , fColorType(colorType)
     , fSampleSize(sampleSize)
     , fSubset(subset)
+    , fTileSize(tileSize)
+    , fCacheBytes(cacheBytes)
 {
     // Choose a useful name for the color type
     const char* colorName = color_type_to_str(colorType);
@@ -45,8 +48,23 @@ void BitmapRegionDecoderBench::onDraw(int n, SkCanvas* canvas) {
     auto ct = fBRD->computeOutputColorType(fColorType);
     auto cs = fBRD->computeOutputColorSpace(ct, nullptr);
     for (int i = 0; i < n; i++) {
-        SkBitmap bm;
-        SkAssertResult(fBRD->decodeRegion(&bm, nullptr, fSubset, fSampleSize, ct, false, cs));
+        if (fTileSize <= 0) {
+            SkBitmap bm;
+            SkAssertResult(fBRD->decodeRegion(&bm, nullptr, fSubset, fSampleSize, ct, false, cs));
+            continue;
+        }
+
+        // Start each pass from an empty cache.
+        fBRD->setRowBandCacheBudget(0);
+        fBRD->setRowBandCacheBudget(fCacheBytes);
+        for (int y = fSubset.top(); y < fSubset.bottom(); y += fTileSize) {
+            for (int x = fSubset.left(); x < fSubset.right(); x += fTileSize) {
+                SkBitmap bm;
+                SkAssertResult(fBRD->decodeRegion(&bm, nullptr,
+                                                  SkIRect::MakeXYWH(x, y, fTileSize, fTileSize),
+                                                  fSampleSize, ct, false, cs));
+            }
+        }
     }
 }
 #endif // SK_ENABLE_ANDROID_UTILS
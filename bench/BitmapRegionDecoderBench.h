@@ -26,12 +26,16 @@ class BitmapRegionDecoder;
  *
  *  nanobench.cpp handles creating benchmarks for interesting scaled subsets.  We strive to test
  *  on real use cases.
+ *
+ *  If tileSize is positive, subset is instead decoded as a grid of tileSize x tileSize regions
+ *  (in the image's coordinates), left to right and top to bottom, as a tiled viewer panning over
+ *  it would. Each pass starts with an empty row band cache of cacheBytes.
  */
 class BitmapRegionDecoderBench : public Benchmark {
 public:
     // Calls encoded->ref()
     BitmapRegionDecoderBench(const char* basename, SkData* encoded, SkColorType colorType,
-            uint32_t sampleSize, const SkIRect& subset);
+            uint32_t sampleSize, const SkIRect& subset, int tileSize = 0, size_t cacheBytes = 0);
 
 protected:
     const char* onGetName() override;
@@ -46,6 +50,8 @@ private:
     const SkColorType                                   fColorType;
     const uint32_t                                      fSampleSize;
     const SkIRect                                       fSubset;
+    const int                                           fTileSize;
+    const size_t                                        fCacheBytes;
     using INHERITED = Benchmark;
 };
 #endif // SK_ENABLE_ANDROID_UTILS
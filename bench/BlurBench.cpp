@@ -5,13 +5,17 @@
  * found in the LICENSE file.
  */
 #include "bench/Benchmark.h"
+#include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkMaskFilter.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkString.h"
 #include "include/utils/SkRandom.h"
 #include "src/core/SkBlurMask.h"
+#include "src/core/SkMask.h"
+#include "src/core/SkMaskBlurFilter.h"
 
 #define MINI    0.01f
 #define SMALL   SkIntToScalar(2)
@@ -101,3 +105,75 @@ DEF_BENCH(return new BlurBench(REAL, kOuter_SkBlurStyle);)
 DEF_BENCH(return new BlurBench(REAL, kInner_SkBlurStyle);)
 
 DEF_BENCH(return new BlurBench(0, kNormal_SkBlurStyle);)
+
+// Blurs the mask of an oval with SkMaskBlurFilter, splitting large blurs across a pool of
+// 'threads' threads, or serially if 'threads' is zero, to show how blurring scales with threads.
+class MaskBlurFilterBench : public Benchmark {
+    SkScalar    fRadius;
+    int         fThreads;
+    SkString    fName;
+    std::unique_ptr<SkExecutor> fExecutor;
+    SkMask      fSrc;
+
+public:
+    MaskBlurFilterBench(SkScalar rad, int threads) : fRadius(rad), fThreads(threads) {
+        fName.printf("blur_mask_%d_%dthreads", SkScalarRoundToInt(rad), threads);
+        fSrc.fImage = nullptr;
+    }
+
+    ~MaskBlurFilterBench() override {
+        SkMask::FreeImage(fSrc.fImage);
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return kNonRendering_Backend == backend;
+    }
+
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        if (fSrc.fImage) {
+            return;
+        }
+        if (fThreads) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+        fSrc.fBounds.setWH(400, 400);
+        fSrc.fFormat = SkMask::kA8_Format;
+        fSrc.fRowBytes = fSrc.fBounds.width();
+        fSrc.fImage = SkMask::AllocImage(fSrc.computeTotalImageSize());
+
+        SkBitmap bitmap;
+        bitmap.installMaskPixels(fSrc);
+        SkCanvas canvas(bitmap);
+        canvas.clear(SK_ColorTRANSPARENT);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        canvas.drawOval(SkRect::MakeXYWH(20, 40, 360, 320), paint);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkMaskBlurFilter filter(SkBlurMask::ConvertRadiusToSigma(fRadius),
+                                SkBlurMask::ConvertRadiusToSigma(fRadius));
+        for (int i = 0; i < loops; i++) {
+            SkMask dst;
+            filter.blur(fSrc, &dst, fExecutor.get());
+            SkMask::FreeImage(dst.fImage);
+        }
+    }
+
+private:
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH(return new MaskBlurFilterBench(BIG, 0);)
+DEF_BENCH(return new MaskBlurFilterBench(BIG, 1);)
+DEF_BENCH(return new MaskBlurFilterBench(BIG, 4);)
+DEF_BENCH(return new MaskBlurFilterBench(BIG, 8);)
+DEF_BENCH(return new MaskBlurFilterBench(REALBIG, 0);)
+DEF_BENCH(return new MaskBlurFilterBench(REALBIG, 1);)
+DEF_BENCH(return new MaskBlurFilterBench(REALBIG, 4);)
+DEF_BENCH(return new MaskBlurFilterBench(REALBIG, 8);)
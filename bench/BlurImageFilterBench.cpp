@@ -8,11 +8,13 @@
 #include "bench/Benchmark.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkString.h"
 #include "include/effects/SkImageFilters.h"
 #include "include/utils/SkRandom.h"
+#include "src/effects/imagefilters/SkBlurImageFilter.h"
 
 #define FILTER_WIDTH_SMALL  32
 #define FILTER_HEIGHT_SMALL 32
@@ -34,6 +36,9 @@
 // of the source (not inset). This is intended to exercise blurring a smaller source bitmap to a
 // larger destination.
 
+// When 'threads' is non-zero, the filter splits large blurs across a pool of that many threads.
+// This shows how blurring scales with threads.
+
 static sk_sp<SkImage> make_checkerboard(int width, int height) {
     SkBitmap bm;
     bm.allocN32Pixels(width, height);
@@ -61,11 +66,12 @@ static sk_sp<SkImage> make_checkerboard(int width, int height) {
 class BlurImageFilterBench : public Benchmark {
 public:
     BlurImageFilterBench(SkScalar sigmaX, SkScalar sigmaY,  bool small, bool cropped,
-                         bool expanded)
+                         bool expanded, int threads = 0)
       : fIsSmall(small)
       , fIsCropped(cropped)
       , fIsExpanded(expanded)
       , fInitialized(false)
+      , fThreads(threads)
       , fSigmaX(sigmaX)
       , fSigmaY(sigmaY) {
         fName.printf("blur_image_filter_%s%s%s_%.2f_%.2f",
@@ -73,6 +79,9 @@ public:
             fIsCropped ? "_cropped" : "",
             fIsExpanded ? "_expanded" : "",
             SkScalarToFloat(sigmaX), SkScalarToFloat(sigmaY));
+        if (fThreads) {
+            fName.appendf("_%dthreads", fThreads);
+        }
         SkASSERT(!fIsExpanded || fIsCropped); // never want expansion w/o cropping
     }
 
@@ -85,6 +94,9 @@ protected:
         if (!fInitialized) {
             fCheckerboard = make_checkerboard(fIsSmall ? FILTER_WIDTH_SMALL : FILTER_WIDTH_LARGE,
                                               fIsSmall ? FILTER_HEIGHT_SMALL : FILTER_HEIGHT_LARGE);
+            if (fThreads) {
+                fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+            }
             fInitialized = true;
         }
     }
@@ -103,7 +115,12 @@ protected:
         const SkIRect* crop =
             fIsExpanded ? &bmpRect : fIsCropped ? &bmpRectInset : nullptr;
         SkPaint paint;
-        paint.setImageFilter(SkImageFilters::Blur(fSigmaX, fSigmaY, std::move(input), crop));
+        if (fExecutor) {
+            paint.setImageFilter(SkMakeBlurImageFilter(fSigmaX, fSigmaY, SkTileMode::kDecal,
+                                                       std::move(input), crop, fExecutor.get()));
+        } else {
+            paint.setImageFilter(SkImageFilters::Blur(fSigmaX, fSigmaY, std::move(input), crop));
+        }
         SkSamplingOptions sampling;
 
         for (int i = 0; i < loops; i++) {
@@ -118,6 +135,8 @@ private:
     bool fIsCropped;
     bool fIsExpanded;
     bool fInitialized;
+    int fThreads;
+    std::unique_ptr<SkExecutor> fExecutor;
     sk_sp<SkImage> fCheckerboard;
     SkScalar fSigmaX, fSigmaY;
     using INHERITED = Benchmark;
@@ -161,3 +180,10 @@ DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, tr
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, false, true, true);)
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, true, true, true);)
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, false, true, true);)
+
+DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, false, false, false, 1);)
+DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, false, false, false, 4);)
+DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, false, false, false, 8);)
+DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, false, false, false, 1);)
+DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, false, false, false, 4);)
+DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, false, false, false, 8);)
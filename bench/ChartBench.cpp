@@ -11,6 +11,12 @@
 #include "include/core/SkPath.h"
 #include "include/private/SkTDArray.h"
 #include "include/utils/SkRandom.h"
+#include "src/core/SkAutoPixmapStorage.h"
+#include "src/core/SkDraw.h"
+#include "src/core/SkMatrixProvider.h"
+#include "src/core/SkRasterClip.h"
+
+#include <vector>
 
 /**
  * This is a conversion of samplecode/SampleChart.cpp into a bench. It sure would be nice to be able
@@ -185,7 +191,83 @@ private:
     using INHERITED = Benchmark;
 };
 
+// A scatter plot: thousands of small marker paths, all drawn with the same paint, each under its
+// own translate. Compares SkDraw::drawPaths() against calling SkDraw::drawPath() per marker.
+class ChartMarkersBench : public Benchmark {
+public:
+    ChartMarkersBench(bool aa, bool batched)
+            : fIdentityMatrixProvider(SkMatrix::I()), fAA(aa), fBatched(batched) {
+        fName.printf("chart_markers_%s_%s", aa ? "aa" : "bw", batched ? "batched" : "single");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fPixmap.alloc(SkImageInfo::MakeN32Premul(kWidth, kHeight));
+        fPixmap.erase(SK_ColorWHITE);
+        fRC.setRect(SkIRect::MakeWH(kWidth, kHeight));
+
+        fDraw.fDst            = fPixmap;
+        fDraw.fMatrixProvider = &fIdentityMatrixProvider;
+        fDraw.fRC             = &fRC;
+
+        // Triangles, diamonds and rough circles, a few pixels across, centered on the origin.
+        SkPath shapes[3];
+        shapes[0].moveTo(0, -3).lineTo(3, 2).lineTo(-3, 2).close();
+        shapes[1].moveTo(0, -3).lineTo(3, 0).lineTo(0, 3).lineTo(-3, 0).close();
+        shapes[2].addCircle(0, 0, 2.5f);
+
+        SkRandom random;
+        fPaths.resize(kNumMarkers);
+        fMatrices.resize(kNumMarkers);
+        for (int i = 0; i < kNumMarkers; ++i) {
+            fPaths[i] = shapes[i % 3];
+            fMatrices[i] = SkMatrix::Translate(random.nextRangeScalar(4, kWidth - 4),
+                                               random.nextRangeScalar(4, kHeight - 4));
+        }
+
+        fPaint.setAntiAlias(fAA);
+        fPaint.setColor(0x802060C0);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int loop = 0; loop < loops; ++loop) {
+            if (fBatched) {
+                fDraw.drawPaths(fPaths.data(), fMatrices.data(), kNumMarkers, fPaint);
+            } else {
+                for (int i = 0; i < kNumMarkers; ++i) {
+                    fDraw.drawPath(fPaths[i], fPaint, &fMatrices[i]);
+                }
+            }
+        }
+    }
+
+private:
+    enum {
+        kWidth      = 1024,
+        kHeight     = 768,
+        kNumMarkers = 20000,
+    };
+    SkString               fName;
+    SkAutoPixmapStorage    fPixmap;
+    SkRasterClip           fRC;
+    SkSimpleMatrixProvider fIdentityMatrixProvider;
+    SkDraw                 fDraw;
+    SkPaint                fPaint;
+    std::vector<SkPath>    fPaths;
+    std::vector<SkMatrix>  fMatrices;
+    bool                   fAA;
+    bool                   fBatched;
+
+    using INHERITED = Benchmark;
+};
+
 //////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new ChartBench(true); )
 DEF_BENCH( return new ChartBench(false); )
+DEF_BENCH( return new ChartMarkersBench(true,  true); )
+DEF_BENCH( return new ChartMarkersBench(true,  false); )
+DEF_BENCH( return new ChartMarkersBench(false, true); )
+DEF_BENCH( return new ChartMarkersBench(false, false); )
@@ -15,6 +15,8 @@
 enum ChecksumType {
     kMD5_ChecksumType,
     kHash_ChecksumType,
+    kCRC32_ChecksumType,
+    kAdler32_ChecksumType,
 };
 
 class ComputeChecksumBench : public Benchmark {
@@ -42,6 +44,8 @@ protected:
         switch (fType) {
             case kMD5_ChecksumType: return "compute_md5";
             case kHash_ChecksumType: return "compute_hash";
+            case kCRC32_ChecksumType: return "compute_crc32";
+            case kAdler32_ChecksumType: return "compute_adler32";
 
             default: SK_ABORT("Invalid Type");
         }
@@ -62,6 +66,18 @@ protected:
                     sk_ignore_unused_variable(result);
                 }
             }break;
+            case kCRC32_ChecksumType: {
+                for (int i = 0; i < loops; i++) {
+                    volatile uint32_t result = SkOpts::crc32_fn(0, fData, sizeof(fData));
+                    sk_ignore_unused_variable(result);
+                }
+            }break;
+            case kAdler32_ChecksumType: {
+                for (int i = 0; i < loops; i++) {
+                    volatile uint32_t result = SkOpts::adler32_fn(1, fData, sizeof(fData));
+                    sk_ignore_unused_variable(result);
+                }
+            }break;
         }
 
     }
@@ -74,3 +90,5 @@ private:
 
 DEF_BENCH( return new ComputeChecksumBench(kMD5_ChecksumType); )
 DEF_BENCH( return new ComputeChecksumBench(kHash_ChecksumType); )
+DEF_BENCH( return new ComputeChecksumBench(kCRC32_ChecksumType); )
+DEF_BENCH( return new ComputeChecksumBench(kAdler32_ChecksumType); )
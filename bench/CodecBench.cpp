@@ -9,22 +9,30 @@
 #include "bench/CodecBenchPriv.h"
 #include "include/codec/SkCodec.h"
 #include "include/core/SkBitmap.h"
+#include "include/core/SkStream.h"
+#include "include/private/SkTo.h"
+#include "include/utils/SkRandom.h"
 #include "src/core/SkOSFile.h"
 #include "tools/flags/CommandLineFlags.h"
 
+#include "png.h"
+
+#include <vector>
+
 // Actually zeroing the memory would throw off timing, so we just lie.
 static DEFINE_bool(zero_init, false,
                    "Pretend our destination is zero-intialized, simulating Android?");
 
 CodecBench::CodecBench(SkString baseName, SkData* encoded, SkColorType colorType,
-        SkAlphaType alphaType)
+        SkAlphaType alphaType, SkExecutor* executor)
     : fColorType(colorType)
     , fAlphaType(alphaType)
+    , fExecutor(executor)
     , fData(SkRef(encoded))
 {
     // Parse filename and the color type to give the benchmark a useful name
-    fName.printf("Codec_%s_%s%s", baseName.c_str(), color_type_to_str(colorType),
-            alpha_type_to_str(alphaType));
+    fName.printf("Codec_%s_%s%s%s", baseName.c_str(), color_type_to_str(colorType),
+            alpha_type_to_str(alphaType), executor ? "_mt" : "");
     // Ensure that we can create an SkCodec from this data.
     SkASSERT(SkCodec::MakeFromData(fData));
 }
@@ -53,6 +61,7 @@ void CodecBench::onDraw(int n, SkCanvas* canvas) {
     if (FLAGS_zero_init) {
         options.fZeroInitialized = SkCodec::kYes_ZeroInitialized;
     }
+    options.fExecutor = fExecutor;
     for (int i = 0; i < n; i++) {
         codec = SkCodec::MakeFromData(fData);
 #ifdef SK_DEBUG
@@ -64,3 +73,62 @@ void CodecBench::onDraw(int n, SkCanvas* canvas) {
                  || result == SkCodec::kIncompleteInput);
     }
 }
+
+// Palette PNGs are not common enough in our resources to be sure of covering every bit depth, so
+// these benches encode their own. The image data is stored uncompressed, to time the swizzling
+// of indices rather than inflating them.
+static void write_to_stream(png_structp png, png_bytep data, png_size_t length) {
+    static_cast<SkDynamicMemoryWStream*>(png_get_io_ptr(png))->write(data, length);
+}
+
+static sk_sp<SkData> make_palette_png(int bitsPerIndex, int width, int height) {
+    png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+    png_infop info = png ? png_create_info_struct(png) : nullptr;
+    if (!info) {
+        png_destroy_write_struct(&png, nullptr);
+        return nullptr;
+    }
+    SkDynamicMemoryWStream stream;
+    if (setjmp(png_jmpbuf(png))) {
+        png_destroy_write_struct(&png, &info);
+        return nullptr;
+    }
+    png_set_write_fn(png, &stream, write_to_stream, nullptr);
+    png_set_compression_level(png, 0);
+    png_set_filter(png, PNG_FILTER_TYPE_BASE, PNG_FILTER_NONE);
+    png_set_IHDR(png, info, width, height, bitsPerIndex, PNG_COLOR_TYPE_PALETTE,
+                 PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+
+    SkRandom random;
+    std::vector<png_color> palette(1 << bitsPerIndex);
+    for (png_color& color : palette) {
+        const uint32_t rgb = random.nextU();
+        color = { (png_byte)(rgb >> 16), (png_byte)(rgb >> 8), (png_byte)rgb };
+    }
+    png_set_PLTE(png, info, palette.data(), SkToInt(palette.size()));
+    png_write_info(png, info);
+
+    // Random indices, packed bitsPerIndex to a byte as libpng expects.
+    std::vector<png_byte> row((width * bitsPerIndex + 7) / 8);
+    for (int y = 0; y < height; y++) {
+        for (png_byte& byte : row) {
+            byte = random.nextU() & 0xFF;
+        }
+        png_write_row(png, row.data());
+    }
+    png_write_end(png, info);
+    png_destroy_write_struct(&png, &info);
+    return stream.detachAsData();
+}
+
+#if defined(SK_CODEC_DECODES_PNG)
+    #define PALETTE_BENCH(bits)                                                                   \
+        DEF_BENCH(return new CodecBench(SkString("palette" #bits "_1024x1024"),                   \
+                                        make_palette_png(bits, 1024, 1024).get(),                 \
+                                        kN32_SkColorType, kPremul_SkAlphaType);)
+    PALETTE_BENCH(1)
+    PALETTE_BENCH(2)
+    PALETTE_BENCH(4)
+    PALETTE_BENCH(8)
+    #undef PALETTE_BENCH
+#endif
@@ -15,13 +15,17 @@
 #include "include/core/SkString.h"
 #include "src/core/SkAutoMalloc.h"
 
+class SkExecutor;
+
 /**
  *  Time SkCodec.
  */
 class CodecBench : public Benchmark {
 public:
     // Calls encoded->ref()
-    CodecBench(SkString basename, SkData* encoded, SkColorType colorType, SkAlphaType alphaType);
+    // If executor is not nullptr, decodes with it as SkCodec::Options::fExecutor.
+    CodecBench(SkString basename, SkData* encoded, SkColorType colorType, SkAlphaType alphaType,
+               SkExecutor* executor = nullptr);
 
 protected:
     const char* onGetName() override;
@@ -33,6 +37,7 @@ private:
     SkString                fName;
     const SkColorType       fColorType;
     const SkAlphaType       fAlphaType;
+    SkExecutor*             fExecutor;
     sk_sp<SkData>           fData;
     SkImageInfo             fInfo;          // Set in onDelayedSetup.
     SkAutoMalloc            fPixelStorage;
@@ -7,6 +7,7 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkBitmap.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkStream.h"
 #include "include/encode/SkJpegEncoder.h"
 #include "include/encode/SkPngEncoder.h"
@@ -123,3 +124,51 @@ DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 3), "PNG_3n"));
 DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 1), "PNG_1n"));
 
 #undef PNG
+
+/**
+ *  Encodes a PNG with SkPngEncoder::Options::fExecutor set to a pool of threads. One thread
+ *  encodes serially.
+ */
+class PngParallelEncodeBench : public Benchmark {
+public:
+    PngParallelEncodeBench(const char* filename, int threads)
+        : fSourceFilename(filename)
+        , fThreads(threads)
+        , fName(SkStringPrintf("Encode_%s_PNG_%dthreads", filename, threads)) {}
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkAssertResult(GetResourceAsBitmap(fSourceFilename, &fBitmap));
+        if (fThreads > 1) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkPngEncoder::Options opts;
+        opts.fExecutor = fExecutor.get();
+        while (loops-- > 0) {
+            SkPixmap pixmap;
+            SkAssertResult(fBitmap.peekPixels(&pixmap));
+            SkNullWStream dst;
+            SkAssertResult(SkPngEncoder::Encode(&dst, pixmap, opts));
+        }
+    }
+
+private:
+    const char*                 fSourceFilename;
+    const int                   fThreads;
+    SkString                    fName;
+    SkBitmap                    fBitmap;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
+DEF_BENCH(return new PngParallelEncodeBench(srcs[0], 1));
+DEF_BENCH(return new PngParallelEncodeBench(srcs[0], 4));
+DEF_BENCH(return new PngParallelEncodeBench(srcs[0], 16));
+DEF_BENCH(return new PngParallelEncodeBench(srcs[1], 1));
+DEF_BENCH(return new PngParallelEncodeBench(srcs[1], 4));
+DEF_BENCH(return new PngParallelEncodeBench(srcs[1], 16));
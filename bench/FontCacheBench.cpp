@@ -7,12 +7,14 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFont.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkString.h"
 #include "include/private/SkChecksum.h"
 #include "include/private/SkTemplates.h"
+#include "src/core/SkTaskGroup.h"
 
 #include "bench/gUniqueGlyphIDs.h"
 
@@ -142,6 +144,61 @@ private:
 };
 DEF_BENCH( return new FontCacheBench(); )
 
+// Measures the same fixed amount of text as FontCacheBench, at kSizes different sizes, split over
+// fThreads threads. Each size is its own strike, so this shows how well concurrent strike lookups
+// scale; with perfect scaling the time per loop drops in proportion to the thread count.
+class FontCacheThreadedBench : public Benchmark {
+    static constexpr int kSizes = 16;
+
+    const int fThreads;
+    SkString fName;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+public:
+    explicit FontCacheThreadedBench(int threads) : fThreads(threads) {
+        fName.printf("fontcache_threads_%d", threads);
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkTaskGroup(*fExecutor).batch(fThreads, [&](int thread) {
+            SkFont font;
+            font.setEdging(SkFont::Edging::kAntiAlias);
+
+            for (int i = 0; i < loops; ++i) {
+                for (int size = thread; size < kSizes; size += fThreads) {
+                    font.setSize(10 + size);
+                    const uint16_t* array = gUniqueGlyphIDs;
+                    while (*array != gUniqueGlyphIDs_Sentinel) {
+                        int count = count_glyphs(array);
+                        (void)font.measureText(array, count * sizeof(uint16_t),
+                                               SkTextEncoding::kGlyphID);
+                        array += count + 1;    // skip the sentinel
+                    }
+                }
+            }
+        });
+    }
+
+private:
+    using INHERITED = Benchmark;
+};
+DEF_BENCH( return new FontCacheThreadedBench(1); )
+DEF_BENCH( return new FontCacheThreadedBench(4); )
+DEF_BENCH( return new FontCacheThreadedBench(16); )
+
 // undefine this to run the efficiency test
 //DEF_BENCH( return new FontCacheEfficiency(); )
 
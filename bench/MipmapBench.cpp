@@ -7,6 +7,7 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkBitmap.h"
+#include "include/core/SkExecutor.h"
 #include "src/core/SkMipmap.h"
 
 class MipmapBench: public Benchmark {
@@ -14,15 +15,20 @@ class MipmapBench: public Benchmark {
     SkString fName;
     const int fW, fH;
     bool fHalfFoat;
+    const int fThreads;
+    std::unique_ptr<SkExecutor> fExecutor;
 
 public:
-    MipmapBench(int w, int h, bool halfFloat = false)
-        : fW(w), fH(h), fHalfFoat(halfFloat)
+    MipmapBench(int w, int h, bool halfFloat = false, int threads = 0)
+        : fW(w), fH(h), fHalfFoat(halfFloat), fThreads(threads)
     {
         fName.printf("mipmap_build_%dx%d", w, h);
         if (halfFloat) {
             fName.append("_f16");
         }
+        if (threads) {
+            fName.appendf("_threads_%d", threads);
+        }
     }
 
 protected:
@@ -38,11 +44,18 @@ protected:
                                              SkColorSpace::MakeSRGB());
         fBitmap.allocPixels(info);
         fBitmap.eraseColor(SK_ColorWHITE);  // so we don't read uninitialized memory
+        if (fThreads) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
     }
 
     void onDraw(int loops, SkCanvas*) override {
         for (int i = 0; i < loops * 4; i++) {
-            SkMipmap::Build(fBitmap, nullptr)->unref();
+            if (fExecutor) {
+                SkMipmap::Build(fBitmap.pixmap(), nullptr, -1, fExecutor.get())->unref();
+            } else {
+                SkMipmap::Build(fBitmap, nullptr)->unref();
+            }
         }
     }
 
@@ -65,3 +78,10 @@ DEF_BENCH( return new MipmapBench(2048, 2048); )
 DEF_BENCH( return new MipmapBench(2047, 2047); )
 DEF_BENCH( return new MipmapBench(2048, 2047); )
 DEF_BENCH( return new MipmapBench(2047, 2048); )
+
+// Multi-megapixel sources, as when making thumbnails of camera images, built serially and with
+// each large level split across threads.
+DEF_BENCH( return new MipmapBench(4000, 3000); )
+DEF_BENCH( return new MipmapBench(4000, 3000, false, 4); )
+DEF_BENCH( return new MipmapBench(4001, 3001, false, 4); )
+DEF_BENCH( return new MipmapBench(4000, 3000, true, 4); )
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/codec/SkCodec.h"
+#include "include/core/SkData.h"
+#include "include/core/SkStream.h"
+#include "include/core/SkString.h"
+#include "src/core/SkAutoMalloc.h"
+#include "src/core/SkOSFile.h"
+#include "src/utils/SkOSPath.h"
+#include "tools/flags/CommandLineFlags.h"
+
+#include <vector>
+
+static DEFINE_string(mmapDecodeDir, "",
+                     "Directory of encoded images for MmapDecodeBench to decode from mmap'ed "
+                     "SkData.");
+
+/**
+ *  Decodes every image in --mmapDecodeDir from an mmap'ed SkData, through an SkMemoryStream that
+ *  codecs read in place. The bench only times the decodes; Codec_memoryStreamReadInPlace checks
+ *  how few bytes they copy out of the stream.
+ */
+class MmapDecodeBench : public Benchmark {
+protected:
+    const char* onGetName() override { return "mmap_decode"; }
+
+    bool isSuitableFor(Backend backend) override {
+        return kNonRendering_Backend == backend && !FLAGS_mmapDecodeDir.isEmpty();
+    }
+
+    void onDelayedSetup() override {
+        size_t maxBytes = 0;
+        SkOSFile::Iter it(FLAGS_mmapDecodeDir[0]);
+        for (SkString name; it.next(&name);) {
+            SkString path = SkOSPath::Join(FLAGS_mmapDecodeDir[0], name.c_str());
+            // SkData::MakeFromFileName() maps the file, rather than reading it.
+            sk_sp<SkData> data = SkData::MakeFromFileName(path.c_str());
+            std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+            if (!codec) {
+                continue;
+            }
+            SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+            if (kUnpremul_SkAlphaType == info.alphaType()) {
+                info = info.makeAlphaType(kPremul_SkAlphaType);
+            }
+            maxBytes = std::max(maxBytes, info.computeMinByteSize());
+            fImages.push_back({std::move(data), info});
+        }
+        fPixels.reset(maxBytes);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            for (const Image& image : fImages) {
+                std::unique_ptr<SkCodec> codec = SkCodec::MakeFromStream(
+                        std::make_unique<SkMemoryStream>(image.fData));
+                if (codec) {
+                    codec->getPixels(image.fInfo, fPixels.get(), image.fInfo.minRowBytes());
+                }
+            }
+        }
+    }
+
+private:
+    struct Image {
+        sk_sp<SkData> fData;
+        SkImageInfo   fInfo;
+    };
+    std::vector<Image> fImages;
+    SkAutoMalloc       fPixels;
+
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH(return new MmapDecodeBench;)
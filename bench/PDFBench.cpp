@@ -10,6 +10,7 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkData.h"
 #include "include/core/SkExecutor.h"
+#include "include/core/SkFont.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkStream.h"
@@ -17,8 +18,10 @@
 #include "include/private/SkTo.h"
 #include "include/utils/SkRandom.h"
 #include "src/core/SkAutoPixmapStorage.h"
+#include "src/core/SkResourceCache.h"
 #include "src/pdf/SkPDFUnion.h"
 #include "src/utils/SkFloatToDecimal.h"
+#include "tools/ProcStats.h"
 #include "tools/Resources.h"
 
 namespace {
@@ -108,6 +111,8 @@ protected:
             return;
         }
         while (loops-- > 0) {
+            // Encode the image every time, rather than reusing it from SkResourceCache.
+            SkResourceCache::PurgeAll();
             SkNullWStream nullStream;
             SkPDFDocument doc(&nullStream, SkPDF::Metadata());
             doc.beginPage(256, 256);
@@ -143,6 +148,8 @@ protected:
             return;
         }
         while (loops-- > 0) {
+            // Encode the image every time, rather than reusing it from SkResourceCache.
+            SkResourceCache::PurgeAll();
             SkNullWStream nullStream;
             SkPDFDocument doc(&nullStream, SkPDF::Metadata());
             doc.beginPage(256, 256);
@@ -302,6 +309,134 @@ struct PDFClipPathBenchmark : public Benchmark {
     }
 };
 
+// Writes a document of many pages, each with an image and text of its own, and reports the peak
+// growth of the resident set size per page. With fStreamPages each page is written out when it
+// ends, so memory should not grow with the number of pages.
+struct PDFStreamPagesBench : public Benchmark {
+    static constexpr int kPageCount = 100;
+
+    bool fStreamPages;
+    std::unique_ptr<SkExecutor> fExecutor;
+    int64_t fPeakGrowth = 0;
+    PDFStreamPagesBench(bool streamPages) : fStreamPages(streamPages) {}
+
+    void onDelayedSetup() override { fExecutor = SkExecutor::MakeFIFOThreadPool(); }
+    const char* onGetName() override {
+        return fStreamPages ? "PDFStreamPages" : "PDFStreamPages_buffered";
+    }
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops-- > 0) {
+            const int64_t baseline = sk_tools::getCurrResidentSetSizeBytes();
+            SkNullWStream wStream;
+            SkPDF::Metadata metadata;
+            metadata.fExecutor = fExecutor.get();
+            metadata.fStreamPages = fStreamPages;
+            auto doc = SkPDF::MakeDocument(&wStream, metadata);
+            SkRandom random(kPageCount);
+            SkBitmap bitmap;
+            bitmap.allocN32Pixels(256, 256);
+            for (int page = 0; page < kPageCount; ++page) {
+                // A new image for every page, so each is encoded and written.
+                for (int y = 0; y < bitmap.height(); ++y) {
+                    uint32_t* row = bitmap.getAddr32(0, y);
+                    for (int x = 0; x < bitmap.width(); ++x) {
+                        row[x] = random.nextU() | 0xFF000000;
+                    }
+                }
+                bitmap.notifyPixelsChanged();
+                SkCanvas* canvas = doc->beginPage(612, 792);
+                canvas->drawImage(SkImage::MakeRasterCopy(bitmap.pixmap()), 36, 36);
+                SkString text = SkStringPrintf("Page %d of %d", page + 1, kPageCount);
+                canvas->drawString(text, 36, 756, SkFont(), SkPaint());
+                doc->endPage();
+                fPeakGrowth = std::max(fPeakGrowth,
+                                       sk_tools::getCurrResidentSetSizeBytes() - baseline);
+            }
+            doc->close();
+        }
+    }
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        if (sk_tools::getCurrResidentSetSizeBytes() >= 0) {
+            SkDebugf("%s: peak memory growth %.1f KB per page over %d pages\n",
+                     this->getName(), fPeakGrowth / 1024.0 / kPageCount, kPageCount);
+        }
+        fPeakGrowth = 0;
+    }
+};
+
+// Makes a document of text, paths and an image at each SkPDF::Metadata compression setting, to
+// compare how long they take and how big the output is.
+struct PDFCompressionSettingsBench : public Benchmark {
+    static constexpr int kPageCount = 10;
+
+    using Level = SkPDF::Metadata::CompressionLevel;
+    using Strategy = SkPDF::Metadata::CompressionStrategy;
+    Level fLevel;
+    Strategy fStrategy;
+    SkString fName;
+    sk_sp<SkImage> fImage;
+    size_t fBytes = 0;
+    PDFCompressionSettingsBench(Level level, Strategy strategy, const char* name)
+        : fLevel(level), fStrategy(strategy), fName(SkStringPrintf("PDFCompression_%s", name)) {}
+
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    void onDelayedSetup() override {
+        // Smooth, like a photo, rather than noise that nothing can compress.
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(400, 300);
+        SkCanvas canvas(bitmap);
+        const SkPoint pts[] = {{0, 0}, {400, 300}};
+        const SkColor colors[] = {SK_ColorRED, SK_ColorYELLOW, SK_ColorBLUE};
+        SkPaint paint;
+        paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 3,
+                                                     SkTileMode::kMirror));
+        canvas.drawPaint(paint);
+        paint.setShader(nullptr);
+        paint.setAntiAlias(true);
+        SkRandom random(1);
+        for (int i = 0; i < 50; ++i) {
+            paint.setColor(random.nextU() | 0xFF000000);
+            canvas.drawCircle(random.nextRangeF(0, 400), random.nextRangeF(0, 300),
+                              random.nextRangeF(5, 40), paint);
+        }
+        fImage = bitmap.asImage();
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops-- > 0) {
+            // Encoded images are cached, so purge them to compress the image every time.
+            SkResourceCache::PurgeAll();
+            SkNullWStream wStream;
+            SkPDF::Metadata metadata;
+            metadata.fCompressionLevel = fLevel;
+            metadata.fCompressionStrategy = fStrategy;
+            auto doc = SkPDF::MakeDocument(&wStream, metadata);
+            SkFont font;
+            SkPaint paint;
+            paint.setStyle(SkPaint::kStroke_Style);
+            for (int page = 0; page < kPageCount; ++page) {
+                SkCanvas* canvas = doc->beginPage(612, 792);
+                canvas->drawImage(fImage, 36, 36);
+                for (int line = 0; line < 40; ++line) {
+                    SkString text = SkStringPrintf("Page %d, line %d: the quick brown fox jumps "
+                                                   "over the lazy dog.", page + 1, line + 1);
+                    canvas->drawString(text, 36, 360 + 10 * line, font, SkPaint());
+                }
+                for (int i = 0; i < 100; ++i) {
+                    canvas->drawLine(36 + 5 * i, 760, 40 + 5 * i, 756 - (i * i) % 20, paint);
+                }
+                doc->endPage();
+            }
+            doc->close();
+            fBytes = wStream.bytesWritten();
+        }
+    }
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        SkDebugf("%s: %zu bytes for %d pages\n", this->getName(), fBytes, kPageCount);
+    }
+};
+
 }  // namespace
 DEF_BENCH(return new PDFImageBench;)
 DEF_BENCH(return new PDFJpegImageBench;)
@@ -310,6 +445,25 @@ DEF_BENCH(return new PDFColorComponentBench;)
 DEF_BENCH(return new PDFShaderBench;)
 DEF_BENCH(return new WritePDFTextBenchmark;)
 DEF_BENCH(return new PDFClipPathBenchmark;)
+DEF_BENCH(return new PDFStreamPagesBench(false);)
+DEF_BENCH(return new PDFStreamPagesBench(true);)
+
+using CompressionLevel = SkPDF::Metadata::CompressionLevel;
+using CompressionStrategy = SkPDF::Metadata::CompressionStrategy;
+DEF_BENCH(return new PDFCompressionSettingsBench(CompressionLevel::None,
+                                                 CompressionStrategy::Default, "none");)
+DEF_BENCH(return new PDFCompressionSettingsBench(CompressionLevel::LowButFast,
+                                                 CompressionStrategy::Default, "fast");)
+DEF_BENCH(return new PDFCompressionSettingsBench(CompressionLevel::Default,
+                                                 CompressionStrategy::Default, "default");)
+DEF_BENCH(return new PDFCompressionSettingsBench(CompressionLevel::HighButSlow,
+                                                 CompressionStrategy::Default, "slow");)
+DEF_BENCH(return new PDFCompressionSettingsBench(CompressionLevel::Default,
+                                                 CompressionStrategy::Filtered, "filtered");)
+DEF_BENCH(return new PDFCompressionSettingsBench(CompressionLevel::Default,
+                                                 CompressionStrategy::HuffmanOnly, "huffman");)
+DEF_BENCH(return new PDFCompressionSettingsBench(CompressionLevel::Default,
+                                                 CompressionStrategy::RLE, "rle");)
 
 #ifdef SK_PDF_ENABLE_SLOW_TESTS
 #include "include/core/SkExecutor.h"
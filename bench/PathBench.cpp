@@ -17,6 +17,7 @@
 #include "include/utils/SkRandom.h"
 
 #include "src/core/SkDraw.h"
+#include "src/core/SkScan.h"
 
 enum Flags {
     kStroke_Flag = 1 << 0,
@@ -29,9 +30,15 @@ enum Flags {
 #define FLAGS11  Flags(kStroke_Flag | kBig_Flag)
 
 class PathBench : public Benchmark {
+public:
+    // Which anti-aliased scan converter to draw with.  kDefault leaves the choice to SkScan.
+    enum class AAMode { kDefault, kSupersample, kAnalytic, kCoverage };
+
+private:
     SkPaint     fPaint;
     SkString    fName;
     Flags       fFlags;
+    AAMode      fAAMode = AAMode::kDefault;
 public:
     PathBench(Flags flags) : fFlags(flags) {
         fPaint.setStyle(flags & kStroke_Flag ? SkPaint::kStroke_Style :
@@ -44,12 +51,23 @@ public:
     virtual void makePath(SkPath*) = 0;
     virtual int complexity() { return 0; }
 
+    PathBench* setAAMode(AAMode mode) {
+        fAAMode = mode;
+        return this;
+    }
+
 protected:
     const char* onGetName() override {
         fName.printf("path_%s_%s_",
                      fFlags & kStroke_Flag ? "stroke" : "fill",
                      fFlags & kBig_Flag ? "big" : "small");
         this->appendName(&fName);
+        switch (fAAMode) {
+            case AAMode::kDefault:                             break;
+            case AAMode::kSupersample: fName.append("_saa");   break;
+            case AAMode::kAnalytic:    fName.append("_aaa");   break;
+            case AAMode::kCoverage:    fName.append("_caa");   break;
+        }
         return fName.c_str();
     }
 
@@ -64,9 +82,31 @@ protected:
             path.transform(m);
         }
 
+        const bool useAnalyticAA   = gSkUseAnalyticAA,
+                   forceAnalyticAA = gSkForceAnalyticAA,
+                   forceCoverageAA = gSkForceCoverageAA;
+        switch (fAAMode) {
+            case AAMode::kDefault:
+                break;
+            case AAMode::kSupersample:
+                gSkUseAnalyticAA = gSkForceAnalyticAA = gSkForceCoverageAA = false;
+                break;
+            case AAMode::kAnalytic:
+                gSkUseAnalyticAA = gSkForceAnalyticAA = true;
+                gSkForceCoverageAA = false;
+                break;
+            case AAMode::kCoverage:
+                gSkForceCoverageAA = true;
+                break;
+        }
+
         for (int i = 0; i < loops; i++) {
             canvas->drawPath(path, paint);
         }
+
+        gSkUseAnalyticAA   = useAnalyticAA;
+        gSkForceAnalyticAA = forceAnalyticAA;
+        gSkForceCoverageAA = forceCoverageAA;
     }
 
 private:
@@ -1192,6 +1232,28 @@ DEF_BENCH( return new LongCurvedPathBench(FLAGS01); )
 DEF_BENCH( return new LongLinePathBench(FLAGS00); )
 DEF_BENCH( return new LongLinePathBench(FLAGS01); )
 
+// The same fills through each anti-aliased scan converter, supersampling (saa), analytic (aaa)
+// and coverage accumulation (caa), for side by side comparison.
+using AAMode = PathBench::AAMode;
+DEF_BENCH( return (new TrianglePathBench(FLAGS10))->setAAMode(AAMode::kSupersample); )
+DEF_BENCH( return (new TrianglePathBench(FLAGS10))->setAAMode(AAMode::kAnalytic); )
+DEF_BENCH( return (new TrianglePathBench(FLAGS10))->setAAMode(AAMode::kCoverage); )
+DEF_BENCH( return (new OvalPathBench(FLAGS00))->setAAMode(AAMode::kSupersample); )
+DEF_BENCH( return (new OvalPathBench(FLAGS00))->setAAMode(AAMode::kAnalytic); )
+DEF_BENCH( return (new OvalPathBench(FLAGS00))->setAAMode(AAMode::kCoverage); )
+DEF_BENCH( return (new OvalPathBench(FLAGS10))->setAAMode(AAMode::kSupersample); )
+DEF_BENCH( return (new OvalPathBench(FLAGS10))->setAAMode(AAMode::kAnalytic); )
+DEF_BENCH( return (new OvalPathBench(FLAGS10))->setAAMode(AAMode::kCoverage); )
+DEF_BENCH( return (new AAAConcavePathBench(FLAGS10))->setAAMode(AAMode::kSupersample); )
+DEF_BENCH( return (new AAAConcavePathBench(FLAGS10))->setAAMode(AAMode::kAnalytic); )
+DEF_BENCH( return (new AAAConcavePathBench(FLAGS10))->setAAMode(AAMode::kCoverage); )
+DEF_BENCH( return (new SawToothPathBench(FLAGS00))->setAAMode(AAMode::kSupersample); )
+DEF_BENCH( return (new SawToothPathBench(FLAGS00))->setAAMode(AAMode::kAnalytic); )
+DEF_BENCH( return (new SawToothPathBench(FLAGS00))->setAAMode(AAMode::kCoverage); )
+DEF_BENCH( return (new LongCurvedPathBench(FLAGS00))->setAAMode(AAMode::kSupersample); )
+DEF_BENCH( return (new LongCurvedPathBench(FLAGS00))->setAAMode(AAMode::kAnalytic); )
+DEF_BENCH( return (new LongCurvedPathBench(FLAGS00))->setAAMode(AAMode::kCoverage); )
+
 DEF_BENCH( return new PathCreateBench(); )
 DEF_BENCH( return new PathCopyBench(); )
 DEF_BENCH( return new PathTransformBench(true); )
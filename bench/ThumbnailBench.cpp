@@ -0,0 +1,59 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkString.h"
+#include "tools/Resources.h"
+
+/**
+ *  Decodes a JPEG through a lazy SkImage and draws it at thumbnail size into a raster canvas, as a
+ *  thumbnail grid does. Each draw uses a new image, so it pays for the decode, which can use the
+ *  codec's DCT scaling when the thumbnail is small enough.
+ */
+class ThumbnailBench : public Benchmark {
+public:
+    ThumbnailBench(int size) : fSize(size) {
+        fName.printf("thumbnail_jpeg_%d", size);
+    }
+
+    bool isSuitableFor(Backend backend) override { return kRaster_Backend == backend; }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    SkIPoint onGetSize() override { return {fSize, fSize}; }
+
+    void onDelayedSetup() override {
+        fEncoded = GetResourceAsData("images/mandrill_512_q075.jpg");
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        if (!fEncoded) {
+            return;
+        }
+        const SkRect dst = SkRect::MakeIWH(fSize, fSize);
+        for (int i = 0; i < loops; i++) {
+            sk_sp<SkImage> image = SkImage::MakeFromEncoded(fEncoded);
+            canvas->drawImageRect(image, dst, SkSamplingOptions(SkFilterMode::kLinear));
+        }
+    }
+
+private:
+    const int     fSize;
+    SkString      fName;
+    sk_sp<SkData> fEncoded;
+
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH(return new ThumbnailBench(48);)
+DEF_BENCH(return new ThumbnailBench(96);)
+DEF_BENCH(return new ThumbnailBench(256);)
+DEF_BENCH(return new ThumbnailBench(512);)
@@ -25,6 +25,7 @@
 #include "include/codec/SkCodec.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkGraphics.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkString.h"
@@ -200,7 +201,9 @@ static SkString humanize(double ms) {
 
 bool Target::init(SkImageInfo info, Benchmark* bench) {
     if (Benchmark::kRaster_Backend == config.backend) {
-        this->surface = SkSurface::MakeRaster(info);
+        this->surface = config.threaded
+                ? SkSurface::MakeRasterThreaded(info, &SkExecutor::GetDefault())
+                : SkSurface::MakeRaster(info);
         if (!this->surface) {
             return false;
         }
@@ -549,6 +552,22 @@ static void create_config(const SkCommandLineConfig* config, SkTArray<Config>* c
 
     #undef CPU_CONFIG
 
+    // 'mt8888' is 8888 with large draws split into bands across the default executor;
+    // vary --threads to see how it scales.
+    if (config->getTag().equals("mt8888")) {
+        if (!FLAGS_cpu) {
+            SkDebugf("Skipping config '%s' as requested.\n", config->getTag().c_str());
+            return;
+        }
+        Config mt = {
+            SkString("mt8888"), Benchmark::kRaster_Backend, kN32_SkColorType, kPremul_SkAlphaType,
+            nullptr, 0, kBogusContextType, kBogusContextOverrides, 0
+        };
+        mt.threaded = true;
+        configs->push_back(mt);
+        return;
+    }
+
     SkDebugf("Unknown config '%s'.\n", config->getTag().c_str());
 }
 
@@ -978,6 +997,38 @@ public:
             fCurrentColorType = 0;
         }
 
+        // Run CodecBenches that decode on the default executor, for images that can be split.
+        for (; fCurrentParallelCodec < fImages.count(); fCurrentParallelCodec++) {
+            fSourceType = "image";
+            fBenchType = "skcodec";
+            const SkString& path = fImages[fCurrentParallelCodec];
+            if (CommandLineFlags::ShouldSkip(FLAGS_match, path.c_str())) {
+                continue;
+            }
+            sk_sp<SkData> encoded(SkData::MakeFromFileName(path.c_str()));
+            std::unique_ptr<SkCodec> codec(SkCodec::MakeFromData(encoded));
+            if (!codec) {
+                continue;
+            }
+
+            SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+            if (kUnpremul_SkAlphaType == info.alphaType()) {
+                info = info.makeAlphaType(kPremul_SkAlphaType);
+            }
+            const size_t rowBytes = info.minRowBytes();
+            SkAutoMalloc storage(info.computeByteSize(rowBytes));
+            SkCodec::Options options;
+            options.fExecutor = &SkExecutor::GetDefault();
+            const SkCodec::Result result = codec->getPixels(info, storage.get(), rowBytes,
+                                                            &options);
+            if (SkCodec::kSuccess == result && codec->getDecodeParallelism() > 1) {
+                fCurrentParallelCodec++;
+                return new CodecBench(SkOSPath::Basename(path.c_str()), encoded.get(),
+                                      info.colorType(), info.alphaType(),
+                                      &SkExecutor::GetDefault());
+            }
+        }
+
         // Run AndroidCodecBenches
         const int sampleSizes[] = { 2, 4, 8 };
         for (; fCurrentAndroidCodec < fImages.count(); fCurrentAndroidCodec++) {
@@ -1037,7 +1088,7 @@ public:
 
             while (fCurrentColorType < fColorTypes.count()) {
                 while (fCurrentSampleSize < (int) SK_ARRAY_COUNT(brdSampleSizes)) {
-                    while (fCurrentSubsetType <= kLastSingle_SubsetType) {
+                    while (fCurrentSubsetType <= kLastBRD_SubsetType) {
 
                         sk_sp<SkData> encoded(SkData::MakeFromFileName(path.c_str()));
                         const SkColorType colorType = fColorTypes[fCurrentColorType];
@@ -1054,6 +1105,8 @@ public:
                         SkString basename = SkOSPath::Basename(path.c_str());
                         SkIRect subset;
                         const uint32_t subsetSize = sampleSize * minOutputSize;
+                        int tileSize = 0;
+                        size_t cacheBytes = 0;
                         switch (currentSubsetType) {
                             case kTopLeft_SubsetType:
                                 basename.append("_TopLeft");
@@ -1079,12 +1132,26 @@ public:
                                 subset = SkIRect::MakeXYWH(width - subsetSize,
                                         height - subsetSize, subsetSize, subsetSize);
                                 break;
+                            case kTranslate_SubsetType:
+                            case kTranslateCached_SubsetType:
+                                // Pan over the whole image in tiles a quarter of the size of the
+                                // single subsets, optionally caching two rows of tiles' worth of
+                                // decoded rows.
+                                basename.append("_Translate");
+                                subset = SkIRect::MakeWH(width, height);
+                                tileSize = subsetSize / 2;
+                                if (kTranslateCached_SubsetType == currentSubsetType) {
+                                    basename.append("Cached");
+                                    cacheBytes = SkColorTypeBytesPerPixel(colorType) *
+                                                 (width / sampleSize) * minOutputSize;
+                                }
+                                break;
                             default:
                                 SkASSERT(false);
                         }
 
                         return new BitmapRegionDecoderBench(basename.c_str(), encoded.get(),
-                                colorType, sampleSize, subset);
+                                colorType, sampleSize, subset, tileSize, cacheBytes);
                     }
                     fCurrentSubsetType = 0;
                     fCurrentSampleSize++;
@@ -1121,15 +1188,17 @@ public:
 private:
 #ifdef SK_ENABLE_ANDROID_UTILS
     enum SubsetType {
-        kTopLeft_SubsetType     = 0,
-        kTopRight_SubsetType    = 1,
-        kMiddle_SubsetType      = 2,
-        kBottomLeft_SubsetType  = 3,
-        kBottomRight_SubsetType = 4,
-        kTranslate_SubsetType   = 5,
-        kZoom_SubsetType        = 6,
-        kLast_SubsetType        = kZoom_SubsetType,
-        kLastSingle_SubsetType  = kBottomRight_SubsetType,
+        kTopLeft_SubsetType         = 0,
+        kTopRight_SubsetType        = 1,
+        kMiddle_SubsetType          = 2,
+        kBottomLeft_SubsetType      = 3,
+        kBottomRight_SubsetType     = 4,
+        kTranslate_SubsetType       = 5,
+        kTranslateCached_SubsetType = 6,
+        kZoom_SubsetType            = 7,
+        kLast_SubsetType            = kZoom_SubsetType,
+        kLastSingle_SubsetType      = kBottomRight_SubsetType,
+        kLastBRD_SubsetType         = kTranslateCached_SubsetType,
     };
 #endif
 
@@ -1158,6 +1227,7 @@ private:
     int fCurrentSVG = 0;
     int fCurrentTextBlobTrace = 0;
     int fCurrentCodec = 0;
+    int fCurrentParallelCodec = 0;
     int fCurrentAndroidCodec = 0;
 #ifdef SK_ENABLE_ANDROID_UTILS
     int fCurrentBRDImage = 0;
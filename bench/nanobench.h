@@ -28,6 +28,7 @@ struct Config {
     sk_gpu_test::GrContextFactory::ContextType ctxType;
     sk_gpu_test::GrContextFactory::ContextOverrides ctxOverrides;
     uint32_t surfaceFlags;
+    bool threaded = false;  // raster only: draw large ops in bands on SkExecutor::GetDefault()
 };
 
 struct Target {
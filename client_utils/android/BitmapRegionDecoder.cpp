@@ -8,8 +8,12 @@
 #include "client_utils/android/BitmapRegionDecoder.h"
 #include "client_utils/android/BitmapRegionDecoderPriv.h"
 #include "include/codec/SkAndroidCodec.h"
+#include "include/private/SkTemplates.h"
 #include "src/codec/SkCodecPriv.h"
 
+#include <algorithm>
+#include <cstring>
+
 namespace android {
 namespace skia {
 
@@ -45,6 +49,199 @@ int BitmapRegionDecoder::height() const {
     return fCodec->getInfo().height();
 }
 
+void BitmapRegionDecoder::setRowBandCacheBudget(size_t cacheBytes) {
+    fBandBudget = cacheBytes;
+    this->purgeBands(cacheBytes, 0, -1);
+}
+
+// Whether a sampled decode of srcDim pixels to dstDim pixels keeps every sampleSize'th pixel,
+// rather than spreading its samples further apart to fit.
+static bool samples_exactly(int srcDim, int dstDim, int sampleSize) {
+    return dstDim > 0 && srcDim / dstDim == sampleSize;
+}
+
+const BitmapRegionDecoder::Band* BitmapRegionDecoder::findBand(int index) {
+    auto band = std::find_if(fBands.begin(), fBands.end(),
+                             [index](const Band& b) { return b.fIndex == index; });
+    if (band == fBands.end()) {
+        return nullptr;
+    }
+    // Move it to the back, as the most recently used.
+    std::rotate(band, band + 1, fBands.end());
+    return &fBands.back();
+}
+
+void BitmapRegionDecoder::purgeBands(size_t budget, int keepFirst, int keepLast) {
+    size_t bytes = 0;
+    for (const Band& band : fBands) {
+        bytes += band.fBitmap.computeByteSize();
+    }
+    for (auto band = fBands.begin(); band != fBands.end() && bytes > budget;) {
+        if (band->fIndex >= keepFirst && band->fIndex <= keepLast) {
+            ++band;
+            continue;
+        }
+        bytes -= band->fBitmap.computeByteSize();
+        band = fBands.erase(band);
+    }
+}
+
+bool BitmapRegionDecoder::decodeBands(int first, int count, int sampleSize) {
+    const int imageHeight = this->height();
+    const int srcBandRows = kBandRows * sampleSize;
+    const int top = first * srcBandRows;
+    const int bottom = std::min((first + count) * srcBandRows, imageHeight);
+    if (count > 1 && 0 == top && imageHeight == bottom) {
+        // Without a subset, a JPEG is scaled to dimensions rounded up rather than down, which
+        // would not line up with the other bands. Keep each decode a strict subset.
+        return this->decodeBands(first, count - 1, sampleSize) &&
+               this->decodeBands(first + count - 1, 1, sampleSize);
+    }
+
+    SkIRect subset = SkIRect::MakeLTRB(0, top, this->width(), bottom);
+    SkISize scaledSize = fCodec->getSampledSubsetDimensions(sampleSize, subset);
+    if (!samples_exactly(subset.width(), scaledSize.width(), sampleSize) ||
+        !samples_exactly(subset.height(), scaledSize.height(), sampleSize)) {
+        return false;
+    }
+
+    SkBitmap decoded;
+    if (!decoded.tryAllocPixels(fBandInfo.makeDimensions(scaledSize))) {
+        return false;
+    }
+    SkAndroidCodec::AndroidOptions options;
+    options.fSampleSize = sampleSize;
+    options.fSubset = &subset;
+    if (SkCodec::kSuccess != fCodec->getAndroidPixels(decoded.info(), decoded.getPixels(),
+                                                      decoded.rowBytes(), &options)) {
+        return false;
+    }
+
+    for (int i = 0; i < count; i++) {
+        SkIRect rows = SkIRect::MakeLTRB(0, i * kBandRows, scaledSize.width(),
+                                         std::min((i + 1) * kBandRows, scaledSize.height()));
+        SkPixmap src;
+        Band band = { first + i, SkBitmap() };
+        if (rows.isEmpty() || !decoded.pixmap().extractSubset(&src, rows) ||
+            !band.fBitmap.tryAllocPixels(src.info()) ||
+            !src.readPixels(band.fBitmap.pixmap())) {
+            return false;
+        }
+        fBands.push_back(std::move(band));
+    }
+    return true;
+}
+
+bool BitmapRegionDecoder::decodeFromBands(const SkImageInfo& decodeInfo, const SkIRect& subset,
+                                          int sampleSize, void* dst, size_t dstRowBytes,
+                                          SkCodec::ZeroInitialized zeroInit) {
+    // A zero initialized dst is decoded directly, so that rows the codec does not reach (in an
+    // incomplete image, say) are left alone rather than filled from a band.
+    if (0 == fBandBudget || SkCodec::kYes_ZeroInitialized == zeroInit) {
+        return false;
+    }
+    // Other formats scale while decoding in ways that depend on where the subset starts.
+    switch (fCodec->getEncodedFormat()) {
+        case SkEncodedImageFormat::kJPEG:
+        case SkEncodedImageFormat::kPNG:
+            break;
+        default:
+            return false;
+    }
+
+    // The bands hold the same pixels that a direct decode of subset would sample if subset
+    // starts on a sample and keeps every sampleSize'th pixel.
+    if (0 != subset.left() % sampleSize || 0 != subset.top() % sampleSize ||
+        !samples_exactly(subset.width(), decodeInfo.width(), sampleSize) ||
+        !samples_exactly(subset.height(), decodeInfo.height(), sampleSize)) {
+        return false;
+    }
+
+    const SkIRect firstBand = SkIRect::MakeWH(this->width(),
+                                              std::min(this->height(), kBandRows * sampleSize));
+    const int bandWidth = fCodec->getSampledSubsetDimensions(sampleSize, firstBand).width();
+    const SkImageInfo bandInfo = decodeInfo.makeWH(bandWidth, kBandRows);
+    if (sampleSize != fBandSampleSize || bandInfo != fBandInfo) {
+        fBands.clear();
+        fBandSampleSize = sampleSize;
+        fBandInfo = bandInfo;
+    }
+
+    const int x = subset.left() / sampleSize;
+    const int y = subset.top() / sampleSize;
+    const int first = y / kBandRows;
+    const int last = (y + decodeInfo.height() - 1) / kBandRows;
+    const int needed = last - first + 1;
+    const int bandCount = (this->height() / sampleSize + kBandRows - 1) / kBandRows;
+    const size_t bandBytes = std::max<size_t>(bandInfo.computeMinByteSize(), 1);
+    const int maxBands = SkToInt(std::min<size_t>(fBandBudget / bandBytes, bandCount));
+    if (needed > maxBands || x + decodeInfo.width() > bandWidth) {
+        return false;
+    }
+
+    // Find the runs of missing bands, and read ahead below the last one.
+    struct Run {
+        int fFirst;
+        int fCount;
+    };
+    auto cached = [this](int index) {
+        return std::any_of(fBands.begin(), fBands.end(),
+                           [index](const Band& b) { return b.fIndex == index; });
+    };
+    std::vector<Run> runs;
+    int newBands = 0;
+    for (int i = first; i <= last; i++) {
+        if (cached(i)) {
+            continue;
+        }
+        Run run = { i, 1 };
+        while (i + 1 <= last && !cached(i + 1)) {
+            run.fCount++;
+            i++;
+        }
+        if (i == last) {
+            const int readAhead = std::min({needed, maxBands - needed, bandCount - 1 - last});
+            while (run.fFirst + run.fCount <= last + readAhead &&
+                   !cached(run.fFirst + run.fCount)) {
+                run.fCount++;
+            }
+        }
+        newBands += run.fCount;
+        runs.push_back(run);
+    }
+
+    if (!runs.empty()) {
+        const size_t newBytes = newBands * bandBytes;
+        this->purgeBands(fBandBudget > newBytes ? fBandBudget - newBytes : 0, first, last);
+        for (const Run& run : runs) {
+            if (!this->decodeBands(run.fFirst, run.fCount, sampleSize)) {
+                return false;
+            }
+        }
+    }
+
+    const size_t rowBytes = decodeInfo.width() * decodeInfo.bytesPerPixel();
+    for (int row = 0; row < decodeInfo.height();) {
+        const int index = (y + row) / kBandRows;
+        const Band* band = this->findBand(index);
+        if (!band) {
+            return false;
+        }
+        const SkPixmap& src = band->fBitmap.pixmap();
+        const int bandRow = y + row - index * kBandRows;
+        const int rows = std::min(decodeInfo.height() - row, src.height() - bandRow);
+        if (rows <= 0 || x + decodeInfo.width() > src.width()) {
+            return false;
+        }
+        for (int i = 0; i < rows; i++) {
+            memcpy(SkTAddOffset<void>(dst, (row + i) * dstRowBytes), src.addr(x, bandRow + i),
+                   rowBytes);
+        }
+        row += rows;
+    }
+    return true;
+}
+
 bool BitmapRegionDecoder::decodeRegion(SkBitmap* bitmap, BRDAllocator* allocator,
         const SkIRect& desiredSubset, int sampleSize, SkColorType dstColorType,
         bool requireUnpremul, sk_sp<SkColorSpace> dstColorSpace) {
@@ -127,11 +324,15 @@ bool BitmapRegionDecoder::decodeRegion(SkBitmap* bitmap, BRDAllocator* allocator
     }
 
     // Decode into the destination bitmap
+    void* dst = bitmap->getAddr(scaledOutX, scaledOutY);
+    if (this->decodeFromBands(decodeInfo, subset, sampleSize, dst, bitmap->rowBytes(), zeroInit)) {
+        return true;
+    }
+
     SkAndroidCodec::AndroidOptions options;
     options.fSampleSize = sampleSize;
     options.fSubset = &subset;
     options.fZeroInitialized = zeroInit;
-    void* dst = bitmap->getAddr(scaledOutX, scaledOutY);
 
     SkCodec::Result result = fCodec->getAndroidPixels(decodeInfo, dst, bitmap->rowBytes(),
             &options);
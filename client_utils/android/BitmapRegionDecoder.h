@@ -13,6 +13,8 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkData.h"
 
+#include <vector>
+
 namespace android {
 namespace skia {
 
@@ -39,10 +41,46 @@ public:
     int width() const;
     int height() const;
 
+    /**
+     *  Keeps up to cacheBytes of decoded rows to serve later calls to decodeRegion(), for
+     *  viewers that decode many neighbouring tiles of one image at the same sampleSize.
+     *
+     *  Rows are decoded across the full width of the image, in bands, and a region is copied out
+     *  of the bands it overlaps. When a band is missing, it is decoded along with the missing
+     *  bands below it, about one more region's worth if cacheBytes allows, in a single decode.
+     *  The cache is cleared whenever the sampleSize or output format changes. Regions that the
+     *  cache cannot serve exactly as a direct decode would, or that need more bands than fit in
+     *  cacheBytes, are decoded directly.
+     *
+     *  The default, zero, disables the cache.
+     */
+    void setRowBandCacheBudget(size_t cacheBytes);
+
 private:
     BitmapRegionDecoder(std::unique_ptr<SkAndroidCodec> codec);
 
+    // Output rows in each cached band.
+    static constexpr int kBandRows = 64;
+
+    struct Band {
+        int      fIndex;
+        SkBitmap fBitmap;
+    };
+
+    bool decodeFromBands(const SkImageInfo& decodeInfo, const SkIRect& subset, int sampleSize,
+                         void* dst, size_t dstRowBytes, SkCodec::ZeroInitialized zeroInit);
+    bool decodeBands(int first, int count, int sampleSize);
+    const Band* findBand(int index);
+    void purgeBands(size_t budget, int keepFirst, int keepLast);
+
     std::unique_ptr<SkAndroidCodec> fCodec;
+
+    // The cached bands, least recently used first, all decoded at fBandSampleSize to
+    // fBandInfo, whose height is kBandRows. The last band of the image may be shorter.
+    size_t            fBandBudget = 0;
+    int               fBandSampleSize = 0;
+    SkImageInfo       fBandInfo;
+    std::vector<Band> fBands;
 };
 
 } // namespace skia
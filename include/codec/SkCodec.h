@@ -27,6 +27,7 @@
 class SkAndroidCodec;
 class SkColorSpace;
 class SkData;
+class SkExecutor;
 class SkFrameHolder;
 class SkImage;
 class SkPngChunkReader;
@@ -289,6 +290,7 @@ public:
             , fSubset(nullptr)
             , fFrameIndex(0)
             , fPriorFrame(kNoFrame)
+            , fExecutor(nullptr)
         {}
 
         ZeroInitialized            fZeroInitialized;
@@ -332,6 +334,15 @@ public:
          *  If set to kNoFrame, the codec will decode any necessary required frame(s) first.
          */
         int                        fPriorFrame;
+
+        /**
+         *  If not NULL, getPixels() may split the decode into independent parts which are
+         *  run concurrently on this executor. The pixels produced are the same either way.
+         *  Codecs (and images) that cannot be split are decoded on the calling thread.
+         *
+         *  getDecodeParallelism() reports how many parts the last decode was split into.
+         */
+        SkExecutor*                fExecutor;
     };
 
     /**
@@ -382,6 +393,12 @@ public:
         return this->getPixels(pm.info(), pm.writable_addr(), pm.rowBytes(), opts);
     }
 
+    /**
+     *  Returns the number of independent parts the most recent getPixels() call decoded
+     *  concurrently on Options::fExecutor, or 1 if it decoded on the calling thread.
+     */
+    int getDecodeParallelism() const { return fDecodeParallelism; }
+
     /**
      *  Return an image containing the pixels.
      */
@@ -846,6 +863,9 @@ protected:
     virtual bool usesColorXform() const { return true; }
     void applyColorXform(void* dst, const void* src, int count) const;
 
+    // Called by subclasses from onGetPixels() when they decode in parallel.
+    void setDecodeParallelism(int parallelism) { fDecodeParallelism = parallelism; }
+
     bool colorXform() const { return fXformTime != kNo_XformTime; }
     bool xformOnDecode() const { return fXformTime == kDecodeRow_XformTime; }
 
@@ -886,6 +906,8 @@ private:
 
     bool                               fStartedIncrementalDecode;
 
+    int                                fDecodeParallelism;
+
     // Allows SkAndroidCodec to call handleFrameIndex (potentially decoding a prior frame and
     // clearing to transparent) without SkCodec calling it, too.
     bool                               fAndroidCodecHandlesFrameIndex;
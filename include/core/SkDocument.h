@@ -12,6 +12,7 @@
 #include "include/core/SkScalar.h"
 
 class SkCanvas;
+class SkPicture;
 class SkWStream;
 struct SkRect;
 
@@ -45,6 +46,16 @@ public:
      */
     void endPage();
 
+    /**
+     *  Add a page for each picture, in order, sized to the picture's cullRect() and drawn with
+     *  the cullRect()'s top left corner at the page's origin. Pictures with an empty cullRect()
+     *  are skipped. If a page was begun with beginPage(), it is ended first.
+     *
+     *  Documents may draw the pages concurrently; the PDF backend does so on the SkExecutor in
+     *  its SkPDF::Metadata, and produces the same document as without one.
+     */
+    void addPages(const sk_sp<SkPicture> pictures[], int count);
+
     /**
      *  Call close() when all pages have been drawn. This will close the file
      *  or stream holding the document's contents. After close() the document
@@ -68,6 +79,9 @@ protected:
 
     virtual SkCanvas* onBeginPage(SkScalar width, SkScalar height) = 0;
     virtual void onEndPage() = 0;
+    // Called between pages, with pictures that all have non-empty cullRects. By default each
+    // picture is drawn into a page from beginPage().
+    virtual void onAddPages(const sk_sp<SkPicture> pictures[], int count);
     virtual void onClose(SkWStream*) = 0;
     virtual void onAbort() = 0;
 
@@ -144,6 +144,30 @@ public:
      *  Call early in main() to allow Skia to use a JIT to accelerate CPU-bound operations.
      */
     static void AllowJIT();
+
+    /**
+     *  Abstract class for a persistent store of the programs Skia builds for CPU-bound
+     *  operations, so that later processes can skip building and optimizing them again.
+     *  Keys and data are opaque. Both calls may be made from any thread.
+     */
+    class SK_API PersistentProgramCache {
+    public:
+        virtual ~PersistentProgramCache() = default;
+
+        /**
+         *  Returns the data for the key if it exists in the cache, otherwise returns null.
+         */
+        virtual sk_sp<SkData> load(const SkData& key) = 0;
+
+        virtual void store(const SkData& key, const SkData& data) = 0;
+    };
+
+    /**
+     *  Sets the persistent store consulted when a program is not found in Skia's in-memory
+     *  program cache, and returns the previous one (which could be NULL). The cache is not
+     *  owned, and must stay alive until it is replaced.
+     */
+    static PersistentProgramCache* SetPersistentProgramCache(PersistentProgramCache*);
 };
 
 class SkAutoGraphics {
@@ -18,8 +18,10 @@
 class SkCanvas;
 class SkData;
 struct SkDeserialProcs;
+class SkExecutor;
 class SkImage;
 class SkMatrix;
+class SkPixmap;
 struct SkSerialProcs;
 class SkStream;
 class SkWStream;
@@ -130,6 +132,32 @@ public:
     */
     virtual void playback(SkCanvas* canvas, AbortCallback* callback = nullptr) const = 0;
 
+    /** Replays the drawing commands into the pixels of dst, transformed by matrix. If SkPicture
+        was recorded with a bounding box hierarchy, dst is split into square tiles of tileSize
+        pixels which are replayed concurrently on executor, each onto its own SkCanvas over dst
+        clipped to that tile. Each tile only replays the commands that intersect it, and tiles
+        that no command touches are skipped. Without a bounding box hierarchy every tile would
+        replay every command, so SkPicture is instead replayed once, as by playback() to a
+        single SkCanvas wrapping dst. So is SkPicture if it draws SkDrawable or uses backdrop
+        image filters, which read the pixels of neighboring tiles.
+
+        Commands that stay within one tile, and axis-aligned rectangles drawn without
+        anti-aliasing, come out exactly as from playback(). Other shapes crossing a tile
+        boundary have their edges clipped there, which may change how those edges are
+        rasterized, as any other change of clip may.
+
+        If executor is nullptr, the tiles are replayed in turn on the calling thread.
+        Returns once every tile has been drawn.
+
+        @param dst       pixels to draw into; must be drawable by a raster SkCanvas
+        @param matrix    transforms SkPicture into dst
+        @param executor  runs the tiles; may be nullptr
+        @param tileSize  width and height of each tile; must be greater than zero
+        @return          true if dst could be drawn into
+    */
+    bool playbackTiled(const SkPixmap& dst, const SkMatrix& matrix, SkExecutor* executor,
+                       int tileSize = 256) const;
+
     /** Returns cull SkRect for this picture, passed in when SkPicture was created.
         Returned SkRect does not specify clipping SkRect for SkPicture; cull is hint
         of SkPicture bounds.
@@ -196,10 +196,13 @@ struct Metadata {
     /** Executor to handle threaded work within PDF Backend. If this is nullptr,
         then all work will be done serially on the main thread. To have worker
         threads assist with various tasks, set this to a valid SkExecutor
-        instance. Currently used for executing Deflate algorithm in parallel.
+        instance. Currently used for executing Deflate algorithm in parallel,
+        for drawing the pages passed to SkDocument::addPages() concurrently
+        (unless fStructureElementTreeRoot is set), and for subsetting fonts
+        concurrently when the document is closed.
 
-        If set, the PDF output will be non-reproducible in the order and
-        internal numbering of objects, but should render the same.
+        If set, the PDF output will be non-reproducible in the order of
+        objects, but their internal numbering is the same as without it.
 
         Experimental.
     */
@@ -215,6 +218,50 @@ struct Metadata {
         kHarfbuzz_Subsetter,
         kSfntly_Subsetter,
     } fSubsetter = kHarfbuzz_Subsetter;
+
+    /** If true, each page, along with the objects it uses, is written to the
+        stream (and the stream flushed) as soon as endPage() or addPages()
+        returns, rather than some of it being kept until close(). Until then,
+        the document keeps little more than the position of each object in the
+        stream, the fonts used, and the named destinations, so that memory use
+        does not grow with the number of pages.
+
+        Pages are then put in the page tree in groups as they are written, so
+        the output differs slightly from that when this is false.
+
+        Experimental.
+    */
+    bool fStreamPages = false;
+
+    /** How hard to compress the streams (page contents, images, fonts, and
+        so on) in the PDF. LowButFast and HighButSlow trade output size for
+        speed. Default is zlib's default, which is the same as Average.
+
+        None writes streams without a filter, except for images that are not
+        JPEGs, which keep the FlateDecode filter with their data in stored
+        (uncompressed) blocks.
+
+        Experimental.
+    */
+    enum class CompressionLevel : int {
+        Default = -1,
+        None = 0,
+        LowButFast = 1,
+        Average = 6,
+        HighButSlow = 9,
+    } fCompressionLevel = CompressionLevel::Default;
+
+    /** How streams are compressed. Filtered can compress images better;
+        HuffmanOnly and RLE are faster, but usually compress less.
+
+        Experimental.
+    */
+    enum class CompressionStrategy : int {
+        Default,
+        Filtered,
+        HuffmanOnly,
+        RLE,
+    } fCompressionStrategy = CompressionStrategy::Default;
 };
 
 /** Associate a node ID with subsequent drawing commands in an
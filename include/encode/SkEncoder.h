@@ -12,6 +12,10 @@
 #include "include/private/SkNoncopyable.h"
 #include "include/private/SkTemplates.h"
 
+#include <functional>
+
+class SkCanvas;
+
 class SK_API SkEncoder : SkNoncopyable {
 public:
 
@@ -19,13 +23,43 @@ public:
      *  Encode |numRows| rows of input.  If the caller requests more rows than are remaining
      *  in the src, this will encode all of the remaining rows.  |numRows| must be greater
      *  than zero.
+     *
+     *  The encoder must have been made with the pixels of the src.
      */
     bool encodeRows(int numRows);
 
+    /**
+     *  Encode the pixels of |rows| as the next rows of the image, so that the whole image need
+     *  never be in memory at once.  |rows| must have the width, color type, alpha type and
+     *  color space of the src.  Its height is the number of rows to encode, which must be
+     *  greater than zero and no more than are remaining.
+     */
+    bool encodeRows(const SkPixmap& rows);
+
+    /**
+     *  Draw and encode all of the remaining rows, |bandRows| at a time, into a raster surface
+     *  of just that many rows that is reused for each band.  Memory use is bounded by the size
+     *  of a band, whatever the size of the image.
+     *
+     *  For each band, |draw| is called with a canvas that is translated so that it draws in
+     *  the coordinates of the whole image, and cleared to transparent.  Anything not within
+     *  the band is clipped out, so draws that are expensive should be culled against the
+     *  canvas' device clip bounds (as SkPicture playback does with a bounding box hierarchy).
+     *  As with any other change of clip, the edges of shapes that cross a band boundary may be
+     *  rasterized slightly differently than if the whole image were drawn at once.
+     *
+     *  Returns false if the src's color type cannot be drawn to, or if encoding fails.
+     */
+    bool encodeDrawnRows(int bandRows, const std::function<void(SkCanvas*)>& draw);
+
     virtual ~SkEncoder() {}
 
 protected:
 
+    /**
+     *  Encode the first |numRows| rows of fRows, which are rows [fCurrRow, fCurrRow + numRows)
+     *  of the image.
+     */
     virtual bool onEncodeRows(int numRows) = 0;
 
     SkEncoder(const SkPixmap& src, size_t storageBytes)
@@ -34,7 +68,11 @@ protected:
         , fStorage(storageBytes)
     {}
 
-    const SkPixmap&        fSrc;
+    // The whole image. Its pixels may be null if all of the rows are passed to
+    // encodeRows(const SkPixmap&).
+    const SkPixmap         fSrc;
+    // The rows being encoded by onEncodeRows(). Its first row is row fCurrRow of the image.
+    SkPixmap               fRows;
     int                    fCurrRow;
     SkAutoTMalloc<uint8_t> fStorage;
 };
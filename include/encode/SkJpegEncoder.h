@@ -82,6 +82,19 @@ public:
     static std::unique_ptr<SkEncoder> Make(SkWStream* dst, const SkPixmap& src,
                                            const Options& options);
 
+    /**
+     *  Create a jpeg encoder for an image described by |info|, whose rows are all passed to
+     *  encodeRows(const SkPixmap&) or drawn by encodeDrawnRows(), rather than read from a
+     *  pixmap of the whole image.  So that memory use does not grow with the size of the image,
+     *  the Huffman tables are not optimized, which makes the output a little larger.
+     *
+     *  |dst| is unowned but must remain valid for the lifetime of the object.
+     *
+     *  This returns nullptr on an invalid or unsupported |info|.
+     */
+    static std::unique_ptr<SkEncoder> Make(SkWStream* dst, const SkImageInfo& info,
+                                           const Options& options);
+
     ~SkJpegEncoder() override;
 
 protected:
@@ -90,6 +103,10 @@ protected:
 private:
     SkJpegEncoder(std::unique_ptr<SkJpegEncoderMgr>, const SkPixmap& src);
 
+    // The pixels of src may be null, if the rows are passed to encodeRows(const SkPixmap&).
+    static std::unique_ptr<SkEncoder> MakeEncoder(SkWStream*, const SkPixmap& src,
+                                                  const Options&);
+
     std::unique_ptr<SkJpegEncoderMgr> fEncoderMgr;
     using INHERITED = SkEncoder;
 };
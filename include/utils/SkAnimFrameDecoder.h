@@ -0,0 +1,108 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkAnimFrameDecoder_DEFINED
+#define SkAnimFrameDecoder_DEFINED
+
+#include "include/codec/SkCodec.h"
+#include "include/core/SkData.h"
+#include "include/private/SkMutex.h"
+#include "include/private/SkTo.h"
+
+#include <vector>
+
+class SkExecutor;
+class SkImage;
+
+/**
+ *  Decodes the frames of an animated image (e.g. GIF or WebP) for random or sequential access,
+ *  keeping a bounded cache of decoded frames.
+ *
+ *  When a requested frame is not cached, it is decoded along with the frames that follow it, as
+ *  many as fit in the cache. Frames that do not depend on earlier ones (whose fRequiredFrame is
+ *  kNoFrame) start independent runs of frames, and each run is decoded by its own SkCodec,
+ *  concurrently with the others if there is an executor.
+ *
+ *  An SkAnimFrameDecoder is not thread safe; it should be used from one thread at a time.
+ */
+class SK_API SkAnimFrameDecoder {
+public:
+    /**
+     *  Returns a decoder for the encoded image in data, or null if it cannot be decoded.
+     *
+     *  @param executor    decodes independent runs of frames concurrently; may be nullptr
+     *  @param cacheBytes  approximate limit on the bytes of decoded frames to keep. At least the
+     *                     requested frame is always kept; the frames it depends on may not be.
+     */
+    static std::unique_ptr<SkAnimFrameDecoder> Make(sk_sp<SkData> data, SkExecutor* executor,
+                                                    size_t cacheBytes);
+
+    ~SkAnimFrameDecoder();
+
+    /**
+     *  Returns the number of frames. This is 1 for a still image.
+     */
+    int frameCount() const { return SkToInt(fFrameInfos.size()); }
+
+    /**
+     *  Returns info about frame index, which must be less than frameCount(). A still image
+     *  reports a single frame with no duration.
+     */
+    const SkCodec::FrameInfo& frameInfo(int index) const {
+        SkASSERT(index >= 0 && index < this->frameCount());
+        return fFrameInfos[index];
+    }
+
+    /**
+     *  Return the size of the images that will be returned by getFrame(), after applying the
+     *  image's encoded origin.
+     */
+    SkISize dimensions() const;
+
+    /**
+     *  Returns frame index, fully composited on top of the frames it depends on, or null if it
+     *  could not be decoded. index must be less than frameCount().
+     */
+    sk_sp<SkImage> getFrame(int index);
+
+    /**
+     *  Returns the bytes of decoded frames currently cached.
+     */
+    size_t cachedBytes() const { return fCachedBytes; }
+
+private:
+    SkAnimFrameDecoder(sk_sp<SkData>, std::unique_ptr<SkCodec>, SkExecutor*, size_t cacheBytes);
+
+    struct Job;
+
+    std::unique_ptr<SkCodec> acquireCodec();
+    void releaseCodec(std::unique_ptr<SkCodec>);
+    sk_sp<SkImage> decodeFrame(SkCodec*, int index) const;
+    void runJob(const Job&);
+    void purge(int index, size_t budget, const std::vector<bool>& keep);
+
+    const sk_sp<SkData>             fData;
+    SkExecutor* const               fExecutor;
+    const size_t                    fCacheBytes;
+    SkImageInfo                     fImageInfo;
+    SkEncodedOrigin                 fOrigin;
+    std::vector<SkCodec::FrameInfo> fFrameInfos;
+
+    // fRunStart[i] is the first frame of the run containing frame i. A run starts at a frame
+    // which neither it, nor any frame after it, depends on frames before.
+    std::vector<int>                fRunStart;
+
+    // Decoded frames, before applying fOrigin. Null if not cached.
+    std::vector<sk_sp<SkImage>>     fFrames;
+    size_t                          fCachedBytes = 0;
+
+    // Codecs not currently decoding a run, for reuse by the next ones.
+    SkMutex                                fCodecMutex;
+    std::vector<std::unique_ptr<SkCodec>>  fIdleCodecs;
+};
+
+#endif
@@ -219,8 +219,17 @@ int SkBmpStandardCodec::decodeRows(const SkImageInfo& dstInfo, void* dst, size_t
     // Iterate over rows of the image
     const int height = dstInfo.height();
     for (int y = 0; y < height; y++) {
-        // Read a row of the input
-        if (this->stream()->read(this->srcBuffer(), this->srcRowBytes()) != this->srcRowBytes()) {
+        // Read a row of the input. Rows of a memory-backed stream are swizzled in place, except
+        // for 32-bit pixels that are not 4-byte aligned there, which the swizzler reads as words.
+        const uint8_t* srcRow = this->srcBuffer();
+        size_t unreadBytes;
+        const uint8_t* memory = get_unread_memory(this->stream(), &unreadBytes);
+        if (memory && unreadBytes >= this->srcRowBytes() &&
+                (this->bitsPerPixel() < 32 || SkIsAlign4(reinterpret_cast<uintptr_t>(memory)))) {
+            this->stream()->skip(this->srcRowBytes());
+            srcRow = memory;
+        } else if (this->stream()->read(this->srcBuffer(), this->srcRowBytes()) !=
+                   this->srcRowBytes()) {
             SkCodecPrintf("Warning: incomplete input stream.\n");
             return y;
         }
@@ -232,10 +241,10 @@ int SkBmpStandardCodec::decodeRows(const SkImageInfo& dstInfo, void* dst, size_t
 
         if (this->xformOnDecode()) {
             SkASSERT(this->colorXform());
-            fSwizzler->swizzle(this->xformBuffer(), this->srcBuffer());
+            fSwizzler->swizzle(this->xformBuffer(), srcRow);
             this->applyColorXform(dstRow, this->xformBuffer(), fSwizzler->swizzleWidth());
         } else {
-            fSwizzler->swizzle(dstRow, this->srcBuffer());
+            fSwizzler->swizzle(dstRow, srcRow);
         }
     }
 
@@ -86,7 +86,7 @@ bool SkCodecImageGenerator::onGetYUVAPlanes(const SkYUVAPixmaps& yuvaPixmaps) {
     }
 }
 
-SkISize SkCodecImageGenerator::getScaledDimensions(float desiredScale) const {
+SkISize SkCodecImageGenerator::onGetScaledDimensions(float desiredScale) const {
     SkISize size = fCodec->getScaledDimensions(desiredScale);
     if (SkEncodedOriginSwapsWidthHeight(fCodec->getOrigin())) {
         std::swap(size.fWidth, size.fHeight);
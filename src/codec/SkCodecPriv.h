@@ -10,6 +10,7 @@
 
 #include "include/codec/SkEncodedOrigin.h"
 #include "include/core/SkImageInfo.h"
+#include "include/core/SkStream.h"
 #include "include/core/SkTypes.h"
 #include "include/private/SkColorData.h"
 #include "include/private/SkEncodedInfo.h"
@@ -253,6 +254,27 @@ static inline PackColorProc choose_pack_color_proc(bool isPremul, SkColorType co
     }
 }
 
+/*
+ * If stream holds all of its data in memory (e.g. an SkMemoryStream wrapping an mmap'ed SkData),
+ * returns its unread bytes and sets *unreadBytes to their count. Codecs can read those in place
+ * rather than copying them out of the stream, then skip() past what they used.
+ *
+ * Otherwise returns nullptr.
+ */
+static inline const uint8_t* get_unread_memory(SkStream* stream, size_t* unreadBytes) {
+    const void* base = stream->getMemoryBase();
+    if (!base || !stream->hasLength() || !stream->hasPosition()) {
+        return nullptr;
+    }
+    const size_t length = stream->getLength(),
+                 position = stream->getPosition();
+    if (position > length) {
+        return nullptr;
+    }
+    *unreadBytes = length - position;
+    return static_cast<const uint8_t*>(base) + position;
+}
+
 bool is_orientation_marker(const uint8_t* data, size_t data_length, SkEncodedOrigin* orientation);
 
 #endif // SkCodecPriv_DEFINED
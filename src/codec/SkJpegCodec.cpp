@@ -8,6 +8,7 @@
 #include "src/codec/SkJpegCodec.h"
 
 #include "include/codec/SkCodec.h"
+#include "include/core/SkData.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkTypes.h"
 #include "include/private/SkColorData.h"
@@ -16,8 +17,14 @@
 #include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkJpegDecoderMgr.h"
 #include "src/codec/SkParseEncodedOrigin.h"
+#include "src/core/SkAutoMalloc.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/pdf/SkJpegInfo.h"
 
+#include <atomic>
+#include <numeric>
+#include <vector>
+
 // stdio is needed for libjpeg-turbo
 #include <stdio.h>
 #include "src/codec/SkJpegUtility.h"
@@ -531,6 +538,10 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
         return kUnimplemented;
     }
 
+    if (options.fExecutor && this->decodeInParallel(dstInfo, dst, dstRowBytes, options)) {
+        return kSuccess;
+    }
+
     // Get a pointer to the decompress info since we will use it quite frequently
     jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
 
@@ -566,6 +577,237 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
     return kSuccess;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Parallel decoding
+//
+// The entropy coded data of a baseline scan can only be decoded from its start, or from just
+// after a restart marker, where the DC predictions are reset. When restart markers fall at the
+// start of rows of MCUs, a band of MCU rows that starts at one is a JPEG of its own: the same
+// headers with a smaller height, followed by the band's entropy coded data. We build such a JPEG
+// for each band and decode them concurrently.
+//
+// Fancy upsampling of subsampled chroma looks at the MCU rows above and below. So each band
+// also decodes (and discards) the aligned MCU rows just above it, and the MCU row below it, in
+// order to produce the same pixels as the serial decode.
+///////////////////////////////////////////////////////////////////////////////
+
+// Bands span at least this many restart-aligned steps, so that the rows each one decodes above
+// and below itself add no more than a quarter, and there are never more than kMaxBands of them.
+static constexpr int kMinBandSteps = 8;
+static constexpr int kMaxBands     = 32;
+
+static constexpr uint8_t kSOSMarker  = 0xDA;
+static constexpr uint8_t kEOIMarker  = 0xD9;
+static constexpr uint8_t kRST0Marker = 0xD0;
+static constexpr uint8_t kRST7Marker = 0xD7;
+
+namespace {
+struct JpegScanLayout {
+    size_t              fHeightOffset;  // Of the image height, in the SOF marker segment.
+    size_t              fScanStart;     // Of the entropy coded data, after the SOS segment.
+    size_t              fScanEnd;       // Of the EOI marker that ends the entropy coded data.
+    std::vector<size_t> fRestarts;      // Of each RSTn marker in the entropy coded data.
+};
+}  // namespace
+
+static size_t read_be16(const uint8_t* p) {
+    return (p[0] << 8) | p[1];
+}
+
+static bool is_sof_marker(uint8_t marker) {
+    // DHT, JPG and DAC share the range of SOFn markers.
+    return marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+}
+
+/*
+ * Finds the markers needed to cut a JPEG into bands. Returns false unless data holds a single,
+ * complete scan.
+ */
+static bool find_scan_layout(const uint8_t* data, size_t size, JpegScanLayout* layout) {
+    // Walk the marker segments that follow SOI, up to and including SOS.
+    layout->fHeightOffset = 0;
+    size_t pos = 2;
+    for (;;) {
+        if (pos + 4 > size || 0xFF != data[pos]) {
+            return false;
+        }
+        const uint8_t marker = data[pos + 1];
+        if (0xFF == marker) {
+            // Fill byte.
+            pos++;
+            continue;
+        }
+        const size_t length = read_be16(data + pos + 2);
+        if (length < 2 || pos + 2 + length > size) {
+            return false;
+        }
+        if (is_sof_marker(marker)) {
+            // Precision, then height.
+            layout->fHeightOffset = pos + 5;
+        }
+        pos += 2 + length;
+        if (kSOSMarker == marker) {
+            break;
+        }
+    }
+    if (!layout->fHeightOffset) {
+        return false;
+    }
+    layout->fScanStart = pos;
+
+    // Find the restart markers, skipping stuffed zeros and fill bytes.
+    layout->fRestarts.clear();
+    for (;;) {
+        const void* ff = memchr(data + pos, 0xFF, size - pos);
+        if (!ff) {
+            return false;
+        }
+        pos = static_cast<const uint8_t*>(ff) - data;
+        if (pos + 1 >= size) {
+            return false;
+        }
+        const uint8_t next = data[pos + 1];
+        if (0x00 == next) {
+            pos += 2;
+        } else if (0xFF == next) {
+            pos += 1;
+        } else if (next >= kRST0Marker && next <= kRST7Marker) {
+            layout->fRestarts.push_back(pos);
+            pos += 2;
+        } else {
+            // Any marker but EOI means more scans, or tables for them, follow.
+            layout->fScanEnd = pos;
+            return kEOIMarker == next;
+        }
+    }
+}
+
+bool SkJpegCodec::decodeInParallel(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                   const Options& options) {
+    SkStream* stream = this->stream();
+    const jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    if (!options.fExecutor || dstInfo.dimensions() != this->dimensions() ||
+            !stream->hasLength() || !stream->getMemoryBase() ||
+            dinfo->progressive_mode || dinfo->arith_code || 0 == dinfo->restart_interval ||
+            dinfo->comps_in_scan != dinfo->num_components) {
+        return false;
+    }
+
+    // Work out which rows of MCUs start with a restart marker. A band of rows is made of whole
+    // iMCU rows, which are a single row of MCUs unless the image has a single component.
+    const int width     = this->dimensions().width(),
+              height    = this->dimensions().height(),
+              rowHeight = dinfo->max_v_samp_factor * DCTSIZE,
+              rows      = (height + rowHeight - 1) / rowHeight;
+    int64_t mcusPerRow, totalMCUs;
+    if (1 == dinfo->comps_in_scan) {
+        // Each MCU is a single block of the component.
+        const jpeg_component_info* comp = dinfo->cur_comp_info[0];
+        const int64_t blocksWide = ((int64_t)width * comp->h_samp_factor +
+                                    dinfo->max_h_samp_factor * DCTSIZE - 1) /
+                                   (dinfo->max_h_samp_factor * DCTSIZE),
+                      blocksHigh = ((int64_t)height * comp->v_samp_factor + rowHeight - 1) /
+                                   rowHeight;
+        mcusPerRow = blocksWide * comp->v_samp_factor;
+        totalMCUs  = blocksWide * blocksHigh;
+    } else {
+        const int mcuWidth = dinfo->max_h_samp_factor * DCTSIZE;
+        mcusPerRow = (width + mcuWidth - 1) / mcuWidth;
+        totalMCUs  = mcusPerRow * rows;
+    }
+    const int64_t interval = dinfo->restart_interval;
+    const int step = SkToInt(interval / std::gcd(interval, mcusPerRow));
+    if (step > rows) {
+        return false;
+    }
+    const int steps     = rows / step,
+              bandSteps = std::max(kMinBandSteps, (steps + kMaxBands - 1) / kMaxBands),
+              bands     = steps / bandSteps;
+    if (bands < 2) {
+        return false;
+    }
+
+    const uint8_t* data = static_cast<const uint8_t*>(stream->getMemoryBase());
+    JpegScanLayout layout;
+    if (!find_scan_layout(data, stream->getLength(), &layout)) {
+        return false;
+    }
+    // A truncated image is left to the serial decode, which reports how far it got.
+    const int64_t segments = (totalMCUs + interval - 1) / interval;
+    if ((int64_t)layout.fRestarts.size() != segments - 1) {
+        return false;
+    }
+    auto segmentStart = [&](int64_t segment) {
+        return segment ? layout.fRestarts[segment - 1] + 2 : layout.fScanStart;
+    };
+    auto segmentEnd = [&](int64_t segment) {
+        return segment + 1 < segments ? layout.fRestarts[segment] : layout.fScanEnd;
+    };
+
+    const skcms_ICCProfile* profile = this->getEncodedInfo().profile();
+    std::atomic<bool> failed{false};
+    auto decodeBand = [&](int band) {
+        const int first = band * bandSteps * step,
+                  last  = band + 1 < bands ? (band + 1) * bandSteps * step : rows,
+                  top   = band ? first - step : 0,
+                  bottom = std::min(rows, last + 1);
+
+        // Copy the headers and the band's entropy coded data, then end it with EOI.
+        const int64_t firstSegment = top * mcusPerRow / interval,
+                      lastSegment  = (std::min(bottom * mcusPerRow, totalMCUs) - 1) / interval;
+        const size_t scanStart = segmentStart(firstSegment),
+                     scanBytes = segmentEnd(lastSegment) - scanStart;
+        sk_sp<SkData> bandData = SkData::MakeUninitialized(layout.fScanStart + scanBytes + 2);
+        uint8_t* bandBytes = static_cast<uint8_t*>(bandData->writable_data());
+        memcpy(bandBytes, data, layout.fScanStart);
+        memcpy(bandBytes + layout.fScanStart, data + scanStart, scanBytes);
+        bandBytes[layout.fScanStart + scanBytes]     = 0xFF;
+        bandBytes[layout.fScanStart + scanBytes + 1] = kEOIMarker;
+
+        const int bandHeight = std::min(height, bottom * rowHeight) - top * rowHeight;
+        bandBytes[layout.fHeightOffset]     = bandHeight >> 8;
+        bandBytes[layout.fHeightOffset + 1] = bandHeight & 0xFF;
+
+        // Restart markers count from RST0 again at the start of the band.
+        for (int64_t segment = firstSegment + 1; segment <= lastSegment; segment++) {
+            const size_t marker = layout.fRestarts[segment - 1] - scanStart + layout.fScanStart;
+            bandBytes[marker + 1] = kRST0Marker + ((segment - firstSegment - 1) & 7);
+        }
+
+        Result result;
+        std::unique_ptr<SkCodec> codec = SkJpegCodec::MakeFromStream(
+                SkMemoryStream::Make(std::move(bandData)), &result,
+                profile ? SkEncodedInfo::ICCProfile::Make(*profile) : nullptr);
+        const SkImageInfo bandInfo = dstInfo.makeWH(width, bandHeight);
+        if (!codec || kSuccess != codec->startScanlineDecode(bandInfo)) {
+            failed = true;
+            return;
+        }
+
+        const int skipRows = (first - top) * rowHeight;
+        if (skipRows > 0) {
+            SkAutoMalloc scratch(skipRows * bandInfo.minRowBytes());
+            if (skipRows != codec->getScanlines(scratch.get(), skipRows,
+                                                bandInfo.minRowBytes())) {
+                failed = true;
+                return;
+            }
+        }
+        const int dstRows = std::min(height, last * rowHeight) - first * rowHeight;
+        if (dstRows != codec->getScanlines(SkTAddOffset<void>(dst, first * rowHeight * rowBytes),
+                                           dstRows, rowBytes)) {
+            failed = true;
+        }
+    };
+    SkTaskGroup(*options.fExecutor).batch(bands, decodeBand);
+    if (failed) {
+        return false;
+    }
+
+    this->setDecodeParallelism(bands);
+    return true;
+}
+
 bool SkJpegCodec::allocateStorage(const SkImageInfo& dstInfo) {
     int dstWidth = dstInfo.width();
 
@@ -109,6 +109,16 @@ private:
     bool SK_WARN_UNUSED_RESULT allocateStorage(const SkImageInfo& dstInfo);
     int readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int count, const Options&);
 
+    /*
+     * Decodes the whole image as bands of MCU rows that start at restart markers, each by its
+     * own SkJpegCodec, concurrently on options.fExecutor.
+     *
+     * Returns false if the image has no suitable restart markers or a band fails to decode.
+     * fDecoderMgr is left untouched, so the caller can then decode serially instead.
+     */
+    bool decodeInParallel(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                          const Options& options);
+
     /*
      * Scanline decoding.
      */
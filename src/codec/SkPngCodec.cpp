@@ -7,23 +7,29 @@
 
 #include "include/core/SkBitmap.h"
 #include "include/core/SkColorSpace.h"
+#include "include/core/SkData.h"
 #include "include/core/SkMath.h"
 #include "include/core/SkPoint3.h"
 #include "include/core/SkSize.h"
+#include "include/core/SkSpan.h"
 #include "include/core/SkStream.h"
 #include "include/private/SkColorData.h"
 #include "include/private/SkMacros.h"
 #include "include/private/SkTemplates.h"
+#include "include/private/SkTo.h"
 #include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkColorTable.h"
 #include "src/codec/SkPngCodec.h"
 #include "src/codec/SkPngPriv.h"
 #include "src/codec/SkSwizzler.h"
 #include "src/core/SkOpts.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkUtils.h"
 
 #include "png.h"
+#include "zlib.h"
 #include <algorithm>
+#include <vector>
 
 #ifdef SK_BUILD_FOR_ANDROID_FRAMEWORK
     #include "include/android/SkAndroidFrameworkUtils.h"
@@ -134,6 +140,15 @@ static inline bool is_chunk(const png_byte* chunk, const char* tag) {
 
 static inline bool process_data(png_structp png_ptr, png_infop info_ptr,
         SkStream* stream, void* buffer, size_t bufferSize, size_t length) {
+    // Hand libpng a memory-backed stream's bytes in place. As when reading into buffer, the
+    // stream moves past them before libpng sees them, in case libpng longjmps out.
+    size_t unreadBytes;
+    if (const uint8_t* memory = get_unread_memory(stream, &unreadBytes)) {
+        const size_t bytes = stream->skip(std::min(length, unreadBytes));
+        png_process_data(png_ptr, info_ptr, const_cast<png_bytep>(memory), bytes);
+        return bytes == length;
+    }
+
     while (length > 0) {
         const size_t bytesToProcess = std::min(bufferSize, length);
         const size_t bytesRead = stream->read(buffer, bytesToProcess);
@@ -429,6 +444,14 @@ std::unique_ptr<SkEncodedInfo::ICCProfile> read_color_profile(png_structp png_pt
 #endif // LIBPNG >= 1.6
 }
 
+// If we have more than 8-bits (per component) of precision, we will keep that extra precision.
+// Otherwise, we will swizzle to RGBA_8888 before transforming.
+static size_t color_xform_row_bytes(const SkEncodedInfo& info, const SkImageInfo& dstInfo) {
+    const int bitsPerPixel = info.bitsPerPixel();
+    const size_t bytesPerPixel = (bitsPerPixel > 32) ? bitsPerPixel / 8 : 4;
+    return dstInfo.width() * bytesPerPixel;
+}
+
 void SkPngCodec::allocateStorage(const SkImageInfo& dstInfo) {
     switch (fXformMode) {
         case kSwizzleOnly_XformMode:
@@ -437,17 +460,10 @@ void SkPngCodec::allocateStorage(const SkImageInfo& dstInfo) {
             // Intentional fall through.  A swizzler hasn't been created yet, but one will
             // be created later if we are sampling.  We'll go ahead and allocate
             // enough memory to swizzle if necessary.
-        case kSwizzleColor_XformMode: {
-            const int bitsPerPixel = this->getEncodedInfo().bitsPerPixel();
-
-            // If we have more than 8-bits (per component) of precision, we will keep that
-            // extra precision.  Otherwise, we will swizzle to RGBA_8888 before transforming.
-            const size_t bytesPerPixel = (bitsPerPixel > 32) ? bitsPerPixel / 8 : 4;
-            const size_t colorXformBytes = dstInfo.width() * bytesPerPixel;
-            fStorage.reset(colorXformBytes);
+        case kSwizzleColor_XformMode:
+            fStorage.reset(color_xform_row_bytes(this->getEncodedInfo(), dstInfo));
             fColorXformSrcRow = fStorage.get();
             break;
-        }
     }
 }
 
@@ -467,6 +483,10 @@ static skcms_PixelFormat png_select_xform_format(const SkEncodedInfo& info) {
 }
 
 void SkPngCodec::applyXformRow(void* dst, const void* src) {
+    this->applyXformRow(dst, src, fColorXformSrcRow);
+}
+
+void SkPngCodec::applyXformRow(void* dst, const void* src, void* colorXformSrcRow) {
     switch (fXformMode) {
         case kSwizzleOnly_XformMode:
             fSwizzler->swizzle(dst, (const uint8_t*) src);
@@ -475,8 +495,8 @@ void SkPngCodec::applyXformRow(void* dst, const void* src) {
             this->applyColorXform(dst, src, fXformWidth);
             break;
         case kSwizzleColor_XformMode:
-            fSwizzler->swizzle(fColorXformSrcRow, (const uint8_t*) src);
-            this->applyColorXform(dst, fColorXformSrcRow, fXformWidth);
+            fSwizzler->swizzle(colorXformSrcRow, (const uint8_t*) src);
+            this->applyColorXform(dst, colorXformSrcRow, fXformWidth);
             break;
     }
 }
@@ -1134,6 +1154,269 @@ bool SkPngCodec::onRewind() {
     return true;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Parallel decoding
+//
+// A deflate stream can only be inflated from its start, so all of the IDAT data is inflated in
+// one serial pass. What ties each row to the one above it after that is its filter, but rows
+// filtered with None or Sub do not look at the previous row. We start a new band at such rows,
+// then unfilter, swizzle and color transform the bands concurrently. Encoders that want their
+// images to decode in parallel can use one of those filters every so many rows.
+///////////////////////////////////////////////////////////////////////////////
+
+// Bands are at least this many rows, and there are never more than kMaxBands of them.
+static constexpr int kMinBandRows = 16;
+static constexpr int kMaxBands    = 64;
+
+enum PngFilter : uint8_t {
+    kNone_PngFilter,
+    kSub_PngFilter,
+    kUp_PngFilter,
+    kAverage_PngFilter,
+    kPaeth_PngFilter,
+
+    kLast_PngFilter = kPaeth_PngFilter,
+};
+
+static uint8_t paeth_predictor(int a, int b, int c) {
+    const int pa = std::abs(b - c),
+              pb = std::abs(a - c),
+              pc = std::abs(a + b - 2*c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return pb <= pc ? b : c;
+}
+
+// Unfilters src, whose first byte is its filter, into x. prev is the unfiltered previous row, or
+// zeros for the first row. Returns false for unknown filters.
+static bool unfilter_row(uint8_t* x, const uint8_t* src, const uint8_t* prev,
+                         size_t len, size_t bpp) {
+    const uint8_t filter = src[0];
+    memcpy(x, src + 1, len);
+    switch (filter) {
+        case kNone_PngFilter:
+            break;
+        case kSub_PngFilter:
+            for (size_t i = bpp; i < len; i++) {
+                x[i] += x[i - bpp];
+            }
+            break;
+        case kUp_PngFilter:
+            for (size_t i = 0; i < len; i++) {
+                x[i] += prev[i];
+            }
+            break;
+        case kAverage_PngFilter:
+            for (size_t i = 0; i < bpp; i++) {
+                x[i] += prev[i] >> 1;
+            }
+            for (size_t i = bpp; i < len; i++) {
+                x[i] += (x[i - bpp] + prev[i]) >> 1;
+            }
+            break;
+        case kPaeth_PngFilter:
+            for (size_t i = 0; i < bpp; i++) {
+                x[i] += prev[i];
+            }
+            for (size_t i = bpp; i < len; i++) {
+                x[i] += paeth_predictor(x[i - bpp], prev[i], prev[i - bpp]);
+            }
+            break;
+        default:
+            return false;
+    }
+    return true;
+}
+
+// Copies up to length bytes of a chunk out of stream. Chunk lengths are untrusted, so this never
+// allocates much more than the stream turns out to hold.
+static sk_sp<SkData> read_chunk_data(SkStream* stream, size_t length) {
+    if (stream->hasLength() && stream->hasPosition()) {
+        const size_t available = stream->getLength() - std::min(stream->getLength(),
+                                                                 stream->getPosition());
+        sk_sp<SkData> data = SkData::MakeUninitialized(std::min(length, available));
+        const size_t bytesRead = stream->read(data->writable_data(), data->size());
+        return bytesRead == data->size() ? data : SkData::MakeSubset(data.get(), 0, bytesRead);
+    }
+
+    SkDynamicMemoryWStream copy;
+    uint8_t buffer[4096];
+    while (length > 0) {
+        const size_t bytesRead = stream->read(buffer, std::min(sizeof(buffer), length));
+        if (0 == bytesRead) {
+            break;
+        }
+        copy.write(buffer, bytesRead);
+        length -= bytesRead;
+    }
+    return copy.detachAsData();
+}
+
+bool SkPngCodec::canDecodeInParallel() const {
+    // Chunks after the IDATs are not read, so an SkPngChunkReader would miss them.
+    if (!this->options().fExecutor || fPngChunkReader || fDecodedIdat || 0 == fIdatLength ||
+            this->dimensions().height() < 2 * kMinBandRows) {
+        return false;
+    }
+
+    png_uint_32 width, height;
+    int bitDepth, colorType, interlaceType;
+    png_get_IHDR(fPng_ptr, fInfo_ptr, &width, &height, &bitDepth, &colorType, &interlaceType,
+                 nullptr, nullptr);
+    if (PNG_INTERLACE_NONE != interlaceType || bitDepth < 8) {
+        return false;
+    }
+
+    // Only decode images for which infoCallback() asked libpng for no transforms.
+    switch (colorType) {
+        case PNG_COLOR_TYPE_PALETTE:
+        case PNG_COLOR_TYPE_RGB_ALPHA:
+            return true;
+        case PNG_COLOR_TYPE_RGB:
+            return !png_get_valid(fPng_ptr, fInfo_ptr, PNG_INFO_tRNS);
+        case PNG_COLOR_TYPE_GRAY:
+            return 8 == bitDepth && !png_get_valid(fPng_ptr, fInfo_ptr, PNG_INFO_tRNS);
+        case PNG_COLOR_TYPE_GRAY_ALPHA:
+            return 8 == bitDepth;
+        default:
+            return false;
+    }
+}
+
+SkCodec::Result SkPngCodec::decodeAllRowsInParallel(void* dst, size_t rowBytes,
+                                                    int* rowsDecoded) {
+    // Gather the IDAT chunks. read_header() has already read the first one's length and type.
+    // Those in a memory-backed stream are inflated in place, others are copied out first.
+    std::vector<SkSpan<const uint8_t>> idats;
+    std::vector<sk_sp<SkData>> copies;
+    bool truncated = false;
+    for (size_t length = fIdatLength; !truncated;) {
+        if (length > PNG_UINT_31_MAX) {
+            // As libpng, reject lengths that do not fit in 31 bits.
+            SkCodecPrintf("------ png error IDAT length out of range\n");
+            return log_and_return_error(false);
+        }
+        size_t unreadBytes, bytesRead;
+        const uint8_t* idat = get_unread_memory(this->stream(), &unreadBytes);
+        if (idat) {
+            bytesRead = this->stream()->skip(std::min(length, unreadBytes));
+        } else {
+            copies.push_back(read_chunk_data(this->stream(), length));
+            idat = copies.back()->bytes();
+            bytesRead = copies.back()->size();
+        }
+        idats.push_back({idat, bytesRead});
+
+        png_byte crc[4];
+        if (bytesRead < length || this->stream()->read(crc, 4) < 4) {
+            truncated = true;
+            break;
+        }
+        uint32_t expected = SkOpts::crc32_fn(0, "IDAT", 4);
+        expected = SkOpts::crc32_fn(expected, idat, length);
+        if (png_get_uint_32(crc) != expected) {
+            SkCodecPrintf("------ png error IDAT CRC error\n");
+            return log_and_return_error(false);
+        }
+
+        png_byte chunk[8];
+        if (this->stream()->read(chunk, 8) < 8 || !is_chunk(chunk, "IDAT")) {
+            break;
+        }
+        length = png_get_uint_32(chunk);
+    }
+    fDecodedIdat = true;
+
+    const int    height = this->dimensions().height();
+    const size_t bpp    = png_get_channels(fPng_ptr, fInfo_ptr) * png_get_bit_depth(fPng_ptr,
+                                                                                fInfo_ptr) / 8,
+                 len    = png_get_rowbytes(fPng_ptr, fInfo_ptr),
+                 stride = 1 + len;  // Each row starts with its filter.
+    SkAutoTMalloc<uint8_t> filtered(stride * height);
+
+    z_stream zs = {};
+    if (Z_OK != inflateInit(&zs)) {
+        return kInternalError;
+    }
+    zs.next_out  = filtered.get();
+    zs.avail_out = SkToUInt(stride * height);
+    int zresult = Z_OK;
+    for (SkSpan<const uint8_t> idat : idats) {
+        zs.next_in  = const_cast<Bytef*>(idat.data());
+        zs.avail_in = SkToUInt(idat.size());
+        zresult = inflate(&zs, Z_NO_FLUSH);
+        if (Z_OK != zresult) {
+            break;
+        }
+    }
+    if (Z_OK == zresult) {
+        // Out of input or output before the end of the stream, as Z_FINISH would report it.
+        zresult = Z_BUF_ERROR;
+    }
+    const int rows = SkToInt(zs.total_out / stride);
+    inflateEnd(&zs);
+
+    // libpng stops at a row with an unknown filter, so the rows from there on are not decoded,
+    // and are left for fillIncompleteImage().
+    int decoded = rows;
+    for (int y = 0; y < rows; y++) {
+        if (filtered[y * stride] > kLast_PngFilter) {
+            decoded = y;
+            break;
+        }
+    }
+
+    // Cut the rows we can decode into bands, each starting with a row that does not need the last.
+    const int minBandRows = std::max(kMinBandRows, decoded / kMaxBands);
+    std::vector<int> bandStarts = {0};
+    for (int y = minBandRows; y < decoded; y++) {
+        const uint8_t filter = filtered[y * stride];
+        if (y - bandStarts.back() >= minBandRows &&
+                (kNone_PngFilter == filter || kSub_PngFilter == filter)) {
+            bandStarts.push_back(y);
+        }
+    }
+    bandStarts.push_back(decoded);
+    const int bands = SkToInt(bandStarts.size()) - 1;
+
+    const size_t colorXformBytes = kSwizzleColor_XformMode == fXformMode
+                                 ? color_xform_row_bytes(this->getEncodedInfo(), this->dstInfo())
+                                 : 0;
+    auto decodeBand = [&](int band) {
+        // Unfiltered rows go into scratch rather than in place, so that they are aligned for
+        // 16-bit reads. The previous row starts out as zeros, as the first row expects.
+        SkAutoTMalloc<uint8_t> colorXformSrcRow(colorXformBytes);
+        const size_t alignedLen = SkAlign4(len);
+        SkAutoTMalloc<uint8_t> scratch(2 * alignedLen);
+        uint8_t* row  = scratch.get();
+        uint8_t* prev = scratch.get() + alignedLen;
+        sk_bzero(prev, len);
+        for (int y = bandStarts[band]; y < bandStarts[band + 1]; y++) {
+            SkAssertResult(unfilter_row(row, filtered.get() + y * stride, prev, len, bpp));
+            this->applyXformRow(SkTAddOffset<void>(dst, y * rowBytes), row,
+                                colorXformSrcRow.get());
+            std::swap(row, prev);
+        }
+    };
+
+    if (bands > 1) {
+        SkTaskGroup(*this->options().fExecutor).batch(bands, decodeBand);
+        this->setDecodeParallelism(bands);
+    } else {
+        decodeBand(0);
+    }
+
+    if (decoded == height && (Z_STREAM_END == zresult || 0 == zs.avail_out)) {
+        return kSuccess;
+    }
+    if (rowsDecoded) {
+        *rowsDecoded = decoded;
+    }
+    // Running out of data is incomplete input, anything else is an error.
+    return log_and_return_error(truncated && decoded == rows && Z_BUF_ERROR == zresult);
+}
+
 SkCodec::Result SkPngCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
                                         size_t rowBytes, const Options& options,
                                         int* rowsDecoded) {
@@ -1148,6 +1431,9 @@ SkCodec::Result SkPngCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
 
     this->allocateStorage(dstInfo);
     this->initializeXformParams();
+    if (this->canDecodeInParallel()) {
+        return this->decodeAllRowsInParallel(dst, rowBytes, rowsDecoded);
+    }
     return this->decodeAllRows(dst, rowBytes, rowsDecoded);
 }
 
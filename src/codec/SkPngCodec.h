@@ -54,6 +54,8 @@ protected:
 
     SkSampler* getSampler(bool createIfNecessary) override;
     void applyXformRow(void* dst, const void* src);
+    // As above, but with the caller's scratch row, so that rows may be transformed concurrently.
+    void applyXformRow(void* dst, const void* src, void* colorXformSrcRow);
 
     voidp png_ptr() { return fPng_ptr; }
     voidp info_ptr() { return fInfo_ptr; }
@@ -106,6 +108,11 @@ private:
     void allocateStorage(const SkImageInfo& dstInfo);
     void destroyReadStruct();
 
+    // Decoding without libpng, splitting the rows into bands that are transformed on
+    // Options::fExecutor. See decodeAllRowsInParallel() in SkPngCodec.cpp.
+    bool canDecodeInParallel() const;
+    Result decodeAllRowsInParallel(void* dst, size_t rowBytes, int* rowsDecoded);
+
     virtual Result decodeAllRows(void* dst, size_t rowBytes, int* rowsDecoded) = 0;
     virtual void setRange(int firstRow, int lastRow, void* dst, size_t rowBytes) = 0;
     virtual Result decode(int* rowsDecoded) = 0;
@@ -12,6 +12,8 @@
 #include "src/codec/SkSwizzler.h"
 #include "src/core/SkOpts.h"
 
+#include <algorithm>
+
 #ifdef SK_BUILD_FOR_ANDROID_FRAMEWORK
     #include "include/android/SkAndroidFrameworkUtils.h"
 #endif
@@ -76,6 +78,26 @@ static void sample8(void* dst, const uint8_t* src, int width, int bpp, int delta
     }
 }
 
+// Unpacks 1, 2 or 4-bit indices starting at a bit offset into chunks of 8-bit indices, and hands
+// each chunk to fn(x, indices, count). Only for use when not sampling.
+template <typename Fn>
+static void unpack_small_indices_then(const uint8_t* src, int width, int bpp, int offset, Fn&& fn) {
+    // A multiple of 8, so that every chunk after the first starts on a byte boundary.
+    constexpr int kChunk = 256;
+    uint8_t indices[kChunk];
+
+    src += offset / 8;
+    int skip = (offset % 8) / bpp;
+    for (int x = 0; x < width;) {
+        const int count = std::min(width - x, kChunk - skip);
+        SkOpts::unpack_small_indices(indices, src, skip + count, bpp);
+        fn(x, indices + skip, count);
+        src += (skip + count) * bpp / 8;
+        x += count;
+        skip = 0;
+    }
+}
+
 // kBit
 // These routines exclusively choose between white and black
 
@@ -105,6 +127,22 @@ static void swizzle_bit_to_grayscale(
     }
 }
 
+static void fast_swizzle_bit_to_grayscale(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    uint8_t* dst8 = (uint8_t*) dst;
+    unpack_small_indices_then(src, width, bpp, offset, [dst8](int x, const uint8_t* bits, int n) {
+        for (int i = 0; i < n; i++) {
+            dst8[x + i] = 0 - bits[i];  // 0 stays GRAYSCALE_BLACK, 1 becomes GRAYSCALE_WHITE.
+        }
+    });
+}
+
 #undef GRAYSCALE_BLACK
 #undef GRAYSCALE_WHITE
 
@@ -129,6 +167,21 @@ static void swizzle_bit_to_n32(
     }
 }
 
+static void fast_swizzle_bit_to_n32(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    static constexpr SkPMColor kBlackWhite[] = { SK_ColorBLACK, SK_ColorWHITE };
+    SkPMColor* dst32 = (SkPMColor*) dst;
+    unpack_small_indices_then(src, width, bpp, offset, [dst32](int x, const uint8_t* bits, int n) {
+        SkOpts::index_to_8888(dst32 + x, bits, n, kBlackWhite);
+    });
+}
+
 #define RGB565_BLACK 0
 #define RGB565_WHITE 0xFFFF
 
@@ -228,6 +281,21 @@ static void swizzle_small_index_to_n32(
     }
 }
 
+static void fast_swizzle_small_index_to_n32(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkPMColor* dst32 = (SkPMColor*) dst;
+    unpack_small_indices_then(src, width, bpp, offset,
+                              [dst32, ctable](int x, const uint8_t* indices, int n) {
+        SkOpts::index_to_8888(dst32 + x, indices, n, ctable);
+    });
+}
+
 // kIndex
 
 static void swizzle_index_to_n32(
@@ -243,6 +311,17 @@ static void swizzle_index_to_n32(
     }
 }
 
+static void fast_swizzle_index_to_n32(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::index_to_8888((uint32_t*) dst, src + offset, width, ctable);
+}
+
 static void swizzle_index_to_n32_skipZ(
         void* SK_RESTRICT dstRow, const uint8_t* SK_RESTRICT src, int dstWidth,
         int bpp, int deltaSrc, int offset, const SkPMColor ctable[]) {
@@ -534,6 +613,17 @@ static void swizzle_rgb16_to_rgba(
     }
 }
 
+static void fast_swizzle_rgb16_to_rgba(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGB16_to_RGB1((uint32_t*) dst, src + offset, width);
+}
+
 static void swizzle_rgb16_to_bgra(
         void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
         const SkPMColor ctable[]) {
@@ -549,6 +639,17 @@ static void swizzle_rgb16_to_bgra(
     }
 }
 
+static void fast_swizzle_rgb16_to_bgra(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGB16_to_BGR1((uint32_t*) dst, src + offset, width);
+}
+
 static void swizzle_rgb16_to_565(
         void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
         const SkPMColor ctable[]) {
@@ -579,6 +680,17 @@ static void swizzle_rgba16_to_rgba_unpremul(
     }
 }
 
+static void fast_swizzle_rgba16_to_rgba_unpremul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGBA16_to_RGBA((uint32_t*) dst, src + offset, width);
+}
+
 static void swizzle_rgba16_to_rgba_premul(
         void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
         const SkPMColor ctable[]) {
@@ -594,6 +706,18 @@ static void swizzle_rgba16_to_rgba_premul(
     }
 }
 
+static void fast_swizzle_rgba16_to_rgba_premul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGBA16_to_RGBA((uint32_t*) dst, src + offset, width);
+    SkOpts::RGBA_to_rgbA((uint32_t*) dst, (const uint32_t*) dst, width);
+}
+
 static void swizzle_rgba16_to_bgra_unpremul(
         void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
         const SkPMColor ctable[]) {
@@ -609,6 +733,17 @@ static void swizzle_rgba16_to_bgra_unpremul(
     }
 }
 
+static void fast_swizzle_rgba16_to_bgra_unpremul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGBA16_to_BGRA((uint32_t*) dst, src + offset, width);
+}
+
 static void swizzle_rgba16_to_bgra_premul(
         void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
         const SkPMColor ctable[]) {
@@ -624,6 +759,18 @@ static void swizzle_rgba16_to_bgra_premul(
     }
 }
 
+static void fast_swizzle_rgba16_to_bgra_premul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGBA16_to_BGRA((uint32_t*) dst, src + offset, width);
+    SkOpts::RGBA_to_rgbA((uint32_t*) dst, (const uint32_t*) dst, width);
+}
+
 // kCMYK
 //
 // CMYK is stored as four bytes per pixel.
@@ -828,12 +975,14 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
                         case kRGBA_8888_SkColorType:
                         case kBGRA_8888_SkColorType:
                             proc = &swizzle_bit_to_n32;
+                            fastProc = &fast_swizzle_bit_to_n32;
                             break;
                         case kRGB_565_SkColorType:
                             proc = &swizzle_bit_to_565;
                             break;
                         case kGray_8_SkColorType:
                             proc = &swizzle_bit_to_grayscale;
+                            fastProc = &fast_swizzle_bit_to_grayscale;
                             break;
                         case kRGBA_F16_SkColorType:
                             proc = &swizzle_bit_to_f16;
@@ -909,6 +1058,7 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
                         case kRGBA_8888_SkColorType:
                         case kBGRA_8888_SkColorType:
                             proc = &swizzle_small_index_to_n32;
+                            fastProc = &fast_swizzle_small_index_to_n32;
                             break;
                         case kRGB_565_SkColorType:
                             proc = &swizzle_small_index_to_565;
@@ -925,6 +1075,7 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
                                 proc = &swizzle_index_to_n32_skipZ;
                             } else {
                                 proc = &swizzle_index_to_n32;
+                                fastProc = &fast_swizzle_index_to_n32;
                             }
                             break;
                         case kRGB_565_SkColorType:
@@ -947,6 +1098,7 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
                 case kRGBA_8888_SkColorType:
                     if (16 == encodedInfo.bitsPerComponent()) {
                         proc = &swizzle_rgb16_to_rgba;
+                        fastProc = &fast_swizzle_rgb16_to_rgba;
                         break;
                     }
 
@@ -957,6 +1109,7 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
                 case kBGRA_8888_SkColorType:
                     if (16 == encodedInfo.bitsPerComponent()) {
                         proc = &swizzle_rgb16_to_bgra;
+                        fastProc = &fast_swizzle_rgb16_to_bgra;
                         break;
                     }
 
@@ -982,6 +1135,8 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
                     if (16 == encodedInfo.bitsPerComponent()) {
                         proc = premultiply ? &swizzle_rgba16_to_rgba_premul :
                                              &swizzle_rgba16_to_rgba_unpremul;
+                        fastProc = premultiply ? &fast_swizzle_rgba16_to_rgba_premul :
+                                                 &fast_swizzle_rgba16_to_rgba_unpremul;
                         break;
                     }
 
@@ -1009,6 +1164,8 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
                     if (16 == encodedInfo.bitsPerComponent()) {
                         proc = premultiply ? &swizzle_rgba16_to_bgra_premul :
                                              &swizzle_rgba16_to_bgra_unpremul;
+                        fastProc = premultiply ? &fast_swizzle_rgba16_to_bgra_premul :
+                                                 &fast_swizzle_rgba16_to_bgra_unpremul;
                         break;
                     }
 
@@ -45,6 +45,12 @@ public:
                                       draw.fRC->clipShader());
             fBlitter = fAlloc.make<SkPairBlitter>(fBlitter, coverageBlitter);
         }
+
+        if (draw.fBlitBounds) {
+            SkRectClipBlitter* clipper = fAlloc.make<SkRectClipBlitter>();
+            clipper->init(fBlitter, *draw.fBlitBounds);
+            fBlitter = clipper;
+        }
         return fBlitter;
     }
 
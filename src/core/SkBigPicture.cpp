@@ -53,6 +53,16 @@ void SkBigPicture::partialPlayback(SkCanvas* canvas,
                         initialCTM);
 }
 
+void SkBigPicture::playbackOps(SkCanvas* canvas, const std::vector<int>& ops) const {
+    SkASSERT(canvas);
+    SkAutoCanvasRestore saveRestore(canvas, true /*save now, restore at exit*/);
+
+    SkRecords::Draw draw(canvas, this->drawablePicts(), nullptr, this->drawableCount());
+    for (int op : ops) {
+        fRecord->visit(op, draw);
+    }
+}
+
 struct NestedApproxOpCounter {
     int fCount = 0;
 
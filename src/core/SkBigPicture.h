@@ -15,6 +15,8 @@
 #include "include/private/SkOnce.h"
 #include "include/private/SkTemplates.h"
 
+#include <vector>
+
 class SkBBoxHierarchy;
 class SkMatrix;
 class SkRecord;
@@ -54,6 +56,8 @@ public:
                          int start,
                          int stop,
                          const SkM44& initialCTM) const;
+// Used by SkPicture::playbackTiled(), replays just ops, which were found by searching bbh().
+    void playbackOps(SkCanvas*, const std::vector<int>& ops) const;
 // Used by GrRecordReplaceDraw
     const SkBBoxHierarchy* bbh() const { return fBBH.get(); }
     const SkRecord*     record() const { return fRecord.get(); }
@@ -30,7 +30,7 @@ void SkNotifyBitmapGenIDIsStale(uint32_t bitmapGenID) {
 SkBitmapCacheDesc SkBitmapCacheDesc::Make(uint32_t imageID, const SkIRect& subset) {
     SkASSERT(imageID);
     SkASSERT(subset.width() > 0 && subset.height() > 0);
-    return { imageID, subset };
+    return { imageID, subset, subset.size() };
 }
 
 SkBitmapCacheDesc SkBitmapCacheDesc::Make(const SkImage* image) {
@@ -38,6 +38,13 @@ SkBitmapCacheDesc SkBitmapCacheDesc::Make(const SkImage* image) {
     return Make(image->uniqueID(), bounds);
 }
 
+SkBitmapCacheDesc SkBitmapCacheDesc::MakeScaled(const SkImage* image, SkISize scaledDimensions) {
+    SkBitmapCacheDesc desc = Make(image);
+    desc.fDimensions = scaledDimensions;
+    desc.validate();
+    return desc;
+}
+
 namespace {
 static unsigned gBitmapKeyNamespaceLabel;
 
@@ -175,9 +182,9 @@ void SkBitmapCache::PrivateDeleteRec(Rec* rec) { delete rec; }
 
 SkBitmapCache::RecPtr SkBitmapCache::Alloc(const SkBitmapCacheDesc& desc, const SkImageInfo& info,
                                            SkPixmap* pmap) {
-    // Ensure that the info matches the subset (i.e. the subset is the entire image)
-    SkASSERT(info.width() == desc.fSubset.width());
-    SkASSERT(info.height() == desc.fSubset.height());
+    // Ensure that the info matches the subset (i.e. the subset is the entire image), at the
+    // described scale.
+    SkASSERT(info.dimensions() == desc.fDimensions);
 
     const size_t rb = info.minRowBytes();
     size_t size = info.computeByteSize(rb);
@@ -284,17 +291,27 @@ static SkResourceCache::DiscardableFactory get_fact(SkResourceCache* localCache)
                       : SkResourceCache::GetDiscardableFactory();
 }
 
-const SkMipmap* SkMipmapCache::AddAndRef(const SkImage_Base* image, SkResourceCache* localCache) {
-    SkBitmap src;
-    if (!image->getROPixels(nullptr, &src)) {
-        return nullptr;
-    }
-
+static const SkMipmap* add_and_ref(const SkImage_Base* image, const SkBitmapCacheDesc& desc,
+                                   const SkBitmap& src, SkResourceCache* localCache) {
     SkMipmap* mipmap = SkMipmap::Build(src, get_fact(localCache));
     if (mipmap) {
-        MipMapRec* rec = new MipMapRec(SkBitmapCacheDesc::Make(image), mipmap);
+        MipMapRec* rec = new MipMapRec(desc, mipmap);
         CHECK_LOCAL(localCache, add, Add, rec);
         image->notifyAddedToRasterCache();
     }
     return mipmap;
 }
+
+const SkMipmap* SkMipmapCache::AddAndRef(const SkImage_Base* image, SkResourceCache* localCache) {
+    SkBitmap src;
+    if (!image->getROPixels(nullptr, &src)) {
+        return nullptr;
+    }
+    return add_and_ref(image, SkBitmapCacheDesc::Make(image), src, localCache);
+}
+
+const SkMipmap* SkMipmapCache::AddAndRef(const SkImage_Base* image, const SkBitmap& scaledSrc,
+                                         SkResourceCache* localCache) {
+    return add_and_ref(image, SkBitmapCacheDesc::MakeScaled(image, scaledSrc.dimensions()),
+                       scaledSrc, localCache);
+}
@@ -26,15 +26,20 @@ void SkNotifyBitmapGenIDIsStale(uint32_t bitmapGenID);
 struct SkBitmapCacheDesc {
     uint32_t    fImageID;       // != 0
     SkIRect     fSubset;        // always set to a valid rect (entire or subset)
+    SkISize     fDimensions;    // size of the cached pixels; smaller than fSubset if downscaled
 
     void validate() const {
         SkASSERT(fImageID);
         SkASSERT(fSubset.fLeft >= 0 && fSubset.fTop >= 0);
         SkASSERT(fSubset.width() > 0 && fSubset.height() > 0);
+        SkASSERT(fDimensions.width() > 0 && fDimensions.width() <= fSubset.width());
+        SkASSERT(fDimensions.height() > 0 && fDimensions.height() <= fSubset.height());
     }
 
     static SkBitmapCacheDesc Make(const SkImage*);
     static SkBitmapCacheDesc Make(uint32_t genID, const SkIRect& subset);
+    // Describes the entire image, generated at the (smaller) scaledDimensions.
+    static SkBitmapCacheDesc MakeScaled(const SkImage*, SkISize scaledDimensions);
 };
 
 class SkBitmapCache {
@@ -62,6 +67,10 @@ public:
                                       SkResourceCache* localCache = nullptr);
     static const SkMipmap* AddAndRef(const SkImage_Base*,
                                      SkResourceCache* localCache = nullptr);
+    // Builds the mipmaps from scaledSrc, a downscaled version of the image returned by
+    // SkImage_Base::getScaledROPixels(). Find them with SkBitmapCacheDesc::MakeScaled().
+    static const SkMipmap* AddAndRef(const SkImage_Base*, const SkBitmap& scaledSrc,
+                                     SkResourceCache* localCache = nullptr);
 };
 
 #endif
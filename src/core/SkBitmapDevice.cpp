@@ -16,6 +16,7 @@
 #include "include/core/SkVertices.h"
 #include "src/core/SkBitmapDevice.h"
 #include "src/core/SkDraw.h"
+#include "src/core/SkDrawProcs.h"
 #include "src/core/SkGlyphRun.h"
 #include "src/core/SkImageFilterCache.h"
 #include "src/core/SkImageFilter_Base.h"
@@ -23,8 +24,11 @@
 #include "src/core/SkSpecialImage.h"
 #include "src/core/SkStrikeCache.h"
 #include "src/core/SkTLazy.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/image/SkImage_Base.h"
 
+#include <vector>
+
 struct Bounder {
     SkRect  fBounds;
     bool    fHasBounds;
@@ -43,7 +47,13 @@ struct Bounder {
 class SkDrawTiler {
     enum {
         // 8K is 1 too big, since 8K << supersample == 32768 which is too big for SkFixed
-        kMaxDim = 8192 - 1
+        kMaxDim = 8192 - 1,
+
+        // When the device has an executor, draws touching at least this many pixels are split
+        // into horizontal bands of at least kMinBandRows rows, which are drawn concurrently.
+        kMinBandedArea = 512 * 512,
+        kMinBandRows   = 64,
+        kMaxBands      = 16,
     };
 
     SkBitmapDevice* fDevice;
@@ -60,12 +70,19 @@ class SkDrawTiler {
 
     bool            fDone, fNeedsTiling;
 
+    // Only used if fBandCount > 0
+    SkIRect         fBandBounds;
+    int             fBandCount = 0;
+
 public:
     static bool NeedsTiling(SkBitmapDevice* dev) {
         return dev->width() > kMaxDim || dev->height() > kMaxDim;
     }
 
-    SkDrawTiler(SkBitmapDevice* dev, const SkRect* bounds) : fDevice(dev) {
+    // If fillsClip is true, the draw is known to cover its whole clip (e.g. drawPaint), so it is
+    // worth drawing in bands even though it has no bounds.
+    SkDrawTiler(SkBitmapDevice* dev, const SkRect* bounds, const SkPaint* paint = nullptr,
+                bool fillsClip = false) : fDevice(dev) {
         fDone = false;
 
         // we need fDst to be set, and if we're actually drawing, to dirty the genID
@@ -118,10 +135,92 @@ public:
 
             fDraw.fCoverage = dev->accessCoverage();
         }
+
+        if (dev->fExecutor && !fDone && (bounds || fillsClip) &&
+            !(paint && DrawsAntiHairlines(*paint, dev->localToDevice()))) {
+            this->setupBands(bounds);
+        }
     }
 
     bool needsTiling() const { return fNeedsTiling; }
 
+    // Anti-aliased hairlines blend some pixel pairs with blitAntiH2/V2, which can round
+    // differently than blending the same pixels one at a time, so a pair split across two
+    // bands would not match the serial result. Hairlines are cheap, so they are never banded.
+    static bool DrawsAntiHairlines(const SkPaint& paint, const SkMatrix& ctm) {
+        SkScalar coverage;
+        return paint.isAntiAlias() &&
+               paint.getStyle() != SkPaint::kFill_Style &&
+               SkDrawTreatAsHairline(paint, ctm, &coverage);
+    }
+
+    bool needsBands() const { return fBandCount > 0; }
+
+    // Draws every tile as a set of horizontal bands, concurrently on the device's executor.
+    // Each band scan-converts against the tile's whole clip and only restricts its blits (see
+    // SkDraw::fBlitBounds), so the result is identical to calling fn() once per next().
+    template <typename Fn>
+    void drawInBands(Fn&& fn) {
+        SkASSERT(this->needsBands());
+
+        struct Tile {
+            SkIPoint     fOrigin;
+            SkPixmap     fDst;
+            SkRasterClip fRC;
+        };
+        struct Band {
+            int     fTile;
+            SkIRect fBlitBounds;    // in the tile's coordinates
+        };
+
+        std::vector<Tile> tiles;
+        while (const SkDraw* draw = this->next()) {
+            tiles.push_back({fOrigin, draw->fDst, *draw->fRC});
+        }
+
+        std::vector<Band> bands;
+        const int bandRows = SkToInt(SkAlign4(fBandBounds.height() / fBandCount));
+        for (int t = 0; t < SkToInt(tiles.size()); ++t) {
+            const Tile& tile = tiles[t];
+            const SkIRect tileBounds = SkIRect::MakeXYWH(tile.fOrigin.x(), tile.fOrigin.y(),
+                                                         tile.fDst.width(), tile.fDst.height());
+            for (int i = 0; i < fBandCount; ++i) {
+                // The outer bands extend to the tile's edges, so no blit is ever dropped.
+                SkIRect band = {
+                    tileBounds.fLeft,
+                    i == 0              ? tileBounds.fTop    : fBandBounds.fTop + i * bandRows,
+                    tileBounds.fRight,
+                    i == fBandCount - 1 ? tileBounds.fBottom : fBandBounds.fTop + (i+1) * bandRows,
+                };
+                if (band.intersect(tileBounds)) {
+                    bands.push_back({t, band.makeOffset(-tile.fOrigin.x(), -tile.fOrigin.y())});
+                }
+            }
+        }
+
+        SkTaskGroup tg(*fDevice->fExecutor);
+        tg.batch(SkToInt(bands.size()), [&](int i) {
+            const Band& band = bands[i];
+            const Tile& tile = tiles[band.fTile];
+
+            SkDraw draw;
+            SkTLazy<SkPostTranslateMatrixProvider> matrixProvider;
+            draw.fDst = tile.fDst;
+            draw.fRC = &tile.fRC;
+            if (fNeedsTiling) {
+                draw.fMatrixProvider = matrixProvider.init(fDevice->asMatrixProvider(),
+                                                           SkIntToScalar(-tile.fOrigin.x()),
+                                                           SkIntToScalar(-tile.fOrigin.y()));
+            } else {
+                draw.fMatrixProvider = fDevice;
+                draw.fCoverage = fDevice->accessCoverage();
+            }
+            draw.fBlitBounds = &band.fBlitBounds;
+            fn(&draw);
+        });
+        tg.wait();
+    }
+
     const SkDraw* next() {
         if (fDone) {
             return nullptr;
@@ -143,6 +242,23 @@ public:
     }
 
 private:
+    void setupBands(const SkRect* bounds) {
+        SkIRect devBounds = fDevice->fRCStack.rc().getBounds();
+        if (bounds) {
+            if (!devBounds.intersect(fDevice->localToDevice().mapRect(*bounds).roundOut())) {
+                return;
+            }
+        }
+        if (sk_64_mul(devBounds.width(), devBounds.height()) < kMinBandedArea) {
+            return;
+        }
+        int bandCount = std::min<int>(devBounds.height() / kMinBandRows, kMaxBands);
+        if (bandCount > 1) {
+            fBandBounds = devBounds;
+            fBandCount = bandCount;
+        }
+    }
+
     void stepAndSetupTileDraw() {
         SkASSERT(!fDone);
         SkASSERT(fNeedsTiling);
@@ -177,10 +293,16 @@ private:
 // drawing. If null is passed, the tiler has to visit everywhere. The bounds is expected to be
 // in local coordinates, as the tiler itself will transform that into device coordinates.
 //
-#define LOOP_TILER(code, boundsPtr)                         \
-    SkDrawTiler priv_tiler(this, boundsPtr);                \
-    while (const SkDraw* priv_draw = priv_tiler.next()) {   \
-        priv_draw->code;                                    \
+// The code must be safe to run concurrently, since it may be drawn in bands (see drawInBands).
+//
+#define LOOP_TILER(code, boundsPtr, paint)                                          \
+    SkDrawTiler priv_tiler(this, boundsPtr, &paint);                                \
+    if (priv_tiler.needsBands()) {                                                  \
+        priv_tiler.drawInBands([&](const SkDraw* priv_draw) { priv_draw->code; });  \
+    } else {                                                                        \
+        while (const SkDraw* priv_draw = priv_tiler.next()) {                       \
+            priv_draw->code;                                                        \
+        }                                                                           \
     }
 
 // Helper to create an SkDraw from a device
@@ -313,7 +435,12 @@ SkBaseDevice* SkBitmapDevice::onCreateDevice(const CreateInfo& cinfo, const SkPa
         info = info.makeColorType(kN32_SkColorType);
     }
 
-    return SkBitmapDevice::Create(info, surfaceProps, cinfo.fTrackCoverage, cinfo.fAllocator);
+    SkBitmapDevice* device =
+            SkBitmapDevice::Create(info, surfaceProps, cinfo.fTrackCoverage, cinfo.fAllocator);
+    if (device) {
+        device->setExecutor(fExecutor);
+    }
+    return device;
 }
 
 bool SkBitmapDevice::onAccessPixels(SkPixmap* pmap) {
@@ -353,16 +480,23 @@ bool SkBitmapDevice::onReadPixels(const SkPixmap& pm, int x, int y) {
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkBitmapDevice::drawPaint(const SkPaint& paint) {
+    if (fExecutor) {
+        SkDrawTiler tiler(this, nullptr, &paint, /*fillsClip=*/true);
+        if (tiler.needsBands() && !tiler.needsTiling()) {
+            tiler.drawInBands([&](const SkDraw* draw) { draw->drawPaint(paint); });
+            return;
+        }
+    }
     BDDraw(this).drawPaint(paint);
 }
 
 void SkBitmapDevice::drawPoints(SkCanvas::PointMode mode, size_t count,
                                 const SkPoint pts[], const SkPaint& paint) {
-    LOOP_TILER( drawPoints(mode, count, pts, paint, nullptr), nullptr)
+    LOOP_TILER( drawPoints(mode, count, pts, paint, nullptr), nullptr, paint)
 }
 
 void SkBitmapDevice::drawRect(const SkRect& r, const SkPaint& paint) {
-    LOOP_TILER( drawRect(r, paint), Bounder(r, paint))
+    LOOP_TILER( drawRect(r, paint), Bounder(r, paint), paint)
 }
 
 void SkBitmapDevice::drawOval(const SkRect& oval, const SkPaint& paint) {
@@ -377,7 +511,7 @@ void SkBitmapDevice::drawRRect(const SkRRect& rrect, const SkPaint& paint) {
     // required to override drawRRect.
     this->drawPath(SkPath::RRect(rrect), paint, true);
 #else
-    LOOP_TILER( drawRRect(rrect, paint), Bounder(rrect.getBounds(), paint))
+    LOOP_TILER( drawRRect(rrect, paint), Bounder(rrect.getBounds(), paint), paint)
 #endif
 }
 
@@ -385,10 +519,18 @@ void SkBitmapDevice::drawPath(const SkPath& path,
                               const SkPaint& paint,
                               bool pathIsMutable) {
     const SkRect* bounds = nullptr;
-    if (SkDrawTiler::NeedsTiling(this) && !path.isInverseFillType()) {
+    if ((SkDrawTiler::NeedsTiling(this) || fExecutor) && !path.isInverseFillType()) {
         bounds = &path.getBounds();
     }
-    SkDrawTiler tiler(this, bounds ? Bounder(*bounds, paint).bounds() : nullptr);
+    SkDrawTiler tiler(this, bounds ? Bounder(*bounds, paint).bounds() : nullptr, &paint);
+    if (tiler.needsBands()) {
+        // Make sure the bands only ever read the path's lazily computed bounds.
+        path.updateBoundsCache();
+        tiler.drawInBands([&](const SkDraw* draw) {
+            draw->drawPath(path, paint, nullptr, false);
+        });
+        return;
+    }
     if (tiler.needsTiling()) {
         pathIsMutable = false;
     }
@@ -402,7 +544,7 @@ void SkBitmapDevice::drawBitmap(const SkBitmap& bitmap, const SkMatrix& matrix,
                                 const SkPaint& paint) {
     const SkRect* bounds = dstOrNull;
     SkRect storage;
-    if (!bounds && SkDrawTiler::NeedsTiling(this)) {
+    if (!bounds && (SkDrawTiler::NeedsTiling(this) || fExecutor)) {
         matrix.mapRect(&storage, SkRect::MakeIWH(bitmap.width(), bitmap.height()));
         Bounder b(storage, paint);
         if (b.hasBounds()) {
@@ -410,7 +552,7 @@ void SkBitmapDevice::drawBitmap(const SkBitmap& bitmap, const SkMatrix& matrix,
             bounds = &storage;
         }
     }
-    LOOP_TILER(drawBitmap(bitmap, matrix, dstOrNull, sampling, paint), bounds)
+    LOOP_TILER(drawBitmap(bitmap, matrix, dstOrNull, sampling, paint), bounds, paint)
 }
 
 static inline bool CanApplyDstMatrixAsCTM(const SkMatrix& m, const SkPaint& paint) {
@@ -429,9 +571,28 @@ void SkBitmapDevice::drawImageRect(const SkImage* image, const SkRect* src, cons
     SkASSERT(dst.isSorted());
 
     SkBitmap bitmap;
+    // When the image is drawn smaller than its size, it may be able to produce a downscaled
+    // version of itself more cheaply than the full-size pixels (e.g. a lazy JPEG decoded with DCT
+    // scaling). Draw that instead, mapping src into its coordinates.
+    SkRect scaledSrc;
+    SkSize scale;
+    if (SkMatrix::Concat(this->localToDevice(),
+                         SkMatrix::RectToRect(src ? *src : SkRect::Make(image->bounds()), dst))
+                .decomposeScale(&scale)) {
+        const float maxScale = std::max(scale.width(), scale.height());
+        if (maxScale < 1 && as_IB(image)->getScaledROPixels(maxScale, &bitmap)) {
+            if (src) {
+                scaledSrc = SkMatrix::Scale(SkIntToScalar(bitmap.width())  / image->width(),
+                                            SkIntToScalar(bitmap.height()) / image->height())
+                                    .mapRect(*src);
+                src = &scaledSrc;
+            }
+        }
+    }
+
     // TODO: Elevate direct context requirement to public API and remove cheat.
     auto dContext = as_IB(image)->directContext();
-    if (!as_IB(image)->getROPixels(dContext, &bitmap)) {
+    if (!bitmap.getPixels() && !as_IB(image)->getROPixels(dContext, &bitmap)) {
         return;
     }
 
@@ -544,7 +705,11 @@ void SkBitmapDevice::drawImageRect(const SkImage* image, const SkRect* src, cons
 
 void SkBitmapDevice::onDrawGlyphRunList(const SkGlyphRunList& glyphRunList, const SkPaint& paint) {
     SkASSERT(!glyphRunList.hasRSXForm());
-    LOOP_TILER( drawGlyphRunList(glyphRunList, paint, &fGlyphPainter), nullptr )
+    // fGlyphPainter is not thread safe, so glyphs are never drawn in bands.
+    SkDrawTiler tiler(this, nullptr);
+    while (const SkDraw* draw = tiler.next()) {
+        draw->drawGlyphRunList(glyphRunList, paint, &fGlyphPainter);
+    }
 }
 
 void SkBitmapDevice::drawVertices(const SkVertices* vertices, SkBlendMode bmode,
@@ -21,6 +21,7 @@
 #include "src/core/SkRasterClip.h"
 #include "src/core/SkRasterClipStack.h"
 
+class SkExecutor;
 class SkImageFilterCache;
 class SkMatrix;
 class SkPaint;
@@ -68,6 +69,13 @@ public:
         return fCoverage ? &fCoverage->pixmap() : nullptr;
     }
 
+    /**
+     *  If an executor is set, large draws are split into horizontal bands which are rasterized
+     *  concurrently on it. The pixels produced are identical to drawing without an executor.
+     *  Layers created by this device inherit its executor.
+     */
+    void setExecutor(SkExecutor* executor) { fExecutor = executor; }
+
 protected:
     void* getRasterHandle() const override { return fRasterHandle; }
 
@@ -160,7 +168,7 @@ private:
     SkRasterClipStack  fRCStack;
     std::unique_ptr<SkBitmap> fCoverage;    // if non-null, will have the same dimensions as fBitmap
     SkGlyphRunListPainter fGlyphPainter;
-
+    SkExecutor* fExecutor = nullptr;
 
     using INHERITED = SkBaseDevice;
 };
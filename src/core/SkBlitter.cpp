@@ -477,7 +477,8 @@ void SkRectClipBlitter::blitMask(const SkMask& mask, const SkIRect& clip) {
 }
 
 const SkPixmap* SkRectClipBlitter::justAnOpaqueColor(uint32_t* value) {
-    return fBlitter->justAnOpaqueColor(value);
+    // Callers write straight into the returned pixmap, which would bypass fClipRect.
+    return nullptr;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
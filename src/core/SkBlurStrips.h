@@ -0,0 +1,36 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBlurStrips_DEFINED
+#define SkBlurStrips_DEFINED
+
+#include "include/core/SkTypes.h"
+
+#include <algorithm>
+
+// How the CPU blurs (SkMaskBlurFilter and SkBlurImageFilter) split a pass into strips of lines
+// that run concurrently.
+namespace SkBlurStrips {
+
+// Blurs with at least this many destination pixels are split into at most kMaxStrips strips of at
+// least kMinStripLines lines (rows for the horizontal pass, columns for the vertical one).
+static constexpr int64_t kMinParallelPixels = 256 * 256;
+static constexpr int     kMinStripLines     = 16;
+static constexpr int     kMaxStrips         = 16;
+
+// Returns how many strips to split a pass of the given lines and destination pixels into. A pass
+// with one strip or fewer runs serially.
+static inline int Count(int lines, int64_t pixels) {
+    if (pixels < kMinParallelPixels) {
+        return 1;
+    }
+    return std::min(lines / kMinStripLines, kMaxStrips);
+}
+
+}  // namespace SkBlurStrips
+
+#endif  // SkBlurStrips_DEFINED
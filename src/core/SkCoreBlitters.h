@@ -8,6 +8,7 @@
 #ifndef SkCoreBlitters_DEFINED
 #define SkCoreBlitters_DEFINED
 
+#include "include/core/SkGraphics.h"
 #include "include/core/SkPaint.h"
 #include "src/core/SkBlitRow.h"
 #include "src/core/SkBlitter.h"
@@ -15,6 +16,8 @@
 #include "src/shaders/SkBitmapProcShader.h"
 #include "src/shaders/SkShaderBase.h"
 
+class SkTraceMemoryDump;
+
 class SkRasterBlitter : public SkBlitter {
 public:
     SkRasterBlitter(const SkPixmap& device) : fDevice(device) {}
@@ -173,6 +176,20 @@ SkBlitter* SkCreateRasterPipelineBlitter(const SkPixmap&, const SkPaint&,
                                          bool shader_is_opaque,
                                          SkArenaAlloc*, sk_sp<SkShader> clipShader);
 
+// SkCreateRasterPipelineBlitter() builds blitters for paints without a shader, color filter or
+// clip shader by copying prototypes shared by all threads through this cache.
+class SkRasterPipelineBlitterCache {
+public:
+    struct Stats {
+        int     fCount;     // prototypes currently in memory
+        int64_t fHits,      // found in memory
+                fMisses;    // built from scratch
+    };
+    static Stats GetStats();
+
+    static void Purge();
+};
+
 SkBlitter* SkCreateSkVMBlitter(const SkPixmap& dst,
                                const SkPaint&,
                                const SkMatrixProvider&,
@@ -186,4 +203,24 @@ SkBlitter* SkCreateSkVMSpriteBlitter(const SkPixmap& dst,
                                      SkArenaAlloc*,
                                      sk_sp<SkShader> clipShader);
 
+// The programs SkCreateSkVMBlitter() builds are shared by all threads through this cache.
+class SkVMBlitterProgramCache {
+public:
+    struct Stats {
+        int     fCount;             // programs currently in memory
+        int64_t fHits,              // found in memory
+                fPersistentHits,    // loaded from the SkGraphics::PersistentProgramCache
+                fMisses,            // built from scratch
+                fBuildNanos;        // total time spent building (or loading) programs
+    };
+    static Stats GetStats();
+
+    static SkGraphics::PersistentProgramCache* SetPersistentCache(
+            SkGraphics::PersistentProgramCache*);
+
+    static void Purge();
+
+    static void DumpMemoryStatistics(SkTraceMemoryDump*);
+};
+
 #endif
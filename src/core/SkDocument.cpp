@@ -7,7 +7,11 @@
 
 #include "include/core/SkCanvas.h"
 #include "include/core/SkDocument.h"
+#include "include/core/SkPicture.h"
 #include "include/core/SkStream.h"
+#include "include/private/SkTo.h"
+
+#include <vector>
 
 SkDocument::SkDocument(SkWStream* stream) : fStream(stream), fState(kBetweenPages_State) {}
 
@@ -48,6 +52,34 @@ void SkDocument::endPage() {
     }
 }
 
+void SkDocument::addPages(const sk_sp<SkPicture> pictures[], int count) {
+    if (kClosed_State == fState) {
+        return;
+    }
+    this->endPage();
+    std::vector<sk_sp<SkPicture>> pages;
+    pages.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        if (pictures[i] && !pictures[i]->cullRect().isEmpty()) {
+            pages.push_back(pictures[i]);
+        }
+    }
+    if (!pages.empty()) {
+        this->onAddPages(pages.data(), SkToInt(pages.size()));
+    }
+}
+
+void SkDocument::onAddPages(const sk_sp<SkPicture> pictures[], int count) {
+    for (int i = 0; i < count; ++i) {
+        const SkRect cull = pictures[i]->cullRect();
+        if (SkCanvas* canvas = this->beginPage(cull.width(), cull.height())) {
+            canvas->translate(-cull.x(), -cull.y());
+            canvas->drawPicture(pictures[i]);
+            this->endPage();
+        }
+    }
+}
+
 void SkDocument::close() {
     for (;;) {
         switch (fState) {
@@ -34,6 +34,7 @@
 #include "src/core/SkRectPriv.h"
 #include "src/core/SkSamplingPriv.h"
 #include "src/core/SkScan.h"
+#include "src/core/SkScanPriv.h"
 #include "src/core/SkStroke.h"
 #include "src/core/SkTLazy.h"
 #include "src/core/SkUtils.h"
@@ -968,6 +969,48 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
     this->drawDevPath(*devPathPtr, *paint, drawCoverage, customBlitter, doFill);
 }
 
+void SkDraw::drawPaths(const SkPath paths[], const SkMatrix matrices[], int count,
+                       const SkPaint& paint) const {
+    SkDEBUGCODE(this->validate();)
+
+    if (count <= 0 || fRC->isEmpty()) {
+        return;
+    }
+
+    if (paint.getPathEffect() || paint.getMaskFilter() ||
+        paint.getStyle() != SkPaint::kFill_Style) {
+        for (int i = 0; i < count; ++i) {
+            this->drawPath(paths[i], paint, matrices ? &matrices[i] : nullptr);
+        }
+        return;
+    }
+
+    // With a plain fill, nothing drawPath() sets up depends on the path or its pre-matrix:
+    // the blitter (and any shader context in it) is always made against fMatrixProvider.
+    SkAutoBlitterChoose blitter(*this, nullptr, paint);
+    SkScan::EdgeBuilders edges;
+    SkPath devPath;
+    devPath.setIsVolatile(true);
+
+    const SkMatrix& ctm = fMatrixProvider->localToDevice();
+    for (int i = 0; i < count; ++i) {
+        paths[i].transform(matrices ? SkMatrix::Concat(ctm, matrices[i]) : ctm, &devPath);
+#if defined(SK_BUILD_FOR_FUZZER)
+        if (devPath.countPoints() > 1000) {
+            continue;
+        }
+#endif
+        if (SkPathPriv::TooBigForMath(devPath)) {
+            continue;
+        }
+        if (paint.isAntiAlias()) {
+            SkScan::AntiFillPath(devPath, *fRC, blitter.get(), &edges);
+        } else {
+            SkScan::FillPath(devPath, *fRC, blitter.get(), &edges);
+        }
+    }
+}
+
 void SkDraw::drawBitmapAsMask(const SkBitmap& bitmap, const SkSamplingOptions& sampling,
                               const SkPaint& paint) const {
     SkASSERT(bitmap.colorType() == kAlpha_8_SkColorType);
@@ -1114,8 +1157,10 @@ void SkDraw::drawBitmap(const SkBitmap& bitmap, const SkMatrix& prematrix,
             SkBlitter* blitter = SkBlitter::ChooseSprite(fDst, *paint, pmap, ix, iy, &allocator,
                                                          fRC->clipShader());
             if (blitter) {
-                SkScan::FillIRect(SkIRect::MakeXYWH(ix, iy, pmap.width(), pmap.height()),
-                                  *fRC, blitter);
+                SkIRect spriteBounds = SkIRect::MakeXYWH(ix, iy, pmap.width(), pmap.height());
+                if (!fBlitBounds || spriteBounds.intersect(*fBlitBounds)) {
+                    SkScan::FillIRect(spriteBounds, *fRC, blitter);
+                }
                 return;
             }
             // if !blitter, then we fall-through to the slower case
@@ -1171,7 +1216,10 @@ void SkDraw::drawSprite(const SkBitmap& bitmap, int x, int y, const SkPaint& ori
         SkBlitter* blitter = SkBlitter::ChooseSprite(fDst, paint, pmap, x, y, &allocator,
                                                      fRC->clipShader());
         if (blitter) {
-            SkScan::FillIRect(bounds, *fRC, blitter);
+            SkIRect spriteBounds = bounds;
+            if (!fBlitBounds || spriteBounds.intersect(*fBlitBounds)) {
+                SkScan::FillIRect(spriteBounds, *fRC, blitter);
+            }
             return;
         }
     }
@@ -57,6 +57,17 @@ public:
         this->drawPath(path, paint, prePathMatrix, pathIsMutable, false);
     }
 
+    /**
+     *  Draws count paths with the same paint. If matrices is not null, matrices[i] is applied to
+     *  paths[i] the same way drawPath()'s prePathMatrix is.
+     *
+     *  Plain fills share a single blitter and a single set of edge builders across the whole
+     *  batch, which is most of the cost of drawing a small path. Paints that need per-path work
+     *  anyway (strokes, path effects, mask filters) just call drawPath() for each path.
+     */
+    void    drawPaths(const SkPath paths[], const SkMatrix matrices[], int count,
+                      const SkPaint& paint) const;
+
     /* If dstOrNull is null, computes a dst by mapping the bitmap's bounds through the matrix. */
     void    drawBitmap(const SkBitmap&, const SkMatrix&, const SkRect* dstOrNull,
                        const SkSamplingOptions&, const SkPaint&) const override;
@@ -161,6 +172,11 @@ public:
     // optional, will be same dimensions as fDst if present
     const SkPixmap* fCoverage{nullptr};
 
+    // optional, if present all blits are restricted to this rect (in fDst's coordinates) while
+    // geometry is still scan-converted against the whole of fRC. Unlike intersecting fRC, this
+    // does not change how edges are clipped, so pixels inside the rect are unaffected by it.
+    const SkIRect*  fBlitBounds{nullptr};
+
 #ifdef SK_DEBUG
     void validate() const;
 #else
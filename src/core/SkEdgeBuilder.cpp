@@ -362,6 +362,18 @@ int SkEdgeBuilder::build(const SkPath& path, const SkIRect* iclip, bool canCullT
 
 int SkEdgeBuilder::buildEdges(const SkPath& path,
                               const SkIRect* shiftedClip) {
+    // A builder may be reused for many paths in a row (see SkScan::EdgeBuilders).  Edges from
+    // earlier paths are dead by now, but we only hand their arena space back once it adds up,
+    // so a run of small paths shares a few arena blocks instead of allocating for each one.
+    static constexpr int kMaxPointsBeforeReset = 2048;
+    if (fPointsSinceReset > kMaxPointsBeforeReset) {
+        fAlloc.reset();
+        fPointsSinceReset = 0;
+    }
+    fPointsSinceReset += path.countPoints();
+    fList.rewind();
+    fEdgeList = nullptr;
+
     // If we're convex, then we need both edges, even if the right edge is past the clip.
     const bool canCullToTheRight = !path.isConvex();
 
@@ -26,9 +26,9 @@ protected:
 
     // In general mode we allocate pointers in fList and fEdgeList points to its head.
     // In polygon mode we preallocated edges contiguously in fAlloc and fEdgeList points there.
-    void**              fEdgeList = nullptr;
-    SkTDArray<void*>    fList;
-    SkSTArenaAlloc<512> fAlloc;
+    void**                       fEdgeList = nullptr;
+    SkTDArray<void*>             fList;
+    SkSTArenaAllocWithReset<512> fAlloc;
 
     enum Combine {
         kNo_Combine,
@@ -37,6 +37,9 @@ protected:
     };
 
 private:
+    // Points seen by buildEdges() since fAlloc was last reset; see buildEdges().
+    int fPointsSinceReset = 0;
+
     int build    (const SkPath& path, const SkIRect* clip, bool clipToTheRight);
     int buildPoly(const SkPath& path, const SkIRect* clip, bool clipToTheRight);
 
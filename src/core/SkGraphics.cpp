@@ -17,6 +17,7 @@
 #include "include/core/SkStream.h"
 #include "include/core/SkTime.h"
 #include "src/core/SkBlitter.h"
+#include "src/core/SkCoreBlitters.h"
 #include "src/core/SkCpu.h"
 #include "src/core/SkGeometry.h"
 #include "src/core/SkImageFilter_Base.h"
@@ -40,12 +41,15 @@ void SkGraphics::Init() {
 void SkGraphics::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
   SkResourceCache::DumpMemoryStatistics(dump);
   SkStrikeCache::DumpMemoryStatistics(dump);
+  SkVMBlitterProgramCache::DumpMemoryStatistics(dump);
 }
 
 void SkGraphics::PurgeAllCaches() {
     SkGraphics::PurgeFontCache();
     SkGraphics::PurgeResourceCache();
     SkImageFilter_Base::PurgeCache();
+    SkVMBlitterProgramCache::Purge();
+    SkRasterPipelineBlitterCache::Purge();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -130,3 +134,8 @@ extern bool gSkVMAllowJIT;
 void SkGraphics::AllowJIT() {
     gSkVMAllowJIT = true;
 }
+
+SkGraphics::PersistentProgramCache* SkGraphics::SetPersistentProgramCache(
+        PersistentProgramCache* cache) {
+    return SkVMBlitterProgramCache::SetPersistentCache(cache);
+}
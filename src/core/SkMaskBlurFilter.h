@@ -15,6 +15,8 @@
 #include "include/core/SkTypes.h"
 #include "src/core/SkMask.h"
 
+class SkExecutor;
+
 // Implement a single channel Gaussian blur. The specifics for implementation are taken from:
 // https://drafts.fxtf.org/filters/#feGaussianBlurElement
 class SkMaskBlurFilter {
@@ -27,8 +29,12 @@ public:
     bool hasNoBlur() const;
 
     // Given a src SkMask, generate dst SkMask returning the border width and height.
+    // Large blurs are split into strips run on SkExecutor::GetDefault().
     SkIPoint blur(const SkMask& src, SkMask* dst) const;
 
+    // Like blur() above, but large blurs run on executor instead, or serially if it is null.
+    SkIPoint blur(const SkMask& src, SkMask* dst, SkExecutor* executor) const;
+
 private:
     const double fSigmaW;
     const double fSigmaH;
@@ -6,6 +6,7 @@
  */
 
 #include "include/core/SkBitmap.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkTypes.h"
 #include "include/private/SkColorData.h"
 #include "include/private/SkHalf.h"
@@ -16,6 +17,7 @@
 #include "src/core/SkMathPriv.h"
 #include "src/core/SkMipmap.h"
 #include "src/core/SkMipmapBuilder.h"
+#include "src/core/SkTaskGroup.h"
 #include <new>
 
 //
@@ -382,6 +384,198 @@ template <typename F> void downsample_3_3(void* dst, const void* src, size_t src
     }
 }
 
+//  The procs above filter one pixel at a time. For the most common formats, these versions of the
+//  2x2 and 3x3 filters handle several destination pixels per iteration with SkVx, then hand the
+//  last few to the procs above. Their results are bit-identical to those procs.
+
+namespace {
+using U16x16 = skvx::Vec<16, uint16_t>;
+
+// Spreads 4 8888 pixels out to 16-bit lanes.
+U16x16 expand_8888(const skvx::Vec<4, uint32_t>& px) {
+    return skvx::cast<uint16_t>(skvx::bit_pun<skvx::Vec<16, uint8_t>>(px));
+}
+
+// Splits 8 adjacent 8888 pixels into their even and odd columns, spread out to 16-bit lanes.
+void load_8888(const uint32_t* p, U16x16* even, U16x16* odd) {
+    auto px = skvx::Vec<8, uint32_t>::Load(p);
+    *even = expand_8888(skvx::shuffle<0,2,4,6>(px));
+    *odd  = expand_8888(skvx::shuffle<1,3,5,7>(px));
+}
+
+void downsample_2_2_8888(void* dst, const void* src, size_t srcRB, int count) {
+    SkASSERT(count > 0);
+    auto p0 = static_cast<const uint32_t*>(src);
+    auto p1 = (const uint32_t*)((const char*)p0 + srcRB);
+    auto d = static_cast<uint32_t*>(dst);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        U16x16 a0, b0, a1, b1;
+        load_8888(p0 + 2*i, &a0, &b0);
+        load_8888(p1 + 2*i, &a1, &b1);
+        skvx::cast<uint8_t>((a0 + b0 + a1 + b1) >> 2).store(d + i);
+    }
+    if (i < count) {
+        downsample_2_2<ColorTypeFilter_8888>(d + i, p0 + 2*i, srcRB, count - i);
+    }
+}
+
+void downsample_3_3_8888(void* dst, const void* src, size_t srcRB, int count) {
+    SkASSERT(count > 0);
+    auto p0 = static_cast<const uint32_t*>(src);
+    auto p1 = (const uint32_t*)((const char*)p0 + srcRB);
+    auto p2 = (const uint32_t*)((const char*)p1 + srcRB);
+    auto d = static_cast<uint32_t*>(dst);
+
+    // Each iteration reads source columns 2i through 2i+9, and the source is 2*count+1 wide.
+    int i = 0;
+    for (; i + 4 < count; i += 4) {
+        U16x16 a[3], b[3], c[3], unused;
+        for (int y = 0; y < 3; y++) {
+            const uint32_t* p = y == 0 ? p0 : y == 1 ? p1 : p2;
+            load_8888(p + 2*i,     &a[y], &b[y]);
+            load_8888(p + 2*i + 2, &c[y], &unused);
+        }
+        U16x16 sum = add_121(a[0], a[1], a[2]) + (add_121(b[0], b[1], b[2]) << 1)
+                   + add_121(c[0], c[1], c[2]);
+        skvx::cast<uint8_t>(sum >> 4).store(d + i);
+    }
+    if (i < count) {
+        downsample_3_3<ColorTypeFilter_8888>(d + i, p0 + 2*i, srcRB, count - i);
+    }
+}
+
+// Splits 32 adjacent 8-bit pixels into their even and odd columns, spread out to 16-bit lanes.
+void load_8(const uint8_t* p, U16x16* even, U16x16* odd) {
+    auto px = U16x16::Load(p);
+    *even = px & 0xff;
+    *odd  = px >> 8;
+}
+
+void downsample_2_2_8(void* dst, const void* src, size_t srcRB, int count) {
+    SkASSERT(count > 0);
+    auto p0 = static_cast<const uint8_t*>(src);
+    auto p1 = p0 + srcRB;
+    auto d = static_cast<uint8_t*>(dst);
+
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        U16x16 a0, b0, a1, b1;
+        load_8(p0 + 2*i, &a0, &b0);
+        load_8(p1 + 2*i, &a1, &b1);
+        skvx::cast<uint8_t>((a0 + b0 + a1 + b1) >> 2).store(d + i);
+    }
+    if (i < count) {
+        downsample_2_2<ColorTypeFilter_8>(d + i, p0 + 2*i, srcRB, count - i);
+    }
+}
+
+void downsample_3_3_8(void* dst, const void* src, size_t srcRB, int count) {
+    SkASSERT(count > 0);
+    auto p0 = static_cast<const uint8_t*>(src);
+    auto d = static_cast<uint8_t*>(dst);
+
+    // Each iteration reads source columns 2i through 2i+33, and the source is 2*count+1 wide.
+    int i = 0;
+    for (; i + 16 < count; i += 16) {
+        U16x16 a[3], b[3], c[3], unused;
+        for (int y = 0; y < 3; y++) {
+            const uint8_t* p = p0 + y * srcRB;
+            load_8(p + 2*i,     &a[y], &b[y]);
+            load_8(p + 2*i + 2, &c[y], &unused);
+        }
+        U16x16 sum = add_121(a[0], a[1], a[2]) + (add_121(b[0], b[1], b[2]) << 1)
+                   + add_121(c[0], c[1], c[2]);
+        skvx::cast<uint8_t>(sum >> 4).store(d + i);
+    }
+    if (i < count) {
+        downsample_3_3<ColorTypeFilter_8>(d + i, p0 + 2*i, srcRB, count - i);
+    }
+}
+
+// On ARM64 SkHalf.h converts with dedicated instructions that round; the portable versions
+// below only match SkHalfToFloat_finite_ftz() and SkFloatToHalf_finite_ftz() elsewhere.
+#if defined(SKNX_NO_SIMD) || !defined(SK_CPU_ARM64)
+    #define SK_MIPMAP_WIDE_F16
+#endif
+
+#if defined(SK_MIPMAP_WIDE_F16)
+using F32x8 = skvx::Vec<8, float>;
+using I32x8 = skvx::Vec<8, int32_t>;
+
+// Converts 2 F16 pixels, exactly like SkHalfToFloat_finite_ftz().
+F32x8 half_to_float(const skvx::Vec<2, uint64_t>& px) {
+    I32x8 bits     = skvx::cast<int32_t>(skvx::bit_pun<skvx::Vec<8, uint16_t>>(px)),
+          sign     = bits & 0x00008000,
+          positive = bits ^ sign,
+          is_norm  = 0x03ff < positive;
+    I32x8 norm = (positive << 13) + ((127 - 15) << 23);
+    return skvx::bit_pun<F32x8>((sign << 16) | (norm & is_norm));
+}
+
+// Converts 2 F16 pixels, exactly like SkFloatToHalf_finite_ftz().
+skvx::Vec<2, uint64_t> float_to_half(const F32x8& fs) {
+    I32x8 bits         = skvx::bit_pun<I32x8>(fs),
+          sign         = bits & ~0x7fffffff,
+          positive     = bits ^ sign,
+          will_be_norm = 0x387fdfff < positive;
+    I32x8 norm = (positive - ((127 - 15) << 23)) >> 13;
+    return skvx::bit_pun<skvx::Vec<2, uint64_t>>(
+            skvx::cast<uint16_t>((sign >> 16) | (will_be_norm & norm)));
+}
+
+void load_F16(const uint64_t* p, F32x8* even, F32x8* odd) {
+    auto px = skvx::Vec<4, uint64_t>::Load(p);
+    *even = half_to_float(skvx::shuffle<0,2>(px));
+    *odd  = half_to_float(skvx::shuffle<1,3>(px));
+}
+
+void downsample_2_2_F16(void* dst, const void* src, size_t srcRB, int count) {
+    SkASSERT(count > 0);
+    auto p0 = static_cast<const uint64_t*>(src);
+    auto p1 = (const uint64_t*)((const char*)p0 + srcRB);
+    auto d = static_cast<uint64_t*>(dst);
+
+    int i = 0;
+    for (; i + 2 <= count; i += 2) {
+        F32x8 a0, b0, a1, b1;
+        load_F16(p0 + 2*i, &a0, &b0);
+        load_F16(p1 + 2*i, &a1, &b1);
+        // Same order of operations as downsample_2_2<ColorTypeFilter_RGBA_F16>.
+        float_to_half((a0 + a1 + b0 + b1) * (1.0f / 4)).store(d + i);
+    }
+    if (i < count) {
+        downsample_2_2<ColorTypeFilter_RGBA_F16>(d + i, p0 + 2*i, srcRB, count - i);
+    }
+}
+
+void downsample_3_3_F16(void* dst, const void* src, size_t srcRB, int count) {
+    SkASSERT(count > 0);
+    auto p0 = static_cast<const uint64_t*>(src);
+    auto d = static_cast<uint64_t*>(dst);
+
+    // Each iteration reads source columns 2i through 2i+5, and the source is 2*count+1 wide.
+    int i = 0;
+    for (; i + 2 < count; i += 2) {
+        F32x8 a[3], b[3], c[3], unused;
+        for (int y = 0; y < 3; y++) {
+            auto p = (const uint64_t*)((const char*)p0 + y * srcRB);
+            load_F16(p + 2*i,     &a[y], &b[y]);
+            load_F16(p + 2*i + 2, &c[y], &unused);
+        }
+        // Same order of operations as downsample_3_3<ColorTypeFilter_RGBA_F16>.
+        F32x8 sum = add_121(a[0], a[1], a[2]) + add_121(b[0], b[1], b[2]) * 2.0f
+                  + add_121(c[0], c[1], c[2]);
+        float_to_half(sum * (1.0f / 16)).store(d + i);
+    }
+    if (i < count) {
+        downsample_3_3<ColorTypeFilter_RGBA_F16>(d + i, p0 + 2*i, srcRB, count - i);
+    }
+}
+#endif
+}  // namespace
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 size_t SkMipmap::AllocLevelsSize(int levelCount, size_t pixelSize) {
@@ -397,6 +591,16 @@ size_t SkMipmap::AllocLevelsSize(int levelCount, size_t pixelSize) {
 
 SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
                           bool computeContents) {
+    return Build(src, fact, computeContents, -1, nullptr);
+}
+
+SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact, int maxLevelCount,
+                          SkExecutor* executor) {
+    return Build(src, fact, true, maxLevelCount, executor);
+}
+
+SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
+                          bool computeContents, int maxLevelCount, SkExecutor* executor) {
     typedef void FilterProc(void*, const void* srcPtr, size_t srcRB, int count);
 
     FilterProc* proc_1_2 = nullptr;
@@ -417,11 +621,11 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
             proc_1_2 = downsample_1_2<ColorTypeFilter_8888>;
             proc_1_3 = downsample_1_3<ColorTypeFilter_8888>;
             proc_2_1 = downsample_2_1<ColorTypeFilter_8888>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_8888>;
+            proc_2_2 = downsample_2_2_8888;
             proc_2_3 = downsample_2_3<ColorTypeFilter_8888>;
             proc_3_1 = downsample_3_1<ColorTypeFilter_8888>;
             proc_3_2 = downsample_3_2<ColorTypeFilter_8888>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_8888>;
+            proc_3_3 = downsample_3_3_8888;
             break;
         case kRGB_565_SkColorType:
             proc_1_2 = downsample_1_2<ColorTypeFilter_565>;
@@ -448,11 +652,11 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
             proc_1_2 = downsample_1_2<ColorTypeFilter_8>;
             proc_1_3 = downsample_1_3<ColorTypeFilter_8>;
             proc_2_1 = downsample_2_1<ColorTypeFilter_8>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_8>;
+            proc_2_2 = downsample_2_2_8;
             proc_2_3 = downsample_2_3<ColorTypeFilter_8>;
             proc_3_1 = downsample_3_1<ColorTypeFilter_8>;
             proc_3_2 = downsample_3_2<ColorTypeFilter_8>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_8>;
+            proc_3_3 = downsample_3_3_8;
             break;
         case kRGBA_F16Norm_SkColorType:
         case kRGBA_F16_SkColorType:
@@ -464,6 +668,10 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
             proc_3_1 = downsample_3_1<ColorTypeFilter_RGBA_F16>;
             proc_3_2 = downsample_3_2<ColorTypeFilter_RGBA_F16>;
             proc_3_3 = downsample_3_3<ColorTypeFilter_RGBA_F16>;
+        #if defined(SK_MIPMAP_WIDE_F16)
+            proc_2_2 = downsample_2_2_F16;
+            proc_3_3 = downsample_3_3_F16;
+        #endif
             break;
         case kR8G8_unorm_SkColorType:
             proc_1_2 = downsample_1_2<ColorTypeFilter_88>;
@@ -551,7 +759,13 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
     // whip through our loop to compute the exact size needed
     size_t size = 0;
     int countLevels = ComputeLevelCount(src.width(), src.height());
-    for (int currentMipLevel = countLevels; currentMipLevel >= 0; currentMipLevel--) {
+    if (maxLevelCount >= 0) {
+        countLevels = std::min(countLevels, maxLevelCount);
+    }
+    if (countLevels == 0) {
+        return nullptr;
+    }
+    for (int currentMipLevel = countLevels - 1; currentMipLevel >= 0; currentMipLevel--) {
         SkISize mipSize = ComputeLevelSize(src.width(), src.height(), currentMipLevel);
         size += SkColorTypeMinRowBytes(ct, mipSize.fWidth) * mipSize.fHeight;
     }
@@ -638,10 +852,28 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
             void* dstBasePtr = dstPM.writable_addr();
 
             const size_t srcRB = srcPM.rowBytes();
-            for (int y = 0; y < height; y++) {
-                proc(dstBasePtr, srcBasePtr, srcRB, width);
-                srcBasePtr = (char*)srcBasePtr + srcRB * 2; // jump two rows
-                dstBasePtr = (char*)dstBasePtr + dstPM.rowBytes();
+            auto filterRows = [&](int top, int bottom) {
+                const char* srcRow = (const char*)srcBasePtr + srcRB * 2 * top;
+                char* dstRow = (char*)dstBasePtr + dstPM.rowBytes() * top;
+                for (int y = top; y < bottom; y++) {
+                    proc(dstRow, srcRow, srcRB, width);
+                    srcRow += srcRB * 2; // jump two rows
+                    dstRow += dstPM.rowBytes();
+                }
+            };
+
+            // Large levels are split into bands of rows, which only read their own source rows.
+            int bands = 1;
+            if (executor && (int64_t)width * height >= kMinParallelPixels) {
+                bands = std::min(height / kMinParallelRows, kMaxParallelBands);
+            }
+            if (bands > 1) {
+                SkTaskGroup(*executor).batch(bands, [&](int band) {
+                    filterRows(height *  band      / bands,
+                               height * (band + 1) / bands);
+                });
+            } else {
+                filterRows(0, height);
             }
         }
         srcPM = dstPM;
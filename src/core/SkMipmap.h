@@ -18,6 +18,7 @@
 class SkBitmap;
 class SkData;
 class SkDiscardableMemory;
+class SkExecutor;
 class SkMipmapBuilder;
 
 typedef SkDiscardableMemory* (*SkDiscardableFactoryProc)(size_t bytes);
@@ -38,6 +39,11 @@ public:
 
     static SkMipmap* Build(const SkBitmap& src, SkDiscardableFactoryProc);
 
+    // Like Build(), but only generates the first maxLevelCount levels (all of them if it is
+    // negative), and if executor is not null, filters the rows of large levels concurrently.
+    static SkMipmap* Build(const SkPixmap& src, SkDiscardableFactoryProc, int maxLevelCount,
+                           SkExecutor* executor);
+
     // Determines how many levels a SkMipmap will have without creating that mipmap.
     // This does not include the base mipmap level that the user provided when
     // creating the SkMipmap.
@@ -91,6 +97,15 @@ private:
 
     static size_t AllocLevelsSize(int levelCount, size_t pixelSize);
 
+    static SkMipmap* Build(const SkPixmap& src, SkDiscardableFactoryProc, bool computeContents,
+                           int maxLevelCount, SkExecutor*);
+
+    // Levels with at least this many pixels are split into at most kMaxParallelBands bands of at
+    // least kMinParallelRows rows each when Build() is given an executor.
+    static constexpr int kMinParallelPixels = 256 * 256;
+    static constexpr int kMinParallelRows   = 32;
+    static constexpr int kMaxParallelBands  = 16;
+
     using INHERITED = SkCachedData;
 };
 
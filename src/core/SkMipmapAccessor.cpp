@@ -26,6 +26,17 @@ static sk_sp<const SkMipmap> try_load_mips(const SkImage_Base* image) {
     return mips;
 }
 
+// Same, but for the mipmaps of a downscaled version of image
+static sk_sp<const SkMipmap> try_load_scaled_mips(const SkImage_Base* image,
+                                                  const SkBitmap& scaled) {
+    sk_sp<const SkMipmap> mips(SkMipmapCache::FindAndRef(
+            SkBitmapCacheDesc::MakeScaled(image, scaled.dimensions())));
+    if (!mips) {
+        mips.reset(SkMipmapCache::AddAndRef(image, scaled));
+    }
+    return mips;
+}
+
 SkMipmapAccessor::SkMipmapAccessor(const SkImage_Base* image, const SkMatrix& inv,
                                    SkMipmapMode requestedMode) {
     fResolvedMode = requestedMode;
@@ -39,10 +50,26 @@ SkMipmapAccessor::SkMipmapAccessor(const SkImage_Base* image, const SkMatrix& in
         }
     };
 
+    SkSize scale;
+    const bool hasScale = inv.decomposeScale(&scale, nullptr);
+
+    // When drawn smaller than its size, the image may be able to produce a downscaled version of
+    // itself more cheaply than the full-size pixels (e.g. a lazy JPEG decoded with DCT scaling).
+    // If so, that becomes the base level, and any mipmaps are built from it.
+    bool scaledBase = false;
+    if (hasScale) {
+        const float maxScale = std::max(1/scale.width(), 1/scale.height());
+        if (maxScale < 1 && image->getScaledROPixels(maxScale, &fBaseStorage)) {
+            fUpper.reset(fBaseStorage.info(), fBaseStorage.getPixels(), fBaseStorage.rowBytes());
+            scale.set(scale.width()  * fBaseStorage.width()  / image->width(),
+                      scale.height() * fBaseStorage.height() / image->height());
+            scaledBase = true;
+        }
+    }
+
     float level = 0;
     if (requestedMode != SkMipmapMode::kNone) {
-        SkSize scale;
-        if (!inv.decomposeScale(&scale, nullptr)) {
+        if (!hasScale) {
             fResolvedMode = SkMipmapMode::kNone;
         } else {
             level = SkMipmap::ComputeLevel({1/scale.width(), 1/scale.height()});
@@ -67,7 +94,7 @@ SkMipmapAccessor::SkMipmapAccessor(const SkImage_Base* image, const SkMatrix& in
     }
     // load fCurrMip if needed
     if (levelNum > 0 || (fResolvedMode == SkMipmapMode::kLinear && lowerWeight > 0)) {
-        fCurrMip = try_load_mips(image);
+        fCurrMip = scaledBase ? try_load_scaled_mips(image, fBaseStorage) : try_load_mips(image);
         if (!fCurrMip) {
             load_upper_from_base();
             fResolvedMode = SkMipmapMode::kNone;
@@ -70,6 +70,12 @@ namespace SkOpts {
     DEFINE_DEFAULT(gray_to_RGB1);
     DEFINE_DEFAULT(grayA_to_RGBA);
     DEFINE_DEFAULT(grayA_to_rgbA);
+    DEFINE_DEFAULT(RGB16_to_RGB1);
+    DEFINE_DEFAULT(RGB16_to_BGR1);
+    DEFINE_DEFAULT(RGBA16_to_RGBA);
+    DEFINE_DEFAULT(RGBA16_to_BGRA);
+    DEFINE_DEFAULT(index_to_8888);
+    DEFINE_DEFAULT(unpack_small_indices);
     DEFINE_DEFAULT(inverted_CMYK_to_RGB1);
     DEFINE_DEFAULT(inverted_CMYK_to_BGR1);
 
@@ -84,6 +90,8 @@ namespace SkOpts {
     DEFINE_DEFAULT(cubic_solver);
 
     DEFINE_DEFAULT(hash_fn);
+    DEFINE_DEFAULT(crc32_fn);
+    DEFINE_DEFAULT(adler32_fn);
 
     DEFINE_DEFAULT(S32_alpha_D32_filter_DX);
     DEFINE_DEFAULT(S32_alpha_D32_filter_DXDY);
@@ -44,7 +44,15 @@ namespace SkOpts {
                            RGB_to_BGR1,     // i.e. swap RB and insert an opaque alpha
                            gray_to_RGB1,    // i.e. expand to color channels + an opaque alpha
                            grayA_to_RGBA,   // i.e. expand to color channels
-                           grayA_to_rgbA;   // i.e. expand to color channels and premultiply
+                           grayA_to_rgbA,   // i.e. expand to color channels and premultiply
+                           RGB16_to_RGB1,   // i.e. keep the high byte of big-endian 16-bit RGB
+                           RGB16_to_BGR1,   // i.e. keep the high byte, swap RB
+                           RGBA16_to_RGBA,  // i.e. keep the high byte of big-endian 16-bit RGBA
+                           RGBA16_to_BGRA;  // i.e. keep the high byte, swap RB
+
+    // Look up 8-bit indices in a color table, and unpack 1, 2 or 4-bit indices to 8 bits.
+    extern void (*index_to_8888)(uint32_t[], const uint8_t*, int, const uint32_t ctable[]);
+    extern void (*unpack_small_indices)(uint8_t[], const uint8_t*, int, int bitsPerIndex);
 
     extern void (*memset16)(uint16_t[], uint16_t, int);
     extern void SK_SPI(*memset32)(uint32_t[], uint32_t, int);
@@ -60,6 +68,11 @@ namespace SkOpts {
         return hash_fn(data, bytes, seed);
     }
 
+    // The CRC-32 of PNG chunks and gzip, and the Adler-32 of zlib streams, continuing from a
+    // previous result. These match zlib's crc32() and adler32(): start from 0 and 1 respectively.
+    extern uint32_t (*crc32_fn)(uint32_t crc, const void* data, size_t bytes);
+    extern uint32_t (*adler32_fn)(uint32_t adler, const void* data, size_t bytes);
+
     // SkBitmapProcState optimized Shader, Sample, or Matrix procs.
     extern void (*S32_alpha_D32_filter_DX)(const SkBitmapProcState&,
                                            const uint32_t* xy, int count, SkPMColor*);
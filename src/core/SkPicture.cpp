@@ -7,10 +7,14 @@
 
 #include "include/core/SkPicture.h"
 
+#include "include/core/SkBBHFactory.h"
+#include "include/core/SkCanvas.h"
 #include "include/core/SkImageGenerator.h"
 #include "include/core/SkPictureRecorder.h"
+#include "include/core/SkPixmap.h"
 #include "include/core/SkSerialProcs.h"
 #include "include/private/SkTo.h"
+#include "src/core/SkBigPicture.h"
 #include "src/core/SkCanvasPriv.h"
 #include "src/core/SkMathPriv.h"
 #include "src/core/SkPictureCommon.h"
@@ -18,7 +22,12 @@
 #include "src/core/SkPicturePlayback.h"
 #include "src/core/SkPicturePriv.h"
 #include "src/core/SkPictureRecord.h"
+#include "src/core/SkRecord.h"
 #include "src/core/SkResourceCache.h"
+#include "src/core/SkSurfacePriv.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <algorithm>
 #include <atomic>
 
 // When we read/write the SkPictInfo via a stream, we have a sentinel byte right after the info.
@@ -335,3 +344,102 @@ sk_sp<SkPicture> SkPicture::MakePlaceholder(SkRect cull) {
     };
     return sk_make_sp<Placeholder>(cull);
 }
+
+static bool reads_other_tiles(sk_sp<const SkPicture> picture);
+
+namespace {
+// Backdrop filters read the pixels around their layer, which other tiles may be drawing into.
+struct ReadsOtherTiles {
+    bool operator()(const SkRecords::SaveLayer& op) { return op.backdrop != nullptr; }
+    bool operator()(const SkRecords::DrawPicture& op) { return reads_other_tiles(op.picture); }
+    // We can't see into drawables.
+    bool operator()(const SkRecords::DrawDrawable&) { return true; }
+    template <typename T> bool operator()(const T&) { return false; }
+};
+}  // namespace
+
+static bool reads_other_tiles(sk_sp<const SkPicture> picture) {
+    // Other pictures hold at most one draw, without layers.
+    const SkBigPicture* bigPicture = SkPicturePriv::AsSkBigPicture(std::move(picture));
+    if (!bigPicture) {
+        return false;
+    }
+    const SkRecord* record = bigPicture->record();
+    for (int i = 0; i < record->count(); i++) {
+        if (record->visit(i, ReadsOtherTiles())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SkPicture::playbackTiled(const SkPixmap& dst, const SkMatrix& matrix, SkExecutor* executor,
+                              int tileSize) const {
+    if (tileSize <= 0 || !dst.addr() || !SkSurfaceValidateRasterInfo(dst.info(), dst.rowBytes())) {
+        return false;
+    }
+
+    // Without a BBH every tile would replay the whole picture, so it's cheaper to replay it once.
+    // Pictures whose tiles would read each other's pixels are replayed once too.
+    const SkBigPicture* bigPicture = this->asSkBigPicture();
+    const SkBBoxHierarchy* bbh = bigPicture ? bigPicture->bbh() : nullptr;
+    if (!bbh || reads_other_tiles(sk_ref_sp(this))) {
+        std::unique_ptr<SkCanvas> canvas =
+                SkCanvas::MakeRasterDirect(dst.info(), dst.writable_addr(), dst.rowBytes());
+        SkASSERT(canvas);
+        canvas->drawPicture(this, &matrix, nullptr);
+        return true;
+    }
+
+    struct Tile {
+        SkIRect          fBounds;
+        std::vector<int> fOps;
+    };
+    std::vector<Tile> tiles;
+    for (int y = 0; y < dst.height(); y += tileSize) {
+        for (int x = 0; x < dst.width(); x += tileSize) {
+            SkIRect bounds = SkIRect::MakeXYWH(x, y, tileSize, tileSize);
+            SkAssertResult(bounds.intersect(dst.bounds()));
+            tiles.push_back({bounds, {}});
+        }
+    }
+
+    // We search the BBH once per tile up front, which lets us drop the tiles nothing draws to
+    // and start the busiest tiles first, rather than leave them to the end of the batch.
+    SkMatrix inverse;
+    if (!matrix.invert(&inverse)) {
+        return true;  // Nothing can be drawn, just like playback() through this matrix.
+    }
+    for (Tile& tile : tiles) {
+        // Outset by one in case we are anti-aliasing, as SkCanvas::getLocalClipBounds() does.
+        SkRect query = inverse.mapRect(SkRect::Make(tile.fBounds.makeOutset(1, 1)));
+        bbh->search(query, &tile.fOps);
+    }
+    tiles.erase(std::remove_if(tiles.begin(), tiles.end(),
+                               [](const Tile& tile) { return tile.fOps.empty(); }),
+                tiles.end());
+    std::stable_sort(tiles.begin(), tiles.end(), [](const Tile& a, const Tile& b) {
+        return a.fOps.size() > b.fOps.size();
+    });
+
+    auto drawTile = [&](int i) {
+        const Tile& tile = tiles[i];
+        // Each tile draws into all of dst, clipped to the tile, so that device coordinates, and
+        // with them rounding and dithering, are the same as for a single canvas.
+        std::unique_ptr<SkCanvas> canvas =
+                SkCanvas::MakeRasterDirect(dst.info(), dst.writable_addr(), dst.rowBytes());
+        SkASSERT(canvas);
+        canvas->clipIRect(tile.fBounds);
+        canvas->concat(matrix);
+        bigPicture->playbackOps(canvas.get(), tile.fOps);
+    };
+
+    if (executor) {
+        SkTaskGroup(*executor).batch(SkToInt(tiles.size()), drawTile);
+    } else {
+        for (int i = 0; i < SkToInt(tiles.size()); i++) {
+            drawTile(i);
+        }
+    }
+    return true;
+}
@@ -382,10 +382,18 @@ std::function<void(size_t, size_t, size_t, size_t)> SkRasterPipeline::compile()
         return [](size_t, size_t, size_t, size_t) {};
     }
 
-    void** program = fAlloc->makeArray<void*>(fSlotsNeeded);
-
-    auto start_pipeline = this->build_pipeline(program + fSlotsNeeded);
+    Program program = this->compileProgram();
     return [=](size_t x, size_t y, size_t w, size_t h) {
-        start_pipeline(x,y,x+w,y+h, program);
+        program.run(x,y,w,h);
     };
 }
+
+SkRasterPipeline::Program SkRasterPipeline::compileProgram() const {
+    SkASSERT(!this->empty());
+
+    Program program;
+    program.fSlotCount = fSlotsNeeded;
+    program.fSlots     = fAlloc->makeArray<void*>(fSlotsNeeded);
+    program.fStart     = this->build_pipeline(program.fSlots + fSlotsNeeded);
+    return program;
+}
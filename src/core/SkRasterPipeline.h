@@ -222,6 +222,20 @@ public:
     // Allocates a thunk which amortizes run() setup cost in alloc.
     std::function<void(size_t, size_t, size_t, size_t)> compile() const;
 
+    // The program compile() wraps: fSlotCount slots in alloc holding stage functions and their
+    // contexts, run by fStart. Callers may copy the slots elsewhere and re-point contexts.
+    using StartPipelineFn = void(*)(size_t,size_t,size_t,size_t, void** program);
+    struct Program {
+        StartPipelineFn fStart     = nullptr;
+        void**          fSlots     = nullptr;
+        int             fSlotCount = 0;
+
+        void run(size_t x, size_t y, size_t w, size_t h) const {
+            fStart(x,y,x+w,y+h, fSlots);
+        }
+    };
+    Program compileProgram() const;
+
     void dump() const;
 
     // Appends a stage for the specified matrix.
@@ -260,7 +274,6 @@ private:
         void*      ctx;
     };
 
-    using StartPipelineFn = void(*)(size_t,size_t,size_t,size_t, void** program);
     StartPipelineFn build_pipeline(void**) const;
 
     void unchecked_append(StockStage, void*);
@@ -8,6 +8,7 @@
 #include "include/core/SkColor.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkShader.h"
+#include "include/private/SkMutex.h"
 #include "include/private/SkTo.h"
 #include "src/core/SkArenaAlloc.h"
 #include "src/core/SkBlendModePriv.h"
@@ -15,12 +16,16 @@
 #include "src/core/SkColorFilterBase.h"
 #include "src/core/SkColorSpacePriv.h"
 #include "src/core/SkColorSpaceXformSteps.h"
+#include "src/core/SkCoreBlitters.h"
+#include "src/core/SkLRUCache.h"
 #include "src/core/SkMatrixProvider.h"
 #include "src/core/SkOpts.h"
 #include "src/core/SkRasterPipeline.h"
 #include "src/core/SkUtils.h"
 #include "src/shaders/SkShaderBase.h"
 
+#include <vector>
+
 class SkRasterPipelineBlitter final : public SkBlitter {
 public:
     // This is our common entrypoint for creating the blitter once we've sorted out shaders.
@@ -29,6 +34,11 @@ public:
                              bool is_opaque, bool is_constant,
                              sk_sp<SkShader> clipShader);
 
+    // Creates a blitter for a paint with no shader, color filter or clip shader by copying a
+    // cached prototype, so the color pipeline and blit programs for each such paint, blend and
+    // dst format are built just once rather than on every draw.
+    static SkBlitter* CreateFromPrototype(const SkPixmap&, const SkPaint&, SkArenaAlloc*);
+
     SkRasterPipelineBlitter(SkPixmap dst,
                             SkBlendMode blend,
                             SkArenaAlloc* alloc)
@@ -47,6 +57,20 @@ public:
     void blitV     (int x, int y, int height, SkAlpha alpha)        override;
 
 private:
+    friend class SkRasterPipelineBlitterCache;
+
+    enum BlitProgram {
+        kBlitRect,
+        kBlitAntiH,
+        kBlitMaskA8,
+        kBlitMaskLCD16,
+        kBlitMask3D,
+
+        kBlitProgramCount,
+    };
+    struct Prototype;
+    class PrototypeCache;
+
     void append_load_dst      (SkRasterPipeline*) const;
     void append_store         (SkRasterPipeline*) const;
 
@@ -54,6 +78,9 @@ private:
     void append_clip_scale    (SkRasterPipeline*) const;
     void append_clip_lerp     (SkRasterPipeline*) const;
 
+    void append_blit_stages(BlitProgram, SkRasterPipeline*) const;
+    std::function<void(size_t, size_t, size_t, size_t)> compile_blit(BlitProgram) const;
+
     SkPixmap               fDst;
     SkBlendMode            fBlend;
     SkArenaAlloc*          fAlloc;
@@ -82,9 +109,174 @@ private:
     float fCurrentCoverage = 0.0f;
     float fDitherRate      = 0.0f;
 
+    // Set if we were copied from a prototype, whose programs we relocate rather than build.
+    sk_sp<const Prototype> fPrototype;
+
     using INHERITED = SkBlitter;
 };
 
+// A blitter built once for a constant color, blend and dst format, with all of its blit programs
+// compiled.  Those programs point at its own members (fDstPtr, fMaskPtr, fCurrentCoverage, ...)
+// and at read-only state in fAlloc, so a copy can run them once the pointers into the prototype
+// blitter are moved over to the copy.  Prototypes never change once made, so any thread may use
+// them, and copies keep them alive.
+struct SkRasterPipelineBlitter::Prototype : public SkNVRefCnt<Prototype> {
+    // A program slot that points at a member of fBlitter, at fOffset bytes into it.
+    struct Relocation {
+        int    fSlot;
+        size_t fOffset;
+    };
+
+    SkSTArenaAlloc<2048>      fAlloc;
+    SkRasterPipelineBlitter*  fBlitter = nullptr;   // in fAlloc, with a dst without pixels
+    SkRasterPipeline::Program fPrograms[kBlitProgramCount];
+    std::vector<Relocation>   fRelocations[kBlitProgramCount];
+
+    static sk_sp<const Prototype> Make(const SkImageInfo& dstInfo, const SkPaint& paint,
+                                       const SkPMColor4f& premulColor) {
+        auto proto = sk_make_sp<Prototype>();
+
+        SkRasterPipeline_<256> shaderPipeline;
+        shaderPipeline.append_constant_color(&proto->fAlloc, premulColor.vec());
+        SkBlitter* blitter = Create(SkPixmap(dstInfo, nullptr, dstInfo.minRowBytes()), paint,
+                                    &proto->fAlloc, shaderPipeline,
+                                    /*is_opaque=*/premulColor.fA == 1.0f, /*is_constant=*/true,
+                                    /*clipShader=*/nullptr);
+        if (!blitter) {
+            return nullptr;
+        }
+        proto->fBlitter = static_cast<SkRasterPipelineBlitter*>(blitter);
+
+        for (int i = 0; i < kBlitProgramCount; ++i) {
+            SkRasterPipeline p(&proto->fAlloc);
+            proto->fBlitter->append_blit_stages((BlitProgram)i, &p);
+            proto->fPrograms[i] = p.compileProgram();
+            proto->fRelocations[i] = FindRelocations(*proto->fBlitter, proto->fPrograms[i]);
+        }
+        return proto;
+    }
+
+    // Finds the slots of program that are contexts of the blitter's own members, which are the
+    // only contexts append_blit_stages() takes from the blitter.  Contexts elsewhere live in the
+    // arena, and function pointers in code, so neither can be the address of one of these.
+    static std::vector<Relocation> FindRelocations(const SkRasterPipelineBlitter& blitter,
+                                                   const SkRasterPipeline::Program& program) {
+        SkASSERT(!blitter.fClipShaderBuffer);
+        const void* members[] = {
+            &blitter.fDstPtr,
+            &blitter.fMaskPtr,
+            &blitter.fEmbossCtx,
+            &blitter.fCurrentCoverage,
+            &blitter.fDitherRate,
+        };
+        const char* start = (const char*)&blitter;
+        std::vector<Relocation> relocations;
+        for (int i = 0; i < program.fSlotCount; ++i) {
+            const char* slot = (const char*)program.fSlots[i];
+            bool relocated = false;
+            for (const void* member : members) {
+                if (slot == member) {
+                    relocations.push_back({i, SkToSizeT(slot - start)});
+                    relocated = true;
+                    break;
+                }
+            }
+            // Anything else pointing into the blitter would be left pointing at the prototype.
+            SkASSERT(relocated || slot < start || slot >= start + sizeof(SkRasterPipelineBlitter));
+        }
+        return relocations;
+    }
+
+    // Copies one of our programs into alloc for copy, a blitter made from our fBlitter.
+    std::function<void(size_t, size_t, size_t, size_t)> relocate(
+            BlitProgram which, const SkRasterPipelineBlitter* copy, SkArenaAlloc* alloc) const {
+        const SkRasterPipeline::Program& src = fPrograms[which];
+
+        SkRasterPipeline::Program program = src;
+        program.fSlots = alloc->makeArrayDefault<void*>(src.fSlotCount);
+        memcpy(program.fSlots, src.fSlots, src.fSlotCount * sizeof(void*));
+        for (const Relocation& relocation : fRelocations[which]) {
+            program.fSlots[relocation.fSlot] = (char*)copy + relocation.fOffset;
+        }
+        return [program](size_t x, size_t y, size_t w, size_t h) {
+            program.run(x,y,w,h);
+        };
+    }
+};
+
+// Prototypes are shared by every thread through one small LRU cache.
+class SkRasterPipelineBlitter::PrototypeCache {
+public:
+    static PrototypeCache* Get() {
+        static PrototypeCache* cache = new PrototypeCache;
+        return cache;
+    }
+
+    SK_BEGIN_REQUIRE_DENSE;
+    struct Key {
+        float    color[4];      // the paint's unpremul sRGB color
+        uint64_t colorSpace;    // dst color space hash, if hasColorSpace
+        uint8_t  colorType,
+                 alphaType,
+                 blendMode,
+                 hasColorSpace;
+        uint32_t padding{0};
+
+        bool operator==(const Key& that) const {
+            return 0 == memcmp(this, &that, sizeof(Key));
+        }
+    };
+    SK_END_REQUIRE_DENSE;
+
+    template <typename Fn>
+    sk_sp<const Prototype> findOrBuild(const Key& key, Fn&& build) {
+        {
+            SkAutoMutexExclusive lock(fMutex);
+            if (sk_sp<const Prototype>* found = fPrototypes.find(key)) {
+                fHits++;
+                return *found;
+            }
+        }
+
+        // Build outside the lock; if another thread races us here, the last one in wins.
+        sk_sp<const Prototype> proto = build();
+
+        SkAutoMutexExclusive lock(fMutex);
+        fMisses++;
+        if (proto) {
+            fPrototypes.insert_or_update(key, proto);
+        }
+        return proto;
+    }
+
+    SkRasterPipelineBlitterCache::Stats stats() {
+        SkAutoMutexExclusive lock(fMutex);
+        return { fPrototypes.count(), fHits, fMisses };
+    }
+
+    void purge() {
+        SkAutoMutexExclusive lock(fMutex);
+        fPrototypes.reset();
+    }
+
+private:
+    // Each prototype is a few KB.
+    static constexpr int kMaxPrototypes = 128;
+
+    SkMutex fMutex;
+    SkLRUCache<Key, sk_sp<const Prototype>> fPrototypes SK_GUARDED_BY(fMutex){kMaxPrototypes};
+    int64_t fHits   SK_GUARDED_BY(fMutex) = 0,
+            fMisses SK_GUARDED_BY(fMutex) = 0;
+};
+
+SkRasterPipelineBlitterCache::Stats SkRasterPipelineBlitterCache::GetStats() {
+    return SkRasterPipelineBlitter::PrototypeCache::Get()->stats();
+}
+
+void SkRasterPipelineBlitterCache::Purge() {
+    SkRasterPipelineBlitter::PrototypeCache::Get()->purge();
+}
+
 SkBlitter* SkCreateRasterPipelineBlitter(const SkPixmap& dst,
                                          const SkPaint& paint,
                                          const SkMatrixProvider& matrixProvider,
@@ -95,14 +287,18 @@ SkBlitter* SkCreateRasterPipelineBlitter(const SkPixmap& dst,
         return nullptr;
     }
 
+    auto shader = as_SB(paint.getShader());
+
+    if (!shader && !paint.getColorFilter() && !clipShader) {
+        return SkRasterPipelineBlitter::CreateFromPrototype(dst, paint, alloc);
+    }
+
     SkColorSpace* dstCS = dst.colorSpace();
     SkColorType dstCT = dst.colorType();
     SkColor4f paintColor = paint.getColor4f();
     SkColorSpaceXformSteps(sk_srgb_singleton(), kUnpremul_SkAlphaType,
                            dstCS,               kUnpremul_SkAlphaType).apply(paintColor.vec());
 
-    auto shader = as_SB(paint.getShader());
-
     SkRasterPipeline_<256> shaderPipeline;
     if (!shader) {
         // Having no shader makes things nice and easy... just use the paint color.
@@ -144,6 +340,42 @@ SkBlitter* SkCreateRasterPipelineBlitter(const SkPixmap& dst,
                                            clipShader);
 }
 
+SkBlitter* SkRasterPipelineBlitter::CreateFromPrototype(const SkPixmap& dst,
+                                                        const SkPaint& paint,
+                                                        SkArenaAlloc* alloc) {
+    SkASSERT(!paint.getShader() && !paint.getColorFilter());
+
+    PrototypeCache::Key key;
+    memcpy(key.color, paint.getColor4f().vec(), sizeof(key.color));
+    key.colorSpace    = dst.colorSpace() ? dst.colorSpace()->hash() : 0;
+    key.colorType     = SkToU8(dst.colorType());
+    key.alphaType     = SkToU8(dst.alphaType());
+    key.blendMode     = SkToU8(paint.getBlendMode());
+    key.hasColorSpace = dst.colorSpace() != nullptr;
+
+    sk_sp<const Prototype> proto = PrototypeCache::Get()->findOrBuild(key, [&] {
+        SkColor4f paintColor = paint.getColor4f();
+        SkColorSpaceXformSteps(sk_srgb_singleton(), kUnpremul_SkAlphaType,
+                               dst.colorSpace(),    kUnpremul_SkAlphaType).apply(paintColor.vec());
+        return Prototype::Make(dst.info(), paint, paintColor.premul());
+    });
+    if (!proto) {
+        return nullptr;
+    }
+
+    const SkRasterPipelineBlitter* src = proto->fBlitter;
+    auto blitter = alloc->make<SkRasterPipelineBlitter>(dst, src->fBlend, alloc);
+    blitter->fDitherRate  = src->fDitherRate;
+    blitter->fMemset2D    = src->fMemset2D;
+    blitter->fMemsetColor = src->fMemsetColor;
+    blitter->fDstPtr = SkRasterPipeline_MemoryCtx{
+        blitter->fDst.writable_addr(),
+        blitter->fDst.rowBytesAsPixels(),
+    };
+    blitter->fPrototype = std::move(proto);
+    return blitter;
+}
+
 SkBlitter* SkRasterPipelineBlitter::Create(const SkPixmap& dst,
                                            const SkPaint& paint,
                                            SkArenaAlloc* alloc,
@@ -320,6 +552,101 @@ void SkRasterPipelineBlitter::append_clip_lerp(SkRasterPipeline* p) const {
     }
 }
 
+// Appends the full pipeline for one kind of blit, from fColorPipeline through to the dst.
+void SkRasterPipelineBlitter::append_blit_stages(BlitProgram which, SkRasterPipeline* p) const {
+    p->extend(fColorPipeline);
+    if (which == kBlitMask3D) {
+        // This bit is where we differ from kA8_Format:
+        p->append(SkRasterPipeline::emboss, &fEmbossCtx);
+        // Now onward just as kA8.
+    }
+    p->append_gamut_clamp_if_normalized(fDst.info());
+
+    switch (which) {
+        case kBlitRect:
+            if (fBlend == SkBlendMode::kSrcOver
+                    && (fDst.info().colorType() == kRGBA_8888_SkColorType ||
+                        fDst.info().colorType() == kBGRA_8888_SkColorType)
+                    && !fDst.colorSpace()
+                    && fDst.info().alphaType() != kUnpremul_SkAlphaType
+                    && fDitherRate == 0.0f) {
+                if (fDst.info().colorType() == kBGRA_8888_SkColorType) {
+                    p->append(SkRasterPipeline::swap_rb);
+                }
+                this->append_clip_scale(p);
+                p->append(SkRasterPipeline::srcover_rgba_8888, &fDstPtr);
+                return;
+            }
+            if (fBlend != SkBlendMode::kSrc) {
+                this->append_load_dst(p);
+                SkBlendMode_AppendStages(fBlend, p);
+                this->append_clip_lerp(p);
+            } else if (fClipShaderBuffer) {
+                this->append_load_dst(p);
+                this->append_clip_lerp(p);
+            }
+            break;
+
+        case kBlitAntiH:
+            if (SkBlendMode_ShouldPreScaleCoverage(fBlend, /*rgb_coverage=*/false)) {
+                p->append(SkRasterPipeline::scale_1_float, &fCurrentCoverage);
+                this->append_clip_scale(p);
+                this->append_load_dst(p);
+                SkBlendMode_AppendStages(fBlend, p);
+            } else {
+                this->append_load_dst(p);
+                SkBlendMode_AppendStages(fBlend, p);
+                p->append(SkRasterPipeline::lerp_1_float, &fCurrentCoverage);
+                this->append_clip_lerp(p);
+            }
+            break;
+
+        case kBlitMaskA8:
+        case kBlitMask3D:
+            if (SkBlendMode_ShouldPreScaleCoverage(fBlend, /*rgb_coverage=*/false)) {
+                p->append(SkRasterPipeline::scale_u8, &fMaskPtr);
+                this->append_clip_scale(p);
+                this->append_load_dst(p);
+                SkBlendMode_AppendStages(fBlend, p);
+            } else {
+                this->append_load_dst(p);
+                SkBlendMode_AppendStages(fBlend, p);
+                p->append(SkRasterPipeline::lerp_u8, &fMaskPtr);
+                this->append_clip_lerp(p);
+            }
+            break;
+
+        case kBlitMaskLCD16:
+            if (SkBlendMode_ShouldPreScaleCoverage(fBlend, /*rgb_coverage=*/true)) {
+                // Somewhat unusually, scale_565 needs dst loaded first.
+                this->append_load_dst(p);
+                p->append(SkRasterPipeline::scale_565, &fMaskPtr);
+                this->append_clip_scale(p);
+                SkBlendMode_AppendStages(fBlend, p);
+            } else {
+                this->append_load_dst(p);
+                SkBlendMode_AppendStages(fBlend, p);
+                p->append(SkRasterPipeline::lerp_565, &fMaskPtr);
+                this->append_clip_lerp(p);
+            }
+            break;
+
+        case kBlitProgramCount:
+            SkUNREACHABLE;
+    }
+    this->append_store(p);
+}
+
+std::function<void(size_t, size_t, size_t, size_t)> SkRasterPipelineBlitter::compile_blit(
+        BlitProgram which) const {
+    if (fPrototype) {
+        return fPrototype->relocate(which, this, fAlloc);
+    }
+    SkRasterPipeline p(fAlloc);
+    this->append_blit_stages(which, &p);
+    return p.compile();
+}
+
 void SkRasterPipelineBlitter::blitH(int x, int y, int w) {
     this->blitRect(x,y,w,1);
 }
@@ -331,32 +658,7 @@ void SkRasterPipelineBlitter::blitRect(int x, int y, int w, int h) {
     }
 
     if (!fBlitRect) {
-        SkRasterPipeline p(fAlloc);
-        p.extend(fColorPipeline);
-        p.append_gamut_clamp_if_normalized(fDst.info());
-        if (fBlend == SkBlendMode::kSrcOver
-                && (fDst.info().colorType() == kRGBA_8888_SkColorType ||
-                    fDst.info().colorType() == kBGRA_8888_SkColorType)
-                && !fDst.colorSpace()
-                && fDst.info().alphaType() != kUnpremul_SkAlphaType
-                && fDitherRate == 0.0f) {
-            if (fDst.info().colorType() == kBGRA_8888_SkColorType) {
-                p.append(SkRasterPipeline::swap_rb);
-            }
-            this->append_clip_scale(&p);
-            p.append(SkRasterPipeline::srcover_rgba_8888, &fDstPtr);
-        } else {
-            if (fBlend != SkBlendMode::kSrc) {
-                this->append_load_dst(&p);
-                SkBlendMode_AppendStages(fBlend, &p);
-                this->append_clip_lerp(&p);
-            } else if (fClipShaderBuffer) {
-                this->append_load_dst(&p);
-                this->append_clip_lerp(&p);
-            }
-            this->append_store(&p);
-        }
-        fBlitRect = p.compile();
+        fBlitRect = this->compile_blit(kBlitRect);
     }
 
     fBlitRect(x,y,w,h);
@@ -364,23 +666,7 @@ void SkRasterPipelineBlitter::blitRect(int x, int y, int w, int h) {
 
 void SkRasterPipelineBlitter::blitAntiH(int x, int y, const SkAlpha aa[], const int16_t runs[]) {
     if (!fBlitAntiH) {
-        SkRasterPipeline p(fAlloc);
-        p.extend(fColorPipeline);
-        p.append_gamut_clamp_if_normalized(fDst.info());
-        if (SkBlendMode_ShouldPreScaleCoverage(fBlend, /*rgb_coverage=*/false)) {
-            p.append(SkRasterPipeline::scale_1_float, &fCurrentCoverage);
-            this->append_clip_scale(&p);
-            this->append_load_dst(&p);
-            SkBlendMode_AppendStages(fBlend, &p);
-        } else {
-            this->append_load_dst(&p);
-            SkBlendMode_AppendStages(fBlend, &p);
-            p.append(SkRasterPipeline::lerp_1_float, &fCurrentCoverage);
-            this->append_clip_lerp(&p);
-        }
-
-        this->append_store(&p);
-        fBlitAntiH = p.compile();
+        fBlitAntiH = this->compile_blit(kBlitAntiH);
     }
 
     for (int16_t run = *runs; run > 0; run = *runs) {
@@ -471,62 +757,13 @@ void SkRasterPipelineBlitter::blitMask(const SkMask& mask, const SkIRect& clip)
 
     // Lazily build whichever pipeline we need, specialized for each mask format.
     if (mask.fFormat == SkMask::kA8_Format && !fBlitMaskA8) {
-        SkRasterPipeline p(fAlloc);
-        p.extend(fColorPipeline);
-        p.append_gamut_clamp_if_normalized(fDst.info());
-        if (SkBlendMode_ShouldPreScaleCoverage(fBlend, /*rgb_coverage=*/false)) {
-            p.append(SkRasterPipeline::scale_u8, &fMaskPtr);
-            this->append_clip_scale(&p);
-            this->append_load_dst(&p);
-            SkBlendMode_AppendStages(fBlend, &p);
-        } else {
-            this->append_load_dst(&p);
-            SkBlendMode_AppendStages(fBlend, &p);
-            p.append(SkRasterPipeline::lerp_u8, &fMaskPtr);
-            this->append_clip_lerp(&p);
-        }
-        this->append_store(&p);
-        fBlitMaskA8 = p.compile();
+        fBlitMaskA8 = this->compile_blit(kBlitMaskA8);
     }
     if (mask.fFormat == SkMask::kLCD16_Format && !fBlitMaskLCD16) {
-        SkRasterPipeline p(fAlloc);
-        p.extend(fColorPipeline);
-        p.append_gamut_clamp_if_normalized(fDst.info());
-        if (SkBlendMode_ShouldPreScaleCoverage(fBlend, /*rgb_coverage=*/true)) {
-            // Somewhat unusually, scale_565 needs dst loaded first.
-            this->append_load_dst(&p);
-            p.append(SkRasterPipeline::scale_565, &fMaskPtr);
-            this->append_clip_scale(&p);
-            SkBlendMode_AppendStages(fBlend, &p);
-        } else {
-            this->append_load_dst(&p);
-            SkBlendMode_AppendStages(fBlend, &p);
-            p.append(SkRasterPipeline::lerp_565, &fMaskPtr);
-            this->append_clip_lerp(&p);
-        }
-        this->append_store(&p);
-        fBlitMaskLCD16 = p.compile();
+        fBlitMaskLCD16 = this->compile_blit(kBlitMaskLCD16);
     }
     if (mask.fFormat == SkMask::k3D_Format && !fBlitMask3D) {
-        SkRasterPipeline p(fAlloc);
-        p.extend(fColorPipeline);
-        // This bit is where we differ from kA8_Format:
-        p.append(SkRasterPipeline::emboss, &fEmbossCtx);
-        // Now onward just as kA8.
-        p.append_gamut_clamp_if_normalized(fDst.info());
-        if (SkBlendMode_ShouldPreScaleCoverage(fBlend, /*rgb_coverage=*/false)) {
-            p.append(SkRasterPipeline::scale_u8, &fMaskPtr);
-            this->append_clip_scale(&p);
-            this->append_load_dst(&p);
-            SkBlendMode_AppendStages(fBlend, &p);
-        } else {
-            this->append_load_dst(&p);
-            SkBlendMode_AppendStages(fBlend, &p);
-            p.append(SkRasterPipeline::lerp_u8, &fMaskPtr);
-            this->append_clip_lerp(&p);
-        }
-        this->append_store(&p);
-        fBlitMask3D = p.compile();
+        fBlitMask3D = this->compile_blit(kBlitMask3D);
     }
 
     std::function<void(size_t,size_t,size_t,size_t)>* blitter = nullptr;
@@ -25,11 +25,19 @@ typedef SkIRect SkXRect;
 
 extern std::atomic<bool> gSkUseAnalyticAA;
 extern std::atomic<bool> gSkForceAnalyticAA;
+extern std::atomic<bool> gSkForceCoverageAA;  // Coverage accumulation AA, see SkScan_CAAPath.cpp
 
 class AdditiveBlitter;
 
 class SkScan {
 public:
+    /**
+     *  Edge builders that FillPath() and AntiFillPath() can reuse from one call to the next,
+     *  so scan converting a batch of paths (see SkDraw::drawPaths()) doesn't set up fresh edge
+     *  storage for every path. Defined in SkScanPriv.h.
+     */
+    struct EdgeBuilders;
+
     /*
      *  Draws count-1 line segments, one at a time:
      *      line(pts[0], pts[1])
@@ -51,6 +59,8 @@ public:
     static void AntiFillXRect(const SkXRect&, const SkRasterClip&, SkBlitter*);
     static void FillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
     static void AntiFillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
+    static void FillPath(const SkPath&, const SkRasterClip&, SkBlitter*, EdgeBuilders*);
+    static void AntiFillPath(const SkPath&, const SkRasterClip&, SkBlitter*, EdgeBuilders*);
     static void FrameRect(const SkRect&, const SkPoint& strokeSize,
                           const SkRasterClip&, SkBlitter*);
     static void AntiFrameRect(const SkRect&, const SkPoint& strokeSize,
@@ -68,7 +78,8 @@ public:
     static void AntiHairRoundPath(const SkPath&, const SkRasterClip&, SkBlitter*);
 
     // Needed by do_fill_path in SkScanPriv.h
-    static void FillPath(const SkPath&, const SkRegion& clip, SkBlitter*);
+    static void FillPath(const SkPath&, const SkRegion& clip, SkBlitter*,
+                         EdgeBuilders* = nullptr);
 
 private:
     friend class SkAAClip;
@@ -79,7 +90,8 @@ private:
     static void FillRect(const SkRect&, const SkRegion* clip, SkBlitter*);
     static void AntiFillRect(const SkRect&, const SkRegion* clip, SkBlitter*);
     static void AntiFillXRect(const SkXRect&, const SkRegion*, SkBlitter*);
-    static void AntiFillPath(const SkPath&, const SkRegion& clip, SkBlitter*, bool forceRLE);
+    static void AntiFillPath(const SkPath&, const SkRegion& clip, SkBlitter*, bool forceRLE,
+                             EdgeBuilders* = nullptr);
     static void FillTriangle(const SkPoint pts[], const SkRegion*, SkBlitter*);
 
     static void AntiFrameRect(const SkRect&, const SkPoint& strokeSize,
@@ -87,8 +99,10 @@ private:
     static void HairLineRgn(const SkPoint[], int count, const SkRegion*, SkBlitter*);
     static void AntiHairLineRgn(const SkPoint[], int count, const SkRegion*, SkBlitter*);
     static void AAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& pathIR,
-                            const SkIRect& clipBounds, bool forceRLE);
+                            const SkIRect& clipBounds, bool forceRLE, EdgeBuilders*);
     static void SAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& pathIR,
+                            const SkIRect& clipBounds, bool forceRLE, EdgeBuilders*);
+    static void CAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& pathIR,
                             const SkIRect& clipBounds, bool forceRLE);
 };
 
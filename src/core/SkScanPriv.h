@@ -10,11 +10,18 @@
 
 #include "include/core/SkPath.h"
 #include "src/core/SkBlitter.h"
+#include "src/core/SkEdgeBuilder.h"
 #include "src/core/SkScan.h"
 
 // controls how much we super-sample (when we use that scan convertion)
 #define SK_SUPERSAMPLE_SHIFT    2
 
+struct SkScan::EdgeBuilders {
+    SkBasicEdgeBuilder    fAliased{0};
+    SkBasicEdgeBuilder    fSupersampled{SK_SUPERSAMPLE_SHIFT};
+    SkAnalyticEdgeBuilder fAnalytic;
+};
+
 class SkScanClipper {
 public:
     SkScanClipper(SkBlitter* blitter, const SkRegion* clip, const SkIRect& bounds,
@@ -33,9 +40,11 @@ private:
     const SkIRect*      fClipRect;
 };
 
+// If builder is non-null it must have been made with shiftEdgesUp, and is used instead of a
+// fresh one on the stack.
 void sk_fill_path(const SkPath& path, const SkIRect& clipRect,
                   SkBlitter* blitter, int start_y, int stop_y, int shiftEdgesUp,
-                  bool pathContainedInClip);
+                  bool pathContainedInClip, SkBasicEdgeBuilder* builder = nullptr);
 
 // blit the rects above and below avoid, clipped to clip
 void sk_blit_above(SkBlitter*, const SkIRect& avoid, const SkRegion& clip);
@@ -20,12 +20,14 @@
 #include "src/core/SkRasterClip.h"
 #include "src/core/SkScan.h"
 #include "src/core/SkScanPriv.h"
+#include "src/core/SkTLazy.h"
 #include "src/core/SkTSort.h"
 
 #include <utility>
 
 #if defined(SK_DISABLE_AAA)
-void SkScan::AAAFillPath(const SkPath&, SkBlitter*, const SkIRect&, const SkIRect&, bool) {
+void SkScan::AAAFillPath(const SkPath&, SkBlitter*, const SkIRect&, const SkIRect&, bool,
+                         EdgeBuilders*) {
     SkDEBUGFAIL("AAA Disabled");
     return;
 }
@@ -1845,10 +1847,12 @@ static SK_ALWAYS_INLINE void aaa_fill_path(
         int              stop_y,
         bool             pathContainedInClip,
         bool             isUsingMask,
-        bool             forceRLE) {  // forceRLE implies that SkAAClip is calling us
+        bool             forceRLE,  // forceRLE implies that SkAAClip is calling us
+        SkAnalyticEdgeBuilder* sharedBuilder) {
     SkASSERT(blitter);
 
-    SkAnalyticEdgeBuilder builder;
+    SkTLazy<SkAnalyticEdgeBuilder> localBuilder;
+    SkAnalyticEdgeBuilder& builder = sharedBuilder ? *sharedBuilder : *localBuilder.init();
     int              count = builder.buildEdges(path, pathContainedInClip ? nullptr : &clipRect);
     SkAnalyticEdge** list  = builder.analyticEdgeList();
 
@@ -1951,9 +1955,11 @@ void SkScan::AAAFillPath(const SkPath&  path,
                          SkBlitter*     blitter,
                          const SkIRect& ir,
                          const SkIRect& clipBounds,
-                         bool           forceRLE) {
+                         bool           forceRLE,
+                         EdgeBuilders*  edges) {
     bool containedInClip = clipBounds.contains(ir);
     bool isInverse       = path.isInverseFillType();
+    SkAnalyticEdgeBuilder* builder = edges ? &edges->fAnalytic : nullptr;
 
     // The mask blitter (where we store intermediate alpha values directly in a mask, and then call
     // the real blitter once in the end to blit the whole mask) is faster than the RLE blitter when
@@ -1974,7 +1980,8 @@ void SkScan::AAAFillPath(const SkPath&  path,
                           ir.fBottom,
                           containedInClip,
                           true,
-                          forceRLE);
+                          forceRLE,
+                          builder);
         }
     } else if (!isInverse && path.isConvex()) {
         // If the filling area is convex (i.e., path.isConvex && !isInverse), our simpler
@@ -1989,7 +1996,8 @@ void SkScan::AAAFillPath(const SkPath&  path,
                       ir.fBottom,
                       containedInClip,
                       false,
-                      forceRLE);
+                      forceRLE,
+                      builder);
     } else {
         // If the filling area might not be convex, the more involved aaa_walk_edges would
         // be called and we have to clamp the alpha downto 255. The SafeRLEAdditiveBlitter
@@ -2002,7 +2010,8 @@ void SkScan::AAAFillPath(const SkPath&  path,
                       ir.fBottom,
                       containedInClip,
                       false,
-                      forceRLE);
+                      forceRLE,
+                      builder);
     }
 }
 #endif  // defined(SK_DISABLE_AAA)
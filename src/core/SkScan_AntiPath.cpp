@@ -672,19 +672,22 @@ static bool ShouldUseAAA(const SkPath& path, SkScalar avgLength, SkScalar comple
 }
 
 void SkScan::SAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& ir,
-                  const SkIRect& clipBounds, bool forceRLE) {
+                  const SkIRect& clipBounds, bool forceRLE, EdgeBuilders* edges) {
     bool containedInClip = clipBounds.contains(ir);
     bool isInverse = path.isInverseFillType();
+    SkBasicEdgeBuilder* builder = edges ? &edges->fSupersampled : nullptr;
 
     // MaskSuperBlitter can't handle drawing outside of ir, so we can't use it
     // if we're an inverse filltype
     if (!isInverse && MaskSuperBlitter::CanHandleRect(ir) && !forceRLE) {
         MaskSuperBlitter superBlit(blitter, ir, clipBounds, isInverse);
         SkASSERT(SkIntToScalar(ir.fTop) <= path.getBounds().fTop);
-        sk_fill_path(path, clipBounds, &superBlit, ir.fTop, ir.fBottom, SHIFT, containedInClip);
+        sk_fill_path(path, clipBounds, &superBlit, ir.fTop, ir.fBottom, SHIFT, containedInClip,
+                     builder);
     } else {
         SuperBlitter superBlit(blitter, ir, clipBounds, isInverse);
-        sk_fill_path(path, clipBounds, &superBlit, ir.fTop, ir.fBottom, SHIFT, containedInClip);
+        sk_fill_path(path, clipBounds, &superBlit, ir.fTop, ir.fBottom, SHIFT, containedInClip,
+                     builder);
     }
 }
 
@@ -712,7 +715,7 @@ static int rect_overflows_short_shift(SkIRect rect, int shift) {
 }
 
 void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
-                          SkBlitter* blitter, bool forceRLE) {
+                          SkBlitter* blitter, bool forceRLE, EdgeBuilders* edges) {
     if (origClip.isEmpty()) {
         return;
     }
@@ -740,7 +743,7 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
        }
     }
     if (rect_overflows_short_shift(clippedIR, SHIFT)) {
-        SkScan::FillPath(path, origClip, blitter);
+        SkScan::FillPath(path, origClip, blitter, edges);
         return;
     }
 
@@ -785,12 +788,14 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
     SkScalar avgLength, complexity;
     compute_complexity(path, avgLength, complexity);
 
-    if (ShouldUseAAA(path, avgLength, complexity)) {
+    if (gSkForceCoverageAA) {
+        SkScan::CAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE);
+    } else if (ShouldUseAAA(path, avgLength, complexity)) {
         // Do not use AAA if path is too complicated:
         // there won't be any speedup or significant visual improvement.
-        SkScan::AAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE);
+        SkScan::AAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE, edges);
     } else {
-        SkScan::SAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE);
+        SkScan::SAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE, edges);
     }
 
     if (isInverse) {
@@ -803,35 +808,46 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
 #include "src/core/SkRasterClip.h"
 
 void SkScan::FillPath(const SkPath& path, const SkRasterClip& clip, SkBlitter* blitter) {
+    FillPath(path, clip, blitter, nullptr);
+}
+
+void SkScan::FillPath(const SkPath& path, const SkRasterClip& clip, SkBlitter* blitter,
+                      EdgeBuilders* edges) {
     if (clip.isEmpty() || !path.isFinite()) {
         return;
     }
 
     if (clip.isBW()) {
-        FillPath(path, clip.bwRgn(), blitter);
+        FillPath(path, clip.bwRgn(), blitter, edges);
     } else {
         SkRegion        tmp;
         SkAAClipBlitter aaBlitter;
 
         tmp.setRect(clip.getBounds());
         aaBlitter.init(blitter, &clip.aaRgn());
-        SkScan::FillPath(path, tmp, &aaBlitter);
+        SkScan::FillPath(path, tmp, &aaBlitter, edges);
     }
 }
 
 void SkScan::AntiFillPath(const SkPath& path, const SkRasterClip& clip, SkBlitter* blitter) {
+    AntiFillPath(path, clip, blitter, nullptr);
+}
+
+void SkScan::AntiFillPath(const SkPath& path, const SkRasterClip& clip, SkBlitter* blitter,
+                          EdgeBuilders* edges) {
     if (clip.isEmpty() || !path.isFinite()) {
         return;
     }
 
     if (clip.isBW()) {
-        AntiFillPath(path, clip.bwRgn(), blitter, false);
+        AntiFillPath(path, clip.bwRgn(), blitter, false, edges);
     } else {
         SkRegion        tmp;
         SkAAClipBlitter aaBlitter;
 
         tmp.setRect(clip.getBounds());
         aaBlitter.init(blitter, &clip.aaRgn());
-        AntiFillPath(path, tmp, &aaBlitter, true); // SkAAClipBlitter can blitMask, why forceRLE?
+        // SkAAClipBlitter can blitMask, why forceRLE?
+        AntiFillPath(path, tmp, &aaBlitter, true, edges);
     }
 }
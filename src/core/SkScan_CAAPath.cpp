@@ -0,0 +1,500 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkPath.h"
+#include "include/private/SkTArray.h"
+#include "include/private/SkTemplates.h"
+#include "include/private/SkVx.h"
+#include "src/core/SkBlitter.h"
+#include "src/core/SkGeometry.h"
+#include "src/core/SkPathPriv.h"
+#include "src/core/SkScan.h"
+#include "src/core/SkTSort.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    #include <emmintrin.h>
+#endif
+
+/*
+ *  Coverage accumulation AA ("CAA").
+ *
+ *  Instead of walking sorted edges the way supersampling (SAA) and analytic AA (AAA) do, we
+ *  flatten the path into lines and let each line deposit its signed area into a float buffer,
+ *  one slot per pixel, like a sparse-scanline rasterizer.  A running sum along a row then turns
+ *  those deposits into winding-weighted coverage.  The running sum, the fill rule and the
+ *  conversion to alpha run four pixels at a time, stretches of a row no line touched are
+ *  skipped as a single run, and each row reaches the blitter as a single blitAntiH() call.
+ *
+ *  The work is proportional to the area the edges cross rather than to the number of edges per
+ *  scanline, so this does best on small, dense or self-intersecting paths, and worst on large
+ *  simple ones, where SAA and AAA only touch the edges of each span.
+ *
+ *  Coverage is exact wherever a pixel is crossed by a single edge.  Where several edges of the
+ *  same path cross one pixel their areas add up before the fill rule is applied, the usual
+ *  approximation made by accumulation rasterizers; it's roughest for even-odd fills.
+ */
+
+namespace {
+
+using F4 = skvx::Vec<4, float>;
+
+// Rows we accumulate before flushing them to the blitter.  Lines are only walked once per band.
+static constexpr int kBandHeight = 16;
+
+// Maximum distance between a curve and the lines we flatten it into, in pixels.
+static constexpr float kFlattenTolerance = 0.05f;
+static constexpr int   kMaxCurveLines    = 128;
+
+struct Line {
+    float fX0, fY0, fX1, fY1;   // fY0 < fY1
+    float fDir;                 // +1 if the original line went down, -1 if it went up.
+};
+
+// Rows are split into cells of kCellWidth pixels, and we only look at the pixels of a cell if
+// some line deposited area in it.
+static constexpr int kCellShift = 4;
+static constexpr int kCellWidth = 1 << kCellShift;
+
+struct Band {
+    float*   fAcc;                  // fRowStride floats of area per row
+    uint8_t* fTouched;              // fCellsPerRow flags per row
+    int      fRowStride,
+             fCellsPerRow;
+    int      fMin[kBandHeight],     // leftmost and rightmost column touched in each row
+             fMax[kBandHeight];
+};
+
+class CoverageAccumulator {
+public:
+    // Accumulates into a window of width x height pixels.  Lines are given in window coordinates.
+    CoverageAccumulator(int width, int height) : fWidth(width), fHeight(height) {}
+
+    void addLine(SkPoint p0, SkPoint p1);
+    void addQuad(const SkPoint pts[3]);
+    void addCubic(const SkPoint pts[4]);
+
+    void blit(SkBlitter*, int left, int top, SkPathFillType);
+
+private:
+    void addClippedLine(float x0, float y0, float x1, float y1);
+    void accumulate(const Line&, Band*, int bandTop, int bandBottom) const;
+
+    const int fWidth, fHeight;
+    SkSTArray<32, Line, true> fLines;
+};
+
+void CoverageAccumulator::addLine(SkPoint p0, SkPoint p1) {
+    if (p0.fY == p1.fY) {
+        return;     // Horizontal lines don't contribute any area.
+    }
+
+    // Trim the line to [0, fHeight]; rows outside the window are simply never drawn.
+    float t0 = 0, t1 = 1;
+    const float dx = p1.fX - p0.fX,
+                dy = p1.fY - p0.fY;
+    auto clipT = [&](float y) { return (y - p0.fY) / dy; };
+    if (dy > 0) {
+        t0 = std::max(t0, clipT(0));
+        t1 = std::min(t1, clipT((float)fHeight));
+    } else {
+        t0 = std::max(t0, clipT((float)fHeight));
+        t1 = std::min(t1, clipT(0));
+    }
+    if (!(t0 < t1)) {
+        return;
+    }
+
+    // Then split it where it crosses x = 0 or x = fWidth.  Pieces to the left of the window still
+    // change the winding of everything to their right, so they become vertical lines on x = 0.
+    // Pieces to the right of the window become vertical lines on x = fWidth, which touch no pixel
+    // we draw but do tell blit() how far along the row coverage may extend.
+    float ts[4] = { t0, t1, t1, t1 };
+    int n = 1;
+    for (float x : { 0.0f, (float)fWidth }) {
+        float t = dx != 0 ? (x - p0.fX) / dx : -1;
+        if (t0 < t && t < t1) {
+            ts[n++] = t;
+        }
+    }
+    std::sort(ts + 1, ts + n);
+    ts[n] = t1;
+
+    for (int i = 0; i < n; ++i) {
+        float ta = ts[i],
+              tb = ts[i+1];
+        float xa = p0.fX + dx * ta, ya = p0.fY + dy * ta,
+              xb = p0.fX + dx * tb, yb = p0.fY + dy * tb;
+        float xm = (xa + xb) * 0.5f;
+        if (xm <= 0) {
+            xa = xb = 0;
+        }
+        if (xm >= fWidth) {
+            xa = xb = (float)fWidth;
+        }
+        this->addClippedLine(SkTPin(xa, 0.0f, (float)fWidth), SkTPin(ya, 0.0f, (float)fHeight),
+                             SkTPin(xb, 0.0f, (float)fWidth), SkTPin(yb, 0.0f, (float)fHeight));
+    }
+}
+
+void CoverageAccumulator::addClippedLine(float x0, float y0, float x1, float y1) {
+    if (y0 == y1) {
+        return;
+    }
+    if (y0 < y1) {
+        fLines.push_back({ x0, y0, x1, y1, +1.0f });
+    } else {
+        fLines.push_back({ x1, y1, x0, y0, -1.0f });
+    }
+}
+
+void CoverageAccumulator::addQuad(const SkPoint pts[3]) {
+    // Uniformly subdividing a quad into n lines is off by at most |p0 - 2p1 + p2| / (8n^2).
+    SkVector dd = pts[0] - pts[1] - pts[1] + pts[2];
+    int n = SkTPin((int)std::ceil(std::sqrt(dd.length() / (8 * kFlattenTolerance))),
+                   1, kMaxCurveLines);
+
+    SkPoint prev = pts[0];
+    for (int i = 1; i <= n; ++i) {
+        float t = (float)i / n,
+              s = 1 - t;
+        SkPoint next = i == n ? pts[2]
+                              : SkPoint{s*s*pts[0].fX + 2*s*t*pts[1].fX + t*t*pts[2].fX,
+                                        s*s*pts[0].fY + 2*s*t*pts[1].fY + t*t*pts[2].fY};
+        this->addLine(prev, next);
+        prev = next;
+    }
+}
+
+void CoverageAccumulator::addCubic(const SkPoint pts[4]) {
+    // Likewise a cubic is off by at most 3/4 max(|p0 - 2p1 + p2|, |p1 - 2p2 + p3|) / n^2.
+    SkVector dd0 = pts[0] - pts[1] - pts[1] + pts[2],
+             dd1 = pts[1] - pts[2] - pts[2] + pts[3];
+    float dd = std::max(dd0.length(), dd1.length());
+    int n = SkTPin((int)std::ceil(std::sqrt(0.75f * dd / kFlattenTolerance)),
+                   1, kMaxCurveLines);
+
+    SkPoint prev = pts[0];
+    for (int i = 1; i <= n; ++i) {
+        float t = (float)i / n,
+              s = 1 - t;
+        float a = s*s*s, b = 3*s*s*t, c = 3*s*t*t, d = t*t*t;
+        SkPoint next = i == n ? pts[3]
+                              : SkPoint{a*pts[0].fX + b*pts[1].fX + c*pts[2].fX + d*pts[3].fX,
+                                        a*pts[0].fY + b*pts[1].fY + c*pts[2].fY + d*pts[3].fY};
+        this->addLine(prev, next);
+        prev = next;
+    }
+}
+
+// Deposit the signed area of the part of line between bandTop and bandBottom.  Each row of the
+// band receives exactly dy * dir in total, spread over the pixels the line crosses so that the
+// running sum along the row ramps from 0 to dy * dir across those pixels.
+void CoverageAccumulator::accumulate(const Line& line, Band* band,
+                                     int bandTop, int bandBottom) const {
+    const float ystart = std::max(line.fY0, (float)bandTop),
+                yend   = std::min(line.fY1, (float)bandBottom);
+    if (!(ystart < yend)) {
+        return;
+    }
+    const float dxdy = (line.fX1 - line.fX0) / (line.fY1 - line.fY0),
+                maxX = (float)fWidth;
+
+    float x = line.fX0 + (ystart - line.fY0) * dxdy;
+    for (int y = (int)ystart; y < yend; ++y) {
+        float dy    = std::min((float)(y + 1), yend) - std::max((float)y, ystart),
+              xnext = x + dxdy * dy,
+              d     = dy * line.fDir;
+        const int r = y - bandTop;
+        float* row = band->fAcc + r * band->fRowStride;
+
+        float x0 = SkTPin(std::min(x, xnext), 0.0f, maxX),
+              x1 = SkTPin(std::max(x, xnext), 0.0f, maxX);
+        float x0floor = std::floor(x0),
+              x1ceil  = std::ceil(x1);
+        int   x0i = (int)x0floor,
+              x1i = (int)x1ceil;
+
+        int last;
+        if (x1i <= x0i + 1) {
+            // The whole step lies within one pixel column.
+            float xmf = 0.5f * (x0 + x1) - x0floor;
+            row[x0i    ] += d - d * xmf;
+            row[x0i + 1] += d * xmf;
+            last = x0i + 1;
+        } else {
+            // Spread the trapezoid across the columns it touches: a quadratic ramp in the first
+            // and last column, and a linear ramp in between.
+            float s   = 1 / (x1 - x0),
+                  x0f = x0 - x0floor,
+                  a0  = 0.5f * s * (1 - x0f) * (1 - x0f),
+                  x1f = x1 - x1ceil + 1,
+                  am  = 0.5f * s * x1f * x1f;
+            row[x0i] += d * a0;
+            if (x1i == x0i + 2) {
+                row[x0i + 1] += d * (1 - a0 - am);
+            } else {
+                float a1 = s * (1.5f - x0f);
+                row[x0i + 1] += d * (a1 - a0);
+                for (int xi = x0i + 2; xi < x1i - 1; ++xi) {
+                    row[xi] += d * s;
+                }
+                float a2 = a1 + (float)(x1i - x0i - 3) * s;
+                row[x1i - 1] += d * (1 - a2 - am);
+            }
+            row[x1i] += d * am;
+            last = x1i;
+        }
+
+        uint8_t* touched = band->fTouched + r * band->fCellsPerRow;
+        for (int cell = x0i >> kCellShift; cell <= last >> kCellShift; ++cell) {
+            touched[cell] = 1;
+        }
+        band->fMin[r] = std::min(band->fMin[r], x0i);
+        band->fMax[r] = std::max(band->fMax[r], last);
+        x = xnext;
+    }
+}
+
+// Inclusive prefix sum of the four lanes of v: { v0, v0+v1, v0+v1+v2, v0+v1+v2+v3 }.
+static inline F4 prefix_sum(F4 v) {
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    // Whole-register byte shifts; GCC lowers the portable shuffles below through memory.
+    __m128 x = skvx::bit_pun<__m128>(v);
+    x = _mm_add_ps(x, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 4)));
+    x = _mm_add_ps(x, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 8)));
+    return skvx::bit_pun<F4>(x);
+#else
+    const F4 zero = 0;
+    v += skvx::shuffle<3,4,5,6>(skvx::join(zero, v));
+    v += skvx::shuffle<2,3,4,5>(skvx::join(zero, v));
+    return v;
+#endif
+}
+
+// Map accumulated winding to alpha according to the fill rule.
+template <bool kEvenOdd, bool kInverse>
+static skvx::Vec<4, uint8_t> winding_to_alpha(F4 v) {
+    F4 c = abs(v);
+    if (kEvenOdd) {
+        c = c - 2 * skvx::floor(c * 0.5f);
+        c = 1 - abs(1 - c);
+    } else {
+        c = min(c, 1.0f);
+    }
+    if (kInverse) {
+        c = 1 - c;
+    }
+    return skvx::cast<uint8_t>(c * 255 + 0.5f);
+}
+
+// Collects alpha runs in the format blitAntiH() wants, merging neighbours with equal alpha so
+// long opaque or clear spans reach the blitter as a single run.
+class RunBuilder {
+public:
+    RunBuilder(SkAlpha alpha[], int16_t runs[]) : fAlpha(alpha), fRuns(runs) {}
+
+    void add(SkAlpha a, int count) {
+        if (fStart >= 0 && fAlpha[fStart] == a) {
+            fEnd += count;
+            return;
+        }
+        if (fStart >= 0) {
+            fRuns[fStart] = SkToS16(fEnd - fStart);
+        }
+        fStart = fEnd;
+        fAlpha[fStart] = a;
+        fEnd += count;
+    }
+
+    // Returns the number of pixels covered by the runs.
+    int finish() {
+        if (fStart >= 0) {
+            fRuns[fStart] = SkToS16(fEnd - fStart);
+        }
+        fRuns[fEnd] = 0;
+        return fEnd;
+    }
+
+private:
+    SkAlpha* fAlpha;
+    int16_t* fRuns;
+    int      fStart = -1,
+             fEnd   = 0;
+};
+
+// Resolve one row of accumulated area into alpha runs for pixels [lo, hi), walking cells
+// [firstCell, lastCell] and clearing every touched one for the next band.  Untouched cells add
+// nothing to the running sum, so they become a single run without looking at their pixels; the
+// running sum, fill rule and conversion to alpha of touched cells go four pixels at a time.
+template <bool kEvenOdd, bool kInverse>
+static void resolve_row(float* acc, uint8_t* touched, int firstCell, int lastCell, int lo, int hi,
+                        SkAlpha alpha[], int16_t runs[]) {
+    RunBuilder builder(alpha, runs);
+    F4 carry = 0;
+    for (int cell = firstCell; cell <= lastCell; ++cell) {
+        const int cellLeft = cell * kCellWidth,
+                  left     = std::max(cellLeft, lo),
+                  right    = std::min(cellLeft + kCellWidth, hi);
+        if (!touched[cell]) {
+            if (left < right) {
+                builder.add(winding_to_alpha<kEvenOdd, kInverse>(carry)[0], right - left);
+            }
+            continue;
+        }
+        touched[cell] = 0;
+
+        SkAlpha cellAlpha[kCellWidth];
+        float* cellAcc = acc + cellLeft;
+        for (int i = 0; i < kCellWidth; i += 4) {
+            F4 v = prefix_sum(F4::Load(cellAcc + i)) + carry;
+            F4(0).store(cellAcc + i);
+            carry = skvx::shuffle<3,3,3,3>(v);
+            winding_to_alpha<kEvenOdd, kInverse>(v).store(cellAlpha + i);
+        }
+        for (int x = left; x < right;) {
+            const SkAlpha a = cellAlpha[x - cellLeft];
+            int end = x + 1;
+            while (end < right && cellAlpha[end - cellLeft] == a) {
+                ++end;
+            }
+            builder.add(a, end - x);
+            x = end;
+        }
+    }
+    if (kInverse && lastCell * kCellWidth + kCellWidth < hi) {
+        builder.add(winding_to_alpha<kEvenOdd, kInverse>(carry)[0],
+                    hi - (lastCell * kCellWidth + kCellWidth));
+    }
+    builder.finish();
+}
+
+void CoverageAccumulator::blit(SkBlitter* blitter, int left, int top, SkPathFillType fillType) {
+    if (fLines.empty() && !SkPathFillType_IsInverse(fillType)) {
+        return;
+    }
+    SkTQSort(fLines.begin(), fLines.end(),
+             [](const Line& a, const Line& b) { return a.fY0 < b.fY0; });
+
+    const bool evenOdd = SkPathFillType_IsEvenOdd(fillType),
+               inverse = SkPathFillType_IsInverse(fillType);
+    auto resolve = evenOdd ? (inverse ? resolve_row<true , true > : resolve_row<true , false>)
+                           : (inverse ? resolve_row<false, true > : resolve_row<false, false>);
+
+    // Lines touch columns up to fWidth + 1, and we resolve whole cells.
+    Band band;
+    band.fRowStride   = (fWidth + 2 + kCellWidth - 1) & ~(kCellWidth - 1);
+    band.fCellsPerRow = band.fRowStride >> kCellShift;
+    const int bandRows = std::min(kBandHeight, fHeight);
+    SkAutoSTMalloc<kBandHeight * 64, float>   acc(bandRows * band.fRowStride);
+    SkAutoSTMalloc<kBandHeight * 4, uint8_t>  touched(bandRows * band.fCellsPerRow);
+    SkAutoSTMalloc<64, SkAlpha>               alpha(fWidth + 1);
+    SkAutoSTMalloc<64, int16_t>               runs(fWidth + 1);
+    sk_bzero(acc.get(), bandRows * band.fRowStride * sizeof(float));
+    sk_bzero(touched.get(), bandRows * band.fCellsPerRow);
+    band.fAcc     = acc.get();
+    band.fTouched = touched.get();
+
+    SkSTArray<32, const Line*, true> active;
+    const Line* next = fLines.begin();
+    for (int bandTop = 0; bandTop < fHeight; bandTop += kBandHeight) {
+        const int bandBottom = std::min(bandTop + kBandHeight, fHeight);
+        std::fill(band.fMin, band.fMin + kBandHeight, fWidth);
+        std::fill(band.fMax, band.fMax + kBandHeight, -1);
+
+        while (next != fLines.end() && next->fY0 < bandBottom) {
+            active.push_back(next++);
+        }
+        for (int i = 0; i < active.count();) {
+            const Line* line = active[i];
+            this->accumulate(*line, &band, bandTop, bandBottom);
+            if (line->fY1 <= bandBottom) {
+                active.removeShuffle(i);
+            } else {
+                ++i;
+            }
+        }
+
+        for (int y = bandTop; y < bandBottom; ++y) {
+            const int r = y - bandTop;
+            int lo = band.fMin[r],
+                hi = band.fMax[r];
+            if (!inverse && hi < 0) {
+                continue;   // Nothing touched this row.
+            }
+            // Nothing left of lo was touched, so the running sum starts there, and it's back to
+            // zero past hi.  Inverse fills are covered everywhere else, so span the whole row.
+            const int firstCell = inverse ? 0 : lo >> kCellShift,
+                      lastCell  = hi >> kCellShift;
+            if (inverse) {
+                lo = 0;
+                hi = fWidth;
+            } else {
+                hi = std::min(hi + 1, fWidth);
+            }
+            resolve(band.fAcc + r * band.fRowStride, band.fTouched + r * band.fCellsPerRow,
+                    firstCell, lastCell, lo, hi, alpha.get(), runs.get());
+            if (lo < hi) {
+                blitter->blitAntiH(left + lo, top + y, alpha.get(), runs.get());
+            }
+        }
+    }
+}
+
+}  // namespace
+
+void SkScan::CAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& ir,
+                         const SkIRect& clipBounds, bool /*forceRLE*/) {
+    // Inverse fills cover the full width of the clip on the rows the path spans; the caller
+    // takes care of the rows above and below.
+    SkIRect bounds = ir;
+    if (path.isInverseFillType()) {
+        bounds.fLeft  = clipBounds.fLeft;
+        bounds.fRight = clipBounds.fRight;
+    }
+    if (!bounds.intersect(clipBounds)) {
+        return;
+    }
+
+    CoverageAccumulator accumulator(bounds.width(), bounds.height());
+    const SkVector origin = { (float)bounds.fLeft, (float)bounds.fTop };
+
+    SkPath::Iter iter(path, true);
+    SkPoint pts[4];
+    SkPath::Verb verb;
+    while ((verb = iter.next(pts)) != SkPath::kDone_Verb) {
+        for (int i = 0; i < SkPathPriv::PtsInIter((unsigned)verb); ++i) {
+            pts[i] -= origin;
+        }
+        switch (verb) {
+            case SkPath::kLine_Verb:
+                accumulator.addLine(pts[0], pts[1]);
+                break;
+            case SkPath::kQuad_Verb:
+                accumulator.addQuad(pts);
+                break;
+            case SkPath::kConic_Verb: {
+                SkAutoConicToQuads quadder;
+                const SkPoint* quads = quadder.computeQuads(pts, iter.conicWeight(),
+                                                            kFlattenTolerance);
+                for (int i = 0; i < quadder.countQuads(); ++i) {
+                    accumulator.addQuad(quads + 2 * i);
+                }
+                break;
+            }
+            case SkPath::kCubic_Verb:
+                accumulator.addCubic(pts);
+                break;
+            default:
+                break;
+        }
+    }
+
+    accumulator.blit(blitter, bounds.fLeft, bounds.fTop, path.getFillType());
+}
@@ -18,6 +18,7 @@
 #include "src/core/SkRasterClip.h"
 #include "src/core/SkRectPriv.h"
 #include "src/core/SkScanPriv.h"
+#include "src/core/SkTLazy.h"
 #include "src/core/SkTSort.h"
 
 #include <utility>
@@ -393,7 +394,8 @@ static SkEdge* sort_edges(SkEdge* list[], int count, SkEdge** last) {
 
 // clipRect has not been shifted up
 void sk_fill_path(const SkPath& path, const SkIRect& clipRect, SkBlitter* blitter,
-                  int start_y, int stop_y, int shiftEdgesUp, bool pathContainedInClip) {
+                  int start_y, int stop_y, int shiftEdgesUp, bool pathContainedInClip,
+                  SkBasicEdgeBuilder* sharedBuilder) {
     SkASSERT(blitter);
 
     SkIRect shiftedClip = clipRect;
@@ -402,7 +404,9 @@ void sk_fill_path(const SkPath& path, const SkIRect& clipRect, SkBlitter* blitte
     shiftedClip.fTop = SkLeftShift(shiftedClip.fTop, shiftEdgesUp);
     shiftedClip.fBottom = SkLeftShift(shiftedClip.fBottom, shiftEdgesUp);
 
-    SkBasicEdgeBuilder builder(shiftEdgesUp);
+    SkTLazy<SkBasicEdgeBuilder> localBuilder;
+    SkBasicEdgeBuilder& builder = sharedBuilder ? *sharedBuilder
+                                                : *localBuilder.init(shiftEdgesUp);
     int count = builder.buildEdges(path, pathContainedInClip ? nullptr : &shiftedClip);
     SkEdge** list = builder.edgeList();
 
@@ -614,7 +618,7 @@ static SkIRect conservative_round_to_int(const SkRect& src) {
 }
 
 void SkScan::FillPath(const SkPath& path, const SkRegion& origClip,
-                      SkBlitter* blitter) {
+                      SkBlitter* blitter, EdgeBuilders* edges) {
     if (origClip.isEmpty()) {
         return;
     }
@@ -661,7 +665,7 @@ void SkScan::FillPath(const SkPath& path, const SkRegion& origClip,
         SkASSERT(clipper.getClipRect() == nullptr ||
                 *clipper.getClipRect() == clipPtr->getBounds());
         sk_fill_path(path, clipPtr->getBounds(), blitter, ir.fTop, ir.fBottom,
-                     0, clipper.getClipRect() == nullptr);
+                     0, clipper.getClipRect() == nullptr, edges ? &edges->fAliased : nullptr);
         if (path.isInverseFillType()) {
             sk_blit_below(blitter, ir, *clipPtr);
         }
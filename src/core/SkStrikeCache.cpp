@@ -34,13 +34,17 @@ SkStrikeCache* SkStrikeCache::GlobalStrikeCache() {
 auto SkStrikeCache::findOrCreateStrike(const SkDescriptor& desc,
                                        const SkScalerContextEffects& effects,
                                        const SkTypeface& typeface) -> sk_sp<Strike> {
-    SkAutoMutexExclusive ac(fLock);
-    sk_sp<Strike> strike = this->internalFindStrikeOrNull(desc);
-    if (strike == nullptr) {
-        auto scaler = typeface.createScalerContext(effects, &desc);
-        strike = this->internalCreateStrike(desc, std::move(scaler));
+    Shard* shard = &this->shardFor(desc);
+    sk_sp<Strike> strike;
+    {
+        SkAutoMutexExclusive ac(shard->fLock);
+        strike = this->internalFindStrikeOrNull(shard, desc);
+        if (strike == nullptr) {
+            auto scaler = typeface.createScalerContext(effects, &desc);
+            strike = this->internalCreateStrike(shard, desc, std::move(scaler));
+        }
     }
-    this->internalPurge();
+    this->purge();
     return strike;
 }
 
@@ -120,34 +124,40 @@ void SkStrikeCache::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
 }
 
 sk_sp<SkStrike> SkStrikeCache::findStrike(const SkDescriptor& desc) {
-    SkAutoMutexExclusive ac(fLock);
-    sk_sp<SkStrike> result = this->internalFindStrikeOrNull(desc);
-    this->internalPurge();
+    Shard* shard = &this->shardFor(desc);
+    sk_sp<SkStrike> result;
+    {
+        SkAutoMutexExclusive ac(shard->fLock);
+        result = this->internalFindStrikeOrNull(shard, desc);
+    }
+    this->purge();
     return result;
 }
 
-auto SkStrikeCache::internalFindStrikeOrNull(const SkDescriptor& desc) -> sk_sp<Strike> {
+auto SkStrikeCache::internalFindStrikeOrNull(Shard* shard, const SkDescriptor& desc)
+        -> sk_sp<Strike> {
+    Strike*& head = shard->fHead;
 
     // Check head because it is likely the strike we are looking for.
-    if (fHead != nullptr && fHead->getDescriptor() == desc) { return sk_ref_sp(fHead); }
+    if (head != nullptr && head->getDescriptor() == desc) { return sk_ref_sp(head); }
 
     // Do the heavy search looking for the strike.
-    sk_sp<Strike>* strikeHandle = fStrikeLookup.find(desc);
+    sk_sp<Strike>* strikeHandle = shard->fStrikeLookup.find(desc);
     if (strikeHandle == nullptr) { return nullptr; }
     Strike* strikePtr = strikeHandle->get();
     SkASSERT(strikePtr != nullptr);
-    if (fHead != strikePtr) {
+    if (head != strikePtr) {
         // Make most recently used
         strikePtr->fPrev->fNext = strikePtr->fNext;
         if (strikePtr->fNext != nullptr) {
             strikePtr->fNext->fPrev = strikePtr->fPrev;
         } else {
-            fTail = strikePtr->fPrev;
+            shard->fTail = strikePtr->fPrev;
         }
-        fHead->fPrev = strikePtr;
-        strikePtr->fNext = fHead;
+        head->fPrev = strikePtr;
+        strikePtr->fNext = head;
         strikePtr->fPrev = nullptr;
-        fHead = strikePtr;
+        head = strikePtr;
     }
     return sk_ref_sp(strikePtr);
 }
@@ -157,53 +167,48 @@ sk_sp<SkStrike> SkStrikeCache::createStrike(
         std::unique_ptr<SkScalerContext> scaler,
         SkFontMetrics* maybeMetrics,
         std::unique_ptr<SkStrikePinner> pinner) {
-    SkAutoMutexExclusive ac(fLock);
-    return this->internalCreateStrike(desc, std::move(scaler), maybeMetrics, std::move(pinner));
+    Shard* shard = &this->shardFor(desc);
+    SkAutoMutexExclusive ac(shard->fLock);
+    return this->internalCreateStrike(
+            shard, desc, std::move(scaler), maybeMetrics, std::move(pinner));
 }
 
 auto SkStrikeCache::internalCreateStrike(
+        Shard* shard,
         const SkDescriptor& desc,
         std::unique_ptr<SkScalerContext> scaler,
         SkFontMetrics* maybeMetrics,
         std::unique_ptr<SkStrikePinner> pinner) -> sk_sp<Strike> {
     auto strike =
             sk_make_sp<Strike>(this, desc, std::move(scaler), maybeMetrics, std::move(pinner));
-    this->internalAttachToHead(strike);
+    this->internalAttachToHead(shard, strike);
     return strike;
 }
 
 void SkStrikeCache::purgeAll() {
-    SkAutoMutexExclusive ac(fLock);
-    this->internalPurge(fTotalMemoryUsed);
+    this->purge(fTotalMemoryUsed.load());
 }
 
 size_t SkStrikeCache::getTotalMemoryUsed() const {
-    SkAutoMutexExclusive ac(fLock);
-    return fTotalMemoryUsed;
+    return fTotalMemoryUsed.load();
 }
 
 int SkStrikeCache::getCacheCountUsed() const {
-    SkAutoMutexExclusive ac(fLock);
-    return fCacheCount;
+    return fCacheCount.load();
 }
 
 int SkStrikeCache::getCacheCountLimit() const {
-    SkAutoMutexExclusive ac(fLock);
-    return fCacheCountLimit;
+    return fCacheCountLimit.load();
 }
 
 size_t SkStrikeCache::setCacheSizeLimit(size_t newLimit) {
-    SkAutoMutexExclusive ac(fLock);
-
-    size_t prevLimit = fCacheSizeLimit;
-    fCacheSizeLimit = newLimit;
-    this->internalPurge();
+    size_t prevLimit = fCacheSizeLimit.exchange(newLimit);
+    this->purge();
     return prevLimit;
 }
 
 size_t  SkStrikeCache::getCacheSizeLimit() const {
-    SkAutoMutexExclusive ac(fLock);
-    return fCacheSizeLimit;
+    return fCacheSizeLimit.load();
 }
 
 int SkStrikeCache::setCacheCountLimit(int newCount) {
@@ -211,53 +216,109 @@ int SkStrikeCache::setCacheCountLimit(int newCount) {
         newCount = 0;
     }
 
-    SkAutoMutexExclusive ac(fLock);
-
-    int prevCount = fCacheCountLimit;
-    fCacheCountLimit = newCount;
-    this->internalPurge();
+    int prevCount = fCacheCountLimit.exchange(newCount);
+    this->purge();
     return prevCount;
 }
 
 void SkStrikeCache::forEachStrike(std::function<void(const Strike&)> visitor) const {
-    SkAutoMutexExclusive ac(fLock);
+    for (const Shard& shard : fShards) {
+        SkAutoMutexExclusive ac(shard.fLock);
 
-    this->validate();
+        this->validate(shard);
 
-    for (Strike* strike = fHead; strike != nullptr; strike = strike->fNext) {
-        visitor(*strike);
+        for (Strike* strike = shard.fHead; strike != nullptr; strike = strike->fNext) {
+            visitor(*strike);
+        }
     }
 }
 
-size_t SkStrikeCache::internalPurge(size_t minBytesNeeded) {
-    size_t bytesNeeded = 0;
-    if (fTotalMemoryUsed > fCacheSizeLimit) {
-        bytesNeeded = fTotalMemoryUsed - fCacheSizeLimit;
+size_t SkStrikeCache::purge(size_t minBytesNeeded) {
+    auto computeNeeded = [&](size_t* bytesNeeded, int* countNeeded) {
+        const size_t totalMemoryUsed = fTotalMemoryUsed.load(),
+                     cacheSizeLimit  = fCacheSizeLimit.load();
+        const int    cacheCount      = fCacheCount.load(),
+                     cacheCountLimit = fCacheCountLimit.load();
+
+        *bytesNeeded = 0;
+        if (totalMemoryUsed > cacheSizeLimit) {
+            *bytesNeeded = totalMemoryUsed - cacheSizeLimit;
+        }
+        *bytesNeeded = std::max(*bytesNeeded, minBytesNeeded);
+        if (*bytesNeeded) {
+            // no small purges!
+            *bytesNeeded = std::max(*bytesNeeded, totalMemoryUsed >> 2);
+        }
+
+        *countNeeded = 0;
+        if (cacheCount > cacheCountLimit) {
+            *countNeeded = cacheCount - cacheCountLimit;
+            // no small purges!
+            *countNeeded = std::max(*countNeeded, cacheCount >> 2);
+        }
+        return *bytesNeeded || *countNeeded;
+    };
+
+    size_t bytesNeeded;
+    int    countNeeded;
+
+    // early exit, without touching any lock
+    if (!computeNeeded(&bytesNeeded, &countNeeded)) {
+        return 0;
     }
-    bytesNeeded = std::max(bytesNeeded, minBytesNeeded);
-    if (bytesNeeded) {
-        // no small purges!
-        bytesNeeded = std::max(bytesNeeded, fTotalMemoryUsed >> 2);
+
+    SkAutoMutexExclusive purgeLock(fPurgeLock);
+    // Another thread may have purged while we waited.
+    if (!computeNeeded(&bytesNeeded, &countNeeded)) {
+        return 0;
     }
+    const size_t totalMemoryUsed = std::max<size_t>(fTotalMemoryUsed.load(), 1);
+    const int    cacheCount      = std::max(fCacheCount.load(), 1);
 
-    int countNeeded = 0;
-    if (fCacheCount > fCacheCountLimit) {
-        countNeeded = fCacheCount - fCacheCountLimit;
-        // no small purges!
-        countNeeded = std::max(countNeeded, fCacheCount >> 2);
+    size_t  bytesFreed = 0;
+    int     countFreed = 0;
+    auto done = [&] { return bytesFreed >= bytesNeeded && countFreed >= countNeeded; };
+
+    // The first pass asks each shard for its share of the purge, in proportion to its size,
+    // so that no shard loses its recently used strikes while another keeps stale ones.
+    // The second pass takes whatever is still needed, e.g. because of pinned strikes.
+    for (int pass = 0; pass < 2 && !done(); pass++) {
+        for (int i = 0; i < kShardCount && !done(); i++) {
+            Shard* shard = &fShards[(fPurgeStart + i) % kShardCount];
+            SkAutoMutexExclusive ac(shard->fLock);
+
+            size_t shardBytesNeeded = bytesFreed < bytesNeeded ? bytesNeeded - bytesFreed : 0;
+            int    shardCountNeeded = std::max(countNeeded - countFreed, 0);
+            if (pass == 0) {
+                shardBytesNeeded = std::min(shardBytesNeeded, (size_t)(
+                        (double)bytesNeeded * shard->fTotalMemoryUsed / totalMemoryUsed + 1));
+                shardCountNeeded = std::min(shardCountNeeded, (int)(
+                        (double)countNeeded * shard->fCacheCount / cacheCount + 1));
+            }
+            this->internalPurgeShard(shard, shardBytesNeeded, shardCountNeeded,
+                                     &bytesFreed, &countFreed);
+        }
     }
+    fPurgeStart = (fPurgeStart + 1) % kShardCount;
 
-    // early exit
-    if (!countNeeded && !bytesNeeded) {
-        return 0;
+#ifdef SPEW_PURGE_STATUS
+    if (countFreed) {
+        SkDebugf("purging %dK from font cache [%d entries]\n",
+                 (int)(bytesFreed >> 10), countFreed);
     }
+#endif
+
+    return bytesFreed;
+}
 
+void SkStrikeCache::internalPurgeShard(Shard* shard, size_t bytesNeeded, int countNeeded,
+                                       size_t* totalBytesFreed, int* totalCountFreed) {
     size_t  bytesFreed = 0;
     int     countFreed = 0;
 
     // Start at the tail and proceed backwards deleting; the list is in LRU
     // order, with unimportant entries at the tail.
-    Strike* strike = fTail;
+    Strike* strike = shard->fTail;
     while (strike != nullptr && (bytesFreed < bytesNeeded || countFreed < countNeeded)) {
         Strike* prev = strike->fPrev;
 
@@ -265,84 +326,83 @@ size_t SkStrikeCache::internalPurge(size_t minBytesNeeded) {
         if (strike->fPinner == nullptr || strike->fPinner->canDelete()) {
             bytesFreed += strike->fMemoryUsed;
             countFreed += 1;
-            this->internalRemoveStrike(strike);
+            this->internalRemoveStrike(shard, strike);
         }
         strike = prev;
     }
 
-    this->validate();
+    this->validate(*shard);
 
-#ifdef SPEW_PURGE_STATUS
-    if (countFreed) {
-        SkDebugf("purging %dK from font cache [%d entries]\n",
-                 (int)(bytesFreed >> 10), countFreed);
-    }
-#endif
-
-    return bytesFreed;
+    *totalBytesFreed += bytesFreed;
+    *totalCountFreed += countFreed;
 }
 
-void SkStrikeCache::internalAttachToHead(sk_sp<Strike> strike) {
-    SkASSERT(fStrikeLookup.find(strike->getDescriptor()) == nullptr);
+void SkStrikeCache::internalAttachToHead(Shard* shard, sk_sp<Strike> strike) {
+    SkASSERT(shard->fStrikeLookup.find(strike->getDescriptor()) == nullptr);
     Strike* strikePtr = strike.get();
-    fStrikeLookup.set(std::move(strike));
+    shard->fStrikeLookup.set(std::move(strike));
     SkASSERT(nullptr == strikePtr->fPrev && nullptr == strikePtr->fNext);
 
+    shard->fCacheCount += 1;
+    shard->fTotalMemoryUsed += strikePtr->fMemoryUsed;
     fCacheCount += 1;
     fTotalMemoryUsed += strikePtr->fMemoryUsed;
 
-    if (fHead != nullptr) {
-        fHead->fPrev = strikePtr;
-        strikePtr->fNext = fHead;
+    if (shard->fHead != nullptr) {
+        shard->fHead->fPrev = strikePtr;
+        strikePtr->fNext = shard->fHead;
     }
 
-    if (fTail == nullptr) {
-        fTail = strikePtr;
+    if (shard->fTail == nullptr) {
+        shard->fTail = strikePtr;
     }
 
-    fHead = strikePtr; // Transfer ownership of strike to the cache list.
+    shard->fHead = strikePtr; // Transfer ownership of strike to the cache list.
 }
 
-void SkStrikeCache::internalRemoveStrike(Strike* strike) {
-    SkASSERT(fCacheCount > 0);
+void SkStrikeCache::internalRemoveStrike(Shard* shard, Strike* strike) {
+    SkASSERT(shard->fCacheCount > 0);
+    shard->fCacheCount -= 1;
+    shard->fTotalMemoryUsed -= strike->fMemoryUsed;
     fCacheCount -= 1;
     fTotalMemoryUsed -= strike->fMemoryUsed;
 
     if (strike->fPrev) {
         strike->fPrev->fNext = strike->fNext;
     } else {
-        fHead = strike->fNext;
+        shard->fHead = strike->fNext;
     }
     if (strike->fNext) {
         strike->fNext->fPrev = strike->fPrev;
     } else {
-        fTail = strike->fPrev;
+        shard->fTail = strike->fPrev;
     }
 
     strike->fPrev = strike->fNext = nullptr;
     strike->fRemoved = true;
-    fStrikeLookup.remove(strike->getDescriptor());
+    shard->fStrikeLookup.remove(strike->getDescriptor());
 }
 
-void SkStrikeCache::validate() const {
+void SkStrikeCache::validate(const Shard& shard) const {
 #ifdef SK_DEBUG
     size_t computedBytes = 0;
     int computedCount = 0;
 
-    const Strike* strike = fHead;
+    const Strike* strike = shard.fHead;
     while (strike != nullptr) {
         computedBytes += strike->fMemoryUsed;
         computedCount += 1;
-        SkASSERT(fStrikeLookup.findOrNull(strike->getDescriptor()) != nullptr);
+        SkASSERT(shard.fStrikeLookup.findOrNull(strike->getDescriptor()) != nullptr);
         strike = strike->fNext;
     }
 
-    if (fCacheCount != computedCount) {
-        SkDebugf("fCacheCount: %d, computedCount: %d", fCacheCount, computedCount);
+    if (shard.fCacheCount != computedCount) {
+        SkDebugf("fCacheCount: %d, computedCount: %d", shard.fCacheCount, computedCount);
         SK_ABORT("fCacheCount != computedCount");
     }
-    if (fTotalMemoryUsed != computedBytes) {
-        SkDebugf("fTotalMemoryUsed: %d, computedBytes: %d", fTotalMemoryUsed, computedBytes);
+    if (shard.fTotalMemoryUsed != computedBytes) {
+        SkDebugf("fTotalMemoryUsed: %zu, computedBytes: %zu",
+                 shard.fTotalMemoryUsed, computedBytes);
         SK_ABORT("fTotalMemoryUsed == computedBytes");
     }
 #endif
@@ -350,9 +410,11 @@ void SkStrikeCache::validate() const {
 
 void SkStrikeCache::Strike::updateDelta(size_t increase) {
     if (increase != 0) {
-        SkAutoMutexExclusive lock{fStrikeCache->fLock};
+        Shard& shard = fStrikeCache->shardFor(this->getDescriptor());
+        SkAutoMutexExclusive lock{shard.fLock};
         fMemoryUsed += increase;
         if (!fRemoved) {
+            shard.fTotalMemoryUsed += increase;
             fStrikeCache->fTotalMemoryUsed += increase;
         }
     }
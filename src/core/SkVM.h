@@ -591,6 +591,11 @@ namespace skvm {
         std::vector<Instruction> program() const { return fProgram; }
         std::vector<OptimizedInstruction> optimize() const;
 
+        // What done() passes to Program() along with optimize(), for callers that keep the
+        // optimized instructions around to recreate the Program later.
+        const std::vector<int>& strides() const { return fStrides; }
+        Features features() const { return fFeatures; }
+
         // Declare an argument with given stride (use stride=0 for uniforms).
         // TODO: different types for varying and uniforms?
         Ptr arg(int stride);
@@ -5,8 +5,12 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkData.h"
+#include "include/core/SkTime.h"
+#include "include/core/SkTraceMemoryDump.h"
 #include "include/private/SkImageInfoPriv.h"
 #include "include/private/SkMacros.h"
+#include "include/private/SkMutex.h"
 #include "src/core/SkArenaAlloc.h"
 #include "src/core/SkBlendModePriv.h"
 #include "src/core/SkBlenderBase.h"
@@ -21,7 +25,9 @@
 #include "src/core/SkVM.h"
 #include "src/shaders/SkColorFilterShader.h"
 
+#include <atomic>
 #include <cinttypes>
+#include <memory>
 
 namespace {
 
@@ -100,19 +106,183 @@ namespace {
                               key.coverage);
     }
 
-    static SkLRUCache<Key, skvm::Program>* try_acquire_program_cache() {
-    #if 1 && defined(SKVM_JIT)
-        thread_local static SkLRUCache<Key, skvm::Program> cache{64};
-        return &cache;
-    #else
-        // iOS in particular does not support thread_local until iOS 9.0.
-        // On the other hand, we'll never be able to JIT there anyway.
-        // It's probably fine to not cache any interpreted programs, anywhere.
-        return nullptr;
-    #endif
-    }
+    // Programs never change once built, so every thread can share one cache of them, and several
+    // Blitters may eval() the same Program at once.  A miss falls back to the client's
+    // SkGraphics::PersistentProgramCache, which holds serialized optimized instructions.  Loading
+    // those skips build_program() and Builder::optimize(), leaving only the JIT to run.
+    class ProgramCache {
+    public:
+        static ProgramCache* Get() {
+            static ProgramCache* cache = new ProgramCache;
+            return cache;
+        }
+
+        template <typename Fn>
+        std::shared_ptr<const skvm::Program> findOrBuild(const Key& key, Fn&& build) {
+            {
+                SkAutoMutexExclusive lock(fMutex);
+                if (std::shared_ptr<const skvm::Program>* found = fPrograms.find(key)) {
+                    fHits++;
+                    return *found;
+                }
+            }
+
+            const double start = SkTime::GetNSecs();
+            SkGraphics::PersistentProgramCache* store = fStore.load();
+            sk_sp<SkData> storeKey = store ? store_key(key) : nullptr;
+            std::shared_ptr<const skvm::Program> program;
+            if (store) {
+                if (sk_sp<SkData> data = store->load(*storeKey)) {
+                    program = load_program(*data, debug_name(key).c_str());
+                }
+            }
+            if (program) {
+                fPersistentHits++;
+            } else {
+                fMisses++;
+                program = build_and_store(key, build, store, storeKey.get());
+            }
+            fBuildNanos += (int64_t)(SkTime::GetNSecs() - start);
+
+            SkAutoMutexExclusive lock(fMutex);
+            fPrograms.insert_or_update(key, program);
+            return program;
+        }
+
+        SkGraphics::PersistentProgramCache* setStore(SkGraphics::PersistentProgramCache* store) {
+            return fStore.exchange(store);
+        }
+
+        SkVMBlitterProgramCache::Stats stats() {
+            SkAutoMutexExclusive lock(fMutex);
+            return { fPrograms.count(), fHits, fPersistentHits, fMisses, fBuildNanos };
+        }
+
+        void purge() {
+            SkAutoMutexExclusive lock(fMutex);
+            fPrograms.reset();
+        }
+
+    private:
+        // Each Blitter uses up to 5 programs, one per Coverage.
+        static constexpr int kMaxPrograms = 256;
+
+        // Bump this whenever the serialized format or the meaning of Key or skvm::Op changes.
+        static constexpr uint32_t kStoreVersion = 1;
+
+        template <typename Fn>
+        static std::shared_ptr<const skvm::Program> build_and_store(
+                const Key& key, Fn&& build,
+                SkGraphics::PersistentProgramCache* store, const SkData* storeKey) {
+            skvm::Builder builder;
+            build(&builder);
+            std::vector<skvm::OptimizedInstruction> instructions = builder.optimize();
+            if (store) {
+                store->store(*storeKey, *save_program(instructions, builder.strides()));
+            }
+            return std::make_shared<const skvm::Program>(instructions, builder.strides(),
+                                                         debug_name(key).c_str(),
+                                                         /*allow_jit=*/true);
+        }
+
+        static sk_sp<SkData> store_key(const Key& key) {
+            const skvm::Features features = skvm::Builder{}.features();
+            const uint32_t header[] = {
+                kStoreVersion,
+                (uint32_t)features.fma << 0 | (uint32_t)features.fp16 << 1,
+            };
+            sk_sp<SkData> data = SkData::MakeUninitialized(sizeof(header) + sizeof(Key));
+            memcpy(data->writable_data(), header, sizeof(header));
+            memcpy(SkTAddOffset<void>(data->writable_data(), sizeof(header)), &key, sizeof(Key));
+            return data;
+        }
+
+        // An OptimizedInstruction is written as kFieldCount int32_ts, skipping its padding.
+        static constexpr int kFieldCount = 9;
+
+        static sk_sp<SkData> save_program(
+                const std::vector<skvm::OptimizedInstruction>& instructions,
+                const std::vector<int>& strides) {
+            std::vector<int32_t> words = {
+                SkToS32(instructions.size()),
+                SkToS32(strides.size()),
+            };
+            words.insert(words.end(), strides.begin(), strides.end());
+            for (const skvm::OptimizedInstruction& inst : instructions) {
+                const int32_t fields[kFieldCount] = {
+                    (int32_t)inst.op,
+                    inst.x, inst.y, inst.z, inst.w,
+                    inst.immA, inst.immB,
+                    inst.death, inst.can_hoist,
+                };
+                words.insert(words.end(), fields, fields + kFieldCount);
+            }
+            return SkData::MakeWithCopy(words.data(), words.size() * sizeof(int32_t));
+        }
 
-    static void release_program_cache() { }
+        // The store is trusted to hand back what we saved, but we still reject data that is
+        // truncated or refers to values that could not exist.
+        static std::shared_ptr<const skvm::Program> load_program(const SkData& data,
+                                                                 const char* debug_name) {
+            const size_t count = data.size() / sizeof(int32_t);
+            const int32_t* words = static_cast<const int32_t*>(data.data());
+            if (count < 2 || data.size() % sizeof(int32_t) != 0) {
+                return nullptr;
+            }
+            const int32_t ninstructions = words[0],
+                          nstrides      = words[1];
+            if (ninstructions <= 0 || nstrides < 0 ||
+                count != 2 + (size_t)nstrides + (size_t)ninstructions * kFieldCount) {
+                return nullptr;
+            }
+            words += 2;
+
+            std::vector<int> strides(words, words + nstrides);
+            words += nstrides;
+
+            constexpr int kOpCount = 0
+            #define M(op) + 1
+                SKVM_OPS(M)
+            #undef M
+            ;
+            std::vector<skvm::OptimizedInstruction> instructions(ninstructions);
+            for (int i = 0; i < ninstructions; i++, words += kFieldCount) {
+                skvm::OptimizedInstruction& inst = instructions[i];
+                if (words[0] < 0 || words[0] >= kOpCount) {
+                    return nullptr;
+                }
+                inst.op = (skvm::Op)words[0];
+                for (int a = 0; a < 4; a++) {
+                    if (words[1+a] < skvm::NA || words[1+a] >= i) {
+                        return nullptr;
+                    }
+                }
+                inst.x         = words[1];
+                inst.y         = words[2];
+                inst.z         = words[3];
+                inst.w         = words[4];
+                inst.immA      = words[5];
+                inst.immB      = words[6];
+                inst.death     = words[7];
+                inst.can_hoist = words[8] != 0;
+                if (inst.death < i || inst.death > ninstructions) {
+                    return nullptr;
+                }
+            }
+            return std::make_shared<const skvm::Program>(instructions, strides, debug_name,
+                                                         /*allow_jit=*/true);
+        }
+
+        SkMutex fMutex;
+        SkLRUCache<Key, std::shared_ptr<const skvm::Program>> fPrograms SK_GUARDED_BY(fMutex)
+                {kMaxPrograms};
+        std::atomic<SkGraphics::PersistentProgramCache*> fStore{nullptr};
+
+        std::atomic<int64_t> fHits{0},
+                             fPersistentHits{0},
+                             fMisses{0},
+                             fBuildNanos{0};
+    };
 
     static skvm::Coord device_coord(skvm::Builder* p, skvm::Uniforms* uniforms) {
         skvm::I32 dx = p->uniform32(uniforms->base, offsetof(BlitterUniforms, right))
@@ -611,23 +781,6 @@ namespace {
             , fKey(cache_key(fParams, &fUniforms, &fAlloc, ok))
         {}
 
-        ~Blitter() override {
-            if (SkLRUCache<Key, skvm::Program>* cache = try_acquire_program_cache()) {
-                auto cache_program = [&](skvm::Program&& program, Coverage coverage) {
-                    if (!program.empty()) {
-                        cache->insert_or_update(fKey.withCoverage(coverage), std::move(program));
-                    }
-                };
-                cache_program(std::move(fBlitH),         Coverage::Full);
-                cache_program(std::move(fBlitAntiH),     Coverage::UniformF);
-                cache_program(std::move(fBlitMaskA8),    Coverage::MaskA8);
-                cache_program(std::move(fBlitMask3D),    Coverage::Mask3D);
-                cache_program(std::move(fBlitMaskLCD16), Coverage::MaskLCD16);
-
-                release_program_cache();
-            }
-        }
-
     private:
         SkPixmap        fDevice;
         const SkPixmap  fSprite;                  // See isSprite().
@@ -636,54 +789,25 @@ namespace {
         SkArenaAlloc    fAlloc{2*sizeof(void*)};  // but a few effects need to ref large content.
         const Params    fParams;
         const Key       fKey;
-        skvm::Program   fBlitH,
-                        fBlitAntiH,
-                        fBlitMaskA8,
-                        fBlitMask3D,
-                        fBlitMaskLCD16;
-
-        skvm::Program buildProgram(Coverage coverage) {
-            Key key = fKey.withCoverage(coverage);
-            {
-                skvm::Program p;
-                if (SkLRUCache<Key, skvm::Program>* cache = try_acquire_program_cache()) {
-                    if (skvm::Program* found = cache->find(key)) {
-                        p = std::move(*found);
-                    }
-                    release_program_cache();
-                }
-                if (!p.empty()) {
-                    return p;
-                }
-            }
-            // We don't really _need_ to rebuild fUniforms here.
-            // It's just more natural to have effects unconditionally emit them,
-            // and more natural to rebuild fUniforms than to emit them into a temporary buffer.
-            // fUniforms should reuse the exact same memory, so this is very cheap.
-            SkDEBUGCODE(size_t prev = fUniforms.buf.size();)
-            fUniforms.buf.resize(kBlitterUniformsCount);
-            skvm::Builder builder;
-            build_program(&builder, fParams.withCoverage(coverage), &fUniforms, &fAlloc);
-            SkASSERTF(fUniforms.buf.size() == prev,
-                      "%zu, prev was %zu", fUniforms.buf.size(), prev);
-
-            skvm::Program program = builder.done(debug_name(key).c_str());
-            if (false) {
-                static std::atomic<int> missed{0},
-                                         total{0};
-                if (!program.hasJIT()) {
-                    SkDebugf("\ncouldn't JIT %s\n", debug_name(key).c_str());
-                    builder.dump();
-                    program.dump();
-
-                    missed++;
-                }
-                if (0 == total++) {
-                    atexit([]{ SkDebugf("SkVMBlitter compiled %d programs, %d without JIT.\n",
-                                        total.load(), missed.load()); });
-                }
-            }
-            return program;
+        std::shared_ptr<const skvm::Program> fBlitH,
+                                             fBlitAntiH,
+                                             fBlitMaskA8,
+                                             fBlitMask3D,
+                                             fBlitMaskLCD16;
+
+        std::shared_ptr<const skvm::Program> buildProgram(Coverage coverage) {
+            return ProgramCache::Get()->findOrBuild(fKey.withCoverage(coverage),
+                                                    [&](skvm::Builder* builder) {
+                // We don't really _need_ to rebuild fUniforms here.
+                // It's just more natural to have effects unconditionally emit them,
+                // and more natural to rebuild fUniforms than to emit them into a temporary buffer.
+                // fUniforms should reuse the exact same memory, so this is very cheap.
+                SkDEBUGCODE(size_t prev = fUniforms.buf.size();)
+                fUniforms.buf.resize(kBlitterUniformsCount);
+                build_program(builder, fParams.withCoverage(coverage), &fUniforms, &fAlloc);
+                SkASSERTF(fUniforms.buf.size() == prev,
+                          "%zu, prev was %zu", fUniforms.buf.size(), prev);
+            });
         }
 
         void updateUniforms(int right, int y) {
@@ -700,28 +824,28 @@ namespace {
         }
 
         void blitH(int x, int y, int w) override {
-            if (fBlitH.empty()) {
+            if (!fBlitH) {
                 fBlitH = this->buildProgram(Coverage::Full);
             }
             this->updateUniforms(x+w, y);
             if (const void* sprite = this->isSprite(x,y)) {
-                fBlitH.eval(w, fUniforms.buf.data(), fDevice.addr(x,y), sprite);
+                fBlitH->eval(w, fUniforms.buf.data(), fDevice.addr(x,y), sprite);
             } else {
-                fBlitH.eval(w, fUniforms.buf.data(), fDevice.addr(x,y));
+                fBlitH->eval(w, fUniforms.buf.data(), fDevice.addr(x,y));
             }
         }
 
         void blitAntiH(int x, int y, const SkAlpha cov[], const int16_t runs[]) override {
-            if (fBlitAntiH.empty()) {
+            if (!fBlitAntiH) {
                 fBlitAntiH = this->buildProgram(Coverage::UniformF);
             }
             for (int16_t run = *runs; run > 0; run = *runs) {
                 this->updateUniforms(x+run, y);
                 const float covF = *cov * (1/255.0f);
                 if (const void* sprite = this->isSprite(x,y)) {
-                    fBlitAntiH.eval(run, fUniforms.buf.data(), fDevice.addr(x,y), sprite, &covF);
+                    fBlitAntiH->eval(run, fUniforms.buf.data(), fDevice.addr(x,y), sprite, &covF);
                 } else {
-                    fBlitAntiH.eval(run, fUniforms.buf.data(), fDevice.addr(x,y), &covF);
+                    fBlitAntiH->eval(run, fUniforms.buf.data(), fDevice.addr(x,y), &covF);
                 }
                 x    += run;
                 runs += run;
@@ -739,24 +863,24 @@ namespace {
                 default: SkUNREACHABLE;     // ARGB and SDF masks shouldn't make it here.
 
                 case SkMask::k3D_Format:
-                    if (fBlitMask3D.empty()) {
+                    if (!fBlitMask3D) {
                         fBlitMask3D = this->buildProgram(Coverage::Mask3D);
                     }
-                    program = &fBlitMask3D;
+                    program = fBlitMask3D.get();
                     break;
 
                 case SkMask::kA8_Format:
-                    if (fBlitMaskA8.empty()) {
+                    if (!fBlitMaskA8) {
                         fBlitMaskA8 = this->buildProgram(Coverage::MaskA8);
                     }
-                    program = &fBlitMaskA8;
+                    program = fBlitMaskA8.get();
                     break;
 
                 case SkMask::kLCD16_Format:
-                    if (fBlitMaskLCD16.empty()) {
+                    if (!fBlitMaskLCD16) {
                         fBlitMaskLCD16 = this->buildProgram(Coverage::MaskLCD16);
                     }
-                    program = &fBlitMaskLCD16;
+                    program = fBlitMaskLCD16.get();
                     break;
             }
 
@@ -769,7 +893,7 @@ namespace {
                     auto  mptr = (const uint8_t*)mask.getAddr(x,y);
                     this->updateUniforms(x+w,y);
 
-                    if (program == &fBlitMask3D) {
+                    if (program == fBlitMask3D.get()) {
                         size_t plane = mask.computeImageSize();
                         if (const void* sprite = this->isSprite(x,y)) {
                             program->eval(w, fUniforms.buf.data(), dptr, sprite, mptr + 1*plane
@@ -794,6 +918,29 @@ namespace {
 
 }  // namespace
 
+SkVMBlitterProgramCache::Stats SkVMBlitterProgramCache::GetStats() {
+    return ProgramCache::Get()->stats();
+}
+
+SkGraphics::PersistentProgramCache* SkVMBlitterProgramCache::SetPersistentCache(
+        SkGraphics::PersistentProgramCache* store) {
+    return ProgramCache::Get()->setStore(store);
+}
+
+void SkVMBlitterProgramCache::Purge() {
+    ProgramCache::Get()->purge();
+}
+
+void SkVMBlitterProgramCache::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
+    static const char kDumpName[] = "skia/sk_vm_program_cache";
+    const Stats stats = GetStats();
+    dump->dumpNumericValue(kDumpName, "program_count", "objects", stats.fCount);
+    dump->dumpNumericValue(kDumpName, "hits", "objects", stats.fHits);
+    dump->dumpNumericValue(kDumpName, "persistent_hits", "objects", stats.fPersistentHits);
+    dump->dumpNumericValue(kDumpName, "misses", "objects", stats.fMisses);
+    dump->dumpNumericValue(kDumpName, "build_time", "nanoseconds", stats.fBuildNanos);
+}
+
 SkBlitter* SkCreateSkVMBlitter(const SkPixmap& device,
                                const SkPaint& paint,
                                const SkMatrixProvider& matrices,
@@ -5,9 +5,12 @@
  * found in the LICENSE file.
  */
 
+#include "src/effects/imagefilters/SkBlurImageFilter.h"
+
 #include <algorithm>
 
 #include "include/core/SkBitmap.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkTileMode.h"
 #include "include/effects/SkImageFilters.h"
 #include "include/private/SkColorData.h"
@@ -16,11 +19,13 @@
 #include "include/private/SkTPin.h"
 #include "src/core/SkArenaAlloc.h"
 #include "src/core/SkAutoPixmapStorage.h"
+#include "src/core/SkBlurStrips.h"
 #include "src/core/SkGpuBlurUtils.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkOpts.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkSpecialImage.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkWriteBuffer.h"
 
 #if SK_SUPPORT_GPU
@@ -36,7 +41,17 @@ public:
                       sk_sp<SkImageFilter> input, const SkRect* cropRect)
             : INHERITED(&input, 1, cropRect)
             , fSigma{sigmaX, sigmaY}
-            , fTileMode(tileMode) {}
+            , fTileMode(tileMode)
+            , fUseDefaultExecutor(true)
+            , fExecutor(nullptr) {}
+
+    SkBlurImageFilter(SkScalar sigmaX, SkScalar sigmaY,  SkTileMode tileMode,
+                      sk_sp<SkImageFilter> input, const SkRect* cropRect, SkExecutor* executor)
+            : INHERITED(&input, 1, cropRect)
+            , fSigma{sigmaX, sigmaY}
+            , fTileMode(tileMode)
+            , fUseDefaultExecutor(false)
+            , fExecutor(executor) {}
 
     SkRect computeFastBounds(const SkRect&) const override;
 
@@ -57,8 +72,16 @@ private:
             SkIRect inputBounds, SkIRect dstBounds, SkIPoint inputOffset, SkIPoint* offset) const;
 #endif
 
+    SkExecutor* executor() const {
+        return fUseDefaultExecutor ? &SkExecutor::GetDefault() : fExecutor;
+    }
+
     SkSize     fSigma;
     SkTileMode fTileMode;
+    // Large CPU blurs are split across SkExecutor::GetDefault(), or fExecutor if not
+    // fUseDefaultExecutor. A null fExecutor blurs serially.
+    bool        fUseDefaultExecutor;
+    SkExecutor* fExecutor;
 
     using INHERITED = SkImageFilter_Base;
 };
@@ -75,6 +98,17 @@ sk_sp<SkImageFilter> SkImageFilters::Blur(
           new SkBlurImageFilter(sigmaX, sigmaY, tileMode, input, cropRect));
 }
 
+sk_sp<SkImageFilter> SkMakeBlurImageFilter(SkScalar sigmaX, SkScalar sigmaY, SkTileMode tileMode,
+                                           sk_sp<SkImageFilter> input,
+                                           const SkImageFilters::CropRect& cropRect,
+                                           SkExecutor* executor) {
+    if (sigmaX < SK_ScalarNearlyZero && sigmaY < SK_ScalarNearlyZero && !cropRect) {
+        return input;
+    }
+    return sk_sp<SkImageFilter>(
+          new SkBlurImageFilter(sigmaX, sigmaY, tileMode, input, cropRect, executor));
+}
+
 void SkRegisterBlurImageFilterFlattenable() {
     SK_REGISTER_FLATTENABLE(SkBlurImageFilter);
     SkFlattenable::Register("SkBlurImageFilterImpl", SkBlurImageFilter::CreateProc);
@@ -340,6 +374,34 @@ static void blur_one_direction(Sk4u* buffer, int window,
     }
 }
 
+// Like blur_one_direction(), but splits the srcH lines into strips run on executor when there are
+// enough pixels to be worth it. Each line is independent of the others, so only the circular
+// buffers need to be per strip.
+static void blur_one_direction_in_strips(SkExecutor* executor, int window, int64_t pixels,
+                                         int srcLeft, int srcRight, int dstRight,
+                                         const uint32_t* src, int srcXStride, int srcYStride,
+                                         int srcH,
+                                               uint32_t* dst, int dstXStride, int dstYStride) {
+    const int bufferSize = calculate_buffer(window);
+    auto blurStrip = [&](int top, int bottom) {
+        // The amount 1024 is enough for buffers up to 10 sigma.
+        SkSTArenaAlloc<1024> alloc;
+        Sk4u* buffer = alloc.makeArrayDefault<Sk4u>(bufferSize);
+        blur_one_direction(buffer, window, srcLeft, srcRight, dstRight,
+                           src + (int64_t)top * srcYStride, srcXStride, srcYStride, bottom - top,
+                           dst + (int64_t)top * dstYStride, dstXStride, dstYStride);
+    };
+
+    const int strips = executor ? SkBlurStrips::Count(srcH, pixels) : 1;
+    if (strips <= 1) {
+        blurStrip(0, srcH);
+        return;
+    }
+    SkTaskGroup(*executor).batch(strips, [&](int strip) {
+        blurStrip(srcH * strip / strips, srcH * (strip + 1) / strips);
+    });
+}
+
 static sk_sp<SkSpecialImage> copy_image_with_bounds(
         const SkImageFilter_Base::Context& ctx, const sk_sp<SkSpecialImage> &input,
         SkIRect srcBounds, SkIRect dstBounds) {
@@ -409,7 +471,7 @@ static sk_sp<SkSpecialImage> copy_image_with_bounds(
 static sk_sp<SkSpecialImage> cpu_blur(
         const SkImageFilter_Base::Context& ctx,
         SkVector sigma, const sk_sp<SkSpecialImage> &input,
-        SkIRect srcBounds, SkIRect dstBounds) {
+        SkIRect srcBounds, SkIRect dstBounds, SkExecutor* executor) {
     auto windowW = calculate_window(sigma.x()),
          windowH = calculate_window(sigma.y());
 
@@ -446,13 +508,7 @@ static sk_sp<SkSpecialImage> cpu_blur(
         return nullptr;
     }
 
-    auto bufferSizeW = calculate_buffer(windowW),
-         bufferSizeH = calculate_buffer(windowH);
-
-    // The amount 1024 is enough for buffers up to 10 sigma. The tmp bitmap will be
-    // allocated on the heap.
-    SkSTArenaAlloc<1024> alloc;
-    Sk4u* buffer = alloc.makeArrayDefault<Sk4u>(std::max(bufferSizeW, bufferSizeH));
+    const int64_t pixels = (int64_t)dstW * dstH;
 
     // Basic Plan: The three cases to handle
     // * Horizontal and Vertical - blur horizontally while copying values from the source to
@@ -494,16 +550,16 @@ static sk_sp<SkSpecialImage> cpu_blur(
         intermediateWidth = dstW;
         intermediateDst = static_cast<uint32_t *>(dst.getPixels());
 
-        blur_one_direction(
-                buffer, windowW,
+        blur_one_direction_in_strips(
+                executor, windowW, pixels,
                 srcBounds.left(), srcBounds.right(), dstBounds.right(),
                 static_cast<uint32_t *>(src.getPixels()), 1, src.rowBytesAsPixels(), srcH,
                 intermediateSrc, 1, intermediateRowBytesAsPixels);
     }
 
     if (windowH > 1) {
-        blur_one_direction(
-                buffer, windowH,
+        blur_one_direction_in_strips(
+                executor, windowH, pixels,
                 srcBounds.top(), srcBounds.bottom(), dstBounds.bottom(),
                 intermediateSrc, intermediateRowBytesAsPixels, 1, intermediateWidth,
                 intermediateDst, dst.rowBytesAsPixels(), 1);
@@ -591,7 +647,7 @@ sk_sp<SkSpecialImage> SkBlurImageFilter::onFilterImage(const Context& ctx,
         sigma.fX = SkTPin(sigma.fX, 0.0f, 135.0f);
         sigma.fY = SkTPin(sigma.fY, 0.0f, 135.0f);
 
-        result = cpu_blur(ctx, sigma, input, inputBounds, dstBounds);
+        result = cpu_blur(ctx, sigma, input, inputBounds, dstBounds, this->executor());
     }
 
     // Return the resultOffset if the blur succeeded.
@@ -0,0 +1,24 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBlurImageFilter_DEFINED
+#define SkBlurImageFilter_DEFINED
+
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkTileMode.h"
+#include "include/effects/SkImageFilters.h"
+
+class SkExecutor;
+
+// Like SkImageFilters::Blur(), but large CPU blurs are split into strips run on executor instead
+// of SkExecutor::GetDefault(), or run serially if it is null. The executor is not serialized.
+sk_sp<SkImageFilter> SkMakeBlurImageFilter(SkScalar sigmaX, SkScalar sigmaY, SkTileMode tileMode,
+                                           sk_sp<SkImageFilter> input,
+                                           const SkImageFilters::CropRect& cropRect,
+                                           SkExecutor* executor);
+
+#endif
@@ -131,6 +131,13 @@ public:
     virtual bool getROPixels(GrDirectContext*, SkBitmap*,
                              CachingHint = kAllow_CachingHint) const = 0;
 
+    // Returns a read-only copy of a downscaled version of the pixels, no smaller than minScale
+    // times the image's size in either direction, if the image can produce one more cheaply than
+    // the full-size pixels (e.g. by having its codec decode directly to a smaller size). Otherwise
+    // returns false, and the caller should use getROPixels().
+    virtual bool getScaledROPixels(float minScale, SkBitmap*,
+                                   CachingHint = kAllow_CachingHint) const { return false; }
+
     virtual sk_sp<SkImage> onMakeSubset(const SkIRect&, GrDirectContext*) const = 0;
 
     virtual sk_sp<SkData> onRefEncoded() const { return nullptr; }
@@ -127,15 +127,14 @@ SkImage_Lazy::SkImage_Lazy(Validator* validator)
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
-bool SkImage_Lazy::getROPixels(GrDirectContext*, SkBitmap* bitmap,
-                               SkImage::CachingHint chint) const {
+bool SkImage_Lazy::lockPixels(const SkBitmapCacheDesc& desc, const SkImageInfo& info,
+                              SkBitmap* bitmap, SkImage::CachingHint chint) const {
     auto check_output_bitmap = [bitmap]() {
         SkASSERT(bitmap->isImmutable());
         SkASSERT(bitmap->getPixels());
         (void)bitmap;
     };
 
-    auto desc = SkBitmapCacheDesc::Make(this);
     if (SkBitmapCache::Find(desc, bitmap)) {
         check_output_bitmap();
         return true;
@@ -143,14 +142,14 @@ bool SkImage_Lazy::getROPixels(GrDirectContext*, SkBitmap* bitmap,
 
     if (SkImage::kAllow_CachingHint == chint) {
         SkPixmap pmap;
-        SkBitmapCache::RecPtr cacheRec = SkBitmapCache::Alloc(desc, this->imageInfo(), &pmap);
+        SkBitmapCache::RecPtr cacheRec = SkBitmapCache::Alloc(desc, info, &pmap);
         if (!cacheRec || !ScopedGenerator(fSharedGenerator)->getPixels(pmap)) {
             return false;
         }
         SkBitmapCache::Add(std::move(cacheRec), bitmap);
         this->notifyAddedToRasterCache();
     } else {
-        if (!bitmap->tryAllocPixels(this->imageInfo()) ||
+        if (!bitmap->tryAllocPixels(info) ||
             !ScopedGenerator(fSharedGenerator)->getPixels(bitmap->pixmap())) {
             return false;
         }
@@ -161,6 +160,46 @@ bool SkImage_Lazy::getROPixels(GrDirectContext*, SkBitmap* bitmap,
     return true;
 }
 
+bool SkImage_Lazy::getROPixels(GrDirectContext*, SkBitmap* bitmap,
+                               SkImage::CachingHint chint) const {
+    return this->lockPixels(SkBitmapCacheDesc::Make(this), this->imageInfo(), bitmap, chint);
+}
+
+bool SkImage_Lazy::getScaledROPixels(float minScale, SkBitmap* bitmap,
+                                     SkImage::CachingHint chint) const {
+    if (!(minScale > 0 && minScale < 1)) {
+        return false;
+    }
+    const SkISize minDims = {sk_float_ceil2int(minScale * this->width()),
+                             sk_float_ceil2int(minScale * this->height())};
+
+    // Only ask for power-of-two scales. These are the ones codecs decode most cheaply (e.g.
+    // libjpeg-turbo's 1/2, 1/4 and 1/8 DCT scaling), and they keep the number of distinct sizes
+    // in the cache small. Take the smallest the generator supports that still has at least
+    // minScale of the image's resolution.
+    SkISize dims = this->dimensions();
+    {
+        ScopedGenerator generator(fSharedGenerator);
+        for (float scale = 0.125f; scale < 1; scale *= 2) {
+            if (scale < minScale) {
+                continue;
+            }
+            SkISize scaled = generator->getScaledDimensions(scale);
+            if (scaled.width()  >= minDims.width()  && scaled.width()  < this->width() &&
+                scaled.height() >= minDims.height() && scaled.height() < this->height()) {
+                dims = scaled;
+                break;
+            }
+        }
+    }
+    if (dims == this->dimensions()) {
+        return false;
+    }
+
+    return this->lockPixels(SkBitmapCacheDesc::MakeScaled(this, dims),
+                            this->imageInfo().makeDimensions(dims), bitmap, chint);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
 bool SkImage_Lazy::onReadPixels(GrDirectContext* dContext,
@@ -17,6 +17,7 @@
 #endif
 
 class SharedGenerator;
+struct SkBitmapCacheDesc;
 
 class SkImage_Lazy : public SkImage_Base {
 public:
@@ -44,6 +45,7 @@ public:
     sk_sp<SkData> onRefEncoded() const override;
     sk_sp<SkImage> onMakeSubset(const SkIRect&, GrDirectContext*) const override;
     bool getROPixels(GrDirectContext*, SkBitmap*, CachingHint) const override;
+    bool getScaledROPixels(float minScale, SkBitmap*, CachingHint) const override;
     bool onIsLazyGenerated() const override { return true; }
     sk_sp<SkImage> onMakeColorTypeAndColorSpace(SkColorType, sk_sp<SkColorSpace>,
                                                 GrDirectContext*) const override;
@@ -85,6 +87,10 @@ private:
 
     class ScopedGenerator;
 
+    // Generates pixels described by info into bitmap, caching them under desc if chint allows.
+    bool lockPixels(const SkBitmapCacheDesc& desc, const SkImageInfo& info, SkBitmap* bitmap,
+                    CachingHint chint) const;
+
     // Note that this->imageInfo() is not necessarily the info from the generator. It may be
     // cropped by onMakeSubset and its color type/space may be changed by
     // onMakeColorTypeAndColorSpace.
@@ -8,6 +8,7 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkMallocPixelRef.h"
 #include "include/private/SkImageInfoPriv.h"
+#include "src/core/SkBitmapDevice.h"
 #include "src/core/SkDevice.h"
 #include "src/core/SkImagePriv.h"
 #include "src/image/SkSurface_Base.h"
@@ -27,8 +28,11 @@ public:
     void onCopyOnWrite(ContentChangeMode) override;
     void onRestoreBackingMutability() override;
 
+    void setExecutor(SkExecutor* executor) { fExecutor = executor; }
+
 private:
     SkBitmap    fBitmap;
+    SkExecutor* fExecutor = nullptr;
     bool        fWeOwnThePixels;
 
     using INHERITED = SkSurface_Base;
@@ -76,9 +80,19 @@ SkSurface_Raster::SkSurface_Raster(const SkImageInfo& info, sk_sp<SkPixelRef> pr
     fWeOwnThePixels = true;
 }
 
-SkCanvas* SkSurface_Raster::onNewCanvas() { return new SkCanvas(fBitmap, this->props()); }
+SkCanvas* SkSurface_Raster::onNewCanvas() {
+    if (fExecutor) {
+        sk_sp<SkBitmapDevice> device(new SkBitmapDevice(fBitmap, this->props(), nullptr, nullptr));
+        device->setExecutor(fExecutor);
+        return new SkCanvas(std::move(device));
+    }
+    return new SkCanvas(fBitmap, this->props());
+}
 
 sk_sp<SkSurface> SkSurface_Raster::onNewSurface(const SkImageInfo& info) {
+    if (fExecutor) {
+        return SkSurface::MakeRasterThreaded(info, fExecutor, &this->props());
+    }
     return SkSurface::MakeRaster(info, &this->props());
 }
 
@@ -187,6 +201,18 @@ sk_sp<SkSurface> SkSurface::MakeRaster(const SkImageInfo& info, size_t rowBytes,
     return sk_make_sp<SkSurface_Raster>(info, std::move(pr), props);
 }
 
+sk_sp<SkSurface> SkSurface::MakeRasterThreaded(const SkImageInfo& info, SkExecutor* executor,
+                                               const SkSurfaceProps* props) {
+    if (!executor) {
+        return nullptr;
+    }
+    sk_sp<SkSurface> surface = SkSurface::MakeRaster(info, props);
+    if (surface) {
+        static_cast<SkSurface_Raster*>(surface.get())->setExecutor(executor);
+    }
+    return surface;
+}
+
 sk_sp<SkSurface> SkSurface::MakeRasterN32Premul(int width, int height,
                                                 const SkSurfaceProps* surfaceProps) {
     return MakeRaster(SkImageInfo::MakeN32Premul(width, height), surfaceProps);
@@ -6,6 +6,8 @@
  */
 
 #include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkColorSpace.h"
 #include "include/encode/SkJpegEncoder.h"
 #include "include/encode/SkPngEncoder.h"
 #include "include/encode/SkWebpEncoder.h"
@@ -16,6 +18,9 @@ bool SkJpegEncoder::Encode(SkWStream*, const SkPixmap&, const Options&) { return
 std::unique_ptr<SkEncoder> SkJpegEncoder::Make(SkWStream*, const SkPixmap&, const Options&) {
     return nullptr;
 }
+std::unique_ptr<SkEncoder> SkJpegEncoder::Make(SkWStream*, const SkImageInfo&, const Options&) {
+    return nullptr;
+}
 #endif
 
 #ifndef SK_ENCODE_PNG
@@ -23,6 +28,9 @@ bool SkPngEncoder::Encode(SkWStream*, const SkPixmap&, const Options&) { return
 std::unique_ptr<SkEncoder> SkPngEncoder::Make(SkWStream*, const SkPixmap&, const Options&) {
     return nullptr;
 }
+std::unique_ptr<SkEncoder> SkPngEncoder::Make(SkWStream*, const SkImageInfo&, const Options&) {
+    return nullptr;
+}
 #endif
 
 #ifndef SK_ENCODE_WEBP
@@ -84,8 +92,8 @@ bool SkEncodeImage(SkWStream* dst, const SkPixmap& src,
 }
 
 bool SkEncoder::encodeRows(int numRows) {
-    SkASSERT(numRows > 0 && fCurrRow < fSrc.height());
-    if (numRows <= 0 || fCurrRow >= fSrc.height()) {
+    SkASSERT(numRows > 0 && fCurrRow < fSrc.height() && fSrc.addr());
+    if (numRows <= 0 || fCurrRow >= fSrc.height() || !fSrc.addr()) {
         return false;
     }
 
@@ -93,6 +101,8 @@ bool SkEncoder::encodeRows(int numRows) {
         numRows = fSrc.height() - fCurrRow;
     }
 
+    fRows = SkPixmap(fSrc.info().makeWH(fSrc.width(), numRows), fSrc.addr(0, fCurrRow),
+                     fSrc.rowBytes());
     if (!this->onEncodeRows(numRows)) {
         // If we fail, short circuit any future calls.
         fCurrRow = fSrc.height();
@@ -102,6 +112,65 @@ bool SkEncoder::encodeRows(int numRows) {
     return true;
 }
 
+bool SkEncoder::encodeRows(const SkPixmap& rows) {
+    const int numRows = rows.height();
+    SkASSERT(numRows > 0 && fCurrRow + numRows <= fSrc.height());
+    if (numRows <= 0 || fCurrRow + numRows > fSrc.height()) {
+        return false;
+    }
+
+    const SkImageInfo& info = rows.info();
+    if (info.width() != fSrc.width() || info.colorType() != fSrc.colorType() ||
+        info.alphaType() != fSrc.alphaType() ||
+        !SkColorSpace::Equals(info.colorSpace(), fSrc.colorSpace()) ||
+        !rows.addr() || rows.rowBytes() < info.minRowBytes()) {
+        return false;
+    }
+
+    fRows = rows;
+    if (!this->onEncodeRows(numRows)) {
+        fCurrRow = fSrc.height();
+        return false;
+    }
+
+    return true;
+}
+
+bool SkEncoder::encodeDrawnRows(int bandRows, const std::function<void(SkCanvas*)>& draw) {
+    SkASSERT(bandRows > 0);
+    if (bandRows <= 0 || fCurrRow >= fSrc.height()) {
+        return false;
+    }
+
+    SkBitmap band;
+    if (!band.tryAllocPixels(fSrc.info().makeWH(fSrc.width(),
+                                                std::min(bandRows, fSrc.height() - fCurrRow)))) {
+        return false;
+    }
+    std::unique_ptr<SkCanvas> canvas = SkCanvas::MakeRasterDirect(band.info(), band.getPixels(),
+                                                                  band.rowBytes());
+    if (!canvas) {
+        return false;
+    }
+
+    while (fCurrRow < fSrc.height()) {
+        const int numRows = std::min(band.height(), fSrc.height() - fCurrRow);
+        canvas->restoreToCount(1);
+        canvas->save();
+        canvas->clear(SK_ColorTRANSPARENT);
+        canvas->translate(0, -SkIntToScalar(fCurrRow));
+        draw(canvas.get());
+
+        SkPixmap rows;
+        SkAssertResult(band.pixmap().extractSubset(&rows,
+                                                   SkIRect::MakeWH(band.width(), numRows)));
+        if (!this->encodeRows(rows)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 sk_sp<SkData> SkEncodePixmap(const SkPixmap& src, SkEncodedImageFormat format, int quality) {
     SkDynamicMemoryWStream stream;
     return SkEncodeImage(&stream, src, format, quality) ? stream.detachAsData() : nullptr;
@@ -169,7 +169,19 @@ std::unique_ptr<SkEncoder> SkJpegEncoder::Make(SkWStream* dst, const SkPixmap& s
     if (!SkPixmapIsValid(src)) {
         return nullptr;
     }
+    return MakeEncoder(dst, src, options);
+}
 
+std::unique_ptr<SkEncoder> SkJpegEncoder::Make(SkWStream* dst, const SkImageInfo& info,
+                                               const Options& options) {
+    if (!SkImageInfoIsValid(info)) {
+        return nullptr;
+    }
+    return MakeEncoder(dst, SkPixmap(info, nullptr, info.minRowBytes()), options);
+}
+
+std::unique_ptr<SkEncoder> SkJpegEncoder::MakeEncoder(SkWStream* dst, const SkPixmap& src,
+                                                      const Options& options) {
     std::unique_ptr<SkJpegEncoderMgr> encoderMgr = SkJpegEncoderMgr::Make(dst);
 
     skjpeg_error_mgr::AutoPushJmpBuf jmp(encoderMgr->errorMgr());
@@ -182,6 +194,11 @@ std::unique_ptr<SkEncoder> SkJpegEncoder::Make(SkWStream* dst, const SkPixmap& s
     }
 
     jpeg_set_quality(encoderMgr->cinfo(), options.fQuality, TRUE);
+    if (!src.addr()) {
+        // Optimizing the Huffman tables makes libjpeg-turbo buffer the coefficients of the whole
+        // image, which would defeat encoding it a band of rows at a time.
+        encoderMgr->cinfo()->optimize_coding = FALSE;
+    }
     jpeg_start_compress(encoderMgr->cinfo(), TRUE);
 
     sk_sp<SkData> icc = icc_from_color_space(src.info());
@@ -218,7 +235,7 @@ bool SkJpegEncoder::onEncodeRows(int numRows) {
     const size_t srcBytes = SkColorTypeBytesPerPixel(fSrc.colorType()) * fSrc.width();
     const size_t jpegSrcBytes = fEncoderMgr->cinfo()->input_components * fSrc.width();
 
-    const void* srcRow = fSrc.addr(0, fCurrRow);
+    const void* srcRow = fRows.addr();
     for (int i = 0; i < numRows; i++) {
         JSAMPLE* jpegSrcRow = (JSAMPLE*) srcRow;
         if (fEncoderMgr->proc()) {
@@ -238,7 +255,7 @@ bool SkJpegEncoder::onEncodeRows(int numRows) {
         }
 
         jpeg_write_scanlines(fEncoderMgr->cinfo(), &jpegSrcRow, 1);
-        srcRow = SkTAddOffset<const void>(srcRow, fSrc.rowBytes());
+        srcRow = SkTAddOffset<const void>(srcRow, fRows.rowBytes());
     }
 
     fCurrRow += numRows;
@@ -16,10 +16,13 @@
 #include "src/codec/SkColorTable.h"
 #include "src/codec/SkPngPriv.h"
 #include "src/core/SkMSAN.h"
+#include "src/core/SkOpts.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/images/SkImageEncoderFns.h"
 #include <vector>
 
 #include "png.h"
+#include "zlib.h"
 
 static_assert(PNG_FILTER_NONE  == (int)SkPngEncoder::FilterFlag::kNone,  "Skia libpng filter err.");
 static_assert(PNG_FILTER_SUB   == (int)SkPngEncoder::FilterFlag::kSub,   "Skia libpng filter err.");
@@ -59,6 +62,18 @@ public:
     bool writeInfo(const SkImageInfo& srcInfo);
     void chooseProc(const SkImageInfo& srcInfo);
 
+    /*
+     * Filters and deflates all of the rows of src in bands on the executor from the options, as
+     * the data of the IDAT chunks of a single zlib stream. Returns false, having written nothing,
+     * if the rows should be encoded serially by libpng instead.
+     */
+    bool compressInParallel(const SkPixmap& src, std::vector<std::vector<uint8_t>>* idats);
+
+    /*
+     * Writes the IDAT chunks from compressInParallel(), and the IEND chunk.
+     */
+    bool writeIDATsAndEnd(const std::vector<std::vector<uint8_t>>& idats);
+
     png_structp pngPtr() { return fPngPtr; }
     png_infop infoPtr() { return fInfoPtr; }
     int pngBytesPerPixel() const { return fPngBytesPerPixel; }
@@ -79,6 +94,9 @@ private:
     png_infop               fInfoPtr;
     int                     fPngBytesPerPixel;
     transform_scanline_proc fProc;
+    int                     fFilters = PNG_ALL_FILTERS;
+    int                     fZLibLevel = Z_DEFAULT_COMPRESSION;
+    SkExecutor*             fExecutor = nullptr;
 };
 
 std::unique_ptr<SkPngEncoderMgr> SkPngEncoderMgr::Make(SkWStream* stream) {
@@ -197,10 +215,14 @@ bool SkPngEncoderMgr::setHeader(const SkImageInfo& srcInfo, const SkPngEncoder::
     int filters = (int)options.fFilterFlags & (int)SkPngEncoder::FilterFlag::kAll;
     SkASSERT(filters == (int)options.fFilterFlags);
     png_set_filter(fPngPtr, PNG_FILTER_TYPE_BASE, filters);
+    // Like libpng, choose among all of the filters if none are specified.
+    fFilters = filters ? filters : PNG_ALL_FILTERS;
 
     int zlibLevel = std::min(std::max(0, options.fZLibLevel), 9);
     SkASSERT(zlibLevel == options.fZLibLevel);
     png_set_compression_level(fPngPtr, zlibLevel);
+    fZLibLevel = zlibLevel;
+    fExecutor = options.fExecutor;
 
     // Set comments in tEXt chunk
     const sk_sp<SkDataTable>& comments = options.fComments;
@@ -392,12 +414,259 @@ void SkPngEncoderMgr::chooseProc(const SkImageInfo& srcInfo) {
     fProc = choose_proc(srcInfo);
 }
 
+// Bands of rows smaller than this are not worth deflating separately, like the blocks of pigz.
+static constexpr size_t kParallelBandBytes = 128 * 1024;
+
+// The most data before a band that deflate can refer back to.
+static constexpr size_t kDeflateWindowBytes = 32 * 1024;
+
+static uint8_t paeth_predictor(int a, int b, int c) {
+    const int p = a + b - c;
+    const int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return pb <= pc ? b : c;
+}
+
+// The heuristic libpng uses to choose among several filters: the smallest sum of the filtered
+// bytes, each read as signed.
+static size_t filtered_row_cost(const uint8_t* row, size_t len) {
+    size_t sum = 0;
+    for (size_t i = 0; i < len; ++i) {
+        sum += row[i] < 128 ? row[i] : 256 - row[i];
+    }
+    return sum;
+}
+
+/*
+ * Writes the len bytes of row, filtered against prev (the row above, or zeros), to dst as a
+ * filter type byte followed by the filtered bytes. scratch must also hold len + 1 bytes.
+ */
+static void filter_row(const uint8_t* row, const uint8_t* prev, size_t len, size_t bpp,
+                       int filters, uint8_t* dst, uint8_t* scratch) {
+    static constexpr struct {
+        int     fFlag;
+        uint8_t fType;
+    } kFilters[] = {
+        { PNG_FILTER_NONE,  PNG_FILTER_VALUE_NONE  },
+        { PNG_FILTER_SUB,   PNG_FILTER_VALUE_SUB   },
+        { PNG_FILTER_UP,    PNG_FILTER_VALUE_UP    },
+        { PNG_FILTER_AVG,   PNG_FILTER_VALUE_AVG   },
+        { PNG_FILTER_PAETH, PNG_FILTER_VALUE_PAETH },
+    };
+
+    const uint8_t* best = nullptr;
+    size_t bestCost = 0;
+    for (const auto& filter : kFilters) {
+        if (!(filters & filter.fFlag)) {
+            continue;
+        }
+        uint8_t* out = best == dst ? scratch : dst;
+        out[0] = filter.fType;
+        uint8_t* f = out + 1;
+        switch (filter.fType) {
+            case PNG_FILTER_VALUE_NONE:
+                memcpy(f, row, len);
+                break;
+            case PNG_FILTER_VALUE_SUB:
+                for (size_t i = 0; i < len; ++i) {
+                    f[i] = row[i] - (i >= bpp ? row[i - bpp] : 0);
+                }
+                break;
+            case PNG_FILTER_VALUE_UP:
+                for (size_t i = 0; i < len; ++i) {
+                    f[i] = row[i] - prev[i];
+                }
+                break;
+            case PNG_FILTER_VALUE_AVG:
+                for (size_t i = 0; i < len; ++i) {
+                    f[i] = row[i] - (((i >= bpp ? row[i - bpp] : 0) + prev[i]) >> 1);
+                }
+                break;
+            case PNG_FILTER_VALUE_PAETH:
+                for (size_t i = 0; i < len; ++i) {
+                    f[i] = row[i] - paeth_predictor(i >= bpp ? row[i - bpp] : 0, prev[i],
+                                                    i >= bpp ? prev[i - bpp] : 0);
+                }
+                break;
+        }
+        if (filters == filter.fFlag) {
+            // Only one filter to choose from.
+            return;
+        }
+        const size_t cost = filtered_row_cost(f, len);
+        if (!best || cost < bestCost) {
+            best = out;
+            bestCost = cost;
+        }
+    }
+    if (best != dst) {
+        memcpy(dst, best, len + 1);
+    }
+}
+
+/*
+ * Filters the rows [startRow, endRow) of src and deflates them as one band of a zlib stream,
+ * ending with a sync flush so that the next band starts on a byte boundary, or finishing the
+ * stream if this is the last band. The first band begins with the zlib header. The band is primed
+ * with the filtered rows before it, so it compresses nearly as well as in a serial stream.
+ */
+static bool compress_band(const SkPixmap& src, transform_scanline_proc proc, size_t rowBytes,
+                          size_t bpp, int filters, int zlibLevel, int startRow, int endRow,
+                          std::vector<uint8_t>* band, uLong* adler) {
+    const size_t filteredRowBytes = rowBytes + 1;
+    const int primeRows = std::min<int>(startRow, SkToInt((kDeflateWindowBytes +
+                                                           filteredRowBytes - 1) /
+                                                          filteredRowBytes));
+    const int firstRow = startRow - primeRows;
+
+    std::vector<uint8_t> filtered((endRow - firstRow) * filteredRowBytes);
+    std::vector<uint8_t> rows(2 * rowBytes + filteredRowBytes, 0);
+    uint8_t* prev = rows.data();
+    uint8_t* curr = prev + rowBytes;
+    uint8_t* scratch = curr + rowBytes;
+
+    const int srcBytesPerPixel = SkColorTypeBytesPerPixel(src.colorType());
+    if (firstRow > 0) {
+        proc((char*)prev, (const char*)src.addr(0, firstRow - 1), src.width(), srcBytesPerPixel);
+    }
+    for (int y = firstRow; y < endRow; ++y) {
+        const void* srcRow = src.addr(0, y);
+        sk_msan_assert_initialized(srcRow,
+                                   (const uint8_t*)srcRow + (src.width() << src.shiftPerPixel()));
+        proc((char*)curr, (const char*)srcRow, src.width(), srcBytesPerPixel);
+        filter_row(curr, prev, rowBytes, bpp, filters,
+                   filtered.data() + (y - firstRow) * filteredRowBytes, scratch);
+        std::swap(prev, curr);
+    }
+
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    // Negative window bits write raw deflate data, without a zlib header or checksum.
+    const int strategy = filters == PNG_FILTER_NONE ? Z_DEFAULT_STRATEGY : Z_FILTERED;
+    if (Z_OK != deflateInit2(&stream, zlibLevel, Z_DEFLATED, -15, 8, strategy)) {
+        return false;
+    }
+
+    const size_t primeBytes = primeRows * filteredRowBytes;
+    const size_t dictionaryBytes = std::min(primeBytes, kDeflateWindowBytes);
+    bool success = 0 == dictionaryBytes ||
+                   Z_OK == deflateSetDictionary(&stream,
+                                                filtered.data() + primeBytes - dictionaryBytes,
+                                                SkToUInt(dictionaryBytes));
+
+    const bool last = endRow == src.height();
+    const uint8_t* in = filtered.data() + primeBytes;
+    const size_t inBytes = filtered.size() - primeBytes;
+    *adler = SkOpts::adler32_fn(1, in, inBytes);
+
+    size_t headerBytes = 0;
+    if (0 == startRow) {
+        // CMF is deflate with a 32K window. FLEVEL matches what zlib writes for zlibLevel.
+        int flevel = zlibLevel < 2 ? 0 : zlibLevel < 6 ? 1 : zlibLevel == 6 ? 2 : 3;
+        int header = (0x78 << 8) | (flevel << 6);
+        header += 31 - header % 31;
+        band->push_back(header >> 8);
+        band->push_back(header & 0xFF);
+        headerBytes = 2;
+    }
+
+    // Leave room for the sync flush marker (an empty stored block) too.
+    band->resize(headerBytes + deflateBound(&stream, inBytes) + 16);
+    stream.next_in = const_cast<uint8_t*>(in);
+    stream.avail_in = SkToUInt(inBytes);
+    stream.next_out = band->data() + headerBytes;
+    stream.avail_out = SkToUInt(band->size() - headerBytes);
+    if (success) {
+        const int result = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+        success = last ? Z_STREAM_END == result
+                       : Z_OK == result && 0 == stream.avail_in && stream.avail_out > 0;
+    }
+    band->resize(band->size() - stream.avail_out);
+    deflateEnd(&stream);
+    return success;
+}
+
+bool SkPngEncoderMgr::compressInParallel(const SkPixmap& src,
+                                         std::vector<std::vector<uint8_t>>* idats) {
+    // Leave rows that libpng transforms further (e.g. to strip filler) to libpng.
+    const size_t rowBytes = png_get_rowbytes(fPngPtr, fInfoPtr);
+    if (!fExecutor || !fProc || 0 == fZLibLevel ||
+        rowBytes != (size_t)fPngBytesPerPixel * src.width()) {
+        return false;
+    }
+
+    const size_t filteredRowBytes = rowBytes + 1;
+    const int bandRows = SkToInt(std::max<size_t>(kParallelBandBytes / filteredRowBytes, 1));
+    const int bandCount = (src.height() + bandRows - 1) / bandRows;
+    if (bandCount < 2 || filteredRowBytes * bandRows > UINT_MAX / 2) {
+        return false;
+    }
+
+    const size_t bpp = rowBytes / src.width();
+    std::vector<std::vector<uint8_t>> bands(bandCount);
+    std::vector<uLong> adlers(bandCount);
+    std::vector<int> success(bandCount);
+    SkTaskGroup(*fExecutor).batch(bandCount, [&](int i) {
+        const int startRow = i * bandRows;
+        const int endRow = std::min(startRow + bandRows, src.height());
+        success[i] = compress_band(src, fProc, rowBytes, bpp, fFilters, fZLibLevel,
+                                   startRow, endRow, &bands[i], &adlers[i]);
+    });
+
+    // The zlib stream ends with the adler32 of all of the bands' filtered rows.
+    uLong adler = adlers[0];
+    for (int i = 0; i < bandCount; ++i) {
+        if (!success[i]) {
+            return false;
+        }
+        if (i > 0) {
+            const int rows = std::min(bandRows, src.height() - i * bandRows);
+            adler = adler32_combine(adler, adlers[i], (z_off_t)(rows * filteredRowBytes));
+        }
+    }
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        bands.back().push_back((adler >> shift) & 0xFF);
+    }
+
+    *idats = std::move(bands);
+    return true;
+}
+
+bool SkPngEncoderMgr::writeIDATsAndEnd(const std::vector<std::vector<uint8_t>>& idats) {
+    if (setjmp(png_jmpbuf(fPngPtr))) {
+        return false;
+    }
+
+    for (const std::vector<uint8_t>& idat : idats) {
+        png_write_chunk(fPngPtr, (png_const_bytep)"IDAT", idat.data(), idat.size());
+    }
+    // png_write_end() would refuse, as libpng only counts the IDATs it compressed itself. It
+    // would write nothing else anyway: writeInfo() wrote the comments, and there are no other
+    // chunks after the IDATs.
+    png_write_chunk(fPngPtr, (png_const_bytep)"IEND", nullptr, 0);
+    return true;
+}
+
 std::unique_ptr<SkEncoder> SkPngEncoder::Make(SkWStream* dst, const SkPixmap& src,
                                               const Options& options) {
     if (!SkPixmapIsValid(src)) {
         return nullptr;
     }
+    return MakeEncoder(dst, src, options);
+}
 
+std::unique_ptr<SkEncoder> SkPngEncoder::Make(SkWStream* dst, const SkImageInfo& info,
+                                              const Options& options) {
+    if (!SkImageInfoIsValid(info)) {
+        return nullptr;
+    }
+    return MakeEncoder(dst, SkPixmap(info, nullptr, info.minRowBytes()), options);
+}
+
+std::unique_ptr<SkEncoder> SkPngEncoder::MakeEncoder(SkWStream* dst, const SkPixmap& src,
+                                                     const Options& options) {
     std::unique_ptr<SkPngEncoderMgr> encoderMgr = SkPngEncoderMgr::Make(dst);
     if (!encoderMgr) {
         return nullptr;
@@ -428,11 +697,19 @@ SkPngEncoder::SkPngEncoder(std::unique_ptr<SkPngEncoderMgr> encoderMgr, const Sk
 SkPngEncoder::~SkPngEncoder() {}
 
 bool SkPngEncoder::onEncodeRows(int numRows) {
+    if (0 == fCurrRow && numRows == fSrc.height()) {
+        std::vector<std::vector<uint8_t>> idats;
+        if (fEncoderMgr->compressInParallel(fRows, &idats)) {
+            fCurrRow = numRows;
+            return fEncoderMgr->writeIDATsAndEnd(idats);
+        }
+    }
+
     if (setjmp(png_jmpbuf(fEncoderMgr->pngPtr()))) {
         return false;
     }
 
-    const void* srcRow = fSrc.addr(0, fCurrRow);
+    const void* srcRow = fRows.addr();
     for (int y = 0; y < numRows; y++) {
         sk_msan_assert_initialized(srcRow,
                                    (const uint8_t*)srcRow + (fSrc.width() << fSrc.shiftPerPixel()));
@@ -443,7 +720,7 @@ bool SkPngEncoder::onEncodeRows(int numRows) {
 
         png_bytep rowPtr = (png_bytep) fStorage.get();
         png_write_rows(fEncoderMgr->pngPtr(), &rowPtr, 1);
-        srcRow = SkTAddOffset<const void>(srcRow, fSrc.rowBytes());
+        srcRow = SkTAddOffset<const void>(srcRow, fRows.rowBytes());
     }
 
     fCurrRow += numRows;
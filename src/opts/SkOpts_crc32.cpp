@@ -12,6 +12,7 @@
 
 namespace SkOpts {
     void Init_crc32() {
-        hash_fn = crc32::hash_fn;
+        hash_fn  = crc32::hash_fn;
+        crc32_fn = crc32::crc32_fn;
     }
 }
@@ -9,6 +9,7 @@
 #define SK_OPTS_NS ssse3
 #include "src/opts/SkBitmapProcState_opts.h"
 #include "src/opts/SkBlitMask_opts.h"
+#include "src/opts/SkChecksum_opts.h"
 #include "src/opts/SkSwizzler_opts.h"
 #include "src/opts/SkXfermode_opts.h"
 
@@ -25,9 +26,16 @@ namespace SkOpts {
         gray_to_RGB1          = ssse3::gray_to_RGB1;
         grayA_to_RGBA         = ssse3::grayA_to_RGBA;
         grayA_to_rgbA         = ssse3::grayA_to_rgbA;
+        RGB16_to_RGB1         = ssse3::RGB16_to_RGB1;
+        RGB16_to_BGR1         = ssse3::RGB16_to_BGR1;
+        RGBA16_to_RGBA        = ssse3::RGBA16_to_RGBA;
+        RGBA16_to_BGRA        = ssse3::RGBA16_to_BGRA;
+        unpack_small_indices  = ssse3::unpack_small_indices;
         inverted_CMYK_to_RGB1 = ssse3::inverted_CMYK_to_RGB1;
         inverted_CMYK_to_BGR1 = ssse3::inverted_CMYK_to_BGR1;
 
         S32_alpha_D32_filter_DX  = ssse3::S32_alpha_D32_filter_DX;
+
+        adler32_fn = ssse3::adler32_fn;
     }
 }  // namespace SkOpts
@@ -10,6 +10,8 @@
 
 #include "include/private/SkColorData.h"
 #include "include/private/SkVx.h"
+#include <algorithm>
+#include <cstring>
 #include <utility>
 
 #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
@@ -1384,6 +1386,322 @@ static void RGB_to_BGR1_portable(uint32_t dst[], const uint8_t* src, int count)
     }
 #endif
 
+
+// Palette lookups do not vectorize well without a gather, so only AVX2 gets a specialization.
+static void index_to_8888_portable(uint32_t dst[], const uint8_t* src, int count,
+                                   const uint32_t ctable[]) {
+    // Unrolled so that several lookups can be in flight at once.
+    while (count >= 4) {
+        uint32_t c0 = ctable[src[0]],
+                 c1 = ctable[src[1]],
+                 c2 = ctable[src[2]],
+                 c3 = ctable[src[3]];
+        dst[0] = c0;
+        dst[1] = c1;
+        dst[2] = c2;
+        dst[3] = c3;
+        src += 4;
+        dst += 4;
+        count -= 4;
+    }
+    for (int i = 0; i < count; i++) {
+        dst[i] = ctable[src[i]];
+    }
+}
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    /*not static*/ inline void index_to_8888(uint32_t dst[], const uint8_t* src, int count,
+                                             const uint32_t ctable[]) {
+        while (count >= 8) {
+            // Widen 8 indices to 32-bit lanes and look them all up at once.
+            __m256i indices = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*) src));
+            __m256i colors  = _mm256_i32gather_epi32((const int*) ctable, indices, 4);
+            _mm256_storeu_si256((__m256i*) dst, colors);
+
+            src += 8;
+            dst += 8;
+            count -= 8;
+        }
+        index_to_8888_portable(dst, src, count, ctable);
+    }
+#else
+    /*not static*/ inline void index_to_8888(uint32_t dst[], const uint8_t* src, int count,
+                                             const uint32_t ctable[]) {
+        index_to_8888_portable(dst, src, count, ctable);
+    }
+#endif
+
+// 1, 2 and 4-bit indices are packed into bytes starting with the most significant bits.
+static void unpack_small_indices_portable(uint8_t dst[], const uint8_t* src, int count,
+                                          int bitsPerIndex) {
+    const int perByte = 8 / bitsPerIndex;
+    const uint8_t mask = (1 << bitsPerIndex) - 1;
+    while (count > 0) {
+        const uint8_t byte = *src++;
+        const int n = std::min(count, perByte);
+        for (int i = 0; i < n; i++) {
+            dst[i] = (byte >> (8 - bitsPerIndex * (i + 1))) & mask;
+        }
+        dst += n;
+        count -= n;
+    }
+}
+#if defined(SK_ARM_HAS_NEON)
+    /*not static*/ inline void unpack_small_indices(uint8_t dst[], const uint8_t* src, int count,
+                                                    int bitsPerIndex) {
+        // Each iteration unpacks 16 indices from 2 * bitsPerIndex bytes.
+        switch (bitsPerIndex) {
+            case 1: {
+                static const uint8_t kBits[16] = { 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+                                                   0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01 };
+                const uint8x16_t bits = vld1q_u8(kBits);
+                while (count >= 16) {
+                    // Spread each byte across 8 lanes, then test one bit in each.
+                    uint8x16_t bytes = vcombine_u8(vdup_n_u8(src[0]), vdup_n_u8(src[1]));
+                    vst1q_u8(dst, vandq_u8(vtstq_u8(bytes, bits), vdupq_n_u8(1)));
+                    src += 2;
+                    dst += 16;
+                    count -= 16;
+                }
+                break;
+            }
+            case 2: {
+                const uint8x8_t mask = vdup_n_u8(0x3);
+                while (count >= 16) {
+                    uint32_t packed;
+                    memcpy(&packed, src, 4);
+                    uint8x8_t bytes = vreinterpret_u8_u32(vdup_n_u32(packed));
+                    uint8x8x2_t ab = vzip_u8(vshr_n_u8(bytes, 6), vand_u8(vshr_n_u8(bytes, 4), mask)),
+                                cd = vzip_u8(vand_u8(vshr_n_u8(bytes, 2), mask), vand_u8(bytes, mask));
+                    uint16x4x2_t abcd = vzip_u16(vreinterpret_u16_u8(ab.val[0]),
+                                                 vreinterpret_u16_u8(cd.val[0]));
+                    vst1_u8(dst + 0, vreinterpret_u8_u16(abcd.val[0]));
+                    vst1_u8(dst + 8, vreinterpret_u8_u16(abcd.val[1]));
+                    src += 4;
+                    dst += 16;
+                    count -= 16;
+                }
+                break;
+            }
+            case 4: {
+                const uint8x8_t mask = vdup_n_u8(0xF);
+                while (count >= 16) {
+                    uint8x8_t bytes = vld1_u8(src);
+                    uint8x8x2_t hilo = vzip_u8(vshr_n_u8(bytes, 4), vand_u8(bytes, mask));
+                    vst1_u8(dst + 0, hilo.val[0]);
+                    vst1_u8(dst + 8, hilo.val[1]);
+                    src += 8;
+                    dst += 16;
+                    count -= 16;
+                }
+                break;
+            }
+        }
+        unpack_small_indices_portable(dst, src, count, bitsPerIndex);
+    }
+#elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
+    /*not static*/ inline void unpack_small_indices(uint8_t dst[], const uint8_t* src, int count,
+                                                    int bitsPerIndex) {
+        // Each iteration unpacks 16 indices from 2 * bitsPerIndex bytes.  The 16-bit shifts
+        // below move bits between neighboring bytes, but those bits are always masked off.
+        switch (bitsPerIndex) {
+            case 1: {
+                const __m128i spread = _mm_setr_epi8(0,0,0,0,0,0,0,0, 1,1,1,1,1,1,1,1);
+                const __m128i bits = _mm_setr_epi8(-128,64,32,16,8,4,2,1, -128,64,32,16,8,4,2,1);
+                const __m128i ones = _mm_set1_epi8(1);
+                while (count >= 16) {
+                    // Spread each byte across 8 lanes, then test one bit in each.
+                    uint16_t packed;
+                    memcpy(&packed, src, 2);
+                    __m128i bytes = _mm_shuffle_epi8(_mm_cvtsi32_si128(packed), spread);
+                    __m128i set = _mm_cmpeq_epi8(_mm_and_si128(bytes, bits), bits);
+                    _mm_storeu_si128((__m128i*) dst, _mm_and_si128(set, ones));
+                    src += 2;
+                    dst += 16;
+                    count -= 16;
+                }
+                break;
+            }
+            case 2: {
+                const __m128i mask = _mm_set1_epi8(0x3);
+                while (count >= 16) {
+                    int32_t packed;
+                    memcpy(&packed, src, 4);
+                    __m128i bytes = _mm_cvtsi32_si128(packed);
+                    __m128i a = _mm_and_si128(_mm_srli_epi16(bytes, 6), mask),
+                            b = _mm_and_si128(_mm_srli_epi16(bytes, 4), mask),
+                            c = _mm_and_si128(_mm_srli_epi16(bytes, 2), mask),
+                            d = _mm_and_si128(bytes, mask);
+                    __m128i abcd = _mm_unpacklo_epi16(_mm_unpacklo_epi8(a, b),
+                                                      _mm_unpacklo_epi8(c, d));
+                    _mm_storeu_si128((__m128i*) dst, abcd);
+                    src += 4;
+                    dst += 16;
+                    count -= 16;
+                }
+                break;
+            }
+            case 4: {
+                const __m128i mask = _mm_set1_epi8(0xF);
+                while (count >= 16) {
+                    __m128i bytes = _mm_loadl_epi64((const __m128i*) src);
+                    __m128i hi = _mm_and_si128(_mm_srli_epi16(bytes, 4), mask),
+                            lo = _mm_and_si128(bytes, mask);
+                    _mm_storeu_si128((__m128i*) dst, _mm_unpacklo_epi8(hi, lo));
+                    src += 8;
+                    dst += 16;
+                    count -= 16;
+                }
+                break;
+            }
+        }
+        unpack_small_indices_portable(dst, src, count, bitsPerIndex);
+    }
+#else
+    /*not static*/ inline void unpack_small_indices(uint8_t dst[], const uint8_t* src, int count,
+                                                    int bitsPerIndex) {
+        unpack_small_indices_portable(dst, src, count, bitsPerIndex);
+    }
+#endif
+
+// 16-bit components are big-endian, so keeping the first byte of each rounds down to 8 bits.
+static void RGB16_to_RGB1_portable(uint32_t dst[], const uint8_t* src, int count) {
+    for (int i = 0; i < count; i++) {
+        dst[i] = (uint32_t)0xFF   << 24
+               | (uint32_t)src[4] << 16
+               | (uint32_t)src[2] <<  8
+               | (uint32_t)src[0] <<  0;
+        src += 6;
+    }
+}
+static void RGB16_to_BGR1_portable(uint32_t dst[], const uint8_t* src, int count) {
+    for (int i = 0; i < count; i++) {
+        dst[i] = (uint32_t)0xFF   << 24
+               | (uint32_t)src[0] << 16
+               | (uint32_t)src[2] <<  8
+               | (uint32_t)src[4] <<  0;
+        src += 6;
+    }
+}
+static void RGBA16_to_RGBA_portable(uint32_t dst[], const uint8_t* src, int count) {
+    for (int i = 0; i < count; i++) {
+        dst[i] = (uint32_t)src[6] << 24
+               | (uint32_t)src[4] << 16
+               | (uint32_t)src[2] <<  8
+               | (uint32_t)src[0] <<  0;
+        src += 8;
+    }
+}
+static void RGBA16_to_BGRA_portable(uint32_t dst[], const uint8_t* src, int count) {
+    for (int i = 0; i < count; i++) {
+        dst[i] = (uint32_t)src[6] << 24
+               | (uint32_t)src[0] << 16
+               | (uint32_t)src[2] <<  8
+               | (uint32_t)src[4] <<  0;
+        src += 8;
+    }
+}
+#if defined(SK_ARM_HAS_NEON)
+    // Loaded as little-endian 16-bit lanes, the first byte of each component is the low byte.
+    static void strip16_should_swaprb(bool kSwapRB, bool kHasAlpha,
+                                      uint32_t dst[], const uint8_t* src, int count) {
+        while (count >= 8) {
+            uint8x8x4_t rgba;
+            uint8x8_t r, g, b;
+            if (kHasAlpha) {
+                uint16x8x4_t px = vld4q_u16((const uint16_t*) src);
+                r = vmovn_u16(px.val[0]);
+                g = vmovn_u16(px.val[1]);
+                b = vmovn_u16(px.val[2]);
+                rgba.val[3] = vmovn_u16(px.val[3]);
+                src += 8*8;
+            } else {
+                uint16x8x3_t px = vld3q_u16((const uint16_t*) src);
+                r = vmovn_u16(px.val[0]);
+                g = vmovn_u16(px.val[1]);
+                b = vmovn_u16(px.val[2]);
+                rgba.val[3] = vdup_n_u8(0xFF);
+                src += 8*6;
+            }
+            rgba.val[0] = kSwapRB ? b : r;
+            rgba.val[1] = g;
+            rgba.val[2] = kSwapRB ? r : b;
+            vst4_u8((uint8_t*) dst, rgba);
+            dst += 8;
+            count -= 8;
+        }
+
+        auto proc = kHasAlpha ? (kSwapRB ? RGBA16_to_BGRA_portable : RGBA16_to_RGBA_portable)
+                              : (kSwapRB ? RGB16_to_BGR1_portable  : RGB16_to_RGB1_portable);
+        proc(dst, src, count);
+    }
+#elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
+    static void strip16_should_swaprb(bool kSwapRB, bool kHasAlpha,
+                                      uint32_t dst[], const uint8_t* src, int count) {
+        const uint8_t X = 0xFF; // Zeroes the lane.
+        if (kHasAlpha) {
+            // Picks the first byte of each component of two pixels.
+            const __m128i pick = kSwapRB
+                    ? _mm_setr_epi8(4,2,0,6, 12,10,8,14, X,X,X,X, X,X,X,X)
+                    : _mm_setr_epi8(0,2,4,6, 8,10,12,14, X,X,X,X, X,X,X,X);
+            while (count >= 4) {
+                __m128i lo = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (src +  0)), pick),
+                        hi = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (src + 16)), pick);
+                _mm_storeu_si128((__m128i*) dst, _mm_unpacklo_epi64(lo, hi));
+                src += 4*8;
+                dst += 4;
+                count -= 4;
+            }
+        } else {
+            const __m128i alphaMask = _mm_set1_epi32(0xFF000000);
+            // Picks the first byte of each component of the two pixels in the first 12 bytes.
+            const __m128i pick = kSwapRB
+                    ? _mm_setr_epi8(4,2,0,X, 10,8,6,X, X,X,X,X, X,X,X,X)
+                    : _mm_setr_epi8(0,2,4,X, 6,8,10,X, X,X,X,X, X,X,X,X);
+            // The second load reads 4 bytes past the fourth pixel, so leave one more pixel.
+            while (count >= 5) {
+                __m128i lo = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (src +  0)), pick),
+                        hi = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (src + 12)), pick);
+                _mm_storeu_si128((__m128i*) dst,
+                                 _mm_or_si128(_mm_unpacklo_epi64(lo, hi), alphaMask));
+                src += 4*6;
+                dst += 4;
+                count -= 4;
+            }
+        }
+
+        auto proc = kHasAlpha ? (kSwapRB ? RGBA16_to_BGRA_portable : RGBA16_to_RGBA_portable)
+                              : (kSwapRB ? RGB16_to_BGR1_portable  : RGB16_to_RGB1_portable);
+        proc(dst, src, count);
+    }
+#endif
+#if defined(SK_ARM_HAS_NEON) || SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
+    /*not static*/ inline void RGB16_to_RGB1(uint32_t dst[], const uint8_t* src, int count) {
+        strip16_should_swaprb(false, false, dst, src, count);
+    }
+    /*not static*/ inline void RGB16_to_BGR1(uint32_t dst[], const uint8_t* src, int count) {
+        strip16_should_swaprb(true, false, dst, src, count);
+    }
+    /*not static*/ inline void RGBA16_to_RGBA(uint32_t dst[], const uint8_t* src, int count) {
+        strip16_should_swaprb(false, true, dst, src, count);
+    }
+    /*not static*/ inline void RGBA16_to_BGRA(uint32_t dst[], const uint8_t* src, int count) {
+        strip16_should_swaprb(true, true, dst, src, count);
+    }
+#else
+    /*not static*/ inline void RGB16_to_RGB1(uint32_t dst[], const uint8_t* src, int count) {
+        RGB16_to_RGB1_portable(dst, src, count);
+    }
+    /*not static*/ inline void RGB16_to_BGR1(uint32_t dst[], const uint8_t* src, int count) {
+        RGB16_to_BGR1_portable(dst, src, count);
+    }
+    /*not static*/ inline void RGBA16_to_RGBA(uint32_t dst[], const uint8_t* src, int count) {
+        RGBA16_to_RGBA_portable(dst, src, count);
+    }
+    /*not static*/ inline void RGBA16_to_BGRA(uint32_t dst[], const uint8_t* src, int count) {
+        RGBA16_to_BGRA_portable(dst, src, count);
+    }
+#endif
+
 }  // namespace SK_OPTS_NS
 
 #endif // SkSwizzler_opts_DEFINED
@@ -10,6 +10,7 @@
 #include "include/core/SkData.h"
 #include "include/private/SkMalloc.h"
 #include "include/private/SkTo.h"
+#include "src/core/SkOpts.h"
 #include "src/core/SkTraceEvent.h"
 
 #include "zlib.h"
@@ -62,14 +63,73 @@ struct SkDeflateWStream::Impl {
     unsigned char fInBuffer[SKDEFLATEWSTREAM_INPUT_BUFFER_SIZE];
     size_t fInBufferIndex;
     z_stream fZStream;
+    bool fGzip;
+    uint32_t fCheck;  // CRC-32 for gzip, Adler-32 for zlib, of the bytes deflated so far.
 };
 
+// zlib deflates raw, and we write the zlib or gzip wrapper ourselves, so that the check value
+// in its trailer is computed by SkOpts rather than by zlib's scalar code. The wrapper matches
+// what zlib would write itself.
+static void write_header(SkWStream* out, int compressionLevel, bool gzip,
+                         SkDeflateWStream::Strategy strategy) {
+    const int level = compressionLevel < 0 ? 6 : compressionLevel;
+    // zlib hints that Huffman-only and RLE compression are fast, like the lowest levels.
+    const bool fast = level < 2 || strategy == SkDeflateWStream::Strategy::kHuffmanOnly ||
+                                   strategy == SkDeflateWStream::Strategy::kRLE;
+    if (gzip) {
+        // No file name, modification time or other extras. XFL hints at the level, as in zlib.
+        const uint8_t xfl = level == 9 ? 2 : (fast ? 4 : 0);
+        const uint8_t header[] = { 0x1f, 0x8b, Z_DEFLATED, 0, 0, 0, 0, 0, xfl, 0x03 /*Unix*/ };
+        out->write(header, sizeof(header));
+    } else {
+        // CMF is deflate with a 32K window. FLEVEL hints at the level, and FCHECK makes the
+        // pair a multiple of 31.
+        const int flevel = fast ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3;
+        const unsigned header = (0x78 << 8) | (flevel << 6);
+        const uint8_t bytes[] = { 0x78, (uint8_t)((flevel << 6) | (31 - header % 31)) };
+        out->write(bytes, sizeof(bytes));
+    }
+}
+
+// gzip ends with the CRC-32 and length (mod 2^32), little-endian; zlib with the Adler-32,
+// big-endian.
+static void write_trailer(SkWStream* out, bool gzip, uint32_t check, uint32_t length) {
+    if (gzip) {
+        const uint8_t trailer[] = {
+            (uint8_t)(check  >>  0), (uint8_t)(check  >>  8),
+            (uint8_t)(check  >> 16), (uint8_t)(check  >> 24),
+            (uint8_t)(length >>  0), (uint8_t)(length >>  8),
+            (uint8_t)(length >> 16), (uint8_t)(length >> 24),
+        };
+        out->write(trailer, sizeof(trailer));
+    } else {
+        const uint8_t trailer[] = {
+            (uint8_t)(check >> 24), (uint8_t)(check >> 16),
+            (uint8_t)(check >>  8), (uint8_t)(check >>  0),
+        };
+        out->write(trailer, sizeof(trailer));
+    }
+}
+
+static int zlib_strategy(SkDeflateWStream::Strategy strategy) {
+    switch (strategy) {
+        case SkDeflateWStream::Strategy::kDefault:     return Z_DEFAULT_STRATEGY;
+        case SkDeflateWStream::Strategy::kFiltered:    return Z_FILTERED;
+        case SkDeflateWStream::Strategy::kHuffmanOnly: return Z_HUFFMAN_ONLY;
+        case SkDeflateWStream::Strategy::kRLE:         return Z_RLE;
+    }
+    SkUNREACHABLE;
+}
+
 SkDeflateWStream::SkDeflateWStream(SkWStream* out,
                                    int compressionLevel,
-                                   bool gzip)
+                                   bool gzip,
+                                   Strategy strategy)
     : fImpl(std::make_unique<SkDeflateWStream::Impl>()) {
     fImpl->fOut = out;
     fImpl->fInBufferIndex = 0;
+    fImpl->fGzip = gzip;
+    fImpl->fCheck = gzip ? 0 : 1;  // The CRC-32 and Adler-32 of no bytes.
     if (!fImpl->fOut) {
         return;
     }
@@ -79,9 +139,15 @@ SkDeflateWStream::SkDeflateWStream(SkWStream* out,
     fImpl->fZStream.opaque = nullptr;
     SkASSERT(compressionLevel <= 9 && compressionLevel >= -1);
     SkDEBUGCODE(int r =) deflateInit2(&fImpl->fZStream, compressionLevel,
-                                      Z_DEFLATED, gzip ? 0x1F : 0x0F,
-                                      8, Z_DEFAULT_STRATEGY);
+                                      Z_DEFLATED, -0x0F,
+                                      8, zlib_strategy(strategy));
     SkASSERT(Z_OK == r);
+    write_header(fImpl->fOut, compressionLevel, gzip, strategy);
+}
+
+// Updates the check value with bytes about to be deflated.
+static void update_check(bool gzip, uint32_t* check, const void* data, size_t len) {
+    *check = gzip ? SkOpts::crc32_fn(*check, data, len) : SkOpts::adler32_fn(*check, data, len);
 }
 
 SkDeflateWStream::~SkDeflateWStream() { this->finalize(); }
@@ -91,9 +157,11 @@ void SkDeflateWStream::finalize() {
     if (!fImpl->fOut) {
         return;
     }
+    update_check(fImpl->fGzip, &fImpl->fCheck, fImpl->fInBuffer, fImpl->fInBufferIndex);
     do_deflate(Z_FINISH, &fImpl->fZStream, fImpl->fOut, fImpl->fInBuffer,
                fImpl->fInBufferIndex);
     (void)deflateEnd(&fImpl->fZStream);
+    write_trailer(fImpl->fOut, fImpl->fGzip, fImpl->fCheck, (uint32_t)fImpl->fZStream.total_in);
     fImpl->fOut = nullptr;
 }
 
@@ -114,6 +182,7 @@ bool SkDeflateWStream::write(const void* void_buffer, size_t len) {
 
         // if the buffer isn't filled, don't call into zlib yet.
         if (sizeof(fImpl->fInBuffer) == fImpl->fInBufferIndex) {
+            update_check(fImpl->fGzip, &fImpl->fCheck, fImpl->fInBuffer, fImpl->fInBufferIndex);
             do_deflate(Z_NO_FLUSH, &fImpl->fZStream, fImpl->fOut,
                        fImpl->fInBuffer, fImpl->fInBufferIndex);
             fImpl->fInBufferIndex = 0;
@@ -16,9 +16,23 @@
   * this stream using the Deflate algorithm.
   *
   * See http://en.wikipedia.org/wiki/DEFLATE
+  *
+  * Compression is always done by zlib.
+  * TODO: a faster whole-buffer backend (libdeflate, say), chosen at build
+  * time, needs that library vendored under third_party and a bot that
+  * builds it and runs SkPDF_DeflateWStream against it.
   */
 class SkDeflateWStream final : public SkWStream {
 public:
+    /** zlib's compression strategies. Filtered suits data like image rows;
+        HuffmanOnly and RLE are faster, but usually compress less. */
+    enum class Strategy {
+        kDefault,
+        kFiltered,
+        kHuffmanOnly,
+        kRLE,
+    };
+
     /** Does not take ownership of the stream.
 
         @param compressionLevel - 0 is no compression; 1 is best
@@ -29,10 +43,13 @@ public:
         a wrapper, documented in RFC 1952, around a deflate stream."
         gzip adds a header with a magic number to the beginning of the
         stream, allowing a client to identify a gzip file.
+
+        @param strategy - tunes zlib's compression for the kind of data.
      */
     SkDeflateWStream(SkWStream*,
                      int compressionLevel = -1,
-                     bool gzip = false);
+                     bool gzip = false,
+                     Strategy strategy = Strategy::kDefault);
 
     /** The destructor calls finalize(). */
     ~SkDeflateWStream() override;
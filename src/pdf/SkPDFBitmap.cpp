@@ -15,6 +15,8 @@
 #include "include/private/SkColorData.h"
 #include "include/private/SkImageInfoPriv.h"
 #include "include/private/SkTo.h"
+#include "src/core/SkOpts.h"
+#include "src/core/SkResourceCache.h"
 #include "src/pdf/SkDeflate.h"
 #include "src/pdf/SkJpegInfo.h"
 #include "src/pdf/SkPDFDocumentPriv.h"
@@ -66,14 +68,22 @@ static SkColor get_neighbor_avg_color(const SkPixmap& bm, int xOrig, int yOrig)
                  : SK_ColorTRANSPARENT;
 }
 
-template <typename T>
+namespace {
+// An image as written to a PDF: its streams, ready to emit, without the references between them.
+struct SkPDFEncodedImage {
+    sk_sp<SkData> fImage;
+    const char* fColorSpace = "DeviceGray";
+    bool fIsJpeg = false;
+    sk_sp<SkData> fAlpha;  // The image's soft mask, or nullptr if it is opaque.
+};
+}  // namespace
+
 static void emit_image_stream(SkPDFDocument* doc,
                               SkPDFIndirectReference ref,
-                              T writeStream,
+                              const SkData& data,
                               SkISize size,
                               const char* colorSpace,
                               SkPDFIndirectReference sMask,
-                              int length,
                               bool isJpeg) {
     SkPDFDict pdfDict("XObject");
     pdfDict.insertName("Subtype", "Image");
@@ -95,13 +105,22 @@ static void emit_image_stream(SkPDFDocument* doc,
     if (isJpeg) {
         pdfDict.insertInt("ColorTransform", 0);
     }
-    pdfDict.insertInt("Length", length);
-    doc->emitStream(pdfDict, std::move(writeStream), ref);
+    pdfDict.insertInt("Length", SkToInt(data.size()));
+    doc->emitStream(pdfDict, [&data](SkWStream* dst) { dst->write(data.data(), data.size()); },
+                    ref);
 }
 
-static void do_deflated_alpha(const SkPixmap& pm, SkPDFDocument* doc, SkPDFIndirectReference ref) {
+static sk_sp<SkData> finish_deflated(SkDynamicMemoryWStream* buffer) {
+    #ifdef SK_PDF_BASE85_BINARY
+    SkPDFUtils::Base85Encode(buffer->detachAsStream(), buffer);
+    #endif
+    return buffer->detachAsData();
+}
+
+static sk_sp<SkData> do_deflated_alpha(const SkPixmap& pm, int deflateLevel,
+                                       SkDeflateWStream::Strategy strategy) {
     SkDynamicMemoryWStream buffer;
-    SkDeflateWStream deflateWStream(&buffer);
+    SkDeflateWStream deflateWStream(&buffer, deflateLevel, false, strategy);
     if (kAlpha_8_SkColorType == pm.colorType()) {
         SkASSERT(pm.rowBytes() == (size_t)pm.width());
         buffer.write(pm.addr8(), pm.width() * pm.height());
@@ -125,38 +144,25 @@ static void do_deflated_alpha(const SkPixmap& pm, SkPDFDocument* doc, SkPDFIndir
         deflateWStream.write(byteBuffer, dst - byteBuffer);
     }
     deflateWStream.finalize();
-
-    #ifdef SK_PDF_BASE85_BINARY
-    SkPDFUtils::Base85Encode(buffer.detachAsStream(), &buffer);
-    #endif
-    int length = SkToInt(buffer.bytesWritten());
-    emit_image_stream(doc, ref, [&buffer](SkWStream* stream) { buffer.writeToAndReset(stream); },
-                      pm.info().dimensions(), "DeviceGray", SkPDFIndirectReference(),
-                      length, false);
+    return finish_deflated(&buffer);
 }
 
-static void do_deflated_image(const SkPixmap& pm,
-                              SkPDFDocument* doc,
-                              bool isOpaque,
-                              SkPDFIndirectReference ref) {
-    SkPDFIndirectReference sMask;
-    if (!isOpaque) {
-        sMask = doc->reserveRef();
-    }
+static SkPDFEncodedImage do_deflated_image(const SkPixmap& pm, bool isOpaque, int deflateLevel,
+                                           SkDeflateWStream::Strategy strategy) {
+    SkPDFEncodedImage encoded;
     SkDynamicMemoryWStream buffer;
-    SkDeflateWStream deflateWStream(&buffer);
-    const char* colorSpace = "DeviceGray";
+    SkDeflateWStream deflateWStream(&buffer, deflateLevel, false, strategy);
     switch (pm.colorType()) {
         case kAlpha_8_SkColorType:
             fill_stream(&deflateWStream, '\x00', pm.width() * pm.height());
             break;
         case kGray_8_SkColorType:
-            SkASSERT(sMask.fValue = -1);
+            SkASSERT(isOpaque);
             SkASSERT(pm.rowBytes() == (size_t)pm.width());
             deflateWStream.write(pm.addr8(), pm.width() * pm.height());
             break;
         default:
-            colorSpace = "DeviceRGB";
+            encoded.fColorSpace = "DeviceRGB";
             SkASSERT(pm.alphaType() == kUnpremul_SkAlphaType);
             SkASSERT(pm.colorType() == kBGRA_8888_SkColorType);
             SkASSERT(pm.rowBytes() == (size_t)pm.width() * 4);
@@ -183,19 +189,14 @@ static void do_deflated_image(const SkPixmap& pm,
             deflateWStream.write(byteBuffer, dst - byteBuffer);
     }
     deflateWStream.finalize();
-    #ifdef SK_PDF_BASE85_BINARY
-    SkPDFUtils::Base85Encode(buffer.detachAsStream(), &buffer);
-    #endif
-    int length = SkToInt(buffer.bytesWritten());
-    emit_image_stream(doc, ref, [&buffer](SkWStream* stream) { buffer.writeToAndReset(stream); },
-                      pm.info().dimensions(), colorSpace, sMask, length, false);
+    encoded.fImage = finish_deflated(&buffer);
     if (!isOpaque) {
-        do_deflated_alpha(pm, doc, sMask);
+        encoded.fAlpha = do_deflated_alpha(pm, deflateLevel, strategy);
     }
+    return encoded;
 }
 
-static bool do_jpeg(sk_sp<SkData> data, SkPDFDocument* doc, SkISize size,
-                    SkPDFIndirectReference ref) {
+static bool do_jpeg(sk_sp<SkData> data, SkISize size, SkPDFEncodedImage* encoded) {
     SkISize jpegSize;
     SkEncodedInfo::Color jpegColorType;
     SkEncodedOrigin exifOrientation;
@@ -216,10 +217,9 @@ static bool do_jpeg(sk_sp<SkData> data, SkPDFDocument* doc, SkISize size,
     data = buffer.detachAsData();
     #endif
 
-    emit_image_stream(doc, ref,
-                      [&data](SkWStream* dst) { dst->write(data->data(), data->size()); },
-                      jpegSize, yuv ? "DeviceRGB" : "DeviceGray",
-                      SkPDFIndirectReference(), SkToInt(data->size()), true);
+    encoded->fImage = std::move(data);
+    encoded->fColorSpace = yuv ? "DeviceRGB" : "DeviceGray";
+    encoded->fIsJpeg = true;
     return true;
 }
 
@@ -247,28 +247,169 @@ static SkBitmap to_pixels(const SkImage* image) {
     return bm;
 }
 
-void serialize_image(const SkImage* img,
-                     int encodingQuality,
-                     SkPDFDocument* doc,
-                     SkPDFIndirectReference ref) {
-    SkASSERT(img);
-    SkASSERT(doc);
-    SkASSERT(encodingQuality >= 0);
+static SkPDFEncodedImage encode_image(const SkImage* img,
+                                      sk_sp<SkData> encodedData,
+                                      int encodingQuality,
+                                      int deflateLevel,
+                                      SkDeflateWStream::Strategy strategy) {
+    SkPDFEncodedImage encoded;
     SkISize dimensions = img->dimensions();
-    sk_sp<SkData> data = img->refEncodedData();
-    if (data && do_jpeg(std::move(data), doc, dimensions, ref)) {
-        return;
+    if (encodedData && do_jpeg(std::move(encodedData), dimensions, &encoded)) {
+        return encoded;
     }
     SkBitmap bm = to_pixels(img);
     const SkPixmap& pm = bm.pixmap();
     bool isOpaque = pm.isOpaque() || pm.computeIsOpaque();
     if (encodingQuality <= 100 && isOpaque) {
         sk_sp<SkData> data = img->encodeToData(SkEncodedImageFormat::kJPEG, encodingQuality);
-        if (data && do_jpeg(std::move(data), doc, dimensions, ref)) {
-            return;
+        if (data && do_jpeg(std::move(data), dimensions, &encoded)) {
+            return encoded;
+        }
+    }
+    return do_deflated_image(pm, isOpaque, deflateLevel, strategy);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Images with encoded data are kept in SkResourceCache, so that an image drawn to many documents
+// (a logo, say) is only encoded once. They are keyed by a hash of that data, so that different
+// SkImages decoded from the same bytes share an entry. Other images are not cached: nothing would
+// purge an entry keyed by their unique ID once they are gone.
+namespace {
+static unsigned gEncodedImageKeyNamespaceLabel;
+
+// The shared ID is the hash of the image's encoded data.
+struct EncodedImageKey : public SkResourceCache::Key {
+public:
+    EncodedImageKey(const SkImage* img, const SkData& encodedData, int encodingQuality,
+                    int deflateLevel, SkDeflateWStream::Strategy strategy)
+        : fDataSize(SkToU32(encodedData.size()))
+        , fWidth(img->width())
+        , fHeight(img->height())
+        , fColorType(img->colorType())
+        , fEncodingQuality(encodingQuality)
+        , fDeflateLevel(deflateLevel)
+        , fDeflateStrategy((uint32_t)strategy)
+    {
+        static const size_t keySize = sizeof(fDataSize) +
+                                      sizeof(fWidth) +
+                                      sizeof(fHeight) +
+                                      sizeof(fColorType) +
+                                      sizeof(fEncodingQuality) +
+                                      sizeof(fDeflateLevel) +
+                                      sizeof(fDeflateStrategy);
+        // This better be packed.
+        SkASSERT(sizeof(uint32_t) * (&fEndOfStruct - &fDataSize) == keySize);
+        this->init(&gEncodedImageKeyNamespaceLabel,
+                   SkOpts::hash(encodedData.data(), encodedData.size()), keySize);
+    }
+
+private:
+    uint32_t fDataSize;
+    int32_t  fWidth;
+    int32_t  fHeight;
+    uint32_t fColorType;
+    int32_t  fEncodingQuality;
+    int32_t  fDeflateLevel;
+    uint32_t fDeflateStrategy;
+
+    SkDEBUGCODE(uint32_t fEndOfStruct;)
+};
+
+struct EncodedImageRec : public SkResourceCache::Rec {
+    EncodedImageRec(const EncodedImageKey& key,
+                    sk_sp<SkData> encodedData,
+                    SkPDFEncodedImage encoded)
+        : fKey(key)
+        , fEncodedData(std::move(encodedData))
+        , fEncoded(std::move(encoded)) {}
+
+    EncodedImageKey   fKey;
+    // The data hashed into fKey, to check that a hit is not a collision.
+    sk_sp<SkData>     fEncodedData;
+    SkPDFEncodedImage fEncoded;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override {
+        // A JPEG passed through is the encoded data itself.
+        return sizeof(*this) + fEncodedData->size() +
+               (fEncoded.fImage != fEncodedData ? fEncoded.fImage->size() : 0) +
+               (fEncoded.fAlpha ? fEncoded.fAlpha->size() : 0);
+    }
+    const char* getCategory() const override { return "pdf-image"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override { return nullptr; }
+
+    struct Context {
+        const SkData* fEncodedData;
+        SkPDFEncodedImage* fResult;
+        bool fFound;
+    };
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextPtr) {
+        const EncodedImageRec& rec = static_cast<const EncodedImageRec&>(baseRec);
+        Context* context = static_cast<Context*>(contextPtr);
+        if (!rec.fEncodedData->equals(context->fEncodedData)) {
+            return true;
         }
+        *context->fResult = rec.fEncoded;
+        context->fFound = true;
+        return true;
+    }
+};
+}  // namespace
+
+static SkPDFEncodedImage find_or_encode_image(const SkImage* img,
+                                              int encodingQuality,
+                                              int deflateLevel,
+                                              SkDeflateWStream::Strategy strategy) {
+    sk_sp<SkData> encodedData = img->refEncodedData();
+    if (!encodedData) {
+        return encode_image(img, nullptr, encodingQuality, deflateLevel, strategy);
+    }
+    EncodedImageKey key(img, *encodedData, encodingQuality, deflateLevel, strategy);
+
+    SkPDFEncodedImage encoded;
+    EncodedImageRec::Context context = {encodedData.get(), &encoded, false};
+    if (SkResourceCache::Find(key, EncodedImageRec::Visitor, &context) && context.fFound) {
+        return encoded;
+    }
+    encoded = encode_image(img, encodedData, encodingQuality, deflateLevel, strategy);
+    if (encoded.fImage) {
+        SkResourceCache::Add(new EncodedImageRec(key, std::move(encodedData), encoded));
+    }
+    return encoded;
+}
+
+void serialize_image(const SkImage* img,
+                     int encodingQuality,
+                     SkPDFDocument* doc,
+                     SkPDFIndirectReference ref,
+                     SkPDFIndirectReference sMask) {
+    SkASSERT(img);
+    SkASSERT(doc);
+    SkASSERT(encodingQuality >= 0);
+    SkPDFEncodedImage encoded = find_or_encode_image(img, encodingQuality, doc->deflateLevel(),
+                                                     doc->deflateStrategy());
+    SkASSERT(!encoded.fAlpha || sMask);
+    SkISize dimensions = img->dimensions();
+    emit_image_stream(doc, ref, *encoded.fImage, dimensions, encoded.fColorSpace,
+                      encoded.fAlpha ? sMask : SkPDFIndirectReference(), encoded.fIsJpeg);
+    if (encoded.fAlpha) {
+        emit_image_stream(doc, sMask, *encoded.fAlpha, dimensions, "DeviceGray",
+                          SkPDFIndirectReference(), false);
+    } else if (sMask) {
+        // The pixels of an image that were not at hand, say a lazy one's, turned out to be opaque.
+        // Fill the number reserved for its mask regardless.
+        doc->emit(SkPDFDict(), sMask);
     }
-    do_deflated_image(pm, doc, isOpaque, ref);
+}
+
+// Whether img may need a soft mask: it is not opaque, nor are its pixels, if they are at hand.
+// Lazy images have their pixels decoded only once they are serialized, so their mask number is
+// reserved if their alpha type is not opaque, even if the pixels turn out to be.
+static bool may_need_mask(const SkImage* img) {
+    SkPixmap pm;
+    return !img->isOpaque() && !(img->peekPixels(&pm) && pm.computeIsOpaque());
 }
 
 SkPDFIndirectReference SkPDFSerializeImage(const SkImage* img,
@@ -277,16 +418,23 @@ SkPDFIndirectReference SkPDFSerializeImage(const SkImage* img,
     SkASSERT(img);
     SkASSERT(doc);
     SkPDFIndirectReference ref = doc->reserveRef();
+    // A job on the executor cannot reserve the number for the mask once the image turns out to
+    // need one, as other objects may have been numbered since. Reserve it now, with or without an
+    // executor, so that objects are numbered the same way either way.
+    SkPDFIndirectReference sMask;
+    if (may_need_mask(img)) {
+        sMask = doc->reserveRef();
+    }
     if (SkExecutor* executor = doc->executor()) {
         SkRef(img);
         doc->incrementJobCount();
-        executor->add([img, encodingQuality, doc, ref]() {
-            serialize_image(img, encodingQuality, doc, ref);
+        executor->add([img, encodingQuality, doc, ref, sMask]() {
+            serialize_image(img, encodingQuality, doc, ref, sMask);
             SkSafeUnref(img);
             doc->signalJobComplete();
         });
         return ref;
     }
-    serialize_image(img, encodingQuality, doc, ref);
+    serialize_image(img, encodingQuality, doc, ref, sMask);
     return ref;
 }
@@ -347,7 +347,7 @@ void SkPDFDevice::drawAnnotation(const SkRect& rect, const char key[], SkData* v
             SkPoint p = this->localToDevice().mapXY(rect.x(), rect.y());
             pageXform.mapPoints(&p, 1);
             auto pg = fDocument->currentPage();
-            fDocument->fNamedDestinations.push_back(SkPDFNamedDestination{sk_ref_sp(value), p, pg});
+            fDocument->addNamedDestination(SkPDFNamedDestination{sk_ref_sp(value), p, pg});
         }
         return;
     }
@@ -372,7 +372,7 @@ void SkPDFDevice::drawAnnotation(const SkRect& rect, const char key[], SkData* v
     if (linkType != SkPDFLink::Type::kNone) {
         std::unique_ptr<SkPDFLink> link = std::make_unique<SkPDFLink>(
             linkType, value, transformedRect, fNodeId);
-        fDocument->fCurrentPageLinks.push_back(std::move(link));
+        fDocument->addLink(std::move(link));
     }
 }
 
@@ -546,12 +546,12 @@ void SkPDFDevice::setGraphicState(SkPDFIndirectReference gs, SkDynamicMemoryWStr
 
 void SkPDFDevice::clearMaskOnGraphicState(SkDynamicMemoryWStream* contentStream) {
     // The no-softmask graphic state is used to "turn off" the mask for later draw calls.
-    SkPDFIndirectReference& noSMaskGS = fDocument->fNoSmaskGraphicState;
-    if (!noSMaskGS) {
-        SkPDFDict tmp("ExtGState");
-        tmp.insertName("SMask", "None");
-        noSMaskGS = fDocument->emit(tmp);
-    }
+    SkPDFIndirectReference noSMaskGS =
+            fDocument->findOrMake(&fDocument->fNoSmaskGraphicState, [this]() {
+                SkPDFDict tmp("ExtGState");
+                tmp.insertName("SMask", "None");
+                return fDocument->emit(tmp);
+            });
     this->setGraphicState(noSMaskGS, contentStream);
 }
 
@@ -867,6 +867,10 @@ void SkPDFDevice::internalDrawGlyphRun(
     SK_AT_SCOPE_EXIT(if (clusterator.reversedChars()) { out->writeText("EMC\n"); } );
     GlyphPositioner glyphPositioner(out, glyphRunFont.getSkewX(), offset);
     SkPDFFont* font = nullptr;
+    // The glyphs drawn with font, noted as used a batch at a time, since fonts are shared
+    // between pages that may be drawn concurrently.
+    std::vector<SkGlyphID> fontGlyphs;
+    SK_AT_SCOPE_EXIT(if (font) { font->noteGlyphUsage(fontGlyphs, fDocument); });
 
     SkBulkGlyphMetricsAndPaths paths{strikeSpec};
     auto glyphs = paths.glyphs(glyphRun.glyphsIDs());
@@ -930,6 +934,10 @@ void SkPDFDevice::internalDrawGlyphRun(
             }
             if (needs_new_font(font, glyphs[index], fontType)) {
                 // Not yet specified font or need to switch font.
+                if (font) {
+                    font->noteGlyphUsage(fontGlyphs, fDocument);
+                    fontGlyphs.clear();
+                }
                 font = SkPDFFont::GetFontResource(fDocument, glyphs[index], typeface);
                 SkASSERT(font);  // All preconditions for SkPDFFont::GetFontResource are met.
                 glyphPositioner.flush();
@@ -941,7 +949,8 @@ void SkPDFDevice::internalDrawGlyphRun(
                 out->writeText(" Tf\n");
 
             }
-            font->noteGlyphUsage(gid);
+            SkASSERT(font->hasGlyph(gid));
+            fontGlyphs.push_back(gid);
             SkGlyphID encodedGlyph = font->multiByteGlyphs()
                                    ? gid : font->glyphToPDFFontEncoding(gid);
             SkScalar advance = advanceScale * glyphs[index]->advanceX();
@@ -1660,15 +1669,12 @@ void SkPDFDevice::internalDrawImageRect(SkKeyedImage imageSubset,
     }
 
     SkBitmapKey key = imageSubset.key();
-    SkPDFIndirectReference* pdfimagePtr = fDocument->fPDFBitmapMap.find(key);
-    SkPDFIndirectReference pdfimage = pdfimagePtr ? *pdfimagePtr : SkPDFIndirectReference();
-    if (!pdfimagePtr) {
+    SkPDFIndirectReference pdfimage = fDocument->findOrMake(&fDocument->fPDFBitmapMap, key, [&]() {
         SkASSERT(imageSubset);
-        pdfimage = SkPDFSerializeImage(imageSubset.image().get(), fDocument,
-                                       fDocument->metadata().fEncodingQuality);
         SkASSERT((key != SkBitmapKey{{0, 0, 0, 0}, 0}));
-        fDocument->fPDFBitmapMap.set(key, pdfimage);
-    }
+        return SkPDFSerializeImage(imageSubset.image().get(), fDocument,
+                                   fDocument->metadata().fEncodingQuality);
+    });
     SkASSERT(pdfimage != SkPDFIndirectReference());
     this->drawFormXObject(pdfimage, content.stream());
 }
@@ -8,9 +8,11 @@
 #include "include/docs/SkPDFDocument.h"
 #include "src/pdf/SkPDFDocumentPriv.h"
 
+#include "include/core/SkPicture.h"
 #include "include/core/SkStream.h"
 #include "include/docs/SkPDFDocument.h"
 #include "include/private/SkTo.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/pdf/SkPDFDevice.h"
 #include "src/pdf/SkPDFFont.h"
 #include "src/pdf/SkPDFGradientShader.h"
@@ -20,6 +22,7 @@
 #include "src/pdf/SkPDFUtils.h"
 #include "src/utils/SkUTF.h"
 
+#include <algorithm>
 #include <utility>
 
 // For use in SkCanvas::drawAnnotation
@@ -93,6 +96,20 @@ static_assert((SKPDF_MAGIC[1] & 0x7F) == "Skia"[1], "");
 static_assert((SKPDF_MAGIC[2] & 0x7F) == "Skia"[2], "");
 static_assert((SKPDF_MAGIC[3] & 0x7F) == "Skia"[3], "");
 #endif
+
+// SkPDFDocument::deflateLevel() and deflateStrategy() pass these straight to SkDeflateWStream.
+using CompressionLevel = SkPDF::Metadata::CompressionLevel;
+using CompressionStrategy = SkPDF::Metadata::CompressionStrategy;
+static_assert((int)CompressionLevel::Default == -1, "");
+static_assert((int)CompressionLevel::None == 0, "");
+static_assert((int)CompressionLevel::LowButFast == 1, "");
+static_assert((int)CompressionLevel::HighButSlow == 9, "");
+static_assert((int)CompressionStrategy::Default == (int)SkDeflateWStream::Strategy::kDefault, "");
+static_assert((int)CompressionStrategy::Filtered == (int)SkDeflateWStream::Strategy::kFiltered, "");
+static_assert((int)CompressionStrategy::HuffmanOnly ==
+              (int)SkDeflateWStream::Strategy::kHuffmanOnly, "");
+static_assert((int)CompressionStrategy::RLE == (int)SkDeflateWStream::Strategy::kRLE, "");
+
 static void serializeHeader(SkPDFOffsetMap* offsetMap, SkWStream* wStream) {
     offsetMap->markStartOfDocument(wStream);
     wStream->writeText("%PDF-1.4\n%" SKPDF_MAGIC "\n");
@@ -135,68 +152,101 @@ static void serialize_footer(const SkPDFOffsetMap& offsetMap,
     wStream->writeText("\n%%EOF");
 }
 
+// PDF wants a tree describing all the pages in the document.  We arbitrary
+// choose 8 (kPageTreeNodeSize) as the number of allowed children.  The internal
+// nodes have type "Pages" with an array of children, a parent pointer, and
+// the number of leaves below the node as "Count."  The leaves have type "Page"
+// and need a parent pointer.
+static constexpr size_t kPageTreeNodeSize = 8;
+
+namespace {
+struct PageTreeNode {
+    std::unique_ptr<SkPDFDict> fNode;
+    SkPDFIndirectReference fReservedRef;
+    int fPageObjectDescendantCount;
+
+    static std::vector<PageTreeNode> Layer(std::vector<PageTreeNode> vec, SkPDFDocument* doc) {
+        std::vector<PageTreeNode> result;
+        const size_t n = vec.size();
+        SkASSERT(n >= 1);
+        const size_t result_len = (n - 1) / kPageTreeNodeSize + 1;
+        SkASSERT(result_len >= 1);
+        SkASSERT(n == 1 || result_len < n);
+        result.reserve(result_len);
+        size_t index = 0;
+        for (size_t i = 0; i < result_len; ++i) {
+            if (n != 1 && index + 1 == n) {  // No need to create a new node.
+                result.push_back(std::move(vec[index++]));
+                continue;
+            }
+            SkPDFIndirectReference parent = doc->reserveRef();
+            auto kids_list = SkPDFMakeArray();
+            int descendantCount = 0;
+            for (size_t j = 0; j < kPageTreeNodeSize && index < n; ++j) {
+                PageTreeNode& node = vec[index++];
+                node.fNode->insertRef("Parent", parent);
+                kids_list->appendRef(doc->emit(*node.fNode, node.fReservedRef));
+                descendantCount += node.fPageObjectDescendantCount;
+            }
+            auto next = SkPDFMakeDict("Pages");
+            next->insertInt("Count", descendantCount);
+            next->insertObject("Kids", std::move(kids_list));
+            result.push_back(PageTreeNode{std::move(next), parent, descendantCount});
+        }
+        return result;
+    }
+};
+}  // namespace
+
+static SkPDFIndirectReference emit_page_tree(SkPDFDocument* doc,
+                                             std::vector<PageTreeNode> currentLayer) {
+    while (currentLayer.size() > 1) {
+        currentLayer = PageTreeNode::Layer(std::move(currentLayer), doc);
+    }
+    SkASSERT(currentLayer.size() == 1);
+    const PageTreeNode& root = currentLayer[0];
+    return doc->emit(*root.fNode, root.fReservedRef);
+}
+
+// Builds the tree bottom up from the pages, skipping internal nodes that would
+// have only one child.
 static SkPDFIndirectReference generate_page_tree(
         SkPDFDocument* doc,
         std::vector<std::unique_ptr<SkPDFDict>> pages,
         const std::vector<SkPDFIndirectReference>& pageRefs) {
-    // PDF wants a tree describing all the pages in the document.  We arbitrary
-    // choose 8 (kNodeSize) as the number of allowed children.  The internal
-    // nodes have type "Pages" with an array of children, a parent pointer, and
-    // the number of leaves below the node as "Count."  The leaves are passed
-    // into the method, have type "Page" and need a parent pointer. This method
-    // builds the tree bottom up, skipping internal nodes that would have only
-    // one child.
     SkASSERT(pages.size() > 0);
-    struct PageTreeNode {
-        std::unique_ptr<SkPDFDict> fNode;
-        SkPDFIndirectReference fReservedRef;
-        int fPageObjectDescendantCount;
-
-        static std::vector<PageTreeNode> Layer(std::vector<PageTreeNode> vec, SkPDFDocument* doc) {
-            std::vector<PageTreeNode> result;
-            static constexpr size_t kMaxNodeSize = 8;
-            const size_t n = vec.size();
-            SkASSERT(n >= 1);
-            const size_t result_len = (n - 1) / kMaxNodeSize + 1;
-            SkASSERT(result_len >= 1);
-            SkASSERT(n == 1 || result_len < n);
-            result.reserve(result_len);
-            size_t index = 0;
-            for (size_t i = 0; i < result_len; ++i) {
-                if (n != 1 && index + 1 == n) {  // No need to create a new node.
-                    result.push_back(std::move(vec[index++]));
-                    continue;
-                }
-                SkPDFIndirectReference parent = doc->reserveRef();
-                auto kids_list = SkPDFMakeArray();
-                int descendantCount = 0;
-                for (size_t j = 0; j < kMaxNodeSize && index < n; ++j) {
-                    PageTreeNode& node = vec[index++];
-                    node.fNode->insertRef("Parent", parent);
-                    kids_list->appendRef(doc->emit(*node.fNode, node.fReservedRef));
-                    descendantCount += node.fPageObjectDescendantCount;
-                }
-                auto next = SkPDFMakeDict("Pages");
-                next->insertInt("Count", descendantCount);
-                next->insertObject("Kids", std::move(kids_list));
-                result.push_back(PageTreeNode{std::move(next), parent, descendantCount});
-            }
-            return result;
-        }
-    };
     std::vector<PageTreeNode> currentLayer;
     currentLayer.reserve(pages.size());
     SkASSERT(pages.size() == pageRefs.size());
     for (size_t i = 0; i < pages.size(); ++i) {
         currentLayer.push_back(PageTreeNode{std::move(pages[i]), pageRefs[i], 1});
     }
-    currentLayer = PageTreeNode::Layer(std::move(currentLayer), doc);
-    while (currentLayer.size() > 1) {
-        currentLayer = PageTreeNode::Layer(std::move(currentLayer), doc);
+    return emit_page_tree(doc, PageTreeNode::Layer(std::move(currentLayer), doc));
+}
+
+// For fStreamPages, the pages have already been written, each group of
+// kPageTreeNodeSize pointing to the parent in parentRefs. Builds the rest of
+// the tree from those parents up.
+static SkPDFIndirectReference generate_streamed_page_tree(
+        SkPDFDocument* doc,
+        const std::vector<SkPDFIndirectReference>& pageRefs,
+        const std::vector<SkPDFIndirectReference>& parentRefs) {
+    SkASSERT(parentRefs.size() == (pageRefs.size() - 1) / kPageTreeNodeSize + 1);
+    std::vector<PageTreeNode> currentLayer;
+    currentLayer.reserve(parentRefs.size());
+    for (size_t i = 0; i < parentRefs.size(); ++i) {
+        auto kids_list = SkPDFMakeArray();
+        const size_t end = std::min(pageRefs.size(), (i + 1) * kPageTreeNodeSize);
+        for (size_t j = i * kPageTreeNodeSize; j < end; ++j) {
+            kids_list->appendRef(pageRefs[j]);
+        }
+        const int count = SkToInt(kids_list->size());
+        auto node = SkPDFMakeDict("Pages");
+        node->insertInt("Count", count);
+        node->insertObject("Kids", std::move(kids_list));
+        currentLayer.push_back(PageTreeNode{std::move(node), parentRefs[i], count});
     }
-    SkASSERT(currentLayer.size() == 1);
-    const PageTreeNode& root = currentLayer[0];
-    return doc->emit(*root.fNode, root.fReservedRef);
+    return emit_page_tree(doc, std::move(currentLayer));
 }
 
 template<typename T, typename... Args>
@@ -246,41 +296,50 @@ void SkPDFDocument::endObject() SK_REQUIRES(fMutex) {
 static SkSize operator*(SkISize u, SkScalar s) { return SkSize{u.width() * s, u.height() * s}; }
 static SkSize operator*(SkSize u, SkScalar s) { return SkSize{u.width() * s, u.height() * s}; }
 
-SkCanvas* SkPDFDocument::onBeginPage(SkScalar width, SkScalar height) {
-    SkASSERT(fCanvas.imageInfo().dimensions().isZero());
-    if (fPages.empty()) {
-        // if this is the first page if the document.
-        {
-            SkAutoMutexExclusive autoMutexAcquire(fMutex);
-            serializeHeader(&fOffsetMap, this->getStream());
-
-        }
+void SkPDFDocument::beginDocument() {
+    {
+        SkAutoMutexExclusive autoMutexAcquire(fMutex);
+        serializeHeader(&fOffsetMap, this->getStream());
+    }
 
-        fInfoDict = this->emit(*SkPDFMetadata::MakeDocumentInformationDict(fMetadata));
-        if (fMetadata.fPDFA) {
-            fUUID = SkPDFMetadata::CreateUUID(fMetadata);
-            // We use the same UUID for Document ID and Instance ID since this
-            // is the first revision of this document (and Skia does not
-            // support revising existing PDF documents).
-            // If we are not in PDF/A mode, don't use a UUID since testing
-            // works best with reproducible outputs.
-            fXMP = SkPDFMetadata::MakeXMPObject(fMetadata, fUUID, fUUID, this);
-        }
+    fInfoDict = this->emit(*SkPDFMetadata::MakeDocumentInformationDict(fMetadata));
+    if (fMetadata.fPDFA) {
+        fUUID = SkPDFMetadata::CreateUUID(fMetadata);
+        // We use the same UUID for Document ID and Instance ID since this
+        // is the first revision of this document (and Skia does not
+        // support revising existing PDF documents).
+        // If we are not in PDF/A mode, don't use a UUID since testing
+        // works best with reproducible outputs.
+        fXMP = SkPDFMetadata::MakeXMPObject(fMetadata, fUUID, fUUID, this);
     }
+}
+
+sk_sp<SkPDFDevice> SkPDFDocument::makePageDevice(SkSize size) {
     // By scaling the page at the device level, we will create bitmap layer
     // devices at the rasterized scale, not the 72dpi scale.  Bitmap layer
     // devices are created when saveLayer is called with an ImageFilter;  see
     // SkPDFDevice::onCreateDevice().
-    SkISize pageSize = (SkSize{width, height} * fRasterScale).toRound();
+    SkISize pageSize = (size * fRasterScale).toRound();
     SkMatrix initialTransform;
     // Skia uses the top left as the origin but PDF natively has the origin at the
     // bottom left. This matrix corrects for that, as well as the raster scale.
     initialTransform.setScaleTranslate(fInverseRasterScale, -fInverseRasterScale,
                                        0, fInverseRasterScale * pageSize.height());
-    fPageDevice = sk_make_sp<SkPDFDevice>(pageSize, this, initialTransform);
-    reset_object(&fCanvas, fPageDevice);
+    return sk_make_sp<SkPDFDevice>(pageSize, this, initialTransform);
+}
+
+SkCanvas* SkPDFDocument::onBeginPage(SkScalar width, SkScalar height) {
+    SkASSERT(fCanvas.imageInfo().dimensions().isZero());
+    if (fPageRefs.empty()) {
+        // if this is the first page if the document.
+        this->beginDocument();
+    }
+    fCurrentPage.fIndex = fPageRefs.size();
+    fCurrentPage.fDevice = this->makePageDevice({width, height});
+    reset_object(&fCanvas, fCurrentPage.fDevice);
     fCanvas.scale(fRasterScale, fRasterScale);
-    fPageRefs.push_back(this->reserveRef());
+    fCurrentPage.fRef = this->reserveRef();
+    fPageRefs.push_back(fCurrentPage.fRef);
     return &fCanvas;
 }
 
@@ -312,15 +371,15 @@ static SkPDFIndirectReference append_destinations(
     return doc->emit(destinations);
 }
 
-std::unique_ptr<SkPDFArray> SkPDFDocument::getAnnotations() {
+std::unique_ptr<SkPDFArray> SkPDFDocument::getAnnotations(const PageState& page) {
     std::unique_ptr<SkPDFArray> array;
-    size_t count = fCurrentPageLinks.size();
+    size_t count = page.fLinks.size();
     if (0 == count) {
         return array;  // is nullptr
     }
     array = SkPDFMakeArray();
     array->reserve(count);
-    for (const auto& link : fCurrentPageLinks) {
+    for (const auto& link : page.fLinks) {
         SkPDFDict annotation("Annot");
         populate_link_annotation(&annotation, link->fRect);
         if (link->fType == SkPDFLink::Type::kUrl) {
@@ -344,38 +403,174 @@ std::unique_ptr<SkPDFArray> SkPDFDocument::getAnnotations() {
         SkPDFIndirectReference annotationRef = emit(annotation);
         array->appendRef(annotationRef);
         if (link->fNodeId) {
-            fTagTree.addNodeAnnotation(link->fNodeId, annotationRef, SkToUInt(this->currentPageIndex()));
+            fTagTree.addNodeAnnotation(link->fNodeId, annotationRef, SkToUInt(page.fIndex));
         }
     }
     return array;
 }
 
+std::unique_ptr<SkPDFDict> SkPDFDocument::finishPage(PageState* page) {
+    SkASSERT(page->fDevice);
+    auto pageDict = SkPDFMakeDict("Page");
+
+    SkSize mediaSize = page->fDevice->imageInfo().dimensions() * fInverseRasterScale;
+    std::unique_ptr<SkStreamAsset> pageContent = page->fDevice->content();
+    auto resourceDict = page->fDevice->makeResourceDict();
+    page->fDevice = nullptr;
+
+    // Everything from here on creates objects.
+    this->waitForTurn();
+
+    pageDict->insertObject("Resources", std::move(resourceDict));
+    pageDict->insertObject("MediaBox", SkPDFUtils::RectToArray(SkRect::MakeSize(mediaSize)));
+
+    if (std::unique_ptr<SkPDFArray> annotations = this->getAnnotations(*page)) {
+        pageDict->insertObject("Annots", std::move(annotations));
+        page->fLinks.clear();
+    }
+
+    pageDict->insertRef("Contents", SkPDFStreamOut(nullptr, std::move(pageContent), this));
+    // The StructParents unique identifier for each page is just its
+    // 0-based page index.
+    pageDict->insertInt("StructParents", SkToInt(page->fIndex));
+
+    for (SkPDFNamedDestination& dest : page->fNamedDestinations) {
+        fNamedDestinations.push_back(std::move(dest));
+    }
+    page->fNamedDestinations.clear();
+
+    if (fMetadata.fStreamPages) {
+        // Write the page now, rather than keeping it to build the page tree.
+        pageDict->insertRef("Parent", this->streamedPageParent(page->fIndex));
+        this->emit(*pageDict, page->fRef);
+        return nullptr;
+    }
+    return pageDict;
+}
+
+SkPDFIndirectReference SkPDFDocument::streamedPageParent(size_t pageIndex) {
+    // Pages are finished in order, so each group's parent is reserved by its first page.
+    if (pageIndex % kPageTreeNodeSize == 0) {
+        SkASSERT(fPageParents.size() == pageIndex / kPageTreeNodeSize);
+        fPageParents.push_back(this->reserveRef());
+    }
+    return fPageParents[pageIndex / kPageTreeNodeSize];
+}
+
+void SkPDFDocument::flushPages() {
+    // Objects the pages use may still be being written by jobs on the executor.
+    this->waitForJobs();
+    SkAutoMutexExclusive autoMutexAcquire(fMutex);
+    this->getStream()->flush();
+}
+
 void SkPDFDocument::onEndPage() {
     SkASSERT(!fCanvas.imageInfo().dimensions().isZero());
     reset_object(&fCanvas);
-    SkASSERT(fPageDevice);
+    std::unique_ptr<SkPDFDict> pageDict = this->finishPage(&fCurrentPage);
+    if (fMetadata.fStreamPages) {
+        this->flushPages();
+    } else {
+        fPages.push_back(std::move(pageDict));
+    }
+}
+
+void SkPDFDocument::onAddPages(const sk_sp<SkPicture> pictures[], int count) {
+    // Tagged PDFs record which page each node's marked content is on as it is drawn, so their
+    // pages are drawn one after another.
+    if (fMetadata.fStructureElementTreeRoot) {
+        this->SkDocument::onAddPages(pictures, count);
+        return;
+    }
+    SkASSERT(fCanvas.imageInfo().dimensions().isZero());
+    if (fPageRefs.empty()) {
+        this->beginDocument();
+    }
 
-    auto page = SkPDFMakeDict("Page");
+    // Every page may draw concurrently with the others, but takes its turn to create objects
+    // (see waitForTurn()) only once the page before it is finished. The page references are
+    // reserved up front, so all pages can refer to each other. The pages are drawn the same way
+    // with or without an executor, so they are numbered the same way too.
+    std::unique_ptr<PageState[]> pages(new PageState[count]);
+    const size_t firstIndex = fPageRefs.size();
+    for (int i = 0; i < count; ++i) {
+        pages[i].fIndex = firstIndex + i;
+        pages[i].fRef = this->reserveRef();
+        fPageRefs.push_back(pages[i].fRef);
+    }
+    pages[0].fHasTurn = true;
+
+    std::vector<std::unique_ptr<SkPDFDict>> pageDicts(count);
+    std::atomic<int> nextPage{0};
+    auto drawPages = [&](int) {
+        // A thread waiting on other work while drawing a page may borrow this task; it must not
+        // start a later page, which would wait for the one beneath it to finish.
+        if (this->concurrentPageState()) {
+            return;
+        }
+        for (int i; (i = nextPage++) < count;) {
+            PageState* page = &pages[i];
+            const SkRect cull = pictures[i]->cullRect();
+            page->fDevice = this->makePageDevice({cull.width(), cull.height()});
+            {
+                SkAutoMutexExclusive lock(fPageStateMutex);
+                fConcurrentPages.set(SkGetThreadID(), page);
+            }
+            {
+                SkCanvas canvas(page->fDevice);
+                canvas.scale(fRasterScale, fRasterScale);
+                canvas.translate(-cull.x(), -cull.y());
+                canvas.drawPicture(pictures[i]);
+            }
+            pageDicts[i] = this->finishPage(page);
+            {
+                SkAutoMutexExclusive lock(fPageStateMutex);
+                fConcurrentPages.remove(SkGetThreadID());
+            }
+            if (i + 1 < count) {
+                pages[i + 1].fTurn.signal();
+            }
+        }
+    };
 
-    SkSize mediaSize = fPageDevice->imageInfo().dimensions() * fInverseRasterScale;
-    std::unique_ptr<SkStreamAsset> pageContent = fPageDevice->content();
-    auto resourceDict = fPageDevice->makeResourceDict();
-    SkASSERT(fPageRefs.size() > 0);
-    fPageDevice = nullptr;
+    fDrawingConcurrently = true;
+    if (fExecutor) {
+        SkTaskGroup(*fExecutor).batch(count, drawPages);
+    } else {
+        drawPages(0);
+    }
+    fDrawingConcurrently = false;
 
-    page->insertObject("Resources", std::move(resourceDict));
-    page->insertObject("MediaBox", SkPDFUtils::RectToArray(SkRect::MakeSize(mediaSize)));
+    if (fMetadata.fStreamPages) {
+        this->flushPages();
+        return;
+    }
+    for (std::unique_ptr<SkPDFDict>& pageDict : pageDicts) {
+        fPages.push_back(std::move(pageDict));
+    }
+}
 
-    if (std::unique_ptr<SkPDFArray> annotations = getAnnotations()) {
-        page->insertObject("Annots", std::move(annotations));
-        fCurrentPageLinks.clear();
+SkPDFDocument::PageState* SkPDFDocument::concurrentPageState() {
+    if (!fDrawingConcurrently) {
+        return nullptr;
     }
+    SkAutoMutexExclusive lock(fPageStateMutex);
+    PageState** page = fConcurrentPages.find(SkGetThreadID());
+    return page ? *page : nullptr;
+}
 
-    page->insertRef("Contents", SkPDFStreamOut(nullptr, std::move(pageContent), this));
-    // The StructParents unique identifier for each page is just its
-    // 0-based page index.
-    page->insertInt("StructParents", SkToInt(this->currentPageIndex()));
-    fPages.emplace_back(std::move(page));
+SkPDFDocument::PageState* SkPDFDocument::pageState() {
+    PageState* page = this->concurrentPageState();
+    return page ? page : &fCurrentPage;
+}
+
+void SkPDFDocument::waitForTurn() {
+    if (PageState* page = this->concurrentPageState()) {
+        if (!page->fHasTurn) {
+            page->fTurn.wait();
+            page->fHasTurn = true;
+        }
+    }
 }
 
 void SkPDFDocument::onAbort() {
@@ -522,8 +717,10 @@ SkPDFIndirectReference SkPDFDocument::getPage(size_t pageIndex) const {
     return fPageRefs[pageIndex];
 }
 
-const SkMatrix& SkPDFDocument::currentPageTransform() const {
-    return fPageDevice->initialTransform();
+const SkMatrix& SkPDFDocument::currentPageTransform() {
+    PageState* page = this->pageState();
+    SkASSERT(page->fDevice);
+    return page->fDevice->initialTransform();
 }
 
 int SkPDFDocument::createMarkIdForNodeId(int nodeId) {
@@ -539,7 +736,7 @@ static std::vector<const SkPDFFont*> get_fonts(const SkPDFDocument& canon) {
     fonts.reserve(canon.fFontMap.count());
     // Sort so the output PDF is reproducible.
     for (const auto& [unused, font] : canon.fFontMap) {
-        fonts.push_back(&font);
+        fonts.push_back(font.get());
     }
     std::sort(fonts.begin(), fonts.end(), [](const SkPDFFont* u, const SkPDFFont* v) {
         return u->indirectReference().fValue < v->indirectReference().fValue;
@@ -549,7 +746,7 @@ static std::vector<const SkPDFFont*> get_fonts(const SkPDFDocument& canon) {
 
 void SkPDFDocument::onClose(SkWStream* stream) {
     SkASSERT(fCanvas.imageInfo().dimensions().isZero());
-    if (fPages.empty()) {
+    if (fPageRefs.empty()) {
         this->waitForJobs();
         return;
     }
@@ -562,7 +759,10 @@ void SkPDFDocument::onClose(SkWStream* stream) {
         docCatalog->insertObject("OutputIntents", make_srgb_output_intents(this));
     }
 
-    docCatalog->insertRef("Pages", generate_page_tree(this, std::move(fPages), fPageRefs));
+    docCatalog->insertRef("Pages",
+                          fMetadata.fStreamPages
+                                  ? generate_streamed_page_tree(this, fPageRefs, fPageParents)
+                                  : generate_page_tree(this, std::move(fPages), fPageRefs));
 
     if (!fNamedDestinations.empty()) {
         docCatalog->insertRef("Dests", append_destinations(this, fNamedDestinations));
@@ -580,9 +780,7 @@ void SkPDFDocument::onClose(SkWStream* stream) {
 
     auto docCatalogRef = this->emit(*docCatalog);
 
-    for (const SkPDFFont* f : get_fonts(*this)) {
-        f->emitSubset(this);
-    }
+    SkPDFFont::EmitSubsets(get_fonts(*this), this);
 
     this->waitForJobs();
     {
@@ -11,7 +11,10 @@
 #include "include/core/SkStream.h"
 #include "include/docs/SkPDFDocument.h"
 #include "include/private/SkMutex.h"
+#include "include/private/SkSemaphore.h"
 #include "include/private/SkTHash.h"
+#include "include/private/SkThreadID.h"
+#include "src/pdf/SkDeflate.h"
 #include "src/pdf/SkPDFMetadata.h"
 #include "src/pdf/SkPDFTag.h"
 
@@ -84,6 +87,7 @@ public:
     ~SkPDFDocument() override;
     SkCanvas* onBeginPage(SkScalar, SkScalar) override;
     void onEndPage() override;
+    void onAddPages(const sk_sp<SkPicture>[], int) override;
     void onClose(SkWStream*) override;
     void onAbort() override;
 
@@ -111,11 +115,14 @@ public:
     }
 
     const SkPDF::Metadata& metadata() const { return fMetadata; }
+    // The fCompressionLevel and fCompressionStrategy of the metadata, for SkDeflateWStream.
+    int deflateLevel() const { return (int)fMetadata.fCompressionLevel; }
+    SkDeflateWStream::Strategy deflateStrategy() const {
+        return (SkDeflateWStream::Strategy)fMetadata.fCompressionStrategy;
+    }
 
     SkPDFIndirectReference getPage(size_t pageIndex) const;
-    SkPDFIndirectReference currentPage() const {
-        return SkASSERT(!fPageRefs.empty()), fPageRefs.back();
-    }
+    SkPDFIndirectReference currentPage() { return this->pageState()->fRef; }
     // Used to allow marked content to refer to its corresponding structure
     // tree node, via a page entry in the parent tree. Returns -1 if no
     // mark ID.
@@ -125,17 +132,78 @@ public:
     // key.
     int createStructParentKeyForNodeId(int nodeId);
 
-    std::unique_ptr<SkPDFArray> getAnnotations();
+    void addLink(std::unique_ptr<SkPDFLink> link) {
+        this->pageState()->fLinks.push_back(std::move(link));
+    }
+    void addNamedDestination(SkPDFNamedDestination dest) {
+        this->pageState()->fNamedDestinations.push_back(std::move(dest));
+    }
 
-    SkPDFIndirectReference reserveRef() { return SkPDFIndirectReference{fNextObjectNumber++}; }
+    SkPDFIndirectReference reserveRef() {
+        this->waitForTurn();
+        return SkPDFIndirectReference{fNextObjectNumber++};
+    }
 
     SkExecutor* executor() const { return fExecutor; }
     void incrementJobCount();
     void signalJobComplete();
-    size_t currentPageIndex() { return fPages.size(); }
+    size_t currentPageIndex() { return this->pageState()->fIndex; }
     size_t pageCount() { return fPageRefs.size(); }
 
-    const SkMatrix& currentPageTransform() const;
+    const SkMatrix& currentPageTransform();
+
+    // While onAddPages() draws pages concurrently, a page may only create new objects once every
+    // earlier page is finished, so that objects are numbered as if the pages were drawn in order.
+    // Blocks the calling thread until then if it is drawing such a page; otherwise returns.
+    void waitForTurn();
+
+    // Returns the object canonicalized as key in map, calling make() to create it if there is
+    // none yet. Safe to call while pages are drawn concurrently.
+    template <typename Map, typename Key, typename Make>
+    SkPDFIndirectReference findOrMake(Map* map, Key&& key, Make&& make) {
+        {
+            SkAutoMutexExclusive lock(fCanonMutex);
+            if (SkPDFIndirectReference* ref = map->find(key)) {
+                return *ref;
+            }
+        }
+        // Only the page whose turn it is creates objects, so no other may add key meanwhile.
+        this->waitForTurn();
+        {
+            SkAutoMutexExclusive lock(fCanonMutex);
+            if (SkPDFIndirectReference* ref = map->find(key)) {
+                return *ref;
+            }
+        }
+        SkPDFIndirectReference ref = make();
+        SkAutoMutexExclusive lock(fCanonMutex);
+        map->set(std::forward<Key>(key), ref);
+        return ref;
+    }
+
+    // As above, for an object of which the document needs at most one.
+    template <typename Make>
+    SkPDFIndirectReference findOrMake(SkPDFIndirectReference* canon, Make&& make) {
+        {
+            SkAutoMutexExclusive lock(fCanonMutex);
+            if (*canon) {
+                return *canon;
+            }
+        }
+        this->waitForTurn();
+        {
+            SkAutoMutexExclusive lock(fCanonMutex);
+            if (*canon) {
+                return *canon;
+            }
+        }
+        SkPDFIndirectReference ref = make();
+        SkAutoMutexExclusive lock(fCanonMutex);
+        return *canon = ref;
+    }
+
+    // Guards the canonicalized objects below, and the glyph usage of fonts in fFontMap.
+    SkMutex fCanonMutex;
 
     // Canonicalized objects
     SkTHashMap<SkPDFImageShaderKey, SkPDFIndirectReference> fImageShaderMap;
@@ -144,24 +212,52 @@ public:
     SkTHashMap<SkBitmapKey, SkPDFIndirectReference> fPDFBitmapMap;
     SkTHashMap<uint32_t, std::unique_ptr<SkAdvancedTypefaceMetrics>> fTypefaceMetrics;
     SkTHashMap<uint32_t, std::vector<SkString>> fType1GlyphNames;
-    SkTHashMap<uint32_t, std::vector<SkUnichar>> fToUnicodeMap;
+    // Values are held by pointer, so that pointers to them stay valid as other threads add more.
+    SkTHashMap<uint32_t, std::unique_ptr<std::vector<SkUnichar>>> fToUnicodeMap;
     SkTHashMap<uint32_t, SkPDFIndirectReference> fFontDescriptors;
     SkTHashMap<uint32_t, SkPDFIndirectReference> fType3FontDescriptors;
-    SkTHashMap<uint64_t, SkPDFFont> fFontMap;
+    SkTHashMap<uint64_t, std::unique_ptr<SkPDFFont>> fFontMap;
     SkTHashMap<SkPDFStrokeGraphicState, SkPDFIndirectReference> fStrokeGSMap;
     SkTHashMap<SkPDFFillGraphicState, SkPDFIndirectReference> fFillGSMap;
     SkPDFIndirectReference fInvertFunction;
     SkPDFIndirectReference fNoSmaskGraphicState;
-    std::vector<std::unique_ptr<SkPDFLink>> fCurrentPageLinks;
-    std::vector<SkPDFNamedDestination> fNamedDestinations;
 
 private:
+    // A page being drawn: the one begun by onBeginPage(), or one drawn by onAddPages().
+    struct PageState {
+        size_t fIndex = 0;
+        SkPDFIndirectReference fRef;
+        sk_sp<SkPDFDevice> fDevice;
+        std::vector<std::unique_ptr<SkPDFLink>> fLinks;
+        std::vector<SkPDFNamedDestination> fNamedDestinations;
+        // For onAddPages(): signaled once the page before this one is finished.
+        SkSemaphore fTurn;
+        bool fHasTurn = false;
+    };
+
+    PageState* pageState();
+    PageState* concurrentPageState();
+    void beginDocument();
+    sk_sp<SkPDFDevice> makePageDevice(SkSize);
+    std::unique_ptr<SkPDFDict> finishPage(PageState*);
+    SkPDFIndirectReference streamedPageParent(size_t pageIndex);
+    void flushPages();
+    std::unique_ptr<SkPDFArray> getAnnotations(const PageState&);
+
     SkPDFOffsetMap fOffsetMap;
     SkCanvas fCanvas;
     std::vector<std::unique_ptr<SkPDFDict>> fPages;
     std::vector<SkPDFIndirectReference> fPageRefs;
+    // For fStreamPages: the parent in the page tree of each group of pages written so far.
+    std::vector<SkPDFIndirectReference> fPageParents;
+    std::vector<SkPDFNamedDestination> fNamedDestinations;
+
+    PageState fCurrentPage;
+    // The pages onAddPages() is drawing, by the thread drawing each.
+    std::atomic<bool> fDrawingConcurrently = {false};
+    SkMutex fPageStateMutex;
+    SkTHashMap<SkThreadID, PageState*> fConcurrentPages;
 
-    sk_sp<SkPDFDevice> fPageDevice;
     std::atomic<int> fNextObjectNumber = {1};
     std::atomic<int> fJobCount = {0};
     SkUUID fUUID;
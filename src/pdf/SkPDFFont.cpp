@@ -33,6 +33,7 @@
 #include "src/core/SkScalerCache.h"
 #include "src/core/SkScalerContext.h"
 #include "src/core/SkStrikeSpec.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/pdf/SkPDFBitmap.h"
 #include "src/pdf/SkPDFDocumentPriv.h"
 #include "src/pdf/SkPDFFont.h"
@@ -107,12 +108,16 @@ const SkAdvancedTypefaceMetrics* SkPDFFont::GetMetrics(const SkTypeface* typefac
                                                        SkPDFDocument* canon) {
     SkASSERT(typeface);
     SkFontID id = typeface->uniqueID();
-    if (std::unique_ptr<SkAdvancedTypefaceMetrics>* ptr = canon->fTypefaceMetrics.find(id)) {
-        return ptr->get();  // canon retains ownership.
+    {
+        SkAutoMutexExclusive lock(canon->fCanonMutex);
+        if (std::unique_ptr<SkAdvancedTypefaceMetrics>* ptr = canon->fTypefaceMetrics.find(id)) {
+            return ptr->get();  // canon retains ownership.
+        }
     }
     int count = typeface->countGlyphs();
     if (count <= 0 || count > 1 + SkTo<int>(UINT16_MAX)) {
         // Cache nullptr to skip this check.  Use SkSafeUnref().
+        SkAutoMutexExclusive lock(canon->fCanonMutex);
         canon->fTypefaceMetrics.set(id, nullptr);
         return nullptr;
     }
@@ -150,6 +155,11 @@ const SkAdvancedTypefaceMetrics* SkPDFFont::GetMetrics(const SkTypeface* typefac
             metrics->fCapHeight = SkToS16(SkScalarRoundToInt(capHeight / 2));
         }
     }
+    // Another page may have made the same metrics meanwhile; keep the first.
+    SkAutoMutexExclusive lock(canon->fCanonMutex);
+    if (std::unique_ptr<SkAdvancedTypefaceMetrics>* ptr = canon->fTypefaceMetrics.find(id)) {
+        return ptr->get();
+    }
     return canon->fTypefaceMetrics.set(id, std::move(metrics))->get();
 }
 
@@ -158,12 +168,19 @@ const std::vector<SkUnichar>& SkPDFFont::GetUnicodeMap(const SkTypeface* typefac
     SkASSERT(typeface);
     SkASSERT(canon);
     SkFontID id = typeface->uniqueID();
-    if (std::vector<SkUnichar>* ptr = canon->fToUnicodeMap.find(id)) {
-        return *ptr;
+    {
+        SkAutoMutexExclusive lock(canon->fCanonMutex);
+        if (std::unique_ptr<std::vector<SkUnichar>>* ptr = canon->fToUnicodeMap.find(id)) {
+            return **ptr;
+        }
     }
-    std::vector<SkUnichar> buffer(typeface->countGlyphs());
-    typeface->getGlyphToUnicodeMap(buffer.data());
-    return *canon->fToUnicodeMap.set(id, std::move(buffer));
+    auto buffer = std::make_unique<std::vector<SkUnichar>>(typeface->countGlyphs());
+    typeface->getGlyphToUnicodeMap(buffer->data());
+    SkAutoMutexExclusive lock(canon->fCanonMutex);
+    if (std::unique_ptr<std::vector<SkUnichar>>* ptr = canon->fToUnicodeMap.find(id)) {
+        return **ptr;
+    }
+    return **canon->fToUnicodeMap.set(id, std::move(buffer));
 }
 
 SkAdvancedTypefaceMetrics::FontType SkPDFFont::FontType(const SkAdvancedTypefaceMetrics& metrics) {
@@ -197,8 +214,18 @@ SkPDFFont* SkPDFFont::GetFontResource(SkPDFDocument* doc,
             multibyte ? 0 : first_nonzero_glyph_for_single_byte_encoding(glyph->getGlyphID());
     uint64_t fontID = (static_cast<uint64_t>(SkTypeface::UniqueID(face)) << 16) | subsetCode;
 
-    if (SkPDFFont* found = doc->fFontMap.find(fontID)) {
-        SkASSERT(multibyte == found->multiByteGlyphs());
+    auto find = [&]() -> SkPDFFont* {
+        SkAutoMutexExclusive lock(doc->fCanonMutex);
+        std::unique_ptr<SkPDFFont>* found = doc->fFontMap.find(fontID);
+        SkASSERT(!found || multibyte == (*found)->multiByteGlyphs());
+        return found ? found->get() : nullptr;
+    };
+    if (SkPDFFont* found = find()) {
+        return found;
+    }
+    // Only the page whose turn it is creates fonts; see SkPDFDocument::findOrMake().
+    doc->waitForTurn();
+    if (SkPDFFont* found = find()) {
         return found;
     }
 
@@ -218,8 +245,10 @@ SkPDFFont* SkPDFFont::GetFontResource(SkPDFDocument* doc,
         lastGlyph = SkToU16(std::min<int>((int)lastGlyph, 254 + (int)subsetCode));
     }
     auto ref = doc->reserveRef();
-    return doc->fFontMap.set(
-            fontID, SkPDFFont(std::move(typeface), firstNonZeroGlyph, lastGlyph, type, ref));
+    std::unique_ptr<SkPDFFont> font(
+            new SkPDFFont(std::move(typeface), firstNonZeroGlyph, lastGlyph, type, ref));
+    SkAutoMutexExclusive lock(doc->fCanonMutex);
+    return doc->fFontMap.set(fontID, std::move(font))->get();
 }
 
 SkPDFFont::SkPDFFont(sk_sp<SkTypeface> typeface,
@@ -236,6 +265,13 @@ SkPDFFont::SkPDFFont(sk_sp<SkTypeface> typeface,
     this->noteGlyphUsage(0);
 }
 
+void SkPDFFont::noteGlyphUsage(const std::vector<SkGlyphID>& glyphs, SkPDFDocument* doc) {
+    SkAutoMutexExclusive lock(doc->fCanonMutex);
+    for (SkGlyphID glyph : glyphs) {
+        this->noteGlyphUsage(glyph);
+    }
+}
+
 void SkPDFFont::PopulateCommonFontDescriptor(SkPDFDict* descriptor,
                                              const SkAdvancedTypefaceMetrics& metrics,
                                              uint16_t emSize,
@@ -280,7 +316,83 @@ static sk_sp<SkData> stream_to_data(std::unique_ptr<SkStreamAsset> stream) {
     return SkData::MakeFromStream(stream.get(), size);
 }
 
-static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc) {
+namespace {
+// The parts of a Type0 font that are slowest to make: its embedded font file, glyph widths and
+// ToUnicode map. They only read from the document, so can be made concurrently for all fonts.
+struct Type0Parts {
+    std::unique_ptr<SkStreamAsset> fFontFile;  // Null if the typeface has no data.
+    SkScalar fDefaultWidth = 0;
+    std::unique_ptr<SkPDFArray> fWidths;
+    std::unique_ptr<SkStreamAsset> fToUnicode;
+};
+}  // namespace
+
+static std::unique_ptr<SkStreamAsset> make_font_file(const SkPDFFont& font,
+                                                     const SkAdvancedTypefaceMetrics& metrics,
+                                                     SkPDFDocument* doc) {
+    SkTypeface* face = font.typeface();
+    const SkPDF::Metadata::Subsetter subsetter = doc->metadata().fSubsetter;
+    const bool subsettable =
+            font.getType() == SkAdvancedTypefaceMetrics::kTrueType_Font &&
+            !SkToBool(metrics.fFlags & SkAdvancedTypefaceMetrics::kNotSubsettable_FontFlag);
+    if (subsettable) {
+        if (sk_sp<SkData> subsetFontData =
+                    SkPDFFindSubsetFont(face->uniqueID(), font.glyphUsage(), subsetter)) {
+            return SkMemoryStream::Make(std::move(subsetFontData));
+        }
+    }
+
+    int ttcIndex;
+    std::unique_ptr<SkStreamAsset> fontAsset = face->openStream(&ttcIndex);
+    size_t fontSize = fontAsset ? fontAsset->getLength() : 0;
+    if (0 == fontSize) {
+        SkDebugf("Error: (SkTypeface)(%p)::openStream() returned "
+                 "empty stream (%p) when identified as kType1CID_Font "
+                 "or kTrueType_Font.\n", face, fontAsset.get());
+        return nullptr;
+    }
+    if (subsettable) {
+        SkASSERT(font.firstGlyphID() == 1);
+        sk_sp<SkData> subsetFontData = SkPDFSubsetFont(
+                stream_to_data(std::move(fontAsset)), font.glyphUsage(), subsetter,
+                metrics.fFontName.c_str(), ttcIndex);
+        if (subsetFontData) {
+            SkPDFAddSubsetFont(face->uniqueID(), font.glyphUsage(), subsetter, subsetFontData);
+            return SkMemoryStream::Make(std::move(subsetFontData));
+        }
+        // If subsetting fails, fall back to original font data.
+        fontAsset = face->openStream(&ttcIndex);
+        SkASSERT(fontAsset);
+        SkASSERT(fontAsset->getLength() == fontSize);
+        if (!fontAsset || fontAsset->getLength() == 0) { return nullptr; }
+    }
+    return fontAsset;
+}
+
+static Type0Parts make_type0_parts(const SkPDFFont& font, SkPDFDocument* doc) {
+    Type0Parts parts;
+    const SkAdvancedTypefaceMetrics* metricsPtr =
+        SkPDFFont::GetMetrics(font.typeface(), doc);
+    SkASSERT(metricsPtr);
+    if (!metricsPtr) { return parts; }
+    SkTypeface* face = font.typeface();
+    SkASSERT(face);
+
+    parts.fFontFile = make_font_file(font, *metricsPtr, doc);
+    parts.fWidths = SkPDFMakeCIDGlyphWidthsArray(*face, font.glyphUsage(), &parts.fDefaultWidth);
+
+    const std::vector<SkUnichar>& glyphToUnicode =
+        SkPDFFont::GetUnicodeMap(font.typeface(), doc);
+    SkASSERT(SkToSizeT(font.typeface()->countGlyphs()) == glyphToUnicode.size());
+    parts.fToUnicode = SkPDFMakeToUnicodeCmap(glyphToUnicode.data(),
+                                              &font.glyphUsage(),
+                                              font.multiByteGlyphs(),
+                                              font.firstGlyphID(),
+                                              font.lastGlyphID());
+    return parts;
+}
+
+static void emit_subset_type0(const SkPDFFont& font, Type0Parts parts, SkPDFDocument* doc) {
     const SkAdvancedTypefaceMetrics* metricsPtr =
         SkPDFFont::GetMetrics(font.typeface(), doc);
     SkASSERT(metricsPtr);
@@ -288,50 +400,18 @@ static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc) {
     const SkAdvancedTypefaceMetrics& metrics = *metricsPtr;
     SkASSERT(can_embed(metrics));
     SkAdvancedTypefaceMetrics::FontType type = font.getType();
-    SkTypeface* face = font.typeface();
-    SkASSERT(face);
 
     auto descriptor = SkPDFMakeDict("FontDescriptor");
     uint16_t emSize = SkToU16(font.typeface()->getUnitsPerEm());
     SkPDFFont::PopulateCommonFontDescriptor(descriptor.get(), metrics, emSize, 0);
 
-    int ttcIndex;
-    std::unique_ptr<SkStreamAsset> fontAsset = face->openStream(&ttcIndex);
-    size_t fontSize = fontAsset ? fontAsset->getLength() : 0;
-    if (0 == fontSize) {
-        SkDebugf("Error: (SkTypeface)(%p)::openStream() returned "
-                 "empty stream (%p) when identified as kType1CID_Font "
-                 "or kTrueType_Font.\n", face, fontAsset.get());
-    } else {
+    if (parts.fFontFile) {
         switch (type) {
             case SkAdvancedTypefaceMetrics::kTrueType_Font: {
-                if (!SkToBool(metrics.fFlags &
-                              SkAdvancedTypefaceMetrics::kNotSubsettable_FontFlag)) {
-                    SkASSERT(font.firstGlyphID() == 1);
-                    sk_sp<SkData> subsetFontData = SkPDFSubsetFont(
-                            stream_to_data(std::move(fontAsset)), font.glyphUsage(),
-                            doc->metadata().fSubsetter,
-                            metrics.fFontName.c_str(), ttcIndex);
-                    if (subsetFontData) {
-                        std::unique_ptr<SkPDFDict> tmp = SkPDFMakeDict();
-                        tmp->insertInt("Length1", SkToInt(subsetFontData->size()));
-                        descriptor->insertRef(
-                                "FontFile2",
-                                SkPDFStreamOut(std::move(tmp),
-                                               SkMemoryStream::Make(std::move(subsetFontData)),
-                                               doc, true));
-                        break;
-                    }
-                    // If subsetting fails, fall back to original font data.
-                    fontAsset = face->openStream(&ttcIndex);
-                    SkASSERT(fontAsset);
-                    SkASSERT(fontAsset->getLength() == fontSize);
-                    if (!fontAsset || fontAsset->getLength() == 0) { break; }
-                }
                 std::unique_ptr<SkPDFDict> tmp = SkPDFMakeDict();
-                tmp->insertInt("Length1", fontSize);
+                tmp->insertInt("Length1", SkToInt(parts.fFontFile->getLength()));
                 descriptor->insertRef("FontFile2",
-                                      SkPDFStreamOut(std::move(tmp), std::move(fontAsset),
+                                      SkPDFStreamOut(std::move(tmp), std::move(parts.fFontFile),
                                                      doc, true));
                 break;
             }
@@ -339,7 +419,7 @@ static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc) {
                 std::unique_ptr<SkPDFDict> tmp = SkPDFMakeDict();
                 tmp->insertName("Subtype", "CIDFontType0C");
                 descriptor->insertRef("FontFile3",
-                                      SkPDFStreamOut(std::move(tmp), std::move(fontAsset),
+                                      SkPDFStreamOut(std::move(tmp), std::move(parts.fFontFile),
                                                      doc, true));
                 break;
             }
@@ -369,15 +449,10 @@ static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc) {
     sysInfo->insertInt("Supplement", 0);
     newCIDFont->insertObject("CIDSystemInfo", std::move(sysInfo));
 
-    SkScalar defaultWidth = 0;
-    {
-        std::unique_ptr<SkPDFArray> widths = SkPDFMakeCIDGlyphWidthsArray(
-                *face, font.glyphUsage(), &defaultWidth);
-        if (widths && widths->size() > 0) {
-            newCIDFont->insertObject("W", std::move(widths));
-        }
-        newCIDFont->insertScalar("DW", defaultWidth);
+    if (parts.fWidths && parts.fWidths->size() > 0) {
+        newCIDFont->insertObject("W", std::move(parts.fWidths));
     }
+    newCIDFont->insertScalar("DW", parts.fDefaultWidth);
 
     ////////////////////////////////////////////////////////////////////////////
 
@@ -389,16 +464,7 @@ static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc) {
     descendantFonts->appendRef(doc->emit(*newCIDFont));
     fontDict.insertObject("DescendantFonts", std::move(descendantFonts));
 
-    const std::vector<SkUnichar>& glyphToUnicode =
-        SkPDFFont::GetUnicodeMap(font.typeface(), doc);
-    SkASSERT(SkToSizeT(font.typeface()->countGlyphs()) == glyphToUnicode.size());
-    std::unique_ptr<SkStreamAsset> toUnicode =
-            SkPDFMakeToUnicodeCmap(glyphToUnicode.data(),
-                                   &font.glyphUsage(),
-                                   font.multiByteGlyphs(),
-                                   font.firstGlyphID(),
-                                   font.lastGlyphID());
-    fontDict.insertRef("ToUnicode", SkPDFStreamOut(nullptr, std::move(toUnicode), doc));
+    fontDict.insertRef("ToUnicode", SkPDFStreamOut(nullptr, std::move(parts.fToUnicode), doc));
 
     doc->emit(fontDict, font.indirectReference());
 }
@@ -671,7 +737,7 @@ void SkPDFFont::emitSubset(SkPDFDocument* doc) const {
     switch (fFontType) {
         case SkAdvancedTypefaceMetrics::kType1CID_Font:
         case SkAdvancedTypefaceMetrics::kTrueType_Font:
-            return emit_subset_type0(*this, doc);
+            return emit_subset_type0(*this, make_type0_parts(*this, doc), doc);
 #ifndef SK_PDF_DO_NOT_SUPPORT_TYPE_1_FONTS
         case SkAdvancedTypefaceMetrics::kType1_Font:
             return SkPDFEmitType1Font(*this, doc);
@@ -681,6 +747,31 @@ void SkPDFFont::emitSubset(SkPDFDocument* doc) const {
     }
 }
 
+void SkPDFFont::EmitSubsets(const std::vector<const SkPDFFont*>& fonts, SkPDFDocument* doc) {
+    SkExecutor* executor = doc->executor();
+    if (!executor) {
+        for (const SkPDFFont* font : fonts) {
+            font->emitSubset(doc);
+        }
+        return;
+    }
+    // Subset the Type0 fonts, and make the rest of their slow parts, concurrently. Then emit all
+    // the fonts in order, so that they are numbered as they would be without the executor.
+    std::vector<Type0Parts> parts(fonts.size());
+    SkTaskGroup(*executor).batch(SkToInt(fonts.size()), [&](int i) {
+        if (SkPDFFont::IsMultiByte(fonts[i]->getType())) {
+            parts[i] = make_type0_parts(*fonts[i], doc);
+        }
+    });
+    for (size_t i = 0; i < fonts.size(); ++i) {
+        if (SkPDFFont::IsMultiByte(fonts[i]->getType())) {
+            emit_subset_type0(*fonts[i], std::move(parts[i]), doc);
+        } else {
+            fonts[i]->emitSubset(doc);
+        }
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 bool SkPDFFont::CanEmbedTypeface(SkTypeface* typeface, SkPDFDocument* doc) {
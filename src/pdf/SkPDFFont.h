@@ -77,6 +77,11 @@ public:
         fGlyphUsage.set(glyph);
     }
 
+    /** As above, for glyphs drawn on a page of doc, which may be drawing other pages with
+     *  this font concurrently.
+     */
+    void noteGlyphUsage(const std::vector<SkGlyphID>& glyphs, SkPDFDocument* doc);
+
     SkPDFIndirectReference indirectReference() const { return fIndirectReference; }
 
     /** Get the font resource for the passed typeface and glyphID. The
@@ -108,6 +113,11 @@ public:
 
     void emitSubset(SkPDFDocument*) const;
 
+    /** Emits each of fonts, in order. If the document has an executor, the fonts are subset
+     *  concurrently on it first.
+     */
+    static void EmitSubsets(const std::vector<const SkPDFFont*>& fonts, SkPDFDocument*);
+
     /**
      *  Return false iff the typeface has its NotEmbeddable flag set.
      *  typeface is not nullptr
@@ -58,17 +58,13 @@ SkPDFIndirectReference SkPDFGraphicState::GetGraphicStateForPaint(SkPDFDocument*
     SkASSERT(doc);
     if (SkPaint::kFill_Style == p.getStyle()) {
         SkPDFFillGraphicState fillKey = {p.getColor4f().fA, pdf_blend_mode(p.getBlendMode())};
-        auto& fillMap = doc->fFillGSMap;
-        if (SkPDFIndirectReference* statePtr = fillMap.find(fillKey)) {
-            return *statePtr;
-        }
-        SkPDFDict state;
-        state.reserve(2);
-        state.insertColorComponentF("ca", fillKey.fAlpha);
-        state.insertName("BM", as_pdf_blend_mode_name((SkBlendMode)fillKey.fBlendMode));
-        SkPDFIndirectReference ref = doc->emit(state);
-        fillMap.set(fillKey, ref);
-        return ref;
+        return doc->findOrMake(&doc->fFillGSMap, fillKey, [&]() {
+            SkPDFDict state;
+            state.reserve(2);
+            state.insertColorComponentF("ca", fillKey.fAlpha);
+            state.insertName("BM", as_pdf_blend_mode_name((SkBlendMode)fillKey.fBlendMode));
+            return doc->emit(state);
+        });
     } else {
         SkPDFStrokeGraphicState strokeKey = {
             p.getStrokeWidth(),
@@ -78,23 +74,19 @@ SkPDFIndirectReference SkPDFGraphicState::GetGraphicStateForPaint(SkPDFDocument*
             SkToU8(p.getStrokeJoin()),
             pdf_blend_mode(p.getBlendMode())
         };
-        auto& sMap = doc->fStrokeGSMap;
-        if (SkPDFIndirectReference* statePtr = sMap.find(strokeKey)) {
-            return *statePtr;
-        }
-        SkPDFDict state;
-        state.reserve(8);
-        state.insertColorComponentF("CA", strokeKey.fAlpha);
-        state.insertColorComponentF("ca", strokeKey.fAlpha);
-        state.insertInt("LC", to_stroke_cap(strokeKey.fStrokeCap));
-        state.insertInt("LJ", to_stroke_join(strokeKey.fStrokeJoin));
-        state.insertScalar("LW", strokeKey.fStrokeWidth);
-        state.insertScalar("ML", strokeKey.fStrokeMiter);
-        state.insertBool("SA", true);  // SA = Auto stroke adjustment.
-        state.insertName("BM", as_pdf_blend_mode_name((SkBlendMode)strokeKey.fBlendMode));
-        SkPDFIndirectReference ref = doc->emit(state);
-        sMap.set(strokeKey, ref);
-        return ref;
+        return doc->findOrMake(&doc->fStrokeGSMap, strokeKey, [&]() {
+            SkPDFDict state;
+            state.reserve(8);
+            state.insertColorComponentF("CA", strokeKey.fAlpha);
+            state.insertColorComponentF("ca", strokeKey.fAlpha);
+            state.insertInt("LC", to_stroke_cap(strokeKey.fStrokeCap));
+            state.insertInt("LJ", to_stroke_join(strokeKey.fStrokeJoin));
+            state.insertScalar("LW", strokeKey.fStrokeWidth);
+            state.insertScalar("ML", strokeKey.fStrokeMiter);
+            state.insertBool("SA", true);  // SA = Auto stroke adjustment.
+            state.insertName("BM", as_pdf_blend_mode_name((SkBlendMode)strokeKey.fBlendMode));
+            return doc->emit(state);
+        });
     }
 }
 
@@ -129,10 +121,9 @@ SkPDFIndirectReference SkPDFGraphicState::GetSMaskGraphicState(SkPDFIndirectRefe
     sMaskDict->insertRef("G", sMask);
     if (invert) {
         // let the doc deduplicate this object.
-        if (doc->fInvertFunction == SkPDFIndirectReference()) {
-            doc->fInvertFunction = make_invert_function(doc);
-        }
-        sMaskDict->insertRef("TR", doc->fInvertFunction);
+        sMaskDict->insertRef("TR", doc->findOrMake(&doc->fInvertFunction, [doc]() {
+            return make_invert_function(doc);
+        }));
     }
     SkPDFDict result("ExtGState");
     result.insertObject("SMask", std::move(sMaskDict));
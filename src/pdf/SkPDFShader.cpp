@@ -356,20 +356,15 @@ SkPDFIndirectReference SkPDFMakeShader(SkPDFDocument* doc,
             SkBitmapKeyFromImage(skimg),
             {imageTileModes[0], imageTileModes[1]},
             paintColor};
-        SkPDFIndirectReference* shaderPtr = doc->fImageShaderMap.find(key);
-        if (shaderPtr) {
-            return *shaderPtr;
-        }
-        SkPDFIndirectReference pdfShader =
-                make_image_shader(doc,
-                                  finalMatrix,
-                                  imageTileModes[0],
-                                  imageTileModes[1],
-                                  SkRect::Make(surfaceBBox),
-                                  skimg,
-                                  paintColor);
-        doc->fImageShaderMap.set(std::move(key), pdfShader);
-        return pdfShader;
+        return doc->findOrMake(&doc->fImageShaderMap, std::move(key), [&]() {
+            return make_image_shader(doc,
+                                     finalMatrix,
+                                     imageTileModes[0],
+                                     imageTileModes[1],
+                                     SkRect::Make(surfaceBBox),
+                                     skimg,
+                                     paintColor);
+        });
     }
     // Don't bother to de-dup fallback shader.
     return make_fallback_shader(doc, shader, canvasTransform, surfaceBBox, paintColor);
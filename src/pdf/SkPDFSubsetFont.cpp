@@ -3,6 +3,12 @@
 
 #include "src/pdf/SkPDFSubsetFont.h"
 
+#include "include/private/SkTo.h"
+#include "src/core/SkResourceCache.h"
+
+#include <cstring>
+#include <vector>
+
 #if defined(SK_USING_THIRD_PARTY_ICU)
 #include "SkLoadICU.h"
 #endif
@@ -179,3 +185,79 @@ sk_sp<SkData> SkPDFSubsetFont(sk_sp<SkData>, const SkPDFGlyphUse&, SkPDF::Metada
 }
 #endif  // defined(SK_PDF_USE_SFNTLY)
 
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+static unsigned gSubsetFontKeyNamespaceLabel;
+
+// The key of a subset: the typeface, the subsetter, and the glyphs used, two to a uint32_t.
+class SubsetFontKey {
+public:
+    SubsetFontKey(SkFontID typefaceID,
+                  const SkPDFGlyphUse& glyphUsage,
+                  SkPDF::Metadata::Subsetter subsetter) {
+        std::vector<uint16_t> glyphs;
+        glyphUsage.getSetValues([&glyphs](unsigned gid) { glyphs.push_back(SkToU16(gid)); });
+        if (glyphs.size() & 1) {
+            glyphs.push_back(0);  // Glyphs are in order, so trailing padding cannot clash.
+        }
+        const uint32_t fields[] = {typefaceID, (uint32_t)subsetter, SkToU32(glyphs.size())};
+        const size_t dataSize = sizeof(fields) + glyphs.size() * sizeof(uint16_t);
+
+        fStorage.reset(new uint8_t[sizeof(SkResourceCache::Key) + dataSize]);
+        SkResourceCache::Key* key = new (fStorage.get()) SkResourceCache::Key();
+        uint8_t* data = fStorage.get() + sizeof(SkResourceCache::Key);
+        memcpy(data, fields, sizeof(fields));
+        memcpy(data + sizeof(fields), glyphs.data(), glyphs.size() * sizeof(uint16_t));
+        key->init(&gSubsetFontKeyNamespaceLabel, 0, dataSize);
+    }
+
+    const SkResourceCache::Key& get() const {
+        return *reinterpret_cast<const SkResourceCache::Key*>(fStorage.get());
+    }
+
+private:
+    std::unique_ptr<uint8_t[]> fStorage;
+};
+
+struct SubsetFontRec : public SkResourceCache::Rec {
+    SubsetFontRec(const SkResourceCache::Key& key, sk_sp<SkData> subset)
+        : fKey(new uint8_t[key.size()])
+        , fSubset(std::move(subset)) {
+        memcpy(fKey.get(), &key, key.size());
+    }
+
+    std::unique_ptr<uint8_t[]> fKey;
+    sk_sp<SkData>              fSubset;
+
+    const Key& getKey() const override { return *reinterpret_cast<const Key*>(fKey.get()); }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + this->getKey().size() + fSubset->size();
+    }
+    const char* getCategory() const override { return "pdf-subset-font"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* context) {
+        const SubsetFontRec& rec = static_cast<const SubsetFontRec&>(baseRec);
+        *static_cast<sk_sp<SkData>*>(context) = rec.fSubset;
+        return true;
+    }
+};
+}  // namespace
+
+sk_sp<SkData> SkPDFFindSubsetFont(SkFontID typefaceID,
+                                  const SkPDFGlyphUse& glyphUsage,
+                                  SkPDF::Metadata::Subsetter subsetter) {
+    sk_sp<SkData> subset;
+    SkResourceCache::Find(SubsetFontKey(typefaceID, glyphUsage, subsetter).get(),
+                          SubsetFontRec::Visitor, &subset);
+    return subset;
+}
+
+void SkPDFAddSubsetFont(SkFontID typefaceID,
+                        const SkPDFGlyphUse& glyphUsage,
+                        SkPDF::Metadata::Subsetter subsetter,
+                        sk_sp<SkData> subset) {
+    SkASSERT(subset);
+    SkResourceCache::Add(new SubsetFontRec(SubsetFontKey(typefaceID, glyphUsage, subsetter).get(),
+                                           std::move(subset)));
+}
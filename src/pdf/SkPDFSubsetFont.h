@@ -4,6 +4,7 @@
 #define SkPDFSubsetFont_DEFINED
 
 #include "include/core/SkData.h"
+#include "include/core/SkTypeface.h"
 #include "include/docs/SkPDFDocument.h"
 #include "src/pdf/SkPDFGlyphUse.h"
 
@@ -13,4 +14,15 @@ sk_sp<SkData> SkPDFSubsetFont(sk_sp<SkData> fontData,
                               const char* fontName,
                               int ttcIndex);
 
+// Subsets are kept in SkResourceCache so that later documents using the same glyphs of a typeface
+// need not subset it again. Returns nullptr if the subset is not in the cache.
+sk_sp<SkData> SkPDFFindSubsetFont(SkFontID typefaceID,
+                                  const SkPDFGlyphUse& glyphUsage,
+                                  SkPDF::Metadata::Subsetter subsetter);
+
+void SkPDFAddSubsetFont(SkFontID typefaceID,
+                        const SkPDFGlyphUse& glyphUsage,
+                        SkPDF::Metadata::Subsetter subsetter,
+                        sk_sp<SkData> subset);
+
 #endif  // SkPDFSubsetFont_DEFINED
@@ -0,0 +1,224 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/utils/SkAnimFrameDecoder.h"
+
+#include "include/core/SkImage.h"
+#include "src/core/SkPixmapPriv.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <algorithm>
+
+// The frames [fStart, fEnd), which all belong to one run.
+struct SkAnimFrameDecoder::Job {
+    int fStart;
+    int fEnd;
+};
+
+static size_t frame_bytes(const SkImage* image) {
+    return image ? image->imageInfo().computeMinByteSize() : 0;
+}
+
+std::unique_ptr<SkAnimFrameDecoder> SkAnimFrameDecoder::Make(sk_sp<SkData> data,
+                                                             SkExecutor* executor,
+                                                             size_t cacheBytes) {
+    std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+    if (!codec) {
+        return nullptr;
+    }
+    return std::unique_ptr<SkAnimFrameDecoder>(
+            new SkAnimFrameDecoder(std::move(data), std::move(codec), executor, cacheBytes));
+}
+
+SkAnimFrameDecoder::SkAnimFrameDecoder(sk_sp<SkData> data, std::unique_ptr<SkCodec> codec,
+                                       SkExecutor* executor, size_t cacheBytes)
+        : fData(std::move(data))
+        , fExecutor(executor)
+        , fCacheBytes(cacheBytes)
+        , fImageInfo(codec->getInfo())
+        , fOrigin(codec->getOrigin())
+        , fFrameInfos(codec->getFrameInfo()) {
+    if (fFrameInfos.empty()) {
+        // A still image is decoded as a single independent frame.
+        SkCodec::FrameInfo info;
+        info.fRequiredFrame = SkCodec::kNoFrame;
+        info.fDuration = 0;
+        info.fFullyReceived = true;
+        info.fAlphaType = fImageInfo.alphaType();
+        info.fHasAlphaWithinBounds = !fImageInfo.isOpaque();
+        info.fDisposalMethod = SkCodecAnimation::DisposalMethod::kKeep;
+        fFrameInfos.push_back(info);
+    }
+    fIdleCodecs.push_back(std::move(codec));
+
+    // A frame can start a run if neither it nor any later frame depends on an earlier frame.
+    const int count = this->frameCount();
+    std::vector<bool> startsRun(count);
+    int minRequired = count;
+    for (int i = count - 1; i >= 0; --i) {
+        const int required = fFrameInfos[i].fRequiredFrame;
+        if (required != SkCodec::kNoFrame) {
+            minRequired = std::min(minRequired, required);
+        }
+        startsRun[i] = required == SkCodec::kNoFrame && minRequired >= i;
+    }
+    fRunStart.resize(count);
+    for (int i = 0; i < count; ++i) {
+        fRunStart[i] = (i == 0 || startsRun[i]) ? i : fRunStart[i - 1];
+    }
+
+    fFrames.resize(count);
+}
+
+SkAnimFrameDecoder::~SkAnimFrameDecoder() {}
+
+SkISize SkAnimFrameDecoder::dimensions() const {
+    if (SkEncodedOriginSwapsWidthHeight(fOrigin)) {
+        return { fImageInfo.height(), fImageInfo.width() };
+    }
+    return fImageInfo.dimensions();
+}
+
+std::unique_ptr<SkCodec> SkAnimFrameDecoder::acquireCodec() {
+    {
+        SkAutoMutexExclusive lock(fCodecMutex);
+        if (!fIdleCodecs.empty()) {
+            std::unique_ptr<SkCodec> codec = std::move(fIdleCodecs.back());
+            fIdleCodecs.pop_back();
+            return codec;
+        }
+    }
+    return SkCodec::MakeFromData(fData);
+}
+
+void SkAnimFrameDecoder::releaseCodec(std::unique_ptr<SkCodec> codec) {
+    SkAutoMutexExclusive lock(fCodecMutex);
+    fIdleCodecs.push_back(std::move(codec));
+}
+
+sk_sp<SkImage> SkAnimFrameDecoder::decodeFrame(SkCodec* codec, int index) const {
+    SkImageInfo info = fImageInfo;
+    if (fFrameInfos[index].fAlphaType != kOpaque_SkAlphaType && info.isOpaque()) {
+        info = info.makeAlphaType(kPremul_SkAlphaType);
+    }
+    const size_t rowBytes = info.minRowBytes();
+    sk_sp<SkData> pixels = SkData::MakeUninitialized(info.computeByteSize(rowBytes));
+
+    SkCodec::Options options;
+    options.fFrameIndex = index;
+
+    // Start from the required frame if it is cached. Otherwise the codec decodes it first.
+    const int required = fFrameInfos[index].fRequiredFrame;
+    SkPixmap prior;
+    if (required != SkCodec::kNoFrame && fFrames[required] &&
+        fFrames[required]->peekPixels(&prior) &&
+        prior.readPixels(info, pixels->writable_data(), rowBytes)) {
+        options.fPriorFrame = required;
+    }
+
+    if (SkCodec::kSuccess != codec->getPixels(info, pixels->writable_data(), rowBytes, &options)) {
+        return nullptr;
+    }
+    return SkImage::MakeRasterData(info, std::move(pixels), rowBytes);
+}
+
+void SkAnimFrameDecoder::runJob(const Job& job) {
+    std::unique_ptr<SkCodec> codec = this->acquireCodec();
+    if (!codec) {
+        return;
+    }
+    // Each frame may depend on the ones before it in the job, so decode them in order. No other
+    // job touches the frames of this run.
+    for (int i = job.fStart; i < job.fEnd; ++i) {
+        if (!fFrames[i]) {
+            fFrames[i] = this->decodeFrame(codec.get(), i);
+        }
+    }
+    this->releaseCodec(std::move(codec));
+}
+
+void SkAnimFrameDecoder::purge(int index, size_t budget, const std::vector<bool>& keep) {
+    auto evict = [&](int i) {
+        if (fFrames[i] && !keep[i]) {
+            fCachedBytes -= frame_bytes(fFrames[i].get());
+            fFrames[i].reset();
+        }
+    };
+    // Frames before index are the least likely to be asked for again, so go first.
+    for (int i = 0; i < index && fCachedBytes > budget; ++i) {
+        evict(i);
+    }
+    for (int i = this->frameCount() - 1; i > index && fCachedBytes > budget; --i) {
+        evict(i);
+    }
+}
+
+sk_sp<SkImage> SkAnimFrameDecoder::getFrame(int index) {
+    SkASSERT(index >= 0 && index < this->frameCount());
+
+    if (!fFrames[index]) {
+        // Decode index and the frames after it that fit in the cache, one job per run.
+        const size_t frameBytes = std::max<size_t>(fImageInfo.computeMinByteSize(), 1);
+        const int windowFrames = SkToInt(std::min<size_t>(
+                std::max<size_t>(fCacheBytes / frameBytes, 1), this->frameCount()));
+        const int end = std::min(index + windowFrames, this->frameCount());
+
+        // Keep any frames of the window that are already cached, and the cached frames before
+        // each job that its frames depend on.
+        std::vector<Job> jobs;
+        std::vector<bool> keep(this->frameCount(), false);
+        for (int start = index; start < end;) {
+            int jobEnd = start + 1;
+            while (jobEnd < end && fRunStart[jobEnd] == fRunStart[start]) {
+                jobEnd++;
+            }
+            for (int i = start; i < jobEnd; ++i) {
+                keep[i] = true;
+                const int required = fFrameInfos[i].fRequiredFrame;
+                if (required != SkCodec::kNoFrame && required < start) {
+                    keep[required] = true;
+                }
+            }
+            jobs.push_back({start, jobEnd});
+            start = jobEnd;
+        }
+
+        const size_t windowBytes = (end - index) * frameBytes;
+        this->purge(index, fCacheBytes > windowBytes ? fCacheBytes - windowBytes : 0, keep);
+
+        if (fExecutor && jobs.size() > 1) {
+            SkTaskGroup(*fExecutor).batch(SkToInt(jobs.size()), [&](int i) {
+                this->runJob(jobs[i]);
+            });
+        } else {
+            for (const Job& job : jobs) {
+                this->runJob(job);
+            }
+        }
+
+        fCachedBytes = 0;
+        for (const sk_sp<SkImage>& frame : fFrames) {
+            fCachedBytes += frame_bytes(frame.get());
+        }
+        this->purge(index, fCacheBytes, std::vector<bool>(this->frameCount(), false));
+    }
+
+    sk_sp<SkImage> frame = fFrames[index];
+    if (!frame || fOrigin == kDefault_SkEncodedOrigin) {
+        return frame;
+    }
+
+    SkPixmap src;
+    SkAssertResult(frame->peekPixels(&src));
+    SkImageInfo info = frame->imageInfo().makeDimensions(this->dimensions());
+    const size_t rowBytes = info.minRowBytes();
+    sk_sp<SkData> pixels = SkData::MakeUninitialized(info.computeByteSize(rowBytes));
+    if (!SkPixmapPriv::Orient(SkPixmap(info, pixels->writable_data(), rowBytes), src, fOrigin)) {
+        return nullptr;
+    }
+    return SkImage::MakeRasterData(info, std::move(pixels), rowBytes);
+}
@@ -12,8 +12,10 @@
 #include "client_utils/android/BitmapRegionDecoder.h"
 #include "include/codec/SkAndroidCodec.h"
 #include "include/codec/SkCodec.h"
+#include "include/core/SkBitmap.h"
 #include "tests/Test.h"
 #include "tools/Resources.h"
+#include "tools/ToolUtils.h"
 
 DEF_TEST(BRD_types, r) {
     static const struct {
@@ -47,4 +49,48 @@ DEF_TEST(BRD_types, r) {
         }
     }
 }
+
+DEF_TEST(BRD_rowBandCache, r) {
+    const char* names[] = {
+        "images/mandrill_512.png",
+        "images/mandrill_512_q075.jpg",
+        "images/brickwork-texture.jpg",
+        "images/grayscale.jpg",
+    };
+    const int sampleSizes[] = { 1, 2, 3, 4, 8 };
+
+    for (const char* name : names) {
+        auto data = GetResourceAsData(name);
+        if (!data) return;
+        auto direct = android::skia::BitmapRegionDecoder::Make(data);
+        auto cached = android::skia::BitmapRegionDecoder::Make(data);
+        REPORTER_ASSERT(r, direct && cached);
+
+        const SkColorType ct = direct->computeOutputColorType(kN32_SkColorType);
+        const sk_sp<SkColorSpace> cs = direct->computeOutputColorSpace(ct);
+        for (int sampleSize : sampleSizes) {
+            // Room for a few bands, so that tiles further down evict the earlier ones.
+            cached->setRowBandCacheBudget(
+                    (size_t)direct->width() / sampleSize * 4 * 64 * 6);
+
+            // Tiles covering the image and hanging off its edges, some of which do not start on
+            // a sample, and so are decoded directly.
+            const int tile = 100 * sampleSize;
+            for (int y = -tile / 2; y < direct->height(); y += tile - 7 * sampleSize) {
+                for (int x = -tile / 3; x < direct->width(); x += tile + sampleSize / 2) {
+                    const SkIRect subset = SkIRect::MakeXYWH(x, y, tile, tile);
+                    SkBitmap expected, actual;
+                    REPORTER_ASSERT(r, direct->decodeRegion(&expected, nullptr, subset,
+                                                            sampleSize, ct, false, cs));
+                    REPORTER_ASSERT(r, cached->decodeRegion(&actual, nullptr, subset,
+                                                            sampleSize, ct, false, cs));
+                    if (!ToolUtils::equal_pixels(expected, actual)) {
+                        ERRORF(r, "%s: tile (%d, %d) at sampleSize %d does not match",
+                               name, x, y, sampleSize);
+                    }
+                }
+            }
+        }
+    }
+}
 #endif // SK_ENABLE_ANDROID_UTILS
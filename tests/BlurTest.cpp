@@ -11,6 +11,7 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkColorPriv.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMaskFilter.h"
 #include "include/core/SkMath.h"
@@ -26,6 +27,7 @@
 #include "include/core/SkSize.h"
 #include "include/core/SkSurface.h"
 #include "include/core/SkTypes.h"
+#include "include/effects/SkImageFilters.h"
 #include "include/effects/SkPerlinNoiseShader.h"
 #include "include/gpu/GrDirectContext.h"
 #include "include/private/SkFloatBits.h"
@@ -33,9 +35,11 @@
 #include "src/core/SkBlurMask.h"
 #include "src/core/SkGpuBlurUtils.h"
 #include "src/core/SkMask.h"
+#include "src/core/SkMaskBlurFilter.h"
 #include "src/core/SkMaskFilterBase.h"
 #include "src/core/SkMathPriv.h"
 #include "src/effects/SkEmbossMaskFilter.h"
+#include "src/effects/imagefilters/SkBlurImageFilter.h"
 #include "tests/Test.h"
 #include "tools/ToolUtils.h"
 #include "tools/gpu/GrContextFactory.h"
@@ -580,3 +584,68 @@ DEF_TEST(zero_blur, reporter) {
     SkIPoint offset;
     bitmap.extractAlpha(&alpha, &paint, nullptr, &offset);
 }
+
+// Large blurs are split into strips run on an executor; they must match the serial result exactly.
+DEF_TEST(BlurThreaded, reporter) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    SkMask src;
+    src.fBounds.setWH(301, 277);
+    src.fFormat = SkMask::kA8_Format;
+    src.fRowBytes = src.fBounds.width();
+    src.fImage = SkMask::AllocImage(src.computeTotalImageSize());
+    SkAutoMaskFreeImage autoSrc(src.fImage);
+    for (int y = 0; y < src.fBounds.height(); ++y) {
+        for (int x = 0; x < src.fBounds.width(); ++x) {
+            src.fImage[y * src.fRowBytes + x] = ((x / 7) ^ (y / 5)) & 1 ? 0xFF : (x * y) & 0x7F;
+        }
+    }
+
+    for (double sigma : {2.5, 8.0, 30.0}) {
+        SkMaskBlurFilter filter(sigma, sigma);
+        SkMask serial, threaded;
+        SkIPoint serialBorder = filter.blur(src, &serial, nullptr);
+        SkAutoMaskFreeImage autoSerial(serial.fImage);
+        SkIPoint threadedBorder = filter.blur(src, &threaded, executor.get());
+        SkAutoMaskFreeImage autoThreaded(threaded.fImage);
+
+        REPORTER_ASSERT(reporter, serialBorder == threadedBorder);
+        REPORTER_ASSERT(reporter, serial.fBounds == threaded.fBounds);
+        REPORTER_ASSERT(reporter, serial.fRowBytes == threaded.fRowBytes);
+        REPORTER_ASSERT(reporter, !memcmp(serial.fImage, threaded.fImage,
+                                          serial.computeTotalImageSize()));
+    }
+
+    // SkBlurImageFilter splits its passes across the executor it is given.
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(300, 280);
+    {
+        SkCanvas canvas(bitmap);
+        canvas.clear(SK_ColorTRANSPARENT);
+        SkPaint paint;
+        paint.setColor(0xFF804020);
+        for (int i = 0; i < 20; ++i) {
+            canvas.drawRect(SkRect::MakeXYWH(i * 15.f, i * 13.f, 40, 25), paint);
+        }
+    }
+    sk_sp<SkImage> image = bitmap.asImage();
+
+    auto blurImage = [&](SkScalar sigmaX, SkScalar sigmaY, SkExecutor* blurExecutor) {
+        SkBitmap result;
+        result.allocN32Pixels(bitmap.width(), bitmap.height());
+        SkCanvas canvas(result);
+        canvas.clear(SK_ColorTRANSPARENT);
+        SkPaint paint;
+        paint.setImageFilter(SkMakeBlurImageFilter(sigmaX, sigmaY, SkTileMode::kDecal, nullptr,
+                                                   nullptr, blurExecutor));
+        canvas.drawImage(image, 0, 0, SkSamplingOptions(), &paint);
+        return result;
+    };
+
+    for (auto sigmas : {std::make_pair(10.f, 10.f), std::make_pair(0.f, 20.f),
+                        std::make_pair(40.f, 0.f)}) {
+        SkBitmap serial = blurImage(sigmas.first, sigmas.second, nullptr);
+        SkBitmap threaded = blurImage(sigmas.first, sigmas.second, executor.get());
+        REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(serial, threaded));
+    }
+}
@@ -5,17 +5,23 @@
  * found in the LICENSE file.
  */
 
+#include "include/codec/SkCodec.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkData.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageGenerator.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkShader.h"
 #include "include/core/SkTypes.h"
 #include "include/private/SkColorData.h"
+#include "src/core/SkBitmapCache.h"
+#include "src/core/SkMipmap.h"
 #include "src/core/SkUtils.h"
 #include "tests/Test.h"
+#include "tools/Resources.h"
 #include "tools/ToolUtils.h"
 
 #include <utility>
@@ -125,3 +131,74 @@ DEF_TEST(Image_NewFromGenerator, r) {
         }
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Draws image into a size x size bitmap, either stretched with drawImageRect or through a
+// shader with the matching local matrix.
+static SkBitmap draw_scaled(const sk_sp<SkImage>& image, int size, bool useShader) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(size, size);
+    SkCanvas canvas(bitmap);
+    const SkRect dst = SkRect::MakeIWH(size, size);
+    if (useShader) {
+        const SkMatrix local = SkMatrix::RectToRect(SkRect::Make(image->bounds()), dst);
+        SkPaint paint;
+        paint.setShader(image->makeShader(SkSamplingOptions(SkFilterMode::kLinear,
+                                                            SkMipmapMode::kLinear), local));
+        canvas.drawRect(dst, paint);
+    } else {
+        canvas.drawImageRect(image, dst, SkSamplingOptions(SkFilterMode::kLinear));
+    }
+    return bitmap;
+}
+
+static bool is_cached(const SkBitmapCacheDesc& desc) {
+    SkBitmap cached;
+    return SkBitmapCache::Find(desc, &cached);
+}
+
+DEF_TEST(Image_ScaledDecode, r) {
+    sk_sp<SkData> jpeg = GetResourceAsData("images/mandrill_512_q075.jpg");
+    sk_sp<SkData> png = GetResourceAsData("images/mandrill_512.png");
+    if (!jpeg || !png) {
+        return;
+    }
+
+    for (bool useShader : {false, true}) {
+        // Drawn at exactly 1/8 scale, the image should be the DCT-scaled decode, as is.
+        sk_sp<SkImage> image = SkImage::MakeFromEncoded(jpeg);
+        SkBitmap drawn = draw_scaled(image, 64, useShader);
+        REPORTER_ASSERT(r, is_cached(SkBitmapCacheDesc::MakeScaled(image.get(), {64, 64})));
+        REPORTER_ASSERT(r, !is_cached(SkBitmapCacheDesc::Make(image.get())));
+
+        std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(jpeg);
+        SkBitmap decoded;
+        decoded.allocPixels(codec->getInfo().makeWH(64, 64));
+        REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(decoded.pixmap()));
+        SkBitmap expected = draw_scaled(decoded.asImage(), 64, useShader);
+        REPORTER_ASSERT(r, ToolUtils::equal_pixels(drawn, expected));
+
+        // Slightly smaller than 1/4 scale needs the 1/4 decode, not the 1/8 one.
+        image = SkImage::MakeFromEncoded(jpeg);
+        draw_scaled(image, 100, useShader);
+        REPORTER_ASSERT(r, is_cached(SkBitmapCacheDesc::MakeScaled(image.get(), {128, 128})));
+        REPORTER_ASSERT(r, !is_cached(SkBitmapCacheDesc::MakeScaled(image.get(), {64, 64})));
+        REPORTER_ASSERT(r, !is_cached(SkBitmapCacheDesc::Make(image.get())));
+        if (useShader) {
+            // The mipmaps for the remaining downscale are built from the 1/4 decode.
+            sk_sp<const SkMipmap> mips(SkMipmapCache::FindAndRef(
+                    SkBitmapCacheDesc::MakeScaled(image.get(), {128, 128})));
+            REPORTER_ASSERT(r, mips);
+        }
+
+        // Drawing at full size still decodes at full size.
+        draw_scaled(image, 512, useShader);
+        REPORTER_ASSERT(r, is_cached(SkBitmapCacheDesc::Make(image.get())));
+
+        // PNG cannot be decoded scaled, so it is decoded at full size and resampled.
+        image = SkImage::MakeFromEncoded(png);
+        draw_scaled(image, 64, useShader);
+        REPORTER_ASSERT(r, is_cached(SkBitmapCacheDesc::Make(image.get())));
+    }
+}
@@ -7,10 +7,13 @@
 
 #include "include/core/SkTypes.h"
 #include "include/private/SkChecksum.h"
+#include "include/private/SkTo.h"
 #include "include/utils/SkRandom.h"
 #include "src/core/SkOpts.h"
 #include "tests/Test.h"
 
+#include "zlib.h"
+
 DEF_TEST(Checksum, r) {
     // Put 128 random bytes into two identical buffers.  Any multiple of 4 will do.
     const size_t kBytes = SkAlign4(128);
@@ -88,3 +91,78 @@ DEF_TEST(ChecksumConsistent, r) {
     REPORTER_ASSERT(r, SkOpts::hash(bytes, 99) == 0x5214485b, "%08x", SkOpts::hash(bytes, 99));
     REPORTER_ASSERT(r, SkOpts::hash(bytes,255) == 0xce206bd3, "%08x", SkOpts::hash(bytes,255));
 }
+
+DEF_TEST(ChecksumCRC32Adler32, r) {
+    // Expected values are from zlib's crc32() and adler32().  The sizes straddle the 16 and 64
+    // byte blocks of the vectorized code.
+    uint8_t bytes[1000];
+    for (int i = 0; i < 1000; i++) {
+        bytes[i] = i;
+    }
+    const struct {
+        size_t   len;
+        uint32_t crc32, adler32;
+    } kTests[] = {
+        {   0, 0x00000000, 0x00000001 },
+        {   1, 0xd202ef8d, 0x00010001 },
+        {  15, 0xa06c675e, 0x023f006a },
+        {  16, 0xcecee288, 0x02b80079 },
+        {  63, 0xdbdea683, 0xa2ff07a2 },
+        {  64, 0x100ece8c, 0xaae007e1 },
+        {  65, 0x40c06fd8, 0xb3010821 },
+        { 127, 0xdec481aa, 0x364a1f42 },
+        { 128, 0x24650d57, 0x560b1fc1 },
+        { 200, 0xed086180, 0x5a284dbd },
+        { 255, 0xd32f9ba0, 0x2e757e82 },
+        {1000, 0x74e3fb41, 0x1d03e73c },
+    };
+    for (const auto& test : kTests) {
+        const uint32_t crc32   = SkOpts::crc32_fn  (0, bytes, test.len),
+                       adler32 = SkOpts::adler32_fn(1, bytes, test.len);
+        REPORTER_ASSERT(r, crc32   == test.crc32,   "%zu: %08x", test.len, crc32);
+        REPORTER_ASSERT(r, adler32 == test.adler32, "%zu: %08x", test.len, adler32);
+
+        // Checksumming in pieces gives the same result.
+        for (size_t split : {(size_t)1, test.len / 3, test.len - 1}) {
+            if (split > test.len) {
+                continue;
+            }
+            const size_t rest = test.len - split;
+            REPORTER_ASSERT(r, crc32 ==
+                    SkOpts::crc32_fn(SkOpts::crc32_fn(0, bytes, split), bytes + split, rest));
+            REPORTER_ASSERT(r, adler32 ==
+                    SkOpts::adler32_fn(SkOpts::adler32_fn(1, bytes, split), bytes + split, rest));
+        }
+    }
+
+    // Enough 0xff bytes to need more than one reduction of the Adler-32 sums.
+    uint8_t ones[6000];
+    memset(ones, 0xff, sizeof(ones));
+    REPORTER_ASSERT(r, SkOpts::crc32_fn  (0, ones, sizeof(ones)) == 0xb7829fe5);
+    REPORTER_ASSERT(r, SkOpts::adler32_fn(1, ones, sizeof(ones)) == 0xa49759ea);
+}
+
+DEF_TEST(ChecksumCRC32MatchesZlib, r) {
+    // A single byte b with no prior CRC looks up entry 0xff ^ b of the CRC-32 table, so this
+    // checks every entry of it.
+    for (int i = 0; i < 256; i++) {
+        const uint8_t byte = i;
+        REPORTER_ASSERT(r, SkOpts::crc32_fn(0, &byte, 1) == crc32(0, &byte, 1), "byte %d", i);
+    }
+
+    // Random bytes, of every length up to a few 64 byte blocks, from every alignment, chained
+    // from a previous CRC.
+    SkRandom rand;
+    uint8_t bytes[300];
+    for (uint8_t& byte : bytes) {
+        byte = rand.nextU();
+    }
+    for (size_t offset = 0; offset < 8; offset++) {
+        for (size_t len = 0; offset + len <= sizeof(bytes); len++) {
+            const uint32_t seed = rand.nextU();
+            const uint32_t expected = crc32(seed, bytes + offset, SkToUInt(len));
+            REPORTER_ASSERT(r, SkOpts::crc32_fn(seed, bytes + offset, len) == expected,
+                            "offset %zu, length %zu", offset, len);
+        }
+    }
+}
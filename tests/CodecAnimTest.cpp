@@ -10,6 +10,7 @@
 #include "include/codec/SkCodecAnimation.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkRect.h"
@@ -18,6 +19,7 @@
 #include "include/core/SkString.h"
 #include "include/core/SkTypes.h"
 #include "include/utils/SkAnimCodecPlayer.h"
+#include "include/utils/SkAnimFrameDecoder.h"
 #include "tests/CodecPriv.h"
 #include "tests/Test.h"
 #include "tools/Resources.h"
@@ -609,3 +611,71 @@ DEF_TEST(AnimCodecPlayer, r) {
                         "Mismatched size for frame at 500 ms of %s", test.fFile);
     }
 }
+
+DEF_TEST(AnimFrameDecoder, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(3);
+    for (const char* file : { "images/alphabetAnim.gif",
+                              "images/randPixelsAnim.gif",
+                              "images/required.gif",
+                              "images/blendBG.webp",
+                              "images/required.webp",
+                              "images/stoplight.webp",
+                              "images/randPixels.png" }) {
+        sk_sp<SkData> data = GetResourceAsData(file);
+        std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+        if (!codec) {
+            ERRORF(r, "Could not create codec for %s", file);
+            continue;
+        }
+
+        // Decode each frame independently, letting the codec decode the frames it depends on.
+        const std::vector<SkCodec::FrameInfo> frameInfos = codec->getFrameInfo();
+        const int frameCount = std::max(SkToInt(frameInfos.size()), 1);
+        std::vector<SkBitmap> expected(frameCount);
+        for (int i = 0; i < frameCount; i++) {
+            SkImageInfo info = codec->getInfo();
+            if (!frameInfos.empty() && frameInfos[i].fAlphaType != kOpaque_SkAlphaType &&
+                info.isOpaque()) {
+                info = info.makeAlphaType(kPremul_SkAlphaType);
+            }
+            expected[i].allocPixels(info);
+            SkCodec::Options options;
+            options.fFrameIndex = i;
+            REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(expected[i].pixmap(),
+                                                                     &options));
+        }
+        const size_t frameBytes = codec->getInfo().computeMinByteSize();
+
+        for (SkExecutor* exec : { (SkExecutor*)nullptr, executor.get() }) {
+            for (int cacheFrames : { 1, 3, frameCount }) {
+                const size_t cacheBytes = cacheFrames * frameBytes;
+                auto decoder = SkAnimFrameDecoder::Make(data, exec, cacheBytes);
+                REPORTER_ASSERT(r, decoder);
+                REPORTER_ASSERT(r, decoder->frameCount() == frameCount);
+                REPORTER_ASSERT(r, decoder->dimensions() == codec->dimensions());
+
+                // Forwards, as when transcoding, then backwards to exercise cache misses that
+                // start partway through a run of dependent frames.
+                std::vector<int> order;
+                for (int i = 0; i < frameCount; i++) {
+                    order.push_back(i);
+                }
+                for (int i = frameCount - 1; i >= 0; i--) {
+                    order.push_back(i);
+                }
+                for (int i : order) {
+                    sk_sp<SkImage> frame = decoder->getFrame(i);
+                    SkPixmap pm;
+                    if (!frame || !frame->peekPixels(&pm)) {
+                        ERRORF(r, "Failed to decode frame %i of %s", i, file);
+                        continue;
+                    }
+                    REPORTER_ASSERT(r, ToolUtils::equal_pixels(pm, expected[i].pixmap()),
+                                    "Mismatch in frame %i of %s", i, file);
+                    REPORTER_ASSERT(r, decoder->cachedBytes() <= std::max(cacheBytes,
+                                                                           frameBytes));
+                }
+            }
+        }
+    }
+}
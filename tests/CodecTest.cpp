@@ -19,6 +19,7 @@
 #include "include/core/SkColorSpace.h"
 #include "include/core/SkData.h"
 #include "include/core/SkEncodedImageFormat.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageEncoder.h"
 #include "include/core/SkImageGenerator.h"
@@ -50,6 +51,7 @@
 #include "tools/ToolUtils.h"
 
 #include "png.h"
+#include "zlib.h"
 
 #include <setjmp.h>
 #include <cstring>
@@ -1047,6 +1049,269 @@ DEF_TEST(Codec_ColorXform, r) {
     check_color_xform(r, "images/mandrill_512.png");
 }
 
+static sk_sp<SkData> encode_png_for_parallel_decode(SkColorType ct, SkAlphaType at,
+                                                    SkPngEncoder::FilterFlag filters) {
+    SkBitmap bm;
+    bm.allocPixels(SkImageInfo::Make(301, 203, ct, at));
+    SkRandom rand;
+    for (int y = 0; y < bm.height(); y++) {
+        for (int x = 0; x < bm.width(); x++) {
+            // A gradient with some noise, so that each row picks its own filter.
+            SkColor c = SkColorSetARGB(0xFF - y, x & 0xFF, (2 * y) & 0xFF, rand.nextU() & 0x3F);
+            bm.erase(c, SkIRect::MakeXYWH(x, y, 1, 1));
+        }
+    }
+    SkPngEncoder::Options options;
+    options.fFilterFlags = filters;
+    SkDynamicMemoryWStream stream;
+    SkAssertResult(SkPngEncoder::Encode(&stream, bm.pixmap(), options));
+    return stream.detachAsData();
+}
+
+DEF_TEST(Codec_png_parallel, r) {
+    using Filter = SkPngEncoder::FilterFlag;
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    struct {
+        SkColorType fColorType;
+        SkAlphaType fAlphaType;
+        Filter      fFilters;
+        bool        fExpectParallel;
+    } recs[] = {
+        {kRGBA_8888_SkColorType, kUnpremul_SkAlphaType, Filter::kAll,   true},
+        {kRGBA_8888_SkColorType, kOpaque_SkAlphaType,   Filter::kSub,   true},
+        {kGray_8_SkColorType,    kOpaque_SkAlphaType,   Filter::kNone,  true},
+        {kRGBA_F16_SkColorType,  kUnpremul_SkAlphaType, Filter::kSub,   true},
+        // Every Paeth row depends on the one above it, so these cannot be split.
+        {kRGBA_8888_SkColorType, kUnpremul_SkAlphaType, Filter::kPaeth, false},
+    };
+
+    for (auto rec : recs) {
+        sk_sp<SkData> data = encode_png_for_parallel_decode(rec.fColorType, rec.fAlphaType,
+                                                            rec.fFilters);
+        SkImageInfo info = SkCodec::MakeFromData(data)->getInfo();
+        sk_sp<SkColorSpace> p3 = SkColorSpace::MakeRGB(SkNamedTransferFn::kSRGB,
+                                                       SkNamedGamut::kDisplayP3);
+        for (SkImageInfo dstInfo : {info.makeColorType(kN32_SkColorType),
+                                    info.makeColorType(kRGBA_F16_SkColorType).makeColorSpace(p3)}) {
+            // Check the whole image, and one truncated part of the way through its IDATs.
+            for (size_t size : {data->size(), data->size() * 3 / 5}) {
+                sk_sp<SkData> truncated = SkData::MakeSubset(data.get(), 0, size);
+
+                SkBitmap serial, parallel;
+                serial.allocPixels(dstInfo);
+                parallel.allocPixels(dstInfo);
+
+                std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(truncated);
+                const SkCodec::Result expected = codec->getPixels(serial.pixmap());
+                REPORTER_ASSERT(r, codec->getDecodeParallelism() == 1);
+
+                SkCodec::Options options;
+                options.fExecutor = executor.get();
+                codec = SkCodec::MakeFromData(truncated);
+                REPORTER_ASSERT(r, codec->getPixels(parallel.pixmap(), &options) == expected);
+                REPORTER_ASSERT(r, (codec->getDecodeParallelism() > 1) == rec.fExpectParallel,
+                                "parallelism %d", codec->getDecodeParallelism());
+                REPORTER_ASSERT(r, md5(serial) == md5(parallel));
+
+                // Decoding again rewinds, and the second decode must match the first.
+                REPORTER_ASSERT(r, codec->getPixels(parallel.pixmap(), &options) == expected);
+                REPORTER_ASSERT(r, md5(serial) == md5(parallel));
+            }
+        }
+    }
+}
+
+// Writes an 8-bit gray PNG whose rows all use the None filter, except that badRow (if any) has
+// an unknown filter type. If claimedIdatLength is not zero, the IDAT chunk says it is that long.
+static sk_sp<SkData> make_gray_png(int width, int height, int badRow, uint32_t claimedIdatLength) {
+    std::vector<uint8_t> filtered;
+    for (int y = 0; y < height; y++) {
+        filtered.push_back(y == badRow ? 5 : 0);
+        for (int x = 0; x < width; x++) {
+            filtered.push_back((uint8_t)(x + 3 * y));
+        }
+    }
+    uLongf idatLength = compressBound(filtered.size());
+    std::vector<uint8_t> idat(idatLength);
+    SkAssertResult(Z_OK == compress(idat.data(), &idatLength, filtered.data(), filtered.size()));
+    idat.resize(idatLength);
+
+    SkDynamicMemoryWStream stream;
+    auto write_u32 = [&stream](uint32_t v) {
+        const uint8_t bytes[] = { (uint8_t)(v >> 24), (uint8_t)(v >> 16),
+                                  (uint8_t)(v >>  8), (uint8_t)(v >>  0) };
+        stream.write(bytes, sizeof(bytes));
+    };
+    auto write_chunk = [&](const char type[4], const uint8_t* data, uint32_t length,
+                           uint32_t claimedLength) {
+        write_u32(claimedLength);
+        stream.write(type, 4);
+        stream.write(data, length);
+        uLong crc = crc32(crc32(0, nullptr, 0), (const Bytef*)type, 4);
+        write_u32((uint32_t)crc32(crc, data, length));
+    };
+
+    const uint8_t signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    stream.write(signature, sizeof(signature));
+    const uint8_t ihdr[] = {
+        (uint8_t)(width  >> 24), (uint8_t)(width  >> 16), (uint8_t)(width  >> 8), (uint8_t)width,
+        (uint8_t)(height >> 24), (uint8_t)(height >> 16), (uint8_t)(height >> 8), (uint8_t)height,
+        8, PNG_COLOR_TYPE_GRAY, 0, 0, 0,
+    };
+    write_chunk("IHDR", ihdr, sizeof(ihdr), sizeof(ihdr));
+    write_chunk("IDAT", idat.data(), (uint32_t)idat.size(),
+                claimedIdatLength ? claimedIdatLength : (uint32_t)idat.size());
+    write_chunk("IEND", nullptr, 0, 0);
+    return stream.detachAsData();
+}
+
+DEF_TEST(Codec_png_parallel_errors, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    struct {
+        int      fBadRow;
+        uint32_t fClaimedIdatLength;
+        bool     fExpectParallel;
+    } recs[] = {
+        // Rows from the first unknown filter on are not decoded, even in bands after it.
+        {150, 0,           true},
+        {40,  0,           true},
+        {0,   0,           false},
+        // An IDAT that claims far more data than the stream holds. All of its rows are there.
+        {-1,  0x7FFFFFF0u, true},
+    };
+
+    for (auto rec : recs) {
+        sk_sp<SkData> data = make_gray_png(64, 200, rec.fBadRow, rec.fClaimedIdatLength);
+        for (bool memory : {true, false}) {
+            auto make_codec = [&]() -> std::unique_ptr<SkCodec> {
+                if (memory) {
+                    return SkCodec::MakeFromData(data);
+                }
+                return SkCodec::MakeFromStream(std::make_unique<NotAssetMemStream>(data));
+            };
+
+            std::unique_ptr<SkCodec> codec = make_codec();
+            if (!codec) {
+                ERRORF(r, "failed to create a codec for bad row %d", rec.fBadRow);
+                continue;
+            }
+            SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+            SkBitmap serial, parallel;
+            serial.allocPixels(info);
+            parallel.allocPixels(info);
+
+            const SkCodec::Result expected = codec->getPixels(serial.pixmap());
+            REPORTER_ASSERT(r, (expected == SkCodec::kSuccess) == (rec.fBadRow < 0));
+
+            SkCodec::Options options;
+            options.fExecutor = executor.get();
+            codec = make_codec();
+            REPORTER_ASSERT(r, codec->getPixels(parallel.pixmap(), &options) == expected,
+                            "bad row %d, memory %d", rec.fBadRow, memory);
+            REPORTER_ASSERT(r, (codec->getDecodeParallelism() > 1) == rec.fExpectParallel,
+                            "bad row %d, parallelism %d", rec.fBadRow,
+                            codec->getDecodeParallelism());
+            REPORTER_ASSERT(r, md5(serial) == md5(parallel), "bad row %d, memory %d",
+                            rec.fBadRow, memory);
+        }
+    }
+}
+
+DEF_TEST(Codec_jpeg_parallel, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    struct {
+        const char* fPath;
+        bool        fExpectParallel;
+    } recs[] = {
+        // 4:2:0 YCbCr, with a restart marker at every row of MCUs.
+        {"images/mandrill_512_restart.jpg", true},
+        // CMYK, with a restart marker every half row of MCUs.
+        {"images/mandrill_cmyk.jpg",        true},
+        // No restart markers.
+        {"images/mandrill_512_q075.jpg",    false},
+        // A restart marker at every row of MCUs, but too few rows to be worth splitting.
+        {"images/icc-v2-gbr.jpg",           false},
+    };
+
+    for (auto rec : recs) {
+        sk_sp<SkData> data = GetResourceAsData(rec.fPath);
+        if (!data) {
+            continue;
+        }
+        SkImageInfo info = SkCodec::MakeFromData(data)->getInfo();
+        sk_sp<SkColorSpace> p3 = SkColorSpace::MakeRGB(SkNamedTransferFn::kSRGB,
+                                                       SkNamedGamut::kDisplayP3);
+        for (SkImageInfo dstInfo : {info.makeColorType(kN32_SkColorType),
+                                    info.makeColorType(kRGB_565_SkColorType),
+                                    info.makeColorType(kRGBA_F16_SkColorType).makeColorSpace(p3)}) {
+            // A truncated image is always decoded serially.
+            for (size_t size : {data->size(), data->size() * 3 / 5}) {
+                sk_sp<SkData> truncated = SkData::MakeSubset(data.get(), 0, size);
+                const bool expectParallel = rec.fExpectParallel && size == data->size();
+
+                SkBitmap serial, parallel;
+                serial.allocPixels(dstInfo);
+                parallel.allocPixels(dstInfo);
+
+                std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(truncated);
+                if (!codec) {
+                    // Truncated within the headers, which are mostly an ICC profile.
+                    continue;
+                }
+                const SkCodec::Result expected = codec->getPixels(serial.pixmap());
+                REPORTER_ASSERT(r, codec->getDecodeParallelism() == 1);
+
+                SkCodec::Options options;
+                options.fExecutor = executor.get();
+                codec = SkCodec::MakeFromData(truncated);
+                REPORTER_ASSERT(r, codec->getPixels(parallel.pixmap(), &options) == expected);
+                REPORTER_ASSERT(r, (codec->getDecodeParallelism() > 1) == expectParallel,
+                                "%s parallelism %d", rec.fPath, codec->getDecodeParallelism());
+                REPORTER_ASSERT(r, md5(serial) == md5(parallel), "%s", rec.fPath);
+
+                // Decoding again rewinds, and the second decode must match the first.
+                REPORTER_ASSERT(r, codec->getPixels(parallel.pixmap(), &options) == expected);
+                REPORTER_ASSERT(r, md5(serial) == md5(parallel), "%s", rec.fPath);
+            }
+        }
+    }
+}
+
+DEF_TEST(Codec_memoryStreamReadInPlace, r) {
+    // Codecs read memory-backed streams in place, copying out little more than their headers.
+    for (const char* path : {"images/mandrill_512.png",
+                             "images/color_wheel.png",
+                             "images/randPixels.bmp"}) {
+        sk_sp<SkData> data = GetResourceAsData(path);
+        if (!data) {
+            continue;
+        }
+        auto stream = std::make_unique<CountingMemStream>(data);
+        CountingMemStream* counter = stream.get();
+        std::unique_ptr<SkCodec> codec = SkCodec::MakeFromStream(std::move(stream));
+        if (!codec) {
+            ERRORF(r, "Unable to create codec for %s", path);
+            continue;
+        }
+
+        SkBitmap inPlace, copied;
+        const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+        inPlace.allocPixels(info);
+        copied.allocPixels(info);
+        REPORTER_ASSERT(r, codec->getPixels(inPlace.pixmap()) == SkCodec::kSuccess);
+        REPORTER_ASSERT(r, counter->bytesCopied() < 512, "%s: %zu of %zu bytes copied", path,
+                        counter->bytesCopied(), data->size());
+
+        // Streams that are not memory-backed are copied from, with the same results.
+        codec = SkCodec::MakeFromStream(std::make_unique<NotAssetMemStream>(data));
+        REPORTER_ASSERT(r, codec->getPixels(copied.pixmap()) == SkCodec::kSuccess);
+        REPORTER_ASSERT(r, md5(inPlace) == md5(copied), "%s", path);
+    }
+}
+
 static bool color_type_match(SkColorType origColorType, SkColorType codecColorType) {
     switch (origColorType) {
         case kRGBA_8888_SkColorType:
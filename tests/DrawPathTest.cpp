@@ -22,6 +22,11 @@
 #include "include/core/SkSurface.h"
 #include "include/core/SkTypes.h"
 #include "include/effects/SkDashPathEffect.h"
+#include "include/utils/SkRandom.h"
+#include "src/core/SkAutoPixmapStorage.h"
+#include "src/core/SkDraw.h"
+#include "src/core/SkMatrixProvider.h"
+#include "src/core/SkRasterClip.h"
 #include "tests/Test.h"
 
 // test that we can draw an aa-rect at coordinates > 32K (bigger than fixedpoint)
@@ -371,3 +376,60 @@ DEF_TEST(DrawPath, reporter) {
     test_big_aa_rect(reporter);
     test_halfway();
 }
+
+// SkDraw::drawPaths() must match drawing each path with drawPath() and the same pre-matrix.
+DEF_TEST(DrawPaths_MatchesDrawPath, reporter) {
+    SkPath shapes[4];
+    shapes[0].moveTo(0, -6).lineTo(6, 4).lineTo(-6, 4).close();
+    shapes[1].addCircle(0, 0, 5.5f);
+    shapes[2].moveTo(-8, 0).cubicTo(-4, -12, 4, 12, 8, 0).close();
+    shapes[3].addRect({-5, -5, 5, 5});
+    shapes[3].setFillType(SkPathFillType::kInverseWinding);
+
+    constexpr int kCount = 200;
+    SkPath paths[kCount];
+    SkMatrix matrices[kCount];
+    SkRandom random;
+    for (int i = 0; i < kCount; ++i) {
+        // Leave the inverse fill out of most runs, it covers the whole clip.
+        paths[i] = shapes[i == kCount - 1 ? 3 : i % 3];
+        matrices[i] = SkMatrix::Translate(random.nextRangeScalar(-10, 138),
+                                          random.nextRangeScalar(-10, 138));
+        matrices[i].preRotate(random.nextRangeScalar(0, 360));
+    }
+
+    SkSimpleMatrixProvider matrixProvider(SkMatrix::Scale(1.5f, 1.25f));
+    for (bool aa : {false, true})
+    for (SkPaint::Style style : {SkPaint::kFill_Style, SkPaint::kStroke_Style}) {
+        SkPaint paint;
+        paint.setAntiAlias(aa);
+        paint.setStyle(style);
+        paint.setColor(0x80FF4020);
+
+        SkAutoPixmapStorage expected, actual;
+        for (SkAutoPixmapStorage* pm : {&expected, &actual}) {
+            pm->alloc(SkImageInfo::MakeN32Premul(160, 160));
+            pm->erase(SK_ColorWHITE);
+        }
+        SkRasterClip rc(SkIRect::MakeLTRB(7, 3, 151, 149));
+
+        SkDraw draw;
+        draw.fMatrixProvider = &matrixProvider;
+        draw.fRC             = &rc;
+
+        draw.fDst = expected;
+        for (int i = 0; i < kCount; ++i) {
+            draw.drawPath(paths[i], paint, &matrices[i]);
+        }
+        draw.fDst = actual;
+        draw.drawPaths(paths, matrices, kCount, paint);
+
+        for (int y = 0; y < expected.height(); ++y) {
+            if (memcmp(expected.addr32(0, y), actual.addr32(0, y), expected.rowBytes())) {
+                ERRORF(reporter, "drawPaths() differs from drawPath() in row %d (aa=%d style=%d)",
+                       y, aa, style);
+                break;
+            }
+        }
+    }
+}
@@ -12,17 +12,21 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColorPriv.h"
 #include "include/core/SkEncodedImageFormat.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkSurface.h"
 #include "include/encode/SkJpegEncoder.h"
 #include "include/encode/SkPngEncoder.h"
 #include "include/encode/SkWebpEncoder.h"
+#include "include/effects/SkGradientShader.h"
 #include "include/private/SkImageInfoPriv.h"
+#include "include/private/SkTo.h"
 
 #include "png.h"
 
 #include <algorithm>
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -332,6 +336,145 @@ DEF_TEST(Encode_PngOptions, r) {
     REPORTER_ASSERT(r, almost_equals(bm0, bm2, 0));
 }
 
+// Returns the types of a PNG's chunks other than IDAT, in order, and counts its IDATs.
+static std::string png_chunk_types(const SkData* png, int* idats) {
+    std::string types;
+    *idats = 0;
+    for (size_t offset = 8; offset + 12 <= png->size();) {
+        const uint8_t* chunk = png->bytes() + offset;
+        const uint32_t length = (uint32_t)chunk[0] << 24 | chunk[1] << 16 | chunk[2] << 8 | chunk[3];
+        if (!memcmp(chunk + 4, "IDAT", 4)) {
+            (*idats)++;
+        } else {
+            types.append((const char*)chunk + 4, 4);
+        }
+        offset += 12 + (size_t)length;
+    }
+    return types;
+}
+
+DEF_TEST(Encode_PngParallel, r) {
+    SkBitmap bitmap;
+    if (!GetResourceAsBitmap("images/mandrill_512.png", &bitmap)) {
+        return;
+    }
+
+    // Also encode a translucent copy, to cover four bytes per pixel.
+    SkBitmap translucent;
+    translucent.allocN32Pixels(bitmap.width(), bitmap.height());
+    translucent.eraseColor(SK_ColorTRANSPARENT);
+    SkPaint paint;
+    paint.setAlphaf(0.5f);
+    SkCanvas(translucent).drawImage(bitmap.asImage(), 0, 0, SkSamplingOptions(), &paint);
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    const struct {
+        SkPngEncoder::FilterFlag fFilters;
+        int                      fZLibLevel;
+    } kCases[] = {
+        { SkPngEncoder::FilterFlag::kAll,   6 },
+        { SkPngEncoder::FilterFlag::kNone,  1 },
+        { SkPngEncoder::FilterFlag::kSub,   9 },
+        { SkPngEncoder::FilterFlag::kPaeth, 3 },
+        { SkPngEncoder::FilterFlag::kUp | SkPngEncoder::FilterFlag::kAvg, 6 },
+    };
+    for (const SkBitmap& bm : { bitmap, translucent }) {
+        SkPixmap src;
+        REPORTER_ASSERT(r, bm.peekPixels(&src));
+        for (const auto& c : kCases) {
+            SkPngEncoder::Options options;
+            options.fFilterFlags = c.fFilters;
+            options.fZLibLevel = c.fZLibLevel;
+            const char* comments[] = {"key", "text"};
+            const size_t commentSizes[] = {sizeof("key"), sizeof("text")};
+            options.fComments = SkDataTable::MakeCopyArrays((const void* const*)comments,
+                                                            commentSizes, 2);
+
+            SkDynamicMemoryWStream serial, parallel;
+            REPORTER_ASSERT(r, SkPngEncoder::Encode(&serial, src, options));
+            options.fExecutor = executor.get();
+            REPORTER_ASSERT(r, SkPngEncoder::Encode(&parallel, src, options));
+
+            sk_sp<SkData> serialData = serial.detachAsData();
+            sk_sp<SkData> parallelData = parallel.detachAsData();
+            // The parallel path writes each band of about 128K of filtered rows as one IDAT,
+            // where libpng would write 8K ones. The other chunks are the same.
+            const size_t filteredRowBytes = src.width() * (bm.isOpaque() ? 3 : 4) + 1;
+            const int bandRows = SkToInt(128 * 1024 / filteredRowBytes);
+            int serialIdats, parallelIdats;
+            REPORTER_ASSERT(r, png_chunk_types(parallelData.get(), &parallelIdats) ==
+                               png_chunk_types(serialData.get(), &serialIdats));
+            REPORTER_ASSERT(r, parallelIdats == (src.height() + bandRows - 1) / bandRows,
+                            "%d IDATs", parallelIdats);
+            // The bands lose a little context at their starts, but should compress nearly as well.
+            REPORTER_ASSERT(r, parallelData->size() < serialData->size() * 1.01,
+                            "%zu vs %zu", parallelData->size(), serialData->size());
+
+            SkBitmap serialBitmap, parallelBitmap;
+            sk_sp<SkImage> parallelImage = SkImage::MakeFromEncoded(parallelData);
+            REPORTER_ASSERT(r, parallelImage);
+            if (!parallelImage) {
+                continue;
+            }
+            SkImage::MakeFromEncoded(serialData)->asLegacyBitmap(&serialBitmap);
+            parallelImage->asLegacyBitmap(&parallelBitmap);
+            REPORTER_ASSERT(r, almost_equals(serialBitmap, parallelBitmap, 0));
+        }
+    }
+}
+
+DEF_TEST(Encode_DrawnRows, r) {
+    // Band edges are not multiples of one another, or of the image's height. Only draw shapes
+    // whose rasterization does not depend on the clip, so each band matches the whole image.
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(100, 150);
+    auto draw = [](SkCanvas* canvas) {
+        SkPaint paint;
+        const SkPoint pts[] = {{0, 0}, {100, 150}};
+        const SkColor colors[] = {SK_ColorBLUE, SK_ColorYELLOW};
+        paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2, SkTileMode::kClamp));
+        canvas->drawRect(SkRect::MakeXYWH(10, 10, 80, 130), paint);
+        paint.setShader(nullptr);
+        paint.setColor(0x80FF0000);
+        canvas->drawRect(SkRect::MakeXYWH(30, 5, 40, 100), paint);
+        canvas->drawLine(0, 0, 100, 150, paint);
+    };
+
+    SkBitmap expected;
+    expected.allocPixels(info);
+    expected.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas canvas(expected);
+    draw(&canvas);
+    SkPixmap src;
+    REPORTER_ASSERT(r, expected.peekPixels(&src));
+
+    for (int bandRows : {1, 7, 16, 1000}) {
+        SkDynamicMemoryWStream full, png, jpeg;
+        REPORTER_ASSERT(r, SkPngEncoder::Encode(&full, src, SkPngEncoder::Options()));
+
+        std::unique_ptr<SkEncoder> encoder = SkPngEncoder::Make(&png, info, {});
+        REPORTER_ASSERT(r, encoder && encoder->encodeDrawnRows(bandRows, draw));
+        sk_sp<SkData> fullData = full.detachAsData();
+        sk_sp<SkData> pngData = png.detachAsData();
+        REPORTER_ASSERT(r, fullData->equals(pngData.get()), "bandRows %d", bandRows);
+
+        encoder = SkJpegEncoder::Make(&jpeg, info, {});
+        REPORTER_ASSERT(r, encoder && encoder->encodeDrawnRows(bandRows, draw));
+        REPORTER_ASSERT(r, !encoder->encodeDrawnRows(bandRows, draw));
+        SkBitmap decoded;
+        REPORTER_ASSERT(r, SkImage::MakeFromEncoded(jpeg.detachAsData())->asLegacyBitmap(&decoded));
+        REPORTER_ASSERT(r, decoded.dimensions() == info.dimensions());
+    }
+
+    // Rows passed to encodeRows(const SkPixmap&) must match the image.
+    SkDynamicMemoryWStream dst;
+    std::unique_ptr<SkEncoder> encoder = SkPngEncoder::Make(&dst, info, {});
+    SkPixmap rows;
+    REPORTER_ASSERT(r, src.extractSubset(&rows, SkIRect::MakeWH(50, 10)));
+    REPORTER_ASSERT(r, !encoder->encodeRows(rows));
+    REPORTER_ASSERT(r, src.extractSubset(&rows, SkIRect::MakeWH(100, 10)));
+    REPORTER_ASSERT(r, encoder->encodeRows(rows));
+}
+
 #ifndef SK_BUILD_FOR_GOOGLE3
 DEF_TEST(Encode_WebpQuality, r) {
     SkBitmap bm;
@@ -83,4 +83,30 @@ private:
     size_t          fLimit;
     SkMemoryStream  fStream;
 };
+
+// Memory stream that counts the bytes copied out of it by read() and peek().
+class CountingMemStream : public SkMemoryStream {
+public:
+    CountingMemStream(sk_sp<SkData> data) : SkMemoryStream(std::move(data)) {}
+
+    size_t read(void* buffer, size_t size) override {
+        const size_t bytes = SkMemoryStream::read(buffer, size);
+        if (buffer) {
+            // Otherwise this is a skip().
+            fBytesCopied += bytes;
+        }
+        return bytes;
+    }
+
+    size_t peek(void* buffer, size_t size) const override {
+        const size_t bytes = SkMemoryStream::peek(buffer, size);
+        fBytesCopied += bytes;
+        return bytes;
+    }
+
+    size_t bytesCopied() const { return fBytesCopied; }
+
+private:
+    mutable size_t fBytesCopied = 0;
+};
 #endif // FakeStreams_DEFINED
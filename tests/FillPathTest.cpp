@@ -5,6 +5,9 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkRegion.h"
 #include "src/core/SkBlitter.h"
@@ -46,3 +49,91 @@ DEF_TEST(FillPathInverse, reporter) {
 
     REPORTER_ASSERT(reporter, blitter.m_blitCount == expected_lines);
 }
+
+// Coverage accumulation AA should closely match a 16x16 supersampled reference, except on the
+// few pixels where edges of the same path cross, where it only approximates the fill rule.
+DEF_TEST(FillPath_CoverageAA, reporter) {
+    SkPath triangle;
+    triangle.moveTo(10.3f, 10.7f);
+    triangle.lineTo(90.2f, 30.1f);
+    triangle.lineTo(40.6f, 88.8f);
+    triangle.close();
+
+    SkPath star;
+    star.moveTo(50, 2);
+    for (int i = 1; i < 5; ++i) {
+        float angle = i * 4 * SK_ScalarPI / 5;
+        star.lineTo(50 + 48 * sinf(angle), 50 - 48 * cosf(angle));
+    }
+    star.close();
+
+    SkPath cubic;
+    cubic.moveTo(-20.5f, 10.25f);
+    cubic.cubicTo(150, -40, -60, 160, 110.75f, 97.5f);
+    cubic.close();
+
+    SkPath ovals;
+    ovals.addOval({-30, -10, 60, 45});
+    ovals.addCircle(70.5f, 70.25f, 20);
+
+    constexpr int kSize = 100,
+                  kScale = 16;
+    auto draw = [](const SkPath& path, bool aa, int scale) {
+        SkBitmap bitmap;
+        bitmap.allocPixels(SkImageInfo::MakeA8(kSize * scale, kSize * scale));
+        bitmap.eraseColor(SK_ColorTRANSPARENT);
+
+        SkCanvas canvas(bitmap);
+        canvas.scale(scale, scale);
+        canvas.clipRect({5, 3, 95, 97});
+        canvas.rotate(10, 50, 50);
+        SkPaint paint;
+        paint.setAntiAlias(aa);
+        canvas.drawPath(path, paint);
+        return bitmap;
+    };
+
+    struct {
+        SkPath path;
+        int    maxDiff;
+    } tests[] = {
+        { triangle, 32 },
+        { star,    128 },
+        { cubic,    32 },
+        { ovals,    32 },
+    };
+    for (const auto& test : tests) {
+        for (SkPathFillType fillType : { SkPathFillType::kWinding,
+                                         SkPathFillType::kEvenOdd,
+                                         SkPathFillType::kInverseWinding,
+                                         SkPathFillType::kInverseEvenOdd }) {
+            SkPath p = test.path;
+            p.setFillType(fillType);
+
+            const bool forceCoverageAA = gSkForceCoverageAA;
+            gSkForceCoverageAA = true;
+            SkBitmap actual = draw(p, true, 1);
+            gSkForceCoverageAA = forceCoverageAA;
+            SkBitmap reference = draw(p, false, kScale);
+
+            int maxDiff = 0, totalDiff = 0;
+            for (int y = 0; y < kSize; ++y) {
+                for (int x = 0; x < kSize; ++x) {
+                    int sum = 0;
+                    for (int j = 0; j < kScale; ++j) {
+                        for (int i = 0; i < kScale; ++i) {
+                            sum += *reference.getAddr8(x * kScale + i, y * kScale + j);
+                        }
+                    }
+                    int diff = std::abs(sum / (kScale * kScale) - *actual.getAddr8(x, y));
+                    maxDiff    = std::max(maxDiff, diff);
+                    totalDiff += diff;
+                }
+            }
+            REPORTER_ASSERT(reporter, maxDiff <= test.maxDiff, "fill type %d: max diff %d",
+                            (int)fillType, maxDiff);
+            REPORTER_ASSERT(reporter, totalDiff <= kSize * kSize, "fill type %d: total diff %d",
+                            (int)fillType, totalDiff);
+        }
+    }
+}
@@ -6,6 +6,7 @@
  */
 
 #include "include/core/SkBitmap.h"
+#include "include/core/SkExecutor.h"
 #include "include/utils/SkRandom.h"
 #include "src/core/SkMipmap.h"
 #include "tests/Test.h"
@@ -211,6 +212,107 @@ DEF_TEST(MipMap_F16, reporter) {
     sk_sp<SkMipmap> mipmap(SkMipmap::Build(bmp, nullptr));
 }
 
+// Checks the first level against a direct computation of the box (even) or triangle (odd) filter.
+DEF_TEST(MipMap_Filters, reporter) {
+    SkRandom rand;
+    for (SkColorType ct : {kN32_SkColorType, kAlpha_8_SkColorType}) {
+        for (SkISize size : {SkISize{64, 64}, SkISize{71, 71}, SkISize{70, 41}, SkISize{69, 40},
+                             SkISize{1, 37}, SkISize{37, 1}}) {
+            SkBitmap bm;
+            bm.allocPixels(SkImageInfo::Make(size, ct, kPremul_SkAlphaType));
+            for (int y = 0; y < size.height(); y++) {
+                uint8_t* row = (uint8_t*)bm.getAddr(0, y);
+                for (size_t i = 0; i < bm.info().minRowBytes(); i++) {
+                    row[i] = (uint8_t)rand.nextU();
+                }
+            }
+
+            sk_sp<SkMipmap> mm(SkMipmap::Build(bm, nullptr));
+            SkMipmap::Level level;
+            REPORTER_ASSERT(reporter, mm && mm->getLevel(0, &level));
+            if (!mm) {
+                continue;
+            }
+            const SkPixmap& dst = level.fPixmap;
+
+            auto weights = [](int srcSize, int* shift) -> std::vector<int> {
+                if (srcSize == 1) { *shift = 0; return {1}; }
+                if (srcSize & 1)  { *shift = 2; return {1, 2, 1}; }
+                *shift = 1;
+                return {1, 1};
+            };
+            int shiftX, shiftY;
+            std::vector<int> wx = weights(size.width(),  &shiftX),
+                             wy = weights(size.height(), &shiftY);
+
+            const int bpp = bm.bytesPerPixel();
+            bool ok = true;
+            for (int y = 0; y < dst.height(); y++)
+            for (int x = 0; x < dst.width(); x++)
+            for (int c = 0; c < bpp; c++) {
+                int sum = 0;
+                for (size_t j = 0; j < wy.size(); j++)
+                for (size_t i = 0; i < wx.size(); i++) {
+                    const uint8_t* src = (const uint8_t*)bm.getAddr(2*x + i, 2*y + j);
+                    sum += wx[i] * wy[j] * src[c];
+                }
+                const uint8_t* got = (const uint8_t*)dst.addr(x, y);
+                ok &= got[c] == (sum >> (shiftX + shiftY));
+            }
+            REPORTER_ASSERT(reporter, ok, "%dx%d, color type %d", size.width(), size.height(), ct);
+        }
+    }
+}
+
+DEF_TEST(MipMap_Threaded, reporter) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkRandom rand;
+
+    for (SkColorType ct : {kN32_SkColorType, kAlpha_8_SkColorType, kRGBA_F16_SkColorType}) {
+        SkBitmap bm;
+        bm.allocPixels(SkImageInfo::Make(1001, 700, ct, kPremul_SkAlphaType));
+        for (int y = 0; y < bm.height(); y++) {
+            uint8_t* row = (uint8_t*)bm.getAddr(0, y);
+            for (size_t i = 0; i < bm.info().minRowBytes(); i++) {
+                // Keep F16 values finite, as the filters assume they are.
+                row[i] = ct == kRGBA_F16_SkColorType && (i & 1) ? rand.nextU() & 0x3b
+                                                                : rand.nextU();
+            }
+        }
+
+        sk_sp<SkMipmap> serial(SkMipmap::Build(bm, nullptr)),
+                        threaded(SkMipmap::Build(bm.pixmap(), nullptr, -1, executor.get())),
+                        partial(SkMipmap::Build(bm.pixmap(), nullptr, 2, executor.get()));
+        REPORTER_ASSERT(reporter, serial && threaded && partial);
+        if (!serial || !threaded || !partial) {
+            continue;
+        }
+        REPORTER_ASSERT(reporter, threaded->countLevels() == serial->countLevels());
+        REPORTER_ASSERT(reporter, partial->countLevels() == 2);
+
+        auto same_level = [&](const SkMipmap* mm, int index) {
+            SkMipmap::Level a, b;
+            if (!serial->getLevel(index, &a) || !mm->getLevel(index, &b) ||
+                a.fPixmap.dimensions() != b.fPixmap.dimensions()) {
+                return false;
+            }
+            for (int y = 0; y < a.fPixmap.height(); y++) {
+                if (0 != memcmp(a.fPixmap.addr(0, y), b.fPixmap.addr(0, y),
+                                a.fPixmap.info().minRowBytes())) {
+                    return false;
+                }
+            }
+            return true;
+        };
+        for (int i = 0; i < serial->countLevels(); i++) {
+            REPORTER_ASSERT(reporter, same_level(threaded.get(), i), "level %d", i);
+        }
+        for (int i = 0; i < partial->countLevels(); i++) {
+            REPORTER_ASSERT(reporter, same_level(partial.get(), i), "level %d", i);
+        }
+    }
+}
+
 #include "include/core/SkCanvas.h"
 #include "include/core/SkSurface.h"
 #include "src/core/SkMipmapBuilder.h"
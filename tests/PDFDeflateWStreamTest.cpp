@@ -9,6 +9,7 @@
 
 #ifdef SK_SUPPORT_PDF
 
+#include "include/core/SkData.h"
 #include "include/private/SkTo.h"
 #include "include/utils/SkRandom.h"
 #include "src/pdf/SkDeflate.h"
@@ -29,7 +30,8 @@ void skia_free_func(void*, void* address) { sk_free(address); }
  *  Use the un-deflate compression algorithm to decompress the data in src,
  *  returning the result.  Returns nullptr if an error occurs.
  */
-std::unique_ptr<SkStreamAsset> stream_inflate(skiatest::Reporter* reporter, SkStream* src) {
+std::unique_ptr<SkStreamAsset> stream_inflate(skiatest::Reporter* reporter, SkStream* src,
+                                              bool gzip = false) {
     SkDynamicMemoryWStream decompressedDynamicMemoryWStream;
     SkWStream* dst = &decompressedDynamicMemoryWStream;
 
@@ -45,7 +47,7 @@ std::unique_ptr<SkStreamAsset> stream_inflate(skiatest::Reporter* reporter, SkSt
     flateData.next_out = outputBuffer;
     flateData.avail_out = kBufferSize;
     int rc;
-    rc = inflateInit(&flateData);
+    rc = gzip ? inflateInit2(&flateData, 0x1F) : inflateInit(&flateData);
     if (rc != Z_OK) {
         ERRORF(reporter, "Zlib: inflateInit failed");
         return nullptr;
@@ -103,6 +105,49 @@ std::unique_ptr<SkStreamAsset> stream_inflate(skiatest::Reporter* reporter, SkSt
     }
     return decompressedDynamicMemoryWStream.detachAsStream();
 }
+
+/**
+ *  Compresses src with zlib itself, wrapped as zlib or gzip.
+ */
+sk_sp<SkData> zlib_deflate(const void* src, size_t size, int level, bool gzip,
+                           int strategy = Z_DEFAULT_STRATEGY) {
+    z_stream zStream;
+    zStream.zalloc = &skia_alloc_func;
+    zStream.zfree = &skia_free_func;
+    zStream.opaque = nullptr;
+    if (deflateInit2(&zStream, level, Z_DEFLATED, gzip ? 0x1F : 0x0F, 8, strategy) != Z_OK) {
+        return nullptr;
+    }
+    sk_sp<SkData> dst = SkData::MakeUninitialized(deflateBound(&zStream, (uLong)size));
+    zStream.next_in = (Bytef*)src;
+    zStream.avail_in = SkToUInt(size);
+    zStream.next_out = (Bytef*)dst->writable_data();
+    zStream.avail_out = SkToUInt(dst->size());
+    const int rc = deflate(&zStream, Z_FINISH);
+    const size_t written = dst->size() - zStream.avail_out;
+    deflateEnd(&zStream);
+    return rc == Z_STREAM_END ? SkData::MakeSubset(dst.get(), 0, written) : nullptr;
+}
+
+/**
+ *  Checks that actual is what zlib wrote, except for the gzip header's OS byte, which zlib sets
+ *  to the platform it was built for.
+ */
+void check_matches_zlib(skiatest::Reporter* r, const SkData* actual, const SkData* expected,
+                        bool gzip) {
+    REPORTER_ASSERT(r, expected && actual && expected->size() == actual->size());
+    if (expected && actual && expected->size() == actual->size()) {
+        const uint8_t* e = expected->bytes();
+        const uint8_t* a = actual->bytes();
+        const size_t kOSByte = 9;
+        for (size_t i = 0; i < actual->size(); ++i) {
+            if (e[i] != a[i] && !(gzip && i == kOSByte)) {
+                ERRORF(r, "Differs from zlib at byte %zu.", i);
+                break;
+            }
+        }
+    }
+}
 }  // namespace
 
 DEF_TEST(SkPDF_DeflateWStream, r) {
@@ -114,9 +159,14 @@ DEF_TEST(SkPDF_DeflateWStream, r) {
             buffer[j] = random.nextU() & 0xff;
         }
 
+        // Cover the zlib and gzip wrappers, whose headers vary with the level.
+        const int kLevels[] = {-1, 0, 1, 9};
+        const int level = kLevels[(i / 2) % SK_ARRAY_COUNT(kLevels)];
+        const bool gzip = i % 2;
+
         SkDynamicMemoryWStream dynamicMemoryWStream;
         {
-            SkDeflateWStream deflateWStream(&dynamicMemoryWStream);
+            SkDeflateWStream deflateWStream(&dynamicMemoryWStream, level, gzip);
             uint32_t j = 0;
             while (j < size) {
                 uint32_t writeSize =
@@ -130,7 +180,12 @@ DEF_TEST(SkPDF_DeflateWStream, r) {
             REPORTER_ASSERT(r, deflateWStream.bytesWritten() == size);
         }
         std::unique_ptr<SkStreamAsset> compressed(dynamicMemoryWStream.detachAsStream());
-        std::unique_ptr<SkStreamAsset> decompressed(stream_inflate(r, compressed.get()));
+        check_matches_zlib(r,
+                           SkData::MakeFromStream(compressed.get(), compressed->getLength()).get(),
+                           zlib_deflate(buffer.get(), size, level, gzip).get(), gzip);
+        SkAssertResult(compressed->rewind());
+
+        std::unique_ptr<SkStreamAsset> decompressed(stream_inflate(r, compressed.get(), gzip));
 
         if (!decompressed) {
             ERRORF(r, "Decompression failed.");
@@ -167,4 +222,44 @@ DEF_TEST(SkPDF_DeflateWStream, r) {
     REPORTER_ASSERT(r, !emptyDeflateWStream.writeText("FOO"));
 }
 
+DEF_TEST(SkPDF_DeflateWStreamStrategies, r) {
+    // Runs of repeated bytes among random ones, so that the strategies have something to find.
+    SkRandom random(654321);
+    sk_sp<SkData> data = SkData::MakeUninitialized(20000);
+    uint8_t* bytes = (uint8_t*)data->writable_data();
+    for (size_t i = 0; i < data->size();) {
+        const size_t run = std::min<size_t>(random.nextRangeU(1, 64), data->size() - i);
+        const uint8_t value = random.nextU() & 0xff;
+        const bool repeat = random.nextBool();
+        for (size_t j = 0; j < run; ++j) {
+            bytes[i++] = repeat ? value : random.nextU() & 0xff;
+        }
+    }
+
+    const struct {
+        SkDeflateWStream::Strategy fStrategy;
+        int fZlibStrategy;
+    } kStrategies[] = {
+        {SkDeflateWStream::Strategy::kDefault,     Z_DEFAULT_STRATEGY},
+        {SkDeflateWStream::Strategy::kFiltered,    Z_FILTERED},
+        {SkDeflateWStream::Strategy::kHuffmanOnly, Z_HUFFMAN_ONLY},
+        {SkDeflateWStream::Strategy::kRLE,         Z_RLE},
+    };
+    for (const auto& strategy : kStrategies) {
+        for (int level : {-1, 0, 1, 9}) {
+            for (bool gzip : {false, true}) {
+                SkDynamicMemoryWStream compressed;
+                {
+                    SkDeflateWStream deflateWStream(&compressed, level, gzip, strategy.fStrategy);
+                    deflateWStream.write(data->data(), data->size());
+                }
+                check_matches_zlib(r, compressed.detachAsData().get(),
+                                   zlib_deflate(data->data(), data->size(), level, gzip,
+                                                strategy.fZlibStrategy).get(),
+                                   gzip);
+            }
+        }
+    }
+}
+
 #endif
@@ -8,15 +8,25 @@
 
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkAnnotation.h"
 #include "include/core/SkExecutor.h"
+#include "include/core/SkFont.h"
+#include "include/core/SkImageEncoder.h"
+#include "include/core/SkPictureRecorder.h"
 #include "include/core/SkStream.h"
 #include "include/docs/SkPDFDocument.h"
+#include "include/effects/SkGradientShader.h"
 #include "src/core/SkOSFile.h"
+#include "src/core/SkOpts.h"
+#include "src/core/SkResourceCache.h"
 #include "src/utils/SkOSPath.h"
 #include "tools/Resources.h"
 
 #include "tools/ToolUtils.h"
 
+#include <map>
+#include <string>
+
 static void test_empty(skiatest::Reporter* reporter) {
     SkDynamicMemoryWStream stream;
 
@@ -256,3 +266,269 @@ DEF_TEST(SkPDF_abort_jobs, rep) {
     doc->abort();
 }
 
+
+// Pages which share some resources (fonts, graphic states, shaders and images) with each other,
+// and make some of their own.
+static std::vector<sk_sp<SkPicture>> make_pages(int count) {
+    SkBitmap alphaBitmap;
+    alphaBitmap.allocN32Pixels(32, 32);
+    alphaBitmap.eraseColor(0x80FF0000);
+    alphaBitmap.erase(SK_ColorBLUE, SkIRect::MakeXYWH(8, 8, 16, 16));
+    sk_sp<SkImage> alphaImage = alphaBitmap.asImage();
+    // Not opaque by its alpha type, but by its pixels, so it needs no soft mask.
+    SkBitmap opaqueBitmap;
+    opaqueBitmap.allocN32Pixels(16, 16);
+    opaqueBitmap.eraseColor(SK_ColorGREEN);
+    sk_sp<SkImage> opaqueImage = opaqueBitmap.asImage();
+    // Likewise, but lazy: whether its pixels are opaque is only known once it is decoded.
+    sk_sp<SkImage> lazyOpaqueImage = SkImage::MakeFromEncoded(
+            SkEncodeBitmap(opaqueBitmap, SkEncodedImageFormat::kPNG, 100));
+
+    std::vector<sk_sp<SkPicture>> pages;
+    for (int i = 0; i < count; ++i) {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(SkRect::MakeXYWH(10, 20, 300, 400));
+        SkPaint paint;
+        paint.setColor(SkColorSetARGB(0x80 + 16 * (i % 4), 0, 0x80, 0xFF));
+        canvas->drawRect(SkRect::MakeXYWH(20, 30, 100, 100), paint);
+
+        const SkPoint pts[] = {{0, 0}, {100, (SkScalar)(10 * (i % 3))}};
+        const SkColor colors[] = {SK_ColorRED, SkColorSetA(SK_ColorGREEN, 0x40 * (i % 2) + 0x80)};
+        paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2,
+                                                     SkTileMode::kClamp));
+        canvas->drawCircle(150, 150, 50, paint);
+        paint.setShader(nullptr);
+
+        paint.setStyle(SkPaint::kStroke_Style);
+        paint.setStrokeWidth(1 + i % 5);
+        canvas->drawLine(20, 300, 280, 320, paint);
+
+        if (i % 3 == 0) {
+            canvas->drawImage(alphaImage, 40, 200);
+        }
+        if (i % 4 == 1) {
+            canvas->drawImage(opaqueImage, 80, 200);
+        }
+        if (i % 5 == 2) {
+            canvas->drawImage(lazyOpaqueImage, 100, 200);
+        }
+        SkFont font(ToolUtils::create_portable_typeface(), 12);
+        SkString text = SkStringPrintf("Page %d of %d", i + 1, count);
+        canvas->drawString(text, 30, 380, font, SkPaint());
+
+        SkString name = SkStringPrintf("page%d", i);
+        SkAnnotateNamedDestination(canvas, {30, 30}, SkData::MakeWithCString(name.c_str()).get());
+        SkAnnotateRectWithURL(canvas, SkRect::MakeXYWH(30, 360, 100, 20),
+                              SkData::MakeWithCString("https://skia.org/").get());
+        pages.push_back(recorder.finishRecordingAsPicture());
+    }
+    return pages;
+}
+
+// Splits a PDF into its numbered objects.
+static std::map<int, std::string> pdf_objects(const SkData& pdf) {
+    const std::string bytes(static_cast<const char*>(pdf.data()), pdf.size());
+    std::map<int, std::string> objects;
+    for (size_t start = bytes.find(" 0 obj\n"); start != std::string::npos;
+         start = bytes.find(" 0 obj\n", start + 1)) {
+        size_t number = bytes.rfind('\n', start);
+        number = number == std::string::npos ? 0 : number + 1;
+        const size_t end = bytes.find("\nendobj\n", start);
+        if (end == std::string::npos) {
+            break;
+        }
+        objects[std::stoi(bytes.substr(number, start - number))] = bytes.substr(start, end - start);
+    }
+    return objects;
+}
+
+static sk_sp<SkData> add_pages(const std::vector<sk_sp<SkPicture>>& pages,
+                               SkExecutor* executor, bool streamPages = false) {
+    SkPDF::Metadata metadata;
+    metadata.fExecutor = executor;
+    metadata.fStreamPages = streamPages;
+    SkDynamicMemoryWStream stream;
+    auto doc = SkPDF::MakeDocument(&stream, metadata);
+    doc->beginPage(100, 100)->drawColor(SK_ColorCYAN);
+    doc->addPages(pages.data(), SkToInt(pages.size()) / 2);
+    doc->addPages(pages.data() + pages.size() / 2, SkToInt(pages.size() - pages.size() / 2));
+    doc->close();
+    return stream.detachAsData();
+}
+
+// Pages added with SkDocument::addPages() are drawn concurrently on the executor, but should be
+// numbered the same way, and so have the same objects, as without one.
+DEF_TEST(SkPDF_addPages_reproducible, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_addPages_reproducible, r);
+    std::vector<sk_sp<SkPicture>> pages = make_pages(24);
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (bool streamPages : {false, true}) {
+        const std::map<int, std::string> expected =
+                pdf_objects(*add_pages(pages, nullptr, streamPages));
+        REPORTER_ASSERT(r, expected.size() > pages.size());
+        // Only the lazy opaque image fills the mask number reserved for it with an empty object.
+        int empty = 0;
+        for (const auto& [number, object] : expected) {
+            empty += object == " 0 obj\n<<>>";
+        }
+        REPORTER_ASSERT(r, empty == 1, "%d empty objects", empty);
+
+        for (int run = 0; run < 3; ++run) {
+            const std::map<int, std::string> actual =
+                    pdf_objects(*add_pages(pages, executor.get(), streamPages));
+            REPORTER_ASSERT(r, actual.size() == expected.size());
+            for (const auto& [number, object] : expected) {
+                auto found = actual.find(number);
+                if (found == actual.end() || found->second != object) {
+                    ERRORF(r, "Object %d differs with an executor.", number);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// Fonts are subset concurrently on the executor when the document is closed, but should be
+// emitted in the same order, and so numbered the same way, as without one.
+DEF_TEST(SkPDF_fonts_reproducible, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_fonts_reproducible, r);
+    const char* resources[] = {"fonts/Roboto-Regular.ttf", "fonts/Em.ttf", "fonts/ahem.ttf"};
+    auto draw = [&](SkExecutor* executor) {
+        SkPDF::Metadata metadata;
+        metadata.fExecutor = executor;
+        SkDynamicMemoryWStream stream;
+        auto doc = SkPDF::MakeDocument(&stream, metadata);
+        SkCanvas* canvas = doc->beginPage(300, 300);
+        SkScalar y = 20;
+        for (const char* resource : resources) {
+            SkFont font(MakeResourceAsTypeface(resource), 12);
+            canvas->drawString("Sphinx of black quartz, judge my vow.", 10, y, font, SkPaint());
+            y += 20;
+        }
+        doc->close();
+        return stream.detachAsData();
+    };
+    const std::map<int, std::string> expected = pdf_objects(*draw(nullptr));
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    REPORTER_ASSERT(r, pdf_objects(*draw(executor.get())) == expected);
+}
+
+// With fStreamPages, each page is written as soon as it ends, and all of them are in the page
+// tree once the document is closed.
+DEF_TEST(SkPDF_streamPages, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_streamPages, r);
+    std::vector<sk_sp<SkPicture>> pages = make_pages(20);
+    SkPDF::Metadata metadata;
+    metadata.fStreamPages = true;
+    SkDynamicMemoryWStream stream;
+    auto doc = SkPDF::MakeDocument(&stream, metadata);
+
+    auto countWritten = [&stream](const char* text) {
+        std::string bytes(stream.bytesWritten(), '\0');
+        stream.copyTo(&bytes[0]);
+        int count = 0;
+        for (size_t i = bytes.find(text); i != std::string::npos; i = bytes.find(text, i + 1)) {
+            count++;
+        }
+        return count;
+    };
+    for (size_t i = 0; i < pages.size(); ++i) {
+        const SkRect cull = pages[i]->cullRect();
+        SkCanvas* canvas = doc->beginPage(cull.width(), cull.height());
+        canvas->translate(-cull.x(), -cull.y());
+        canvas->drawPicture(pages[i]);
+        doc->endPage();
+        REPORTER_ASSERT(r, countWritten("/Type /Page\n") == SkToInt(i + 1));
+    }
+    REPORTER_ASSERT(r, countWritten("/Type /Pages\n") == 0);
+    doc->close();
+
+    // 20 pages, in groups of 8 under a root.
+    REPORTER_ASSERT(r, countWritten("/Type /Pages\n") == 4);
+    REPORTER_ASSERT(r, countWritten("/Count 20") == 1);
+}
+
+// Every compression level and strategy should make the same objects, and only the streams in them
+// should differ.
+DEF_TEST(SkPDF_compression, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_compression, r);
+    using Level = SkPDF::Metadata::CompressionLevel;
+    using Strategy = SkPDF::Metadata::CompressionStrategy;
+    std::vector<sk_sp<SkPicture>> pages = make_pages(6);
+    auto makePDF = [&pages](Level level, Strategy strategy) {
+        SkPDF::Metadata metadata;
+        metadata.fCompressionLevel = level;
+        metadata.fCompressionStrategy = strategy;
+        SkDynamicMemoryWStream stream;
+        auto doc = SkPDF::MakeDocument(&stream, metadata);
+        doc->addPages(pages.data(), SkToInt(pages.size()));
+        doc->close();
+        return stream.detachAsData();
+    };
+    sk_sp<SkData> none = makePDF(Level::None, Strategy::Default);
+    const size_t objectCount = pdf_objects(*none).size();
+    for (Level level : {Level::Default, Level::LowButFast, Level::Average, Level::HighButSlow}) {
+        for (Strategy strategy : {Strategy::Default, Strategy::Filtered, Strategy::HuffmanOnly,
+                                  Strategy::RLE}) {
+            sk_sp<SkData> pdf = makePDF(level, strategy);
+            REPORTER_ASSERT(r, pdf_objects(*pdf).size() == objectCount);
+            REPORTER_ASSERT(r, pdf->size() < none->size());
+        }
+    }
+    // Default is the same as Average.
+    REPORTER_ASSERT(r, makePDF(Level::Default, Strategy::Default)->equals(
+                               makePDF(Level::Average, Strategy::Default).get()));
+}
+
+// Images with encoded data are encoded once and kept in SkResourceCache, so that later documents
+// drawing the same image, or another image decoded from the same data, reuse the encoding.
+DEF_TEST(SkPDF_imageCache, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_imageCache, r);
+    // Encoded images are shared by the hash of their encoded data.
+    auto countCached = [](uint64_t sharedID) {
+        struct Data {
+            uint64_t fSharedID;
+            int fCount;
+        } data = {sharedID, 0};
+        SkResourceCache::VisitAll([](const SkResourceCache::Rec& rec, void* dataPtr) {
+            Data* data = static_cast<Data*>(dataPtr);
+            if (rec.getKey().getSharedID() == data->fSharedID &&
+                0 == strcmp(rec.getCategory(), "pdf-image")) {
+                data->fCount++;
+            }
+        }, &data);
+        return data.fCount;
+    };
+    auto drawImage = [](const sk_sp<SkImage>& image) {
+        SkDynamicMemoryWStream stream;
+        auto doc = SkPDF::MakeDocument(&stream);
+        doc->beginPage(image->width(), image->height())->drawImage(image, 0, 0);
+        doc->close();
+        return stream.detachAsData();
+    };
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(64, 64);
+    bitmap.eraseColor(0x80FF0000);
+    sk_sp<SkImage> raster = bitmap.asImage();
+    // Nothing would purge an entry for an image without encoded data, so none is made.
+    sk_sp<SkData> first = drawImage(raster);
+    sk_sp<SkData> second = drawImage(raster);
+    REPORTER_ASSERT(r, countCached(raster->uniqueID()) == 0);
+    REPORTER_ASSERT(r, first->equals(second.get()));
+
+    // JPEGs are passed through, PNGs deflated.
+    for (const char* resource : {"images/brickwork-texture.jpg", "images/mandrill_128.png"}) {
+        sk_sp<SkData> encoded = GetResourceAsData(resource);
+        if (!encoded) {
+            continue;
+        }
+        const uint32_t hash = SkOpts::hash(encoded->data(), encoded->size());
+        first = drawImage(SkImage::MakeFromEncoded(encoded));
+        REPORTER_ASSERT(r, countCached(hash) == 1, "%s", resource);
+        second = drawImage(SkImage::MakeFromEncoded(
+                SkData::MakeWithCopy(encoded->data(), encoded->size())));
+        REPORTER_ASSERT(r, countCached(hash) == 1, "%s", resource);
+        REPORTER_ASSERT(r, first->equals(second.get()), "%s", resource);
+    }
+}
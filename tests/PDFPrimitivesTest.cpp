@@ -29,6 +29,7 @@
 #include "src/pdf/SkPDFDevice.h"
 #include "src/pdf/SkPDFDocumentPriv.h"
 #include "src/pdf/SkPDFFont.h"
+#include "src/pdf/SkPDFSubsetFont.h"
 #include "src/pdf/SkPDFTypes.h"
 #include "src/pdf/SkPDFUnion.h"
 #include "src/pdf/SkPDFUtils.h"
@@ -322,6 +323,37 @@ DEF_TEST(SkPDF_FontCanEmbedTypeface, reporter) {
                     SkPDFFont::CanEmbedTypeface(portableTypeface.get(), &doc));
 }
 
+// Subset fonts are cached by typeface, subsetter, and the exact set of glyphs used.
+DEF_TEST(SkPDF_SubsetFontCache, reporter) {
+    sk_sp<SkTypeface> typeface = MakeResourceAsTypeface("fonts/Roboto-Regular.ttf");
+    if (!typeface) {
+        return;
+    }
+    const SkFontID id = typeface->uniqueID();
+    const auto harfbuzz = SkPDF::Metadata::kHarfbuzz_Subsetter;
+    const auto sfntly = SkPDF::Metadata::kSfntly_Subsetter;
+
+    SkPDFGlyphUse glyphs(1, 100);
+    SkPDFGlyphUse sameGlyphs(1, 100);
+    SkPDFGlyphUse moreGlyphs(1, 100);
+    for (SkGlyphID gid : {0, 3, 42}) {
+        glyphs.set(gid);
+        sameGlyphs.set(gid);
+        moreGlyphs.set(gid);
+    }
+    moreGlyphs.set(99);
+
+    REPORTER_ASSERT(reporter, !SkPDFFindSubsetFont(id, glyphs, harfbuzz));
+    sk_sp<SkData> subset = SkData::MakeWithCString("subset");
+    SkPDFAddSubsetFont(id, glyphs, harfbuzz, subset);
+
+    sk_sp<SkData> found = SkPDFFindSubsetFont(id, sameGlyphs, harfbuzz);
+    REPORTER_ASSERT(reporter, found && found->equals(subset.get()));
+    REPORTER_ASSERT(reporter, !SkPDFFindSubsetFont(id, moreGlyphs, harfbuzz));
+    REPORTER_ASSERT(reporter, !SkPDFFindSubsetFont(id, glyphs, sfntly));
+    REPORTER_ASSERT(reporter, !SkPDFFindSubsetFont(id + 1, glyphs, harfbuzz));
+}
+
 
 // test to see that all finite scalars round trip via scanf().
 static void check_pdf_scalar_serialization(
@@ -11,6 +11,7 @@
 #include "include/core/SkClipOp.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFontStyle.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
@@ -18,6 +19,7 @@
 #include "include/core/SkPath.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkPixelRef.h"
+#include "include/core/SkPixmap.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkScalar.h"
@@ -25,6 +27,7 @@
 #include "include/core/SkStream.h"
 #include "include/core/SkTypeface.h"
 #include "include/core/SkTypes.h"
+#include "include/effects/SkImageFilters.h"
 #include "include/utils/SkRandom.h"
 #include "src/core/SkBigPicture.h"
 #include "src/core/SkClipOpPriv.h"
@@ -32,6 +35,7 @@
 #include "src/core/SkPicturePriv.h"
 #include "src/core/SkRectPriv.h"
 #include "tests/Test.h"
+#include "tools/ToolUtils.h"
 
 #include <memory>
 
@@ -998,3 +1002,97 @@ DEF_TEST(Picture_nested_op_count, r) {
     check(make_pic(10, leaf1),  10,  10);
     check(make_pic(10, leaf10), 10, 100);
 }
+
+DEF_TEST(Picture_playbackTiled, r) {
+    constexpr int kTileSize = 64;
+    const SkMatrix matrix = SkMatrix::Scale(1.25f, 1.25f);
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(500, 375);
+
+    // Anti-aliased shapes that each fit inside one tile, and aliased rectangles anywhere, are
+    // drawn exactly as a single canvas would draw them.
+    auto recordExact = [&](SkBBHFactory* factory) {
+        SkPictureRecorder rec;
+        SkCanvas* c = rec.beginRecording({0,0, 400,300}, factory);
+        SkRandom rand;
+        SkPaint paint;
+        for (int i = 0; i < 200; i++) {
+            paint.setColor(rand.nextU() | 0xFF000000);
+            paint.setAntiAlias(false);
+            c->drawRect(SkRect::MakeXYWH(rand.nextRangeScalar(-20, 400),
+                                         rand.nextRangeScalar(-20, 300), 30, 20), paint);
+
+            // Pick a tile, and a spot well inside it, in picture coordinates.
+            paint.setAntiAlias(true);
+            SkRect inside = SkRect::MakeXYWH(kTileSize * rand.nextRangeU(0, 7) + 8,
+                                             kTileSize * rand.nextRangeU(0, 5) + 8,
+                                             kTileSize - 16, kTileSize - 16);
+            inside = SkMatrix::Scale(0.8f, 0.8f).mapRect(inside);
+            switch (i % 3) {
+                case 0: c->drawOval(inside, paint); break;
+                case 1: c->drawCircle(inside.centerX(), inside.centerY(), 12, paint); break;
+                case 2:
+                    c->save();
+                    c->translate(inside.centerX(), inside.centerY());
+                    c->rotate(30);
+                    c->drawRect({-10,-5, 10,5}, paint);
+                    c->restore();
+                    break;
+            }
+        }
+        paint.setAntiAlias(false);
+        paint.setColor(0x80008000);
+        c->drawRect({20,20, 380,60}, paint);
+        c->saveLayerAlpha(nullptr, 0x80);
+        c->drawRect({100,100, 300,200}, SkPaint{});
+        c->restore();
+        return rec.finishRecordingAsPicture();
+    };
+
+    // Anti-aliased shapes crossing tile boundaries, optionally blurred behind a layer.
+    auto recordCrossing = [](SkBBHFactory* factory, bool backdrop) {
+        SkPictureRecorder rec;
+        SkCanvas* c = rec.beginRecording({0,0, 400,300}, factory);
+        SkRandom rand;
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < 200; i++) {
+            paint.setColor(rand.nextU() | 0xFF000000);
+            c->drawOval(SkRect::MakeXYWH(rand.nextRangeScalar(-20, 400),
+                                         rand.nextRangeScalar(-20, 300), 45, 25), paint);
+        }
+        if (backdrop) {
+            sk_sp<SkImageFilter> blur = SkImageFilters::Blur(4, 4, nullptr);
+            c->saveLayer({nullptr, nullptr, blur.get(), 0});
+            c->restore();
+        }
+        return rec.finishRecordingAsPicture();
+    };
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkRTreeFactory factory;
+    auto check = [&](sk_sp<SkPicture> pic) {
+        SkBitmap expected;
+        expected.allocPixels(info);
+        expected.eraseColor(SK_ColorWHITE);
+        SkCanvas(expected).drawPicture(pic, &matrix, nullptr);
+
+        for (SkExecutor* e : {executor.get(), (SkExecutor*)nullptr}) {
+            SkBitmap actual;
+            actual.allocPixels(info);
+            actual.eraseColor(SK_ColorWHITE);
+            REPORTER_ASSERT(r, pic->playbackTiled(actual.pixmap(), matrix, e, kTileSize));
+            REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected, actual));
+        }
+    };
+    check(recordExact(&factory));
+    // Pictures without a BBH, or with backdrop filters, are replayed serially, so even shapes
+    // crossing tiles match.
+    check(recordExact(nullptr));
+    check(recordCrossing(nullptr, false));
+    check(recordCrossing(&factory, true));
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(10, 10);
+    REPORTER_ASSERT(r, !recordExact(&factory)->playbackTiled(bitmap.pixmap(), matrix, nullptr, 0));
+    REPORTER_ASSERT(r, !recordExact(&factory)->playbackTiled(SkPixmap(), matrix, nullptr, 64));
+}
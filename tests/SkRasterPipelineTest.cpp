@@ -5,8 +5,14 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkCanvas.h"
+#include "include/core/SkColorSpace.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkShader.h"
+#include "include/core/SkSurface.h"
 #include "include/private/SkHalf.h"
 #include "include/private/SkTo.h"
+#include "src/core/SkCoreBlitters.h"
 #include "src/core/SkRasterPipeline.h"
 #include "src/gpu/GrSwizzle.h"
 #include "tests/Test.h"
@@ -566,3 +572,76 @@ DEF_TEST(SkRasterPipeline_lowp_clamp01, r) {
     p.append(SkRasterPipeline::store_8888, &ptr);
     p.run(0,0,1,1);
 }
+
+DEF_TEST(SkRasterPipelineBlitter_Prototypes, r) {
+    // Solid color paints are drawn by copies of cached prototype blitters.  Those should draw
+    // exactly what the equivalent color shader does, which never uses a prototype.
+    auto draw = [](SkCanvas* canvas, bool useShader) {
+        const SkColor4f colors[] = {
+            {0.2f, 0.4f, 0.8f, 1.0f},
+            {0.9f, 0.1f, 0.3f, 0.5f},
+            {0.0f, 0.0f, 0.0f, 1.0f},
+        };
+        const SkBlendMode modes[] = {
+            SkBlendMode::kSrcOver, SkBlendMode::kSrc, SkBlendMode::kMultiply,
+        };
+        SkPath path;
+        path.moveTo(3.3f, 60.1f);
+        path.cubicTo(90, -20, -30, 90, 61.6f, 5.2f);
+
+        canvas->clear(SK_ColorWHITE);
+        // Draw everything twice, so the second time around uses cached prototypes.
+        for (int pass = 0; pass < 2; ++pass)
+        for (const SkColor4f& color : colors)
+        for (SkBlendMode mode : modes) {
+            SkPaint paint;
+            if (useShader) {
+                paint.setShader(SkShaders::Color(color, nullptr));
+            } else {
+                paint.setColor(color);
+            }
+            paint.setBlendMode(mode);
+
+            canvas->drawRect({2, 2, 30, 20}, paint);                // blitRect()
+            paint.setAntiAlias(true);
+            canvas->drawPath(path, paint);                          // blitAntiH()
+            canvas->drawRect({10.5f, 30.5f, 50.25f, 44.75f}, paint);
+            paint.setStyle(SkPaint::kStroke_Style);
+            canvas->drawLine(5.5f, 50.25f, 60.75f, 62.5f, paint);   // blitMask()
+        }
+    };
+
+    const SkImageInfo infos[] = {
+        SkImageInfo::Make(64, 64, kRGBA_F16_SkColorType, kPremul_SkAlphaType,
+                          SkColorSpace::MakeSRGBLinear()),
+        SkImageInfo::Make(64, 64, kRGBA_8888_SkColorType, kPremul_SkAlphaType,
+                          SkColorSpace::MakeRGB(SkNamedTransferFn::kSRGB, SkNamedGamut::kRec2020)),
+        SkImageInfo::Make(64, 64, kRGBA_8888_SkColorType, kUnpremul_SkAlphaType),
+        SkImageInfo::Make(64, 64, kRGBA_1010102_SkColorType, kPremul_SkAlphaType),
+        SkImageInfo::Make(64, 64, kAlpha_8_SkColorType, kPremul_SkAlphaType),
+    };
+    for (const SkImageInfo& info : infos) {
+        SkRasterPipelineBlitterCache::Purge();
+        auto before = SkRasterPipelineBlitterCache::GetStats();
+
+        sk_sp<SkSurface> want = SkSurface::MakeRaster(info),
+                         got  = SkSurface::MakeRaster(info);
+        draw(want->getCanvas(), /*useShader=*/true);
+        draw(got ->getCanvas(), /*useShader=*/false);
+
+        auto after = SkRasterPipelineBlitterCache::GetStats();
+        REPORTER_ASSERT(r, after.fMisses > before.fMisses);
+        REPORTER_ASSERT(r, after.fHits   > before.fHits);
+
+        SkPixmap wantPixels, gotPixels;
+        REPORTER_ASSERT(r, want->peekPixels(&wantPixels));
+        REPORTER_ASSERT(r,  got->peekPixels(&gotPixels));
+        for (int y = 0; y < info.height(); ++y) {
+            if (memcmp(wantPixels.addr(0,y), gotPixels.addr(0,y), info.minRowBytes())) {
+                ERRORF(r, "%d: prototype blitter differs from color shader in row %d",
+                       info.colorType(), y);
+                break;
+            }
+        }
+    }
+}
@@ -7,6 +7,7 @@
 
 #include "src/core/SkStrikeCache.h"
 #include "src/core/SkStrikeSpec.h"
+#include "src/core/SkTaskGroup.h"
 #include "tests/Test.h"
 #include "tools/ToolUtils.h"
 
@@ -48,6 +49,34 @@ DEF_TEST(SkStrikeCache_CachePurge, Reporter) {
         REPORTER_ASSERT(Reporter, cache.getTotalMemoryUsed() == 0);
     }
     REPORTER_ASSERT(Reporter, cache.getTotalMemoryUsed() == 0);
+}
+
+DEF_TEST(SkStrikeCache_ConcurrentBudget, Reporter) {
+    SkStrikeCache cache;
+    cache.setCacheCountLimit(8);
+
+    sk_sp<SkTypeface> typeface =
+            ToolUtils::create_portable_typeface("serif", SkFontStyle::Italic());
+
+    // Many distinct strikes land in many shards; the count budget still covers them all.
+    SkTaskGroup().batch(8, [&](int thread) {
+        SkFont font;
+        font.setTypeface(typeface);
+        SkPaint defaultPaint;
+        for (int size = 8; size < 40; size++) {
+            font.setSize(size + 32 * thread);
+            SkStrikeSpec strikeSpec = SkStrikeSpec::MakeMask(
+                    font, defaultPaint, SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+                    SkScalerContextFlags::kNone, SkMatrix::I());
+            sk_sp<SkStrike> strike = strikeSpec.findOrCreateStrike(&cache);
+            REPORTER_ASSERT(Reporter, strike != nullptr);
+        }
+    });
 
+    REPORTER_ASSERT(Reporter, cache.getCacheCountUsed() <= 8);
+    REPORTER_ASSERT(Reporter, cache.getTotalMemoryUsed() > 0);
 
+    cache.purgeAll();
+    REPORTER_ASSERT(Reporter, cache.getCacheCountUsed() == 0);
+    REPORTER_ASSERT(Reporter, cache.getTotalMemoryUsed() == 0);
 }
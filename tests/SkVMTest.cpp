@@ -5,9 +5,16 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkBitmap.h"
 #include "include/core/SkColorPriv.h"
+#include "include/core/SkData.h"
+#include "include/core/SkGraphics.h"
 #include "include/private/SkColorData.h"
+#include "include/private/SkMutex.h"
+#include "src/core/SkArenaAlloc.h"
+#include "src/core/SkCoreBlitters.h"
 #include "src/core/SkCpu.h"
+#include "src/core/SkMatrixProvider.h"
 #include "src/core/SkMSAN.h"
 #include "src/core/SkVM.h"
 #include "tests/Test.h"
@@ -2538,3 +2545,67 @@ DEF_TEST(SkVM_fast_mul, r) {
         }
     });
 }
+
+DEF_TEST(SkVM_PersistentProgramCache, r) {
+    struct MemoryCache final : public SkGraphics::PersistentProgramCache {
+        sk_sp<SkData> load(const SkData& key) override {
+            SkAutoMutexExclusive lock(fMutex);
+            for (const auto& [k, v] : fEntries) {
+                if (k->equals(&key)) {
+                    return v;
+                }
+            }
+            return nullptr;
+        }
+        void store(const SkData& key, const SkData& data) override {
+            SkAutoMutexExclusive lock(fMutex);
+            fEntries.push_back({SkData::MakeWithCopy(key.data(), key.size()),
+                                SkData::MakeWithCopy(data.data(), data.size())});
+        }
+
+        SkMutex fMutex;
+        std::vector<std::pair<sk_sp<SkData>, sk_sp<SkData>>> fEntries;
+    } cache;
+
+    auto draw = [&](SkBitmap* bm) {
+        bm->allocN32Pixels(16, 16);
+        bm->eraseColor(SK_ColorWHITE);
+        SkPaint paint;
+        paint.setColor4f({0.25f, 0.5f, 0.75f, 0.5f});
+        SkSimpleMatrixProvider matrixProvider(SkMatrix::I());
+        SkSTArenaAlloc<2048> alloc;
+        SkBlitter* blitter = SkCreateSkVMBlitter(bm->pixmap(), paint, matrixProvider,
+                                                 &alloc, nullptr);
+        if (!blitter) {
+            return false;
+        }
+        blitter->blitRect(2,2, 8,8);
+        const SkAlpha  aa[] = { 0x40, 0xc0, 0 };
+        const int16_t runs[] = {    3,    5, 0 };
+        blitter->blitAntiH(0,12, aa, runs);
+        return true;
+    };
+
+    SkGraphics::PersistentProgramCache* prev = SkGraphics::SetPersistentProgramCache(&cache);
+
+    SkVMBlitterProgramCache::Purge();
+    SkBitmap built;
+    if (!draw(&built)) {
+        SkGraphics::SetPersistentProgramCache(prev);
+        return;
+    }
+    REPORTER_ASSERT(r, !cache.fEntries.empty());
+
+    SkVMBlitterProgramCache::Purge();
+    const int64_t persistentHits = SkVMBlitterProgramCache::GetStats().fPersistentHits;
+    SkBitmap loaded;
+    REPORTER_ASSERT(r, draw(&loaded));
+    REPORTER_ASSERT(r, SkVMBlitterProgramCache::GetStats().fPersistentHits > persistentHits);
+
+    SkGraphics::SetPersistentProgramCache(prev);
+
+    for (int y = 0; y < 16; y++)
+    for (int x = 0; x < 16; x++) {
+        REPORTER_ASSERT(r, *built.getAddr32(x,y) == *loaded.getAddr32(x,y));
+    }
+}
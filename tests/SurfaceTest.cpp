@@ -7,11 +7,13 @@
 
 #include "include/core/SkCanvas.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkOverdrawCanvas.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkRRect.h"
 #include "include/core/SkRegion.h"
 #include "include/core/SkSurface.h"
+#include "include/effects/SkGradientShader.h"
 #include "include/gpu/GrBackendSurface.h"
 #include "include/gpu/GrDirectContext.h"
 #include "src/core/SkAutoPixmapStorage.h"
@@ -688,6 +690,56 @@ DEF_TEST(surface_raster_zeroinitialized, reporter) {
     }
 }
 
+DEF_TEST(surface_raster_threaded, reporter) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    auto draw = [](SkCanvas* canvas) {
+        const SkPoint pts[] = {{0, 0}, {1000, 700}};
+        const SkColor colors[] = {SK_ColorRED, SK_ColorBLUE};
+        SkPaint paint;
+        paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2, SkTileMode::kClamp));
+        canvas->drawPaint(paint);
+
+        paint.setShader(nullptr);
+        paint.setAntiAlias(true);
+        paint.setColor(0x8000FF00);
+        SkPath path;
+        path.moveTo(13.3f, 17.1f);
+        path.cubicTo(900, -200, -300, 900, 987.6f, 653.2f);
+        path.close();
+        canvas->drawPath(path, paint);
+
+        canvas->rotate(7);
+        paint.setStyle(SkPaint::kStroke_Style);
+        paint.setStrokeWidth(0);
+        canvas->drawOval({50.5f, 40.25f, 950.75f, 600.5f}, paint);
+
+        canvas->clipRRect(SkRRect::MakeRectXY({100, 100, 900, 600}, 40, 40), true);
+        paint.setStyle(SkPaint::kFill_Style);
+        paint.setColor(0x40FF00FF);
+        canvas->drawRect({-10.5f, 33.3f, 1500, 1200}, paint);
+    };
+
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(1000, 700);
+    sk_sp<SkSurface> serial = SkSurface::MakeRaster(info);
+    sk_sp<SkSurface> threaded = SkSurface::MakeRasterThreaded(info, executor.get());
+    REPORTER_ASSERT(reporter, threaded);
+    REPORTER_ASSERT(reporter, !SkSurface::MakeRasterThreaded(info, nullptr));
+
+    draw(serial->getCanvas());
+    draw(threaded->getCanvas());
+
+    SkPixmap expected, actual;
+    REPORTER_ASSERT(reporter, serial->peekPixels(&expected));
+    REPORTER_ASSERT(reporter, threaded->peekPixels(&actual));
+    for (int y = 0; y < info.height(); ++y) {
+        if (memcmp(expected.addr(0, y), actual.addr(0, y), info.minRowBytes())) {
+            ERRORF(reporter, "threaded surface differs from serial surface in row %d", y);
+            break;
+        }
+    }
+}
+
 static sk_sp<SkSurface> create_gpu_surface_backend_texture(GrDirectContext* dContext,
                                                            int sampleCnt,
                                                            const SkColor4f& color) {
@@ -7,6 +7,7 @@
 
 #include "include/core/SkSwizzle.h"
 #include "include/private/SkImageInfoPriv.h"
+#include "include/utils/SkRandom.h"
 #include "src/codec/SkSwizzler.h"
 #include "src/core/SkOpts.h"
 #include "tests/Test.h"
@@ -144,6 +145,64 @@ DEF_TEST(SwizzleOpts, r) {
     REPORTER_ASSERT(r, dst == 0xFA04ADCA);
 }
 
+DEF_TEST(SwizzleIndexOpts, r) {
+    // Enough to cover both the vectorized loops and their tails.
+    constexpr int kMaxCount = 70;
+    SkRandom rand;
+    uint8_t src[kMaxCount];
+    for (uint8_t& byte : src) {
+        byte = rand.nextU() & 0xFF;
+    }
+    uint32_t ctable[256];
+    for (uint32_t& color : ctable) {
+        color = rand.nextU();
+    }
+
+    for (int count = 0; count <= kMaxCount; count++) {
+        uint32_t dst[kMaxCount];
+        SkOpts::index_to_8888(dst, src, count, ctable);
+        for (int i = 0; i < count; i++) {
+            REPORTER_ASSERT(r, dst[i] == ctable[src[i]]);
+        }
+
+        for (int bits : {1, 2, 4}) {
+            uint8_t indices[kMaxCount];
+            SkOpts::unpack_small_indices(indices, src, count, bits);
+            for (int i = 0; i < count; i++) {
+                const int bit = i * bits;
+                const uint8_t expected = (src[bit / 8] >> (8 - bits - bit % 8)) & ((1 << bits) - 1);
+                REPORTER_ASSERT(r, indices[i] == expected, "bits %d count %d i %d", bits, count, i);
+            }
+        }
+    }
+}
+
+DEF_TEST(Swizzle16Opts, r) {
+    constexpr int kMaxCount = 35;
+    SkRandom rand;
+    uint8_t src[kMaxCount * 8];
+    for (uint8_t& byte : src) {
+        byte = rand.nextU() & 0xFF;
+    }
+
+    for (int count = 0; count <= kMaxCount; count++) {
+        uint32_t rgb[kMaxCount], bgr[kMaxCount], rgba[kMaxCount], bgra[kMaxCount];
+        SkOpts::RGB16_to_RGB1(rgb, src, count);
+        SkOpts::RGB16_to_BGR1(bgr, src, count);
+        SkOpts::RGBA16_to_RGBA(rgba, src, count);
+        SkOpts::RGBA16_to_BGRA(bgra, src, count);
+        for (int i = 0; i < count; i++) {
+            // Components are big-endian, so their high bytes come first.
+            const uint8_t* p3 = src + 6*i;
+            const uint8_t* p4 = src + 8*i;
+            REPORTER_ASSERT(r, rgb[i]  == (0xFF000000 | p3[4] << 16 | p3[2] << 8 | p3[0]));
+            REPORTER_ASSERT(r, bgr[i]  == (0xFF000000 | p3[0] << 16 | p3[2] << 8 | p3[4]));
+            REPORTER_ASSERT(r, rgba[i] == ((uint32_t)p4[6] << 24 | p4[4] << 16 | p4[2] << 8 | p4[0]));
+            REPORTER_ASSERT(r, bgra[i] == ((uint32_t)p4[6] << 24 | p4[0] << 16 | p4[2] << 8 | p4[4]));
+        }
+    }
+}
+
 DEF_TEST(PublicSwizzleOpts, r) {
     uint32_t dst, src;
 
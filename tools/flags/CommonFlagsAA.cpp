@@ -9,8 +9,11 @@ static DEFINE_bool(forceAnalyticAA, false,
             "Force analytic anti-aliasing even if the path is complicated: "
             "whether it's concave or convex, we consider a path complicated"
             "if its number of points is comparable to its resolution.");
+static DEFINE_bool(forceCoverageAA, false,
+            "Force coverage accumulation anti-aliasing in place of supersampling or analytic AA.");
 
 void SetAnalyticAAFromCommonFlags() {
     gSkUseAnalyticAA   = FLAGS_analyticAA;
     gSkForceAnalyticAA = FLAGS_forceAnalyticAA;
+    gSkForceCoverageAA = FLAGS_forceCoverageAA;
 }
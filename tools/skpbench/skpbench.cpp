@@ -7,6 +7,7 @@
 
 #include "include/core/SkCanvas.h"
 #include "include/core/SkDeferredDisplayList.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkGraphics.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkPictureRecorder.h"
@@ -58,7 +59,8 @@
  * Well, maybe a little fanciness, MSKP's can be loaded and played. The animation is played as many
  * times as necessary to reach the target sample duration and FPS is reported.
  *
- * Currently, only GPU configs are supported.
+ * Currently, only GPU configs are supported, plus 'tiled8888': a CPU config that replays the skp
+ * into a raster bitmap with SkPicture::playbackTiled(), spreading its tiles across a thread pool.
  */
 
 static DEFINE_bool(ddl, false, "record the skp into DDLs before rendering");
@@ -79,6 +81,8 @@ static DEFINE_int(verbosity, 4, "level of verbosity (0=none to 5=debug)");
 static DEFINE_bool(suppressHeader, false, "don't print a header row before the results");
 static DEFINE_double(scale, 1, "Scale the size of the canvas and the zoom level by this factor.");
 static DEFINE_bool(dumpSamples, false, "print the individual samples to stdout");
+static DEFINE_int(cpuThreads, 0, "number of tiled8888 playback threads (0=num_cores)");
+static DEFINE_int(cpuTileSize, 256, "width and height of the tiles in tiled8888 playback");
 
 static const char header[] =
 "   accum    median       max       min   stddev  samples  sample_ms  clock  metric  config    bench";
@@ -130,6 +134,7 @@ static void draw_skp_and_flush_with_sync(GrDirectContext*, SkSurface*, const SkP
 static sk_sp<SkPicture> create_warmup_skp();
 static sk_sp<SkPicture> create_skp_from_svg(SkStream*, const char* filename);
 static bool mkdir_p(const SkString& name);
+static void save_png(const SkBitmap&);
 static SkString         join(const CommandLineFlags::StringArray&);
 static void exitf(ExitErr, const char* format, ...);
 
@@ -373,6 +378,41 @@ static void run_benchmark(GrDirectContext* context, SkSurface* surface, SkpProdu
     context->submit(true);
 }
 
+static void run_tiled_cpu_benchmark(const SkPicture* skp, const SkPixmap& dst,
+                                    const SkMatrix& matrix, std::vector<Sample>* samples) {
+    using clock = std::chrono::high_resolution_clock;
+    const Sample::duration sampleDuration = std::chrono::milliseconds(FLAGS_sampleMs);
+    const clock::duration benchDuration = std::chrono::milliseconds(FLAGS_duration);
+
+    std::unique_ptr<SkExecutor> threadPool = SkExecutor::MakeFIFOThreadPool(FLAGS_cpuThreads);
+    auto draw = [&]() {
+        if (!skp->playbackTiled(dst, matrix, threadPool.get(), FLAGS_cpuTileSize)) {
+            exitf(ExitErr::kUnavailable, "failed to play back tiles of size %i",
+                                         FLAGS_cpuTileSize);
+        }
+    };
+
+    for (int i = 0; i < kNumFlushesToPrimeCache; ++i) {
+        draw();
+    }
+
+    clock::time_point now = clock::now();
+    const clock::time_point endTime = now + benchDuration;
+
+    do {
+        clock::time_point sampleStart = now;
+        samples->emplace_back();
+        Sample& sample = samples->back();
+
+        do {
+            draw();
+            ++sample.fFrames;
+            now = clock::now();
+            sample.fDuration = now - sampleStart;
+        } while (sample.fDuration < sampleDuration);
+    } while (now < endTime || 0 == samples->size() % 2);
+}
+
 static void run_gpu_time_benchmark(sk_gpu_test::GpuTimer* gpuTimer, GrDirectContext* context,
                                    SkSurface* surface, const SkPicture* skp,
                                    std::vector<Sample>* samples) {
@@ -494,13 +534,15 @@ int main(int argc, char** argv) {
         exit(0); // This can be used to print the header and quit.
     }
 
-    // Parse the config.
+    // Parse the config. The CPU config 'tiled8888' leaves config null.
     const SkCommandLineConfigGpu* config = nullptr; // Initialize for spurious warning.
     SkCommandLineConfigArray configs;
     ParseConfigs(FLAGS_config, &configs);
-    if (configs.count() != 1 || !(config = configs[0]->asConfigGpu())) {
-        exitf(ExitErr::kUsage, "invalid config '%s': must specify one (and only one) GPU config",
-                               join(FLAGS_config).c_str());
+    if (configs.count() != 1 || !(configs[0]->getTag().equals("tiled8888") ||
+                                  (config = configs[0]->asConfigGpu()))) {
+        exitf(ExitErr::kUsage,
+              "invalid config '%s': must specify one (and only one) GPU config, or tiled8888",
+              join(FLAGS_config).c_str());
     }
 
     // Parse the skp.
@@ -555,6 +597,24 @@ int main(int argc, char** argv) {
         }
     }
 
+    SkMatrix matrix = SkMatrix::Translate(-skp->cullRect().x(), -skp->cullRect().y());
+    matrix.preScale(FLAGS_scale, FLAGS_scale);
+
+    if (!config) {
+        if (FLAGS_ddl || FLAGS_gpuClock || mskp) {
+            exitf(ExitErr::kUnavailable, "tiled8888 only supports static skps on the cpu clock");
+        }
+        SkBitmap bmp;
+        bmp.allocPixels(SkImageInfo::MakeN32Premul(width, height));
+        bmp.eraseColor(SK_ColorTRANSPARENT);
+
+        std::vector<Sample> samples;
+        run_tiled_cpu_benchmark(skp.get(), bmp.pixmap(), matrix, &samples);
+        print_result(samples, configs[0]->getTag().c_str(), srcname.c_str());
+        save_png(bmp);
+        return(0);
+    }
+
     if (config->getSurfType() != SkCommandLineConfigGpu::SurfType::kDefault) {
         exitf(ExitErr::kUnavailable, "This tool only supports the default surface type. (%s)",
               config->getTag().c_str());
@@ -614,11 +674,7 @@ int main(int argc, char** argv) {
     } else {
         samples.reserve(2 * FLAGS_duration);
     }
-    SkCanvas* canvas = surface->getCanvas();
-    canvas->translate(-skp->cullRect().x(), -skp->cullRect().y());
-    if (FLAGS_scale != 1) {
-        canvas->scale(FLAGS_scale, FLAGS_scale);
-    }
+    surface->getCanvas()->setMatrix(matrix);
     if (!FLAGS_gpuClock) {
         if (FLAGS_ddl) {
             run_ddl_benchmark(testCtx, ctx, surface, skp.get(), &samples);
@@ -646,17 +702,24 @@ int main(int argc, char** argv) {
         if (!surface->getCanvas()->readPixels(bmp, 0, 0)) {
             exitf(ExitErr::kUnavailable, "failed to read canvas pixels for png");
         }
-        if (!mkdir_p(SkOSPath::Dirname(FLAGS_png[0]))) {
-            exitf(ExitErr::kIO, "failed to create directory for png \"%s\"", FLAGS_png[0]);
-        }
-        if (!ToolUtils::EncodeImageToFile(FLAGS_png[0], bmp, SkEncodedImageFormat::kPNG, 100)) {
-            exitf(ExitErr::kIO, "failed to save png to \"%s\"", FLAGS_png[0]);
-        }
+        save_png(bmp);
     }
 
     return(0);
 }
 
+static void save_png(const SkBitmap& bmp) {
+    if (FLAGS_png.isEmpty()) {
+        return;
+    }
+    if (!mkdir_p(SkOSPath::Dirname(FLAGS_png[0]))) {
+        exitf(ExitErr::kIO, "failed to create directory for png \"%s\"", FLAGS_png[0]);
+    }
+    if (!ToolUtils::EncodeImageToFile(FLAGS_png[0], bmp, SkEncodedImageFormat::kPNG, 100)) {
+        exitf(ExitErr::kIO, "failed to save png to \"%s\"", FLAGS_png[0]);
+    }
+}
+
 static void flush_with_sync(GrDirectContext* context, GpuSync& gpuSync) {
     gpuSync.waitIfNeeded();
 
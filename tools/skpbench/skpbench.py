@@ -68,7 +68,7 @@ __argparse.add_argument('--allPathsVolatile',
   action='store_true',
   help="Causes all GPU paths to be processed as if 'setIsVolatile' had been called.")
 __argparse.add_argument('-c', '--config',
-  default='gl', help="comma- or space-separated list of GPU configs")
+  default='gl', help="comma- or space-separated list of GPU configs, or 'tiled8888'")
 __argparse.add_argument('-a', '--resultsfile',
   help="optional file to append results into")
 __argparse.add_argument('--ddl',
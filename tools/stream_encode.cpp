@@ -0,0 +1,129 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBBHFactory.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkStream.h"
+#include "include/core/SkTime.h"
+#include "include/encode/SkJpegEncoder.h"
+#include "include/encode/SkPngEncoder.h"
+#include "include/effects/SkGradientShader.h"
+#include "tools/ProcStats.h"
+#include "tools/flags/CommandLineFlags.h"
+
+// Draws a large image and encodes it, and reports the peak resident set size of the process.
+// By default the image is drawn and encoded in bands with SkEncoder::encodeDrawnRows, so memory
+// stays bounded by a band however large the image is. With --full it is drawn into one bitmap
+// and encoded from that, for comparison.
+//
+//   stream_encode --width 30000 --height 30000 --format png --out big.png
+
+static DEFINE_int(width, 30000, "Width of the image to encode.");
+static DEFINE_int(height, 30000, "Height of the image to encode.");
+static DEFINE_int(bandRows, 256, "Rows drawn and encoded at a time.");
+static DEFINE_string(format, "png", "Format to encode: png or jpeg.");
+static DEFINE_string(skp, "", "SKP to draw, scaled to fill the image. Draws a pattern if empty.");
+static DEFINE_string(out, "", "File to write the encoded image to. Discards it if empty.");
+static DEFINE_bool(full, false, "Draw the whole image into memory before encoding it.");
+
+// A picture of shapes and gradients tiled over the whole image, with a bounding box hierarchy so
+// that drawing a band only replays the shapes that touch it.
+static sk_sp<SkPicture> make_pattern(int width, int height) {
+    constexpr SkScalar kCell = 250;
+    const SkRect bounds = SkRect::MakeIWH(width, height);
+
+    SkRTreeFactory factory;
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(bounds, &factory);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    for (SkScalar y = 0; y < bounds.height(); y += kCell) {
+        for (SkScalar x = 0; x < bounds.width(); x += kCell) {
+            const SkPoint pts[] = {{x, y}, {x + kCell, y + kCell}};
+            const SkColor colors[] = {SK_ColorBLUE, SK_ColorYELLOW};
+            paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2,
+                                                         SkTileMode::kClamp));
+            canvas->drawRect(SkRect::MakeXYWH(x, y, kCell, kCell), paint);
+            paint.setShader(nullptr);
+            paint.setColor(SkColorSetARGB(0xC0, (int)x & 0xFF, (int)y & 0xFF, 0x80));
+            canvas->drawCircle(x + kCell / 2, y + kCell / 2, kCell / 3, paint);
+        }
+    }
+    return recorder.finishRecordingAsPicture();
+}
+
+static std::unique_ptr<SkEncoder> make_encoder(SkWStream* dst, const SkImageInfo& info) {
+    if (0 == strcmp(FLAGS_format[0], "jpeg")) {
+        return SkJpegEncoder::Make(dst, info, SkJpegEncoder::Options());
+    }
+    return SkPngEncoder::Make(dst, info, SkPngEncoder::Options());
+}
+
+int main(int argc, char** argv) {
+    CommandLineFlags::SetUsage("Draws and encodes a large image, and reports peak memory use.");
+    CommandLineFlags::Parse(argc, argv);
+
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(FLAGS_width, FLAGS_height);
+    sk_sp<SkPicture> picture;
+    SkMatrix matrix;
+    if (!FLAGS_skp.isEmpty()) {
+        std::unique_ptr<SkStream> stream = SkStream::MakeFromFile(FLAGS_skp[0]);
+        picture = stream ? SkPicture::MakeFromStream(stream.get()) : nullptr;
+        if (!picture) {
+            SkDebugf("Could not read %s.\n", FLAGS_skp[0]);
+            return 1;
+        }
+        matrix = SkMatrix::RectToRect(picture->cullRect(), SkRect::Make(info.bounds()));
+    } else {
+        picture = make_pattern(info.width(), info.height());
+    }
+    const int recordedMB = sk_tools::getMaxResidentSetSizeMB();
+
+    std::unique_ptr<SkWStream> dst;
+    if (!FLAGS_out.isEmpty()) {
+        dst = std::make_unique<SkFILEWStream>(FLAGS_out[0]);
+    } else {
+        dst = std::make_unique<SkNullWStream>();
+    }
+
+    const double start = SkTime::GetMSecs();
+    bool success;
+    if (FLAGS_full) {
+        SkBitmap bitmap;
+        if (!bitmap.tryAllocPixels(info)) {
+            SkDebugf("Could not allocate %zu bytes.\n", info.computeMinByteSize());
+            return 1;
+        }
+        bitmap.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas(bitmap).drawPicture(picture, &matrix, nullptr);
+        SkPixmap pixmap;
+        SkAssertResult(bitmap.peekPixels(&pixmap));
+        success = 0 == strcmp(FLAGS_format[0], "jpeg")
+                ? SkJpegEncoder::Encode(dst.get(), pixmap, SkJpegEncoder::Options())
+                : SkPngEncoder::Encode(dst.get(), pixmap, SkPngEncoder::Options());
+    } else {
+        std::unique_ptr<SkEncoder> encoder = make_encoder(dst.get(), info);
+        success = encoder && encoder->encodeDrawnRows(FLAGS_bandRows, [&](SkCanvas* canvas) {
+            canvas->drawPicture(picture, &matrix, nullptr);
+        });
+    }
+    dst->flush();
+
+    if (!success) {
+        SkDebugf("Encoding failed.\n");
+        return 1;
+    }
+    SkDebugf("Encoded %dx%d %s (%zu bytes) in %.0f ms, %s.\n",
+             info.width(), info.height(), FLAGS_format[0], dst->bytesWritten(),
+             SkTime::GetMSecs() - start, FLAGS_full ? "all at once" : "in bands");
+    SkDebugf("Peak RSS: %d MB (%d MB after recording).\n",
+             sk_tools::getMaxResidentSetSizeMB(), recordedMB);
+    return 0;
+}